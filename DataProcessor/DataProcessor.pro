@@ -13,12 +13,16 @@ CONFIG += utf8
 # depend on your compiler). Please consult the documentation of the
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS
+
 TARGET = DataProcessor
 TEMPLATE = app
 
 INCLUDEPATH += $$PWD/
 DEPENDPATH += $$PWD/
 
+# 回放引擎（与 replay_cli、udpsend_bench 共用）
+include(replay.pri)
+
 # 按debug|release模式分别设置输出目录
 CONFIG(debug, debug|release) {
     DESTDIR = $$PWD/bin_debug
@@ -50,36 +54,50 @@ UI_DIR = $$DESTDIR/.ui
 SOURCES += \
     configmanager.cpp \
     customdatasender.cpp \
+    framegenerator.cpp \
+    framepattern.cpp \
     faultAlarmWidget/faultAlarmWidget.cpp \
+    log/logmodel.cpp \
     main.cpp \
     mainwindow.cpp \
     threadmanager.cpp \
     orderSend/ordersendwidget.cpp \
     orderSend/sendworker.cpp \
+    orderSend/commandflow.cpp \
+    orderSend/flowengine.cpp \
+    orderSend/timerwheel.cpp \
+    orderSend/frametemplate.cpp \
     orderSend/multipliersettingsdialog.cpp \
     orderSend/multiplierhelpdialog.cpp \
     tinyxml/tinystr.cpp \
     tinyxml/tinyxml.cpp \
     tinyxml/tinyxmlerror.cpp \
     tinyxml/tinyxmlparser.cpp \
-    udpsender.cpp \
-    workerclass.cpp
+    tinyxml/tinyxmlarena.cpp \
+    tinyxml/tinyxmlreader.cpp
 
 HEADERS += \
     alldefine.h \
     threadmanager.h \
     configmanager.h \
     customdatasender.h \
+    framegenerator.h \
+    framepattern.h \
     faultAlarmWidget/faultAlarmWidget.h \
+    log/logmodel.h \
     mainwindow.h \
     orderSend/ordersendwidget.h \
     orderSend/sendworker.h \
+    orderSend/commandflow.h \
+    orderSend/flowengine.h \
+    orderSend/timerwheel.h \
+    orderSend/frametemplate.h \
     orderSend/multipliersettingsdialog.h \
     orderSend/multiplierhelpdialog.h \
     tinyxml/tinystr.h \
     tinyxml/tinyxml.h \
-    udpsender.h \
-    workerclass.h
+    tinyxml/tinyxmlarena.h \
+    tinyxml/tinyxmlreader.h
 
 FORMS += \
     mainwindow.ui \
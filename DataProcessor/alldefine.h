@@ -6,7 +6,7 @@
 #include <QColor>
 
 /**
- * @brief 最大日志条目
+ * @brief 最大日志条目（日志视图环形缓冲区容量，超出后淘汰最早的日志）
  */
 const int MAX_LOG_ENTRIES = 100000;
 
@@ -0,0 +1,21 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG += utf8
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Werror=return-type
+
+TARGET = hexdecoder_bench
+TEMPLATE = app
+
+# 直接复用 DataProcessor 的解码器源码
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    ../../replay/hexdecoder.cpp
+
+HEADERS += \
+    ../../replay/hexdecoder.h
@@ -0,0 +1,144 @@
+//hexdecoder_bench
+//对比原 WorkerClass::cleanHexData（正则清洗 + toLatin1 + fromHex）与 HexDecoder 各实现的解码吞吐
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <random>
+
+#include "replay/hexdecoder.h"
+
+namespace
+{
+    ///原实现（去掉日志输出）
+    QByteArray legacyCleanHexData(const QString &data)
+    {
+        static QRegularExpression nonHexChar("[^0-9A-Fa-f]");
+        QString cleanStr = data;
+        cleanStr.remove(nonHexChar);
+        if(cleanStr.isEmpty() || (cleanStr.length() % 2 != 0))
+        {
+            return QByteArray();
+        }
+        return QByteArray::fromHex(cleanStr.toLatin1());
+    }
+
+    ///生成与现场抓包一致的数据行：空格分隔的大写十六进制，或连续十六进制
+    QVector<QByteArray> makeLines(int count, int minBytes, int maxBytes, bool spaced)
+    {
+        std::mt19937 rng(20240601);
+        std::uniform_int_distribution<int> lenDist(minBytes, maxBytes);
+        std::uniform_int_distribution<int> byteDist(0, 255);
+        QVector<QByteArray> lines;
+        lines.reserve(count);
+        for(int i = 0; i < count; ++i)
+        {
+            QByteArray raw;
+            const int len = lenDist(rng);
+            for(int j = 0; j < len; ++j)
+            {
+                raw.append(static_cast<char>(byteDist(rng)));
+            }
+            lines.append(spaced ? raw.toHex(' ').toUpper() : raw.toHex().toUpper());
+        }
+        return lines;
+    }
+
+    struct Result
+    {
+        double nsPerLine;
+        double mbPerSec;
+    };
+
+    Result report(qint64 elapsedNs, int lines, qint64 inputBytes, int rounds)
+    {
+        Result r;
+        r.nsPerLine = static_cast<double>(elapsedNs) / (static_cast<double>(lines) * rounds);
+        r.mbPerSec = (static_cast<double>(inputBytes) * rounds / (1024.0 * 1024.0))
+                     / (static_cast<double>(elapsedNs) / 1e9);
+        return r;
+    }
+
+    void runScenario(QTextStream &out, const QString &name, const QVector<QByteArray> &lines, int rounds)
+    {
+        qint64 inputBytes = 0;
+        int maxLen = 0;
+        QVector<QString> asStrings;
+        asStrings.reserve(lines.size());
+        for(const QByteArray &line : lines)
+        {
+            inputBytes += line.size();
+            maxLen = qMax(maxLen, line.size());
+            asStrings.append(QString::fromLatin1(line));
+        }
+        out << "== " << name << "  行数:" << lines.size() << "  平均行长:" << (inputBytes / lines.size()) << " 字符\n";
+        //原实现（与原来一样按 QString 输入）
+        QElapsedTimer timer;
+        qint64 checksum = 0;
+        timer.start();
+        for(int r = 0; r < rounds; ++r)
+        {
+            for(const QString &line : asStrings)
+            {
+                checksum += legacyCleanHexData(line).size();
+            }
+        }
+        const Result legacy = report(timer.nsecsElapsed(), lines.size(), inputBytes, rounds);
+        out << QString("  %1 %2 ns/行  %3 MB/s\n").arg("legacy", -8)
+            .arg(legacy.nsPerLine, 10, 'f', 1).arg(legacy.mbPerSec, 9, 'f', 1);
+        //HexDecoder 各实现，写入调用方提供的同一缓冲区
+        QByteArray buffer(HexDecoder::maxDecodedSize(maxLen), Qt::Uninitialized);
+        const HexDecoder::Isa isas[] = {HexDecoder::Isa::Scalar, HexDecoder::Isa::Sse2, HexDecoder::Isa::Avx2};
+        for(HexDecoder::Isa isa : isas)
+        {
+            if(!HexDecoder::isSupported(isa))
+            {
+                out << QString("  %1 不支持\n").arg(HexDecoder::isaName(isa), -8);
+                continue;
+            }
+            //先校验与原实现结果一致
+            for(int i = 0; i < lines.size(); ++i)
+            {
+                const int n = HexDecoder::decodeWith(isa, lines[i].constData(), lines[i].size(),
+                                                     buffer.data(), buffer.size());
+                if(QByteArray(buffer.constData(), qMax(n, 0)) != legacyCleanHexData(asStrings[i]))
+                {
+                    out << "  结果不一致: " << HexDecoder::isaName(isa) << " 第" << i << "行\n";
+                    return;
+                }
+            }
+            timer.restart();
+            for(int r = 0; r < rounds; ++r)
+            {
+                for(const QByteArray &line : lines)
+                {
+                    checksum += HexDecoder::decodeWith(isa, line.constData(), line.size(),
+                                                       buffer.data(), buffer.size());
+                }
+            }
+            const Result res = report(timer.nsecsElapsed(), lines.size(), inputBytes, rounds);
+            out << QString("  %1 %2 ns/行  %3 MB/s  加速比 x%4\n").arg(HexDecoder::isaName(isa), -8)
+                .arg(res.nsPerLine, 10, 'f', 1).arg(res.mbPerSec, 9, 'f', 1)
+                .arg(legacy.nsPerLine / res.nsPerLine, 0, 'f', 1);
+        }
+        out << "  (checksum " << checksum << ")\n";
+        out.flush();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    const int rounds = app.arguments().size() > 1 ? qMax(1, app.arguments().at(1).toInt()) : 20;
+    out << "HexDecoder 当前实现: " << HexDecoder::isaName(HexDecoder::activeIsa()) << "  轮数: " << rounds << "\n";
+    runScenario(out, "小包 空格分隔 (16-64 字节)", makeLines(20000, 16, 64, true), rounds);
+    runScenario(out, "常规包 空格分隔 (64-512 字节)", makeLines(20000, 64, 512, true), rounds);
+    runScenario(out, "大包 连续十六进制 (512-1400 字节)", makeLines(5000, 512, 1400, false), rounds);
+    return 0;
+}
@@ -0,0 +1,247 @@
+//tinyxml_bench
+//对比指令配置的三种读取方式：原 getconfig 方式（堆上 DOM，逐节点 new/delete）、arena DOM（整棵树一次释放）
+//与 TiXmlReader 拉取式解析（直接解析内存映射的文件，不建树）。
+//DOM 方式同时统计 LoadFile 期间的 malloc 次数（TiXmlGetAllocationStats），按节点与属性数折算，
+//用于观察 TiXmlString 短串内联与 arena 对分配次数的影响。
+//用法：tinyxml_bench [文件大小MB ...]，默认 1 10 100
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QStringList>
+#include <cstring>
+
+#include "tinyxml/tinyxml.h"
+#include "tinyxml/tinyxmlreader.h"
+
+namespace
+{
+    ///与 getconfig 相同的取值：任务数、主题号与命令字之和、超时之和，用于校验三种方式结果一致
+    struct Summary
+    {
+        qint64 tasks = 0;
+        qint64 ids = 0;
+        double outTime = 0;
+
+        void add(const char *id, const char *comid, const char *outTime)
+        {
+            ++tasks;
+            ids += QByteArray(id).mid(2).toLongLong(nullptr, 16) + QByteArray(comid).mid(2).toLongLong(nullptr, 16);
+            this->outTime += QByteArray(outTime).toDouble();
+        }
+
+        bool operator==(const Summary &other) const
+        {
+            //取值与累加顺序相同，浮点和应完全一致
+            return tasks == other.tasks && ids == other.ids && outTime == other.outTime;
+        }
+    };
+
+    ///各阶段耗时（毫秒）
+    struct Timing
+    {
+        double loadMs = 0;
+        double walkMs = 0;
+        double freeMs = 0;
+        double totalMs() const { return loadMs + walkMs + freeMs; }
+    };
+
+    ///DOM 方式的附加统计
+    struct DomStats
+    {
+        qint64 arenaBytes = 0;
+        qint64 mallocs = 0;     ///<LoadFile 期间的 malloc 次数（含 arena 块）
+        qint64 nodes = 0;       ///<节点与属性总数
+    };
+
+    qint64 countNodes(const TiXmlNode *node)
+    {
+        qint64 count = 0;
+        for(const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+        {
+            ++count;
+            if(const TiXmlElement *element = child->ToElement())
+            {
+                for(const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+                {
+                    ++count;
+                }
+            }
+            count += countNodes(child);
+        }
+        return count;
+    }
+
+    ///生成与 sibugz_config.xml 结构相同的任务配置，直到文件达到指定大小
+    bool writeConfig(const QString &path, qint64 bytes)
+    {
+        QFile file(path);
+        if(!file.open(QIODevice::WriteOnly))
+        {
+            return false;
+        }
+        qint64 written = file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<outdataConfig>\n");
+        QByteArray chunk;
+        for(int i = 0; written + chunk.size() < bytes; ++i)
+        {
+            chunk += QString("    <task name=\"模拟任务%1\">\n"
+                             "        <id>0x%2</id>\n"
+                             "        <comid>0x%3</comid>\n"
+                             "        <outTime>%4.5</outTime>\n"
+                             "        <startIndex>%5</startIndex>\n"
+                             "    </task>\n")
+                     .arg(i).arg(i & 0xFFFF, 0, 16).arg((i * 7) & 0xFFFF, 0, 16).arg(i % 10).arg(i % 16).toUtf8();
+            if(chunk.size() > (1 << 20))
+            {
+                written += file.write(chunk);
+                chunk.clear();
+            }
+        }
+        file.write(chunk);
+        file.write("</outdataConfig>\n");
+        return true;
+    }
+
+    ///DOM 方式：加载、按 getconfig 的方式遍历、释放
+    Timing runDom(const QByteArray &path, bool arena, Summary &summary, DomStats &stats)
+    {
+        Timing timing;
+        QElapsedTimer timer;
+        timer.start();
+        const TiXmlAllocationStats before = TiXmlGetAllocationStats();
+        TiXmlDocument *doc = new TiXmlDocument();
+        doc->SetUseArena(arena);
+        if(!doc->LoadFile(path.constData()))
+        {
+            delete doc;
+            return timing;
+        }
+        timing.loadMs = timer.nsecsElapsed() / 1e6;
+        stats.mallocs = static_cast<qint64>(TiXmlGetAllocationStats().heap - before.heap);
+        timer.restart();
+        for(const TiXmlElement *task = doc->RootElement()->FirstChildElement("task"); task;
+            task = task->NextSiblingElement("task"))
+        {
+            summary.add(task->FirstChildElement("id")->GetText(), task->FirstChildElement("comid")->GetText(),
+                        task->FirstChildElement("outTime")->GetText());
+        }
+        timing.walkMs = timer.nsecsElapsed() / 1e6;
+        stats.arenaBytes = doc->Arena() ? static_cast<qint64>(doc->Arena()->BytesReserved()) : 0;
+        stats.nodes = countNodes(doc);
+        timer.restart();
+        delete doc;
+        timing.freeMs = timer.nsecsElapsed() / 1e6;
+        return timing;
+    }
+
+    ///拉取式解析：边读边取值，不建树
+    Timing runReader(const QByteArray &path, Summary &summary)
+    {
+        Timing timing;
+        QElapsedTimer timer;
+        timer.start();
+        TiXmlReader reader;
+        if(!reader.OpenFile(path.constData()))
+        {
+            return timing;
+        }
+        enum Field { Other, Id, ComId, OutTime } field = Other;
+        QByteArray id, comid, outTime;
+        while(true)
+        {
+            const TiXmlReader::EventType event = reader.Next();
+            if(event == TiXmlReader::TINYXML_START_ELEMENT && reader.Depth() == 2)
+            {
+                const char *name = reader.Name();
+                field = strcmp(name, "id") == 0 ? Id : strcmp(name, "comid") == 0 ? ComId
+                        : strcmp(name, "outTime") == 0 ? OutTime : Other;
+            }
+            else if(event == TiXmlReader::TINYXML_TEXT && reader.Depth() == 3)
+            {
+                if(field == Id) id = reader.Text();
+                else if(field == ComId) comid = reader.Text();
+                else if(field == OutTime) outTime = reader.Text();
+            }
+            else if(event == TiXmlReader::TINYXML_END_ELEMENT && reader.Depth() == 1)
+            {
+                summary.add(id.constData(), comid.constData(), outTime.constData());
+            }
+            else if(event == TiXmlReader::TINYXML_END_DOCUMENT || event == TiXmlReader::TINYXML_READ_ERROR)
+            {
+                break;
+            }
+        }
+        timing.loadMs = timer.nsecsElapsed() / 1e6;
+        return timing;
+    }
+
+    QString mallocText(const DomStats &stats)
+    {
+        return QString("  malloc %1 (每节点 %2)").arg(stats.mallocs)
+            .arg(stats.nodes > 0 ? double(stats.mallocs) / stats.nodes : 0.0, 0, 'f', 3);
+    }
+
+    void report(QTextStream &out, const QString &name, const Timing &timing, qint64 bytes, const QString &extra)
+    {
+        const double mbPerSec = timing.totalMs() > 0 ? (bytes / (1024.0 * 1024.0)) / (timing.totalMs() / 1000.0) : 0;
+        out << QString("  %1 加载 %2 ms  遍历 %3 ms  释放 %4 ms  合计 %5 ms  %6 MB/s%7\n")
+                   .arg(name, -12).arg(timing.loadMs, 8, 'f', 1).arg(timing.walkMs, 7, 'f', 1)
+                   .arg(timing.freeMs, 7, 'f', 1).arg(timing.totalMs(), 8, 'f', 1).arg(mbPerSec, 7, 'f', 1).arg(extra);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QList<int> sizes;
+    for(const QString &arg : app.arguments().mid(1))
+    {
+        if(arg.toInt() > 0)
+        {
+            sizes << arg.toInt();
+        }
+    }
+    if(sizes.isEmpty())
+    {
+        sizes << 1 << 10 << 100;
+    }
+    QTemporaryDir dir;
+    if(!dir.isValid())
+    {
+        out << "无法创建临时目录\n";
+        return 1;
+    }
+    for(int mb : sizes)
+    {
+        const QString path = dir.filePath(QString("config_%1mb.xml").arg(mb));
+        if(!writeConfig(path, static_cast<qint64>(mb) << 20))
+        {
+            out << "无法写入 " << path << "\n";
+            return 1;
+        }
+        const qint64 bytes = QFile(path).size();
+        const QByteArray localPath = path.toUtf8();
+        out << "== " << mb << " MB 配置\n";
+        out.flush();
+        Summary heap, arena, pull;
+        DomStats heapStats, arenaStats;
+        const Timing heapTiming = runDom(localPath, false, heap, heapStats);
+        report(out, "DOM(堆)", heapTiming, bytes, QString("  任务 %1").arg(heap.tasks) + mallocText(heapStats));
+        const Timing arenaTiming = runDom(localPath, true, arena, arenaStats);
+        report(out, "DOM(arena)", arenaTiming, bytes,
+               QString("  arena %1 MB").arg(arenaStats.arenaBytes / (1024.0 * 1024.0), 0, 'f', 1) + mallocText(arenaStats));
+        const Timing pullTiming = runReader(localPath, pull);
+        report(out, "拉取解析", pullTiming, bytes, QString("  加速比 x%1").arg(heapTiming.totalMs() / qMax(pullTiming.totalMs(), 0.001), 0, 'f', 1));
+        if(!(heap == arena && heap == pull) || heap.tasks == 0)
+        {
+            out << "  结果不一致: 任务 " << heap.tasks << "/" << arena.tasks << "/" << pull.tasks << "\n";
+            return 1;
+        }
+        out.flush();
+        QFile::remove(path);
+    }
+    return 0;
+}
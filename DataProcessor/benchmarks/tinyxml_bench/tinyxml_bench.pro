@@ -0,0 +1,29 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG += utf8
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Werror=return-type
+
+TARGET = tinyxml_bench
+TEMPLATE = app
+
+# 直接复用 DataProcessor 自带的 tinyxml 源码
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    ../../tinyxml/tinystr.cpp \
+    ../../tinyxml/tinyxml.cpp \
+    ../../tinyxml/tinyxmlerror.cpp \
+    ../../tinyxml/tinyxmlparser.cpp \
+    ../../tinyxml/tinyxmlarena.cpp \
+    ../../tinyxml/tinyxmlreader.cpp
+
+HEADERS += \
+    ../../tinyxml/tinystr.h \
+    ../../tinyxml/tinyxml.h \
+    ../../tinyxml/tinyxmlarena.h \
+    ../../tinyxml/tinyxmlreader.h
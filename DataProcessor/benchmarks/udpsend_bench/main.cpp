@@ -0,0 +1,408 @@
+//udpsend_bench
+//本机回环测量 DataProcessor 各发送路径的实际能力：接收端统计速率、丢包、乱序与到达间隔抖动，结果写入 JSON。
+//场景：
+//  1. 文本抓包最快回放（WorkerClass 完整流程：遍历、解析、调度、UdpSender）
+//  2. UdpSender 扇出 1/4/16 个目标（小包）
+//  3. UdpSender 小包与巨型包（64 / 8192 字节）
+//  4. QUdpSocket 逐包 writeDatagram（FaultAlarmWidget 使用的发送方式）
+//  5. FrameGenerator 模板帧（CustomDataSender 使用）：10us 定速 1 目标、最快 1 目标与 4 目标
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "udpsink.h"
+#include "workerclass.h"
+#include "framegenerator.h"
+
+namespace
+{
+    ///接收端期望的接收缓冲区（实际值受系统上限约束，见结果中的 receiveBuffer）
+    const int SINK_RECEIVE_BUFFER = 32 * 1024 * 1024;
+    ///发送结束后接收端无新数据多久视为接收完毕
+    const int DRAIN_IDLE_MS = 300;
+
+    ///场景参数
+    struct Scenario
+    {
+        QString name;        ///< 场景名称
+        QString driver;      ///< 发送路径：replay / udpsender / qudpsocket / generator
+        int destinations;    ///< 目标数
+        int payloadBytes;    ///< 数据包长度
+        int packets;         ///< 每个目标的包数
+        qint64 intervalNs;   ///< 帧间隔（仅 generator），0 表示尽可能快
+    };
+
+    ///构造第 seq 个数据包：第 3-4 字节为小端主题号（00C6），第 5-12 字节为小端序号，其余填充
+    void fillPacket(char *data, int length, quint64 seq)
+    {
+        std::memset(data, 0x5A, static_cast<size_t>(length));
+        data[0] = static_cast<char>(0x80);
+        data[1] = 0x21;
+        data[2] = 0x00;
+        data[3] = static_cast<char>(0xC6);
+        data[4] = 0x00;
+        qToLittleEndian<quint64>(seq, reinterpret_cast<uchar *>(data + 5));
+    }
+
+    ///生成文本抓包：[时间戳]\t空格分隔的十六进制
+    bool writeCapture(const QString &path, int packets, int payloadBytes, QString &error)
+    {
+        QFile file(path);
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            error = file.errorString();
+            return false;
+        }
+        QByteArray packet(payloadBytes, Qt::Uninitialized);
+        QByteArray chunk;
+        for(int i = 0; i < packets; ++i)
+        {
+            fillPacket(packet.data(), payloadBytes, static_cast<quint64>(i));
+            const qint64 us = static_cast<qint64>(i) * 100;
+            chunk += QString("[2024-06-01 12:%1:%2.%3]\t")
+                     .arg(us / 60000000 % 60, 2, 10, QLatin1Char('0'))
+                     .arg(us / 1000000 % 60, 2, 10, QLatin1Char('0'))
+                     .arg(us % 1000000, 6, 10, QLatin1Char('0')).toLatin1();
+            chunk += packet.toHex(' ').toUpper();
+            chunk += '\n';
+            if(chunk.size() > 4 * 1024 * 1024)
+            {
+                file.write(chunk);
+                chunk.clear();
+            }
+        }
+        file.write(chunk);
+        return true;
+    }
+
+    ///等待各接收端收齐或空闲超时
+    void drainSinks(const std::vector<std::unique_ptr<UdpSink>> &sinks, qint64 expected)
+    {
+        qint64 lastTotal = -1;
+        QElapsedTimer idle;
+        idle.start();
+        while(idle.elapsed() < DRAIN_IDLE_MS)
+        {
+            qint64 total = 0;
+            bool complete = true;
+            for(const auto &sink : sinks)
+            {
+                total += sink->received();
+                complete = complete && sink->received() >= expected;
+            }
+            if(complete)
+            {
+                return;
+            }
+            if(total != lastTotal)
+            {
+                lastTotal = total;
+                idle.restart();
+            }
+            QThread::msleep(5);
+        }
+    }
+
+    ///UdpSender：一次发布到全部目标，载荷共用
+    bool runUdpSender(const Scenario &scenario, const QStringList &addresses, QString &error)
+    {
+        UdpSender sender;
+        QVector<int> destinations;
+        for(const QString &address : addresses)
+        {
+            destinations.append(sender.addDestination(address));
+        }
+        for(int i = 0; i < scenario.packets; ++i)
+        {
+            char *buffer = sender.reserve(scenario.payloadBytes, destinations.size());
+            if(!buffer)
+            {
+                error = "发送队列预留失败";
+                return false;
+            }
+            fillPacket(buffer, scenario.payloadBytes, static_cast<quint64>(i));
+            sender.publish(scenario.payloadBytes, destinations.constData(), destinations.size(),
+                           ReplayScheduler::AsFastAsPossible, 0x00C6);
+        }
+        sender.flush();
+        return true;
+    }
+
+    ///QUdpSocket：每包每目标一次 writeDatagram
+    bool runQUdpSocket(const Scenario &scenario, const QStringList &addresses, QString &error)
+    {
+        QUdpSocket socket;
+        QVector<QPair<QHostAddress, quint16>> targets;
+        for(const QString &address : addresses)
+        {
+            targets.append(qMakePair(QHostAddress(address.section(':', 0, 0)), address.section(':', 1, 1).toUShort()));
+        }
+        QByteArray packet(scenario.payloadBytes, Qt::Uninitialized);
+        for(int i = 0; i < scenario.packets; ++i)
+        {
+            fillPacket(packet.data(), scenario.payloadBytes, static_cast<quint64>(i));
+            for(const auto &target : targets)
+            {
+                //发送缓冲区满时让出 CPU 重试，与界面发送器遇到的情况一致
+                int retries = 0;
+                while(socket.writeDatagram(packet, target.first, target.second) < 0)
+                {
+                    if(++retries > 1000)
+                    {
+                        error = socket.errorString();
+                        return false;
+                    }
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }
+        return true;
+    }
+
+    ///帧发生器：第 5-12 字节为按目标计数的小端序号，单帧模板，依次发往各目标
+    bool runGenerator(const Scenario &scenario, const QStringList &addresses, QString &error)
+    {
+        FramePattern frame;
+        const QString line = "80 21 00 C6 00 {cnt:8:tgt}" + QString(" 5A").repeated(scenario.payloadBytes - 13);
+        if(!frame.compile(line, error))
+        {
+            return false;
+        }
+        FrameGenerator::Config config;
+        config.frames << frame;
+        config.targets = addresses;
+        config.intervalNs = scenario.intervalNs;
+        config.loop = true;
+        config.count = static_cast<qint64>(scenario.packets) * scenario.destinations;
+        FrameGenerator generator;
+        if(!generator.configure(config, error))
+        {
+            return false;
+        }
+        QEventLoop loop;
+        QObject::connect(&generator, &QThread::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+        generator.start(QThread::TimeCriticalPriority);
+        loop.exec();
+        generator.stop();
+        if(generator.sentCount() != config.count)
+        {
+            error = QString("发生器发出 %1 包，预期 %2 包").arg(generator.sentCount()).arg(config.count);
+        }
+        return true;
+    }
+
+    ///文本抓包回放：与界面相同的 WorkerClass 流程，固定间隔 0 即尽可能快
+    bool runReplay(const Scenario &scenario, const QStringList &addresses, const QString &dataDir, QString &error)
+    {
+        QThread thread;
+        WorkerClass worker;
+        worker.setAddrList(addresses);
+        worker.configure(QVariantMap{{"dataDir", dataDir}, {"pacingMode", "interval"}, {"sendInterval", 0},
+                                     {"order", "顺序"}, {"parseThreads", 0}});
+        worker.moveToThread(&thread);
+        QObject::connect(&thread, &QThread::started, &worker, &WorkerClass::startProcessing);
+        QEventLoop loop;
+        QObject::connect(&worker, &WorkerClass::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+        thread.start();
+        loop.exec();
+        worker.stopProcessing();
+        thread.quit();
+        thread.wait();
+        const ReplayTelemetry::Snapshot snapshot = worker.telemetry()->snapshot();
+        qint64 sent = 0;
+        for(const ReplayTelemetry::DestinationStats &stats : snapshot.destinations)
+        {
+            sent += stats.packets;
+        }
+        if(sent != static_cast<qint64>(scenario.packets) * scenario.destinations)
+        {
+            error = QString("回放发出 %1 包，预期 %2 包").arg(sent)
+                    .arg(static_cast<qint64>(scenario.packets) * scenario.destinations);
+        }
+        return true;
+    }
+
+    QJsonObject runScenario(QTextStream &out, const Scenario &scenario, const QString &dataDir)
+    {
+        QJsonObject result;
+        result["name"] = scenario.name;
+        result["driver"] = scenario.driver;
+        result["destinations"] = scenario.destinations;
+        result["payloadBytes"] = scenario.payloadBytes;
+        result["packetsPerDestination"] = scenario.packets;
+        result["intervalNs"] = scenario.intervalNs;
+        //每个目标一个接收端
+        std::vector<std::unique_ptr<UdpSink>> sinks;
+        QStringList addresses;
+        for(int i = 0; i < scenario.destinations; ++i)
+        {
+            std::unique_ptr<UdpSink> sink(new UdpSink());
+            QString error;
+            if(!sink->open(SINK_RECEIVE_BUFFER, error))
+            {
+                result["error"] = "接收端绑定失败: " + error;
+                return result;
+            }
+            sink->reset(scenario.packets);
+            sink->start();
+            addresses << QString("127.0.0.1:%1").arg(sink->port());
+            sinks.push_back(std::move(sink));
+        }
+        QString error;
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = false;
+        if(scenario.driver == "replay")
+        {
+            ok = runReplay(scenario, addresses, dataDir, error);
+        }
+        else if(scenario.driver == "udpsender")
+        {
+            ok = runUdpSender(scenario, addresses, error);
+        }
+        else if(scenario.driver == "generator")
+        {
+            ok = runGenerator(scenario, addresses, error);
+        }
+        else
+        {
+            ok = runQUdpSocket(scenario, addresses, error);
+        }
+        const qint64 sendNs = timer.nsecsElapsed();
+        drainSinks(sinks, scenario.packets);
+        for(const auto &sink : sinks)
+        {
+            sink->stop();
+        }
+        if(!error.isEmpty())
+        {
+            result["error"] = error;
+        }
+        if(!ok)
+        {
+            return result;
+        }
+        //发送端：从开始发送到全部交给系统
+        const double sendSec = sendNs / 1e9;
+        const qint64 datagrams = static_cast<qint64>(scenario.packets) * scenario.destinations;
+        result["sendSeconds"] = sendSec;
+        result["sendPps"] = datagrams / sendSec;
+        result["sendBitsPerSec"] = datagrams * scenario.payloadBytes * 8 / sendSec;
+        //接收端
+        QJsonArray sinkResults;
+        qint64 received = 0;
+        qint64 lost = 0;
+        qint64 reordered = 0;
+        for(const auto &sink : sinks)
+        {
+            const UdpSink::Stats stats = sink->stats();
+            const double rxSec = (stats.lastNs - stats.firstNs) / 1e9;
+            QJsonObject object;
+            object["port"] = sink->port();
+            object["receiveBuffer"] = sink->receiveBuffer();
+            object["received"] = stats.packets;
+            object["bytes"] = stats.bytes;
+            object["lost"] = stats.lost;
+            object["reordered"] = stats.reordered;
+            object["duplicates"] = stats.duplicates;
+            object["rxPps"] = rxSec > 0 ? stats.packets / rxSec : 0.0;
+            object["jitterNs"] = stats.jitterNs;
+            object["interArrivalNs"] = stats.interArrival.toJson();
+            sinkResults.append(object);
+            received += stats.packets;
+            lost += stats.lost;
+            reordered += stats.reordered;
+        }
+        result["sinks"] = sinkResults;
+        result["received"] = received;
+        result["lost"] = lost;
+        result["lossRate"] = datagrams > 0 ? static_cast<double>(lost) / datagrams : 0.0;
+        result["reordered"] = reordered;
+        out << QString("%1 %2 发送 %3 pps  %4 Mbit/s  接收 %5/%6  丢包 %7 (%8%)  乱序 %9")
+               .arg(scenario.name, -28).arg(sendSec, 7, 'f', 3)
+               .arg(datagrams / sendSec, 10, 'f', 0)
+               .arg(datagrams * scenario.payloadBytes * 8 / sendSec / 1e6, 9, 'f', 1)
+               .arg(received).arg(datagrams).arg(lost)
+               .arg(datagrams > 0 ? 100.0 * lost / datagrams : 0.0, 0, 'f', 3).arg(reordered);
+        if(!error.isEmpty())
+        {
+            out << "  [" << error << "]";
+        }
+        out << "\n";
+        out.flush();
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+    QCommandLineParser parser;
+    parser.setApplicationDescription("DataProcessor 发送路径回环基准测试");
+    parser.addHelpOption();
+    const QCommandLineOption packetsOption({"n", "packets"}, "每个场景每个目标的包数（默认 200000）", "count", "200000");
+    const QCommandLineOption outputOption({"o", "output"}, "结果 JSON 文件（默认 udpsend_bench.json）", "file",
+                                          "udpsend_bench.json");
+    parser.addOptions({packetsOption, outputOption});
+    parser.process(app);
+    const int packets = qMax(1000, parser.value(packetsOption).toInt());
+    QTextStream out(stdout);
+
+    //文本回放场景的数据在临时目录中生成
+    QTemporaryDir dataDir;
+    QString error;
+    if(!dataDir.isValid() || !writeCapture(dataDir.filePath("capture.txt"), packets, 64, error))
+    {
+        out << "生成抓包文件失败: " << error << "\n";
+        return EXIT_FAILURE;
+    }
+    const QList<Scenario> scenarios =
+    {
+        {"文本回放 最快 1 目标 64B", "replay", 1, 64, packets, 0},
+        {"UdpSender 扇出 1 目标 64B", "udpsender", 1, 64, packets, 0},
+        {"UdpSender 扇出 4 目标 64B", "udpsender", 4, 64, packets, 0},
+        {"UdpSender 扇出 16 目标 64B", "udpsender", 16, 64, packets / 4, 0},
+        {"UdpSender 1 目标 8192B", "udpsender", 1, 8192, packets / 4, 0},
+        {"QUdpSocket 逐包 1 目标 64B", "qudpsocket", 1, 64, packets, 0},
+        {"QUdpSocket 逐包 4 目标 64B", "qudpsocket", 4, 64, packets, 0},
+        {"QUdpSocket 逐包 1 目标 8192B", "qudpsocket", 1, 8192, packets / 4, 0},
+        {"发生器 10us 定速 1 目标 64B", "generator", 1, 64, packets, 10000},
+        {"发生器 最快 1 目标 64B", "generator", 1, 64, packets, 0},
+        {"发生器 最快 4 目标 64B", "generator", 4, 64, packets, 0}
+    };
+    out << "每目标包数: " << packets << "（16 目标与 8192B 场景为 1/4）\n";
+    out.flush();
+    QJsonArray results;
+    for(const Scenario &scenario : scenarios)
+    {
+        results.append(runScenario(out, scenario, dataDir.path()));
+    }
+    QJsonObject root;
+    root["packetsPerDestination"] = packets;
+    root["scenarios"] = results;
+    QFile file(parser.value(outputOption));
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        out << "无法写入结果: " << file.fileName() << " (" << file.errorString() << ")\n";
+        return EXIT_FAILURE;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    out << "结果已写入 " << file.fileName() << "\n";
+    return EXIT_SUCCESS;
+}
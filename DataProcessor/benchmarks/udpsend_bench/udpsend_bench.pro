@@ -0,0 +1,25 @@
+QT       += core network concurrent
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG += utf8
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Werror=return-type
+
+TARGET = udpsend_bench
+TEMPLATE = app
+
+# 直接复用 DataProcessor 的回放引擎源码
+include(../../replay.pri)
+
+SOURCES += \
+    main.cpp \
+    udpsink.cpp \
+    ../../framepattern.cpp \
+    ../../framegenerator.cpp
+
+HEADERS += \
+    udpsink.h \
+    ../../framepattern.h \
+    ../../framegenerator.h
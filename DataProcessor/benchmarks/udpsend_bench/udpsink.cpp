@@ -0,0 +1,227 @@
+#include "udpsink.h"
+#include "replay/replayscheduler.h"
+#include <QtEndian>
+#include <QUdpSocket>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
+namespace
+{
+    ///单次 recvmmsg 的最大包数
+    const int RECV_BATCH = 64;
+    ///每包拷贝的字节数（只需序号所在的前 13 字节）
+    const int HEAD_BYTES = 16;
+    ///等待数据的轮询间隔（毫秒），决定 stop() 的响应时间
+    const int POLL_MS = 20;
+}
+
+UdpSink::UdpSink()
+{
+}
+
+UdpSink::~UdpSink()
+{
+    stop();
+#if defined(Q_OS_LINUX)
+    if(m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+#endif
+}
+
+bool UdpSink::open(int receiveBuffer, QString &error)
+{
+#if defined(Q_OS_LINUX)
+    m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if(m_fd < 0)
+    {
+        error = QString::fromLocal8Bit(std::strerror(errno));
+        return false;
+    }
+    const int on = 1;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    ::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    socklen_t optionLength = sizeof(m_receiveBuffer);
+    ::getsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &m_receiveBuffer, &optionLength);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if(::bind(m_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        error = QString::fromLocal8Bit(std::strerror(errno));
+        return false;
+    }
+    socklen_t addressLength = sizeof(address);
+    ::getsockname(m_fd, reinterpret_cast<sockaddr *>(&address), &addressLength);
+    m_port = ntohs(address.sin_port);
+#else
+    m_socket.reset(new QUdpSocket());
+    if(!m_socket->bind(QHostAddress::LocalHost, 0))
+    {
+        error = m_socket->errorString();
+        return false;
+    }
+    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, receiveBuffer);
+    m_receiveBuffer = m_socket->socketOption(QAbstractSocket::ReceiveBufferSizeSocketOption).toInt();
+    m_port = m_socket->localPort();
+    //套接字由接收线程使用
+    m_socket->moveToThread(this);
+#endif
+    return true;
+}
+
+void UdpSink::reset(qint64 expected)
+{
+    m_stats = Stats();
+    m_seen = QBitArray(static_cast<int>(expected));
+    m_expected = expected;
+    m_maxSeq = -1;
+    m_lastGapNs = -1;
+    m_jitterSumNs = 0.0;
+    m_jitterCount = 0;
+    m_received.store(0);
+}
+
+void UdpSink::stop()
+{
+    m_running.store(false);
+    wait();
+}
+
+UdpSink::Stats UdpSink::stats() const
+{
+    Stats stats = m_stats;
+    stats.lost = m_expected - (stats.packets - stats.duplicates);
+    stats.jitterNs = m_jitterCount > 0 ? m_jitterSumNs / static_cast<double>(m_jitterCount) : 0.0;
+    return stats;
+}
+
+void UdpSink::onPacket(const char *data, int copied, int length, qint64 arrivalNs)
+{
+    Stats &stats = m_stats;
+    if(stats.packets > 0)
+    {
+        const qint64 gapNs = arrivalNs - stats.lastNs;
+        stats.interArrival.record(gapNs);
+        if(m_lastGapNs >= 0)
+        {
+            m_jitterSumNs += static_cast<double>(qAbs(gapNs - m_lastGapNs));
+            m_jitterCount++;
+        }
+        m_lastGapNs = gapNs;
+    }
+    else
+    {
+        stats.firstNs = arrivalNs;
+    }
+    stats.lastNs = arrivalNs;
+    stats.packets++;
+    stats.bytes += length;
+    m_received.fetch_add(1, std::memory_order_relaxed);
+    if(copied < 13)
+    {
+        return;
+    }
+    const qint64 seq = static_cast<qint64>(qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(data + 5)));
+    if(seq < 0 || seq >= m_expected)
+    {
+        return;
+    }
+    if(m_seen.testBit(static_cast<int>(seq)))
+    {
+        stats.duplicates++;
+        return;
+    }
+    m_seen.setBit(static_cast<int>(seq));
+    if(seq < m_maxSeq)
+    {
+        stats.reordered++;
+    }
+    else
+    {
+        m_maxSeq = seq;
+    }
+}
+
+void UdpSink::run()
+{
+    m_running.store(true);
+#if defined(Q_OS_LINUX)
+    char heads[RECV_BATCH][HEAD_BYTES];
+    char controls[RECV_BATCH][CMSG_SPACE(sizeof(timespec))];
+    mmsghdr msgs[RECV_BATCH];
+    iovec iov[RECV_BATCH];
+    pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    while(m_running.load(std::memory_order_relaxed))
+    {
+        if(::poll(&pfd, 1, POLL_MS) <= 0)
+        {
+            continue;
+        }
+        std::memset(msgs, 0, sizeof(msgs));
+        for(int i = 0; i < RECV_BATCH; ++i)
+        {
+            iov[i].iov_base = heads[i];
+            iov[i].iov_len = HEAD_BYTES;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = controls[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+        }
+        //MSG_TRUNC：msg_len 返回数据包实际长度而非拷贝长度
+        const int n = ::recvmmsg(m_fd, msgs, RECV_BATCH, MSG_DONTWAIT | MSG_TRUNC, nullptr);
+        if(n <= 0)
+        {
+            continue;
+        }
+        const qint64 fallbackNs = ReplayScheduler::nowNs();
+        for(int i = 0; i < n; ++i)
+        {
+            qint64 arrivalNs = fallbackNs;
+            for(cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+            {
+                if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+                {
+                    timespec ts;
+                    std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                    arrivalNs = static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+                }
+            }
+            const int length = static_cast<int>(msgs[i].msg_len);
+            onPacket(heads[i], qMin(length, HEAD_BYTES), length, arrivalNs);
+        }
+    }
+#else
+    QByteArray buffer(65536, Qt::Uninitialized);
+    while(m_running.load(std::memory_order_relaxed))
+    {
+        if(!m_socket->waitForReadyRead(POLL_MS))
+        {
+            continue;
+        }
+        while(m_socket->hasPendingDatagrams())
+        {
+            const qint64 length = m_socket->readDatagram(buffer.data(), buffer.size());
+            if(length < 0)
+            {
+                break;
+            }
+            onPacket(buffer.constData(), static_cast<int>(length), static_cast<int>(length), ReplayScheduler::nowNs());
+        }
+    }
+#endif
+}
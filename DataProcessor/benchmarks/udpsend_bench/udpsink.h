@@ -0,0 +1,91 @@
+#ifndef UDPSINK_H
+#define UDPSINK_H
+
+#include <QThread>
+#include <QBitArray>
+#include <QScopedPointer>
+#include <atomic>
+#include "replay/latencyhistogram.h"
+
+class QUdpSocket;
+
+/**
+ * @brief 本机 UDP 接收端（基准测试用）
+ * 绑定 127.0.0.1 的随机端口，在独立线程中接收数据包并统计速率、丢包、乱序与到达间隔抖动。
+ * Linux 下通过 recvmmsg 批量接收，到达时刻取内核时间戳（SO_TIMESTAMPNS），
+ * 只拷贝每包前 16 字节（序号所在位置），长度按 MSG_TRUNC 取实际值；其他平台使用 QUdpSocket。
+ * 数据包第 5-12 字节为小端序号（0 起），由发送端写入（第 3-4 字节为主题号）。
+ * stats() 需在 stop() 之后调用。
+ */
+class UdpSink : public QThread
+{
+public:
+    ///接收统计
+    struct Stats
+    {
+        qint64 packets = 0;      ///< 收到的包数
+        qint64 bytes = 0;        ///< 收到的字节数
+        qint64 lost = 0;         ///< 未收到的序号数
+        qint64 reordered = 0;    ///< 序号小于此前最大序号的包数
+        qint64 duplicates = 0;   ///< 重复序号的包数
+        qint64 firstNs = 0;      ///< 首包到达时刻
+        qint64 lastNs = 0;       ///< 末包到达时刻
+        double jitterNs = 0.0;   ///< 相邻到达间隔之差的平均绝对值
+        LatencyHistogram interArrival; ///< 到达间隔分布（纳秒）
+    };
+
+    UdpSink();
+    ~UdpSink() override;
+
+    /**
+     * @brief 绑定 127.0.0.1 的随机端口
+     * @param receiveBuffer 期望的接收缓冲区大小（字节）
+     * @param error 输出参数，失败原因
+     */
+    bool open(int receiveBuffer, QString &error);
+
+    ///绑定的端口
+    quint16 port() const { return m_port; }
+
+    ///实际生效的接收缓冲区大小
+    int receiveBuffer() const { return m_receiveBuffer; }
+
+    ///开始新一轮统计（需在线程未运行时调用）
+    ///@param expected 本轮发送端将发出的序号数
+    void reset(qint64 expected);
+
+    ///已收到的包数（可在接收过程中调用）
+    qint64 received() const { return m_received.load(std::memory_order_relaxed); }
+
+    ///停止接收并等待线程退出
+    void stop();
+
+    ///本轮统计（丢包数在此时结算）
+    Stats stats() const;
+
+protected:
+    void run() override;
+
+private:
+    ///记录一个数据包
+    void onPacket(const char *data, int copied, int length, qint64 arrivalNs);
+
+    std::atomic<bool> m_running{false};
+    std::atomic<qint64> m_received{0};
+    quint16 m_port = 0;
+    int m_receiveBuffer = 0;
+#if defined(Q_OS_LINUX)
+    int m_fd = -1;
+#else
+    QScopedPointer<QUdpSocket> m_socket;
+#endif
+    Stats m_stats;
+    QBitArray m_seen;           ///< 已收到的序号
+    qint64 m_expected = 0;      ///< 本轮序号数
+    qint64 m_maxSeq = -1;       ///< 已收到的最大序号
+    qint64 m_lastGapNs = -1;    ///< 上一个到达间隔
+    double m_jitterSumNs = 0.0; ///< 到达间隔之差的绝对值之和
+    qint64 m_jitterCount = 0;   ///< 参与抖动统计的间隔对数
+};
+
+#endif //UDPSINK_H
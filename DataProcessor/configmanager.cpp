@@ -68,6 +68,20 @@ void ConfigManager::initDefaultConfig()
         {"dataDir", QDir::homePath()},
         {"order", "顺序"},
         {"sendInterval", 100},
+        {"pacingMode", "interval"},
+        {"speedFactor", 1.0},
+        {"rateLimits", QVariantMap()},
+        {"parseThreads", 0},
+        {"parseBufferMB", 256},
+        {"telemetryFile", ""},
+        {"loopCount", 1},
+        {"preloadMB", 1024},
+        {"recordDir", ""},
+        {"recordFormat", "text"},
+        {"recordInterface", ""},
+        {"startTime", ""},
+        {"checkpointFile", ""},
+        {"resumeCheckpoint", false},
         {"addresses", QStringList()},
         {"includeTopics", QStringList()},
         {"excludeTopics", QStringList()},
@@ -350,6 +364,26 @@ bool ConfigManager::migrateConfig()
     if (!m_config.contains("flowFastMultiplier")) ensureKeys["flowFastMultiplier"] = 0.01;
     if (!m_config.contains("flowNormalMultiplier")) ensureKeys["flowNormalMultiplier"] = 0.8;
     if (!m_config.contains("timeoutCheckedMultiplier")) ensureKeys["timeoutCheckedMultiplier"] = 1.5;
+    // 回放节奏键
+    if (!m_config.contains("pacingMode")) ensureKeys["pacingMode"] = "interval";
+    if (!m_config.contains("speedFactor")) ensureKeys["speedFactor"] = 1.0;
+    // 目标限速键
+    if (!m_config.contains("rateLimits")) ensureKeys["rateLimits"] = QVariantMap();
+    if (!m_config.contains("parseThreads")) ensureKeys["parseThreads"] = 0;
+    if (!m_config.contains("parseBufferMB")) ensureKeys["parseBufferMB"] = 256;
+    // 回放统计导出路径
+    if (!m_config.contains("telemetryFile")) ensureKeys["telemetryFile"] = "";
+    // 循环回放键
+    if (!m_config.contains("loopCount")) ensureKeys["loopCount"] = 1;
+    if (!m_config.contains("preloadMB")) ensureKeys["preloadMB"] = 1024;
+    // 录制键
+    if (!m_config.contains("recordDir")) ensureKeys["recordDir"] = "";
+    if (!m_config.contains("recordFormat")) ensureKeys["recordFormat"] = "text";
+    if (!m_config.contains("recordInterface")) ensureKeys["recordInterface"] = "";
+    // 起始位置与断点续播键
+    if (!m_config.contains("startTime")) ensureKeys["startTime"] = "";
+    if (!m_config.contains("checkpointFile")) ensureKeys["checkpointFile"] = "";
+    if (!m_config.contains("resumeCheckpoint")) ensureKeys["resumeCheckpoint"] = false;
     if (!ensureKeys.isEmpty())
     {
         updateConfig(ensureKeys);
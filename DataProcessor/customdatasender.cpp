@@ -1,5 +1,6 @@
 #include "customdatasender.h"
 #include <QRegExp> //用于正则表达式处理
+#include <QHostAddress> //用于验证目标地址
 
 //构造函数，初始化成员变量并连接信号槽
 CustomDataSender::CustomDataSender(QTextEdit *textEdit,
@@ -20,15 +21,24 @@ CustomDataSender::CustomDataSender(QTextEdit *textEdit,
       m_pauseBtn(pauseBtn),      //暂停按钮
       m_stopBtn(stopBtn),        //停止按钮
       m_logView(logView),        //日志显示框
-      m_udpSocket(nullptr),      //初始化为空
-      m_timer(new QTimer(this)), //初始化定时器
-      m_currentFrameIndex(0)     //当前帧索引初始化为0
+      m_generator(new FrameGenerator(this)), //帧发生器
+      m_statsTimer(new QTimer(this)), //统计定时器
+      m_lastSent(0)              //已发送帧数初始化为0
 {
     //连接按钮点击事件到槽函数
     connect(m_startBtn, &QPushButton::clicked, this, &CustomDataSender::onStartClicked);
     connect(m_pauseBtn, &QPushButton::clicked, this, &CustomDataSender::onPauseClicked);
     connect(m_stopBtn, &QPushButton::clicked, this, &CustomDataSender::onStopClicked);
-    connect(m_timer, &QTimer::timeout, this, &CustomDataSender::sendNextFrame); //定时器超时触发发送
+    connect(m_statsTimer, &QTimer::timeout, this, &CustomDataSender::logStatistics); //每秒输出发送统计
+    connect(m_generator, &FrameGenerator::completed, this, &CustomDataSender::onGeneratorCompleted);
+    //发送器只转发警告与错误，不再逐帧记录日志
+    connect(m_generator, &FrameGenerator::logMessage, this, [this](const QString &level, const QString &msg)
+    {
+        if (level == "WARN" || level == "ERROR")
+        {
+            appendLog(msg, level == "ERROR");
+        }
+    });
     //初始化按钮状态
     m_pauseBtn->setEnabled(false); //暂停按钮默认禁用
     m_stopBtn->setEnabled(false);  //停止按钮默认禁用
@@ -39,71 +49,90 @@ CustomDataSender::CustomDataSender(QTextEdit *textEdit,
 //析构函数，清理资源
 CustomDataSender::~CustomDataSender()
 {
-    if (m_udpSocket)
-    {
-        m_udpSocket->close(); //关闭UDP Socket
-        m_udpSocket->deleteLater(); //延迟删除对象
-    }
+    m_generator->stop(); //停止发生器线程
 }
 
 //开始按钮点击事件
 void CustomDataSender::onStartClicked()
 {
     appendLog("尝试启动发送任务");
-    //解析地址和端口
-    QString addrPort = m_addrEdit->text().trimmed(); //获取地址和端口输入
-    QStringList parts = addrPort.split(':'); //按冒号分割
-    if (parts.size() != 2)
+    //解析地址和端口，多个目标以逗号、分号或空白分隔，依次向每个目标发送整组帧
+    const QStringList addrList = m_addrEdit->text().split(QRegExp("[,;\\s]+"), QString::SkipEmptyParts);
+    if (addrList.isEmpty())
     {
         appendLog("地址格式错误，应为IP:Port格式", true);
         QMessageBox::critical(nullptr, "错误", "地址格式应为IP:Port");
         return;
     }
-    //验证IP地址有效性
-    QHostAddress ipCheck(parts[0]);
-    if (ipCheck.protocol() == QAbstractSocket::UnknownNetworkLayerProtocol)
-    {
-        appendLog("无效的IP地址格式", true);
-        QMessageBox::critical(nullptr, "错误", "无效的IP地址");
-        return;
-    }
-    //验证组播地址范围（224.0.0.0 - 239.255.255.255）
-    bool isMulticast = ipCheck.isMulticast();
-    if (isMulticast)
+    for (const QString &addrPort : addrList)
     {
-        appendLog(QString("检测到组播地址: %1").arg(parts[0]));
+        QStringList parts = addrPort.split(':'); //按冒号分割
+        if (parts.size() != 2)
+        {
+            appendLog("地址格式错误，应为IP:Port格式", true);
+            QMessageBox::critical(nullptr, "错误", "地址格式应为IP:Port");
+            return;
+        }
+        //验证IP地址有效性
+        QHostAddress ipCheck(parts[0]);
+        if (ipCheck.protocol() == QAbstractSocket::UnknownNetworkLayerProtocol)
+        {
+            appendLog("无效的IP地址格式", true);
+            QMessageBox::critical(nullptr, "错误", "无效的IP地址");
+            return;
+        }
+        //验证组播地址范围（224.0.0.0 - 239.255.255.255）
+        if (ipCheck.isMulticast())
+        {
+            appendLog(QString("检测到组播地址: %1").arg(parts[0]));
+        }
+        //验证端口号有效性
+        bool ok;
+        int port = parts[1].toInt(&ok);
+        if (!ok || port < 1 || port > 65535)
+        {
+            QMessageBox::critical(nullptr, "错误", "无效的端口号");
+            return;
+        }
+        appendLog(QString("解析目标地址：%1:%2").arg(parts[0]).arg(port));
     }
-    //验证端口号有效性
-    bool ok;
-    int port = parts[1].toInt(&ok);
-    if (!ok || port < 1 || port > 65535)
+    //解析发送间隔
+    qint64 intervalNs = 0;
+    if (!parseInterval(m_intervalEdit->text(), intervalNs))
     {
-        QMessageBox::critical(nullptr, "错误", "无效的端口号");
+        appendLog("发送间隔格式错误", true);
+        QMessageBox::critical(nullptr, "错误", "发送间隔应为毫秒数（可带小数），或以 us 结尾的微秒数");
         return;
     }
-    appendLog(QString("解析目标地址：%1:%2").arg(parts[0]).arg(port));
-    //解析数据帧
-    m_frames = parseFrames();
-    if (m_frames.isEmpty())
+    //编译数据帧模板
+    FrameGenerator::Config config;
+    config.frames = parseFrames();
+    if (config.frames.isEmpty())
     {
         appendLog("未检测到有效数据帧", true);
         QMessageBox::critical(nullptr, "错误", "未检测到有效数据帧");
         return;
     }
-    appendLog(QString("成功解析 %1 个数据帧").arg(m_frames.size()));
-    //初始化目标IP和端口
-    m_currentIp = parts[0];
-    m_currentPort = port;
-    m_currentFrameIndex = 0;
-    appendLog("正在初始化UDP连接...");
-    //初始化UDP Socket
-    if (m_udpSocket)
+    appendLog(QString("成功解析 %1 个数据帧").arg(config.frames.size()));
+    config.targets = addrList;
+    config.intervalNs = intervalNs;
+    config.loop = m_loopCheck->isChecked();
+    //组播参数与原逐帧设置的取值相同：TTL 为 1，关闭回环
+    config.multicastTtl = 1;
+    config.multicastLoopback = false;
+    QString error;
+    if (!m_generator->configure(config, error))
     {
-        m_udpSocket->deleteLater();
+        appendLog(error, true);
+        QMessageBox::critical(nullptr, "错误", error);
+        return;
     }
-    m_udpSocket = new QUdpSocket(this);
-    //启动定时器
-    m_timer->start(m_intervalEdit->text().toInt());
+    m_generator->start(QThread::TimeCriticalPriority);
+    m_lastSent = 0;
+    m_statsClock.start();
+    m_statsTimer->start(1000);
+    appendLog(QString("开始发送：%1 个目标，间隔 %2").arg(addrList.size())
+              .arg(intervalNs > 0 ? QString("%1 ms").arg(intervalNs / 1e6, 0, 'g', 9) : QString("0（尽可能快）")));
     //更新按钮状态
     m_startBtn->setEnabled(false);
     m_pauseBtn->setEnabled(true);
@@ -113,14 +142,18 @@ void CustomDataSender::onStartClicked()
 //暂停按钮点击事件
 void CustomDataSender::onPauseClicked()
 {
-    if (m_timer->isActive())
+    if (!m_generator->isPaused())
     {
-        m_timer->stop(); //停止定时器
+        m_generator->pause(true); //暂停生成与发送
+        m_statsTimer->stop();
         m_pauseBtn->setText("继续(P)");
     }
     else
     {
-        m_timer->start(m_intervalEdit->text().toInt()); //启动定时器
+        m_generator->pause(false); //恢复，之后的发送时刻整体顺延
+        m_lastSent = m_generator->sentCount();
+        m_statsClock.restart();
+        m_statsTimer->start(1000);
         m_pauseBtn->setText("暂停(P)");
     }
 }
@@ -129,114 +162,88 @@ void CustomDataSender::onPauseClicked()
 void CustomDataSender::onStopClicked()
 {
     appendLog("用户手动停止发送");
-    m_timer->stop(); //停止定时器
-    if (m_udpSocket)
-    {
-        m_udpSocket->close(); //关闭UDP Socket
-        m_udpSocket->deleteLater(); //延迟删除对象
-        m_udpSocket = nullptr;
-    }
+    m_generator->stop(); //停止发生器，丢弃未发出的帧
+    m_statsTimer->stop();
+    appendLog(QString("共发送 %1 帧，失败 %2 帧").arg(m_generator->sentCount()).arg(m_generator->failedCount()),
+              m_generator->failedCount() > 0);
     //重置状态
-    m_currentFrameIndex = 0;
     m_startBtn->setEnabled(true);
     m_pauseBtn->setEnabled(false);
     m_stopBtn->setEnabled(false);
     m_pauseBtn->setText("暂停(P)");
 }
 
-//发送下一帧数据
-void CustomDataSender::sendNextFrame()
+//非循环发送全部完成
+void CustomDataSender::onGeneratorCompleted()
 {
-    if (m_currentFrameIndex >= m_frames.size())
+    //完成通知可能晚于用户手动停止到达
+    if (!m_stopBtn->isEnabled())
     {
-        if (m_loopCheck->isChecked())
-        {
-            appendLog("达到帧列表末尾，循环发送");
-            m_currentFrameIndex = 0; //重置帧索引
-        }
-        else
-        {
-            appendLog("发送完成，自动停止");
-            onStopClicked(); //停止发送
-            return;
-        }
-    }
-    if (m_udpSocket)
-    {
-        QHostAddress targetAddr(m_currentIp); //目标地址
-        bool isMulticast = targetAddr.isMulticast(); //判断是否为组播地址
-        //设置组播参数
-        if (isMulticast)
-        {
-            //设置TTL（范围1-255）
-            m_udpSocket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
-            //禁用回环（0=关闭，1=开启）
-            m_udpSocket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 0);
-        }
-        QByteArray frame = m_frames[m_currentFrameIndex]; //获取当前帧数据
-        const QString topic = QString("%1%2")
-                              .arg(QString::fromLatin1(frame.mid(4, 1).toHex().toUpper()))
-                              .arg(QString::fromLatin1(frame.mid(3, 1).toHex().toUpper())); //解析主题号
-        qint64 bytesSent = m_udpSocket->writeDatagram(frame, targetAddr, m_currentPort); //发送数据
-        //构造日志信息
-        QString logPrefix = isMulticast ? "[组播]" : "[单播]";
-        if (bytesSent == -1)
-        {
-            appendLog(QString("%1 发送失败, 主题号[%2]: %3")
-                      .arg(logPrefix)
-                      .arg(topic)
-                      .arg(m_udpSocket->errorString()), true);
-        }
-        else
-        {
-            appendLog(QString("%1 发送成功, 主题号[%2], 帧长[%3], 目标[%4:%5]")
-                      .arg(logPrefix)
-                      .arg(topic)
-                      .arg(bytesSent)
-                      .arg(m_currentIp)
-                      .arg(m_currentPort));
-        }
-        m_currentFrameIndex++; //更新帧索引
+        return;
     }
+    appendLog("发送完成，自动停止");
+    onStopClicked();
+}
+
+//每秒输出一次发送帧数与速率
+void CustomDataSender::logStatistics()
+{
+    const qint64 sent = m_generator->sentCount();
+    const double seconds = m_statsClock.restart() / 1000.0;
+    const qint64 failed = m_generator->failedCount();
+    appendLog(QString("已发送 %1 帧，速率 %2 帧/秒，失败 %3 帧")
+              .arg(sent)
+              .arg(seconds > 0 ? (sent - m_lastSent) / seconds : 0.0, 0, 'f', 0)
+              .arg(failed), failed > 0);
+    m_lastSent = sent;
 }
 
-//解析输入的十六进制数据帧
-QList<QByteArray> CustomDataSender::parseFrames() const
+//编译输入的帧模板
+QVector<FramePattern> CustomDataSender::parseFrames()
 {
-    QList<QByteArray> frames;
-    const QStringList lines = m_textEdit->toPlainText().split('\n', QString::SkipEmptyParts); //按行分割
-    for (const QString &line : lines)
+    QVector<FramePattern> frames;
+    const QStringList lines = m_textEdit->toPlainText().split('\n');
+    for (int i = 0; i < lines.size(); ++i)
     {
-        QByteArray frame = hexStringToByteArray(line.trimmed()); //转换为字节数组
-        if (!frame.isEmpty())
+        const QString line = lines[i].trimmed();
+        if (line.isEmpty())
         {
-            frames.append(frame); //添加到帧列表
+            continue;
         }
+        FramePattern frame;
+        QString error;
+        if (!frame.compile(line, error))
+        {
+            appendLog(QString("第 %1 行已跳过：%2").arg(i + 1).arg(error), true);
+            continue;
+        }
+        frames.append(frame);
     }
     return frames;
 }
 
-//将十六进制字符串转换为字节数组
-QByteArray CustomDataSender::hexStringToByteArray(const QString &hexStr) const
+//解析发送间隔：默认单位毫秒，可带小数；以 us 结尾时单位为微秒；0 表示尽可能快
+bool CustomDataSender::parseInterval(const QString &text, qint64 &intervalNs)
 {
-    QString cleanStr = hexStr;
-    cleanStr.remove(QRegExp("[^0-9a-fA-F]"));  //移除非十六进制字符
-    if (cleanStr.length() % 2 != 0)
+    QString value = text.trimmed().toLower();
+    double unitNs = 1000000.0;
+    if (value.endsWith("us"))
     {
-        return QByteArray(); //如果长度不是偶数，返回空
+        unitNs = 1000.0;
+        value.chop(2);
     }
-    QByteArray byteArray;
-    bool conversionOK = true;
-    for (int i = 0; i < cleanStr.length(); i += 2)
+    else if (value.endsWith("ms"))
     {
-        const QString byteStr = cleanStr.mid(i, 2); //每两个字符为一字节
-        byteArray.append(static_cast<char>(byteStr.toInt(&conversionOK, 16))); //转换为字节
-        if (!conversionOK)
-        {
-            return QByteArray(); //转换失败返回空
-        }
+        value.chop(2);
+    }
+    bool ok = false;
+    const double interval = value.trimmed().toDouble(&ok);
+    if (!ok || interval < 0)
+    {
+        return false;
     }
-    return byteArray;
+    intervalNs = static_cast<qint64>(interval * unitNs + 0.5);
+    return true;
 }
 
 //添加日志到日志显示框
@@ -5,14 +5,15 @@
 #define CUSTOMDATASENDER_H
 
 #include <QObject>
-#include <QUdpSocket>  //用于UDP通信
-#include <QTimer>      //用于定时发送
+#include <QTimer>      //用于定时输出发送统计
+#include <QElapsedTimer> //用于计算发送速率
 #include <QTextEdit>   //用于显示日志和输入数据
 #include <QLineEdit>   //用于输入地址和间隔时间
 #include <QCheckBox>   //用于选择是否循环发送
 #include <QPushButton> //用于控制按钮
 #include <QMessageBox> //用于显示错误提示
 #include <QDateTime>   //用于生成日志时间戳
+#include "framegenerator.h" //帧发生器（独立线程生成并发送）
 
 class CustomDataSender : public QObject
 {
@@ -34,11 +35,12 @@ private slots:
     void onStartClicked();  //开始按钮点击事件
     void onPauseClicked();  //暂停按钮点击事件
     void onStopClicked();   //停止按钮点击事件
-    void sendNextFrame();   //定时器触发，发送下一帧数据
+    void onGeneratorCompleted(); //非循环发送全部完成
+    void logStatistics();   //定时输出发送帧数与速率
 
 private:
-    QList<QByteArray> parseFrames() const; //解析输入的十六进制数据帧
-    QByteArray hexStringToByteArray(const QString &hexStr) const; //将十六进制字符串转换为字节数组
+    QVector<FramePattern> parseFrames(); //编译输入的帧模板，无法编译的行记录日志后跳过
+    static bool parseInterval(const QString &text, qint64 &intervalNs); //解析发送间隔（毫秒，可带小数或 us 后缀）
     void appendLog(const QString &message, bool isError = false); //添加日志到日志显示框
 
     //UI控件
@@ -51,13 +53,11 @@ private:
     QPushButton *m_stopBtn;    //停止按钮
     QTextEdit *m_logView;      //日志显示框
 
-    //UDP与定时器
-    QUdpSocket *m_udpSocket;      //UDP Socket，用于发送数据
-    QTimer *m_timer;              //定时器，控制发送间隔
-    QList<QByteArray> m_frames;   //存储解析后的数据帧
-    int m_currentFrameIndex;      //当前发送的数据帧索引
-    QString m_currentIp;          //当前目标IP地址
-    int m_currentPort;            //当前目标端口
+    //发生器与统计
+    FrameGenerator *m_generator;  //帧发生器，在独立线程中生成并发送
+    QTimer *m_statsTimer;         //统计定时器，每秒输出一次发送速率
+    QElapsedTimer m_statsClock;   //距上次统计的时长
+    qint64 m_lastSent;            //上次统计时的已发送帧数
 };
 
 #endif //CUSTOMDATASENDER_H
@@ -0,0 +1,186 @@
+#include "framegenerator.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+#include "udpsender.h"
+
+FrameGenerator::FrameGenerator(QObject *parent)
+    : QThread(parent)
+{
+}
+
+FrameGenerator::~FrameGenerator()
+{
+    stop();
+}
+
+bool FrameGenerator::configure(const Config &config, QString &error)
+{
+    if(isRunning())
+    {
+        error = "发生器正在运行";
+        return false;
+    }
+    if(config.frames.isEmpty() || config.targets.isEmpty())
+    {
+        error = "没有可发送的帧或目标";
+        return false;
+    }
+    m_config = config;
+    m_sender.reset(new UdpSender());
+    connect(m_sender.data(), &UdpSender::logMessage, this, &FrameGenerator::logMessage);
+    m_destinations.clear();
+    for(const QString &target : config.targets)
+    {
+        const int destination = m_sender->addDestination(target);
+        if(destination < 0)
+        {
+            error = "无效的目标地址：" + target;
+            m_sender.reset();
+            return false;
+        }
+        m_destinations.append(destination);
+    }
+    //组播参数只在发送套接字上设置一次
+    m_sender->setMulticastOptions(config.multicastTtl, config.multicastLoopback);
+    m_scheduler.configureInterval(config.intervalNs);
+    m_sender->setScheduler(&m_scheduler);
+    m_generated.store(0);
+    m_paused.store(false);
+    m_running.store(true);
+    return true;
+}
+
+void FrameGenerator::pause(bool paused)
+{
+    if(!m_sender || m_paused.load() == paused)
+    {
+        return;
+    }
+    //先暂停调度再通知发送线程，恢复时顺序相反，保证两侧看到相同的暂停偏移
+    if(paused)
+    {
+        m_scheduler.pause();
+        m_sender->pause(true);
+    }
+    else
+    {
+        m_scheduler.resume();
+        m_sender->pause(false);
+    }
+    QMutexLocker locker(&m_pauseMutex);
+    m_paused.store(paused);
+    m_pauseCondition.wakeAll();
+}
+
+void FrameGenerator::stop()
+{
+    {
+        QMutexLocker locker(&m_pauseMutex);
+        m_running.store(false);
+        m_pauseCondition.wakeAll();
+    }
+    if(m_sender)
+    {
+        //唤醒可能因队列满而阻塞在 reserve() 中的生成线程
+        m_sender->stop();
+    }
+    wait();
+    if(m_sender)
+    {
+        m_sender->waitForStop();
+    }
+    m_scheduler.finish();
+}
+
+qint64 FrameGenerator::sentCount() const
+{
+    return m_sender ? m_sender->sentCount() : 0;
+}
+
+qint64 FrameGenerator::failedCount() const
+{
+    return m_sender ? m_sender->failedCount() : 0;
+}
+
+void FrameGenerator::waitWhilePaused()
+{
+    QMutexLocker locker(&m_pauseMutex);
+    while(m_paused.load() && m_running.load())
+    {
+        m_pauseCondition.wait(&m_pauseMutex);
+    }
+}
+
+void FrameGenerator::run()
+{
+    const QVector<FramePattern> &frames = m_config.frames;
+    const int frameCount = frames.size();
+    const int targetCount = m_destinations.size();
+    //每个模板的已生成帧数，以及每个模板发往每个目标的帧数（按目标计数的计数器使用）
+    QVector<quint64> sequences(frameCount, 0);
+    QVector<quint64> targetSequences(frameCount * targetCount, 0);
+    FramePattern::Context context;
+    context.random = QRandomGenerator::global()->generate64() | 1;
+    const auto interrupted = [this]()
+    {
+        return !m_running.load(std::memory_order_relaxed) || m_paused.load(std::memory_order_relaxed);
+    };
+    m_scheduler.start();
+    //单调时钟换算为 Unix 时间的偏移，帧内时间戳由调度时刻换算
+    const qint64 epochOffsetNs = QDateTime::currentMSecsSinceEpoch() * 1000000LL - ReplayScheduler::nowNs();
+    //每个目标依次收到整组帧，非循环时共发送 帧数 × 目标数
+    const qint64 total = !m_config.loop ? static_cast<qint64>(frameCount) * targetCount
+                                        : (m_config.count > 0 ? m_config.count : -1);
+    int frameIndex = 0;
+    int target = 0;
+    qint64 generated = 0;
+    while(m_running.load(std::memory_order_relaxed) && (total < 0 || generated < total))
+    {
+        if(m_paused.load(std::memory_order_relaxed))
+        {
+            waitWhilePaused();
+            continue;
+        }
+        const qint64 dueNs = m_scheduler.schedule(QLatin1String());
+        if(dueNs != ReplayScheduler::AsFastAsPossible)
+        {
+            //至多领先 LEAD_NS 生成；暂停时等待恢复后继续等待同一时刻
+            while(!m_scheduler.waitUntil(dueNs - LEAD_NS, interrupted, false) && m_running.load())
+            {
+                waitWhilePaused();
+            }
+            if(!m_running.load())
+            {
+                break;
+            }
+        }
+        const FramePattern &frame = frames.at(frameIndex);
+        char *buffer = m_sender->reserve(frame.length(), 1);
+        if(!buffer)
+        {
+            break;
+        }
+        context.sequence = sequences[frameIndex]++;
+        context.targetSequence = targetSequences[frameIndex * targetCount + target]++;
+        context.epochNs = epochOffsetNs + (dueNs == ReplayScheduler::AsFastAsPossible
+                                           ? ReplayScheduler::nowNs() : m_scheduler.toWallNs(dueNs));
+        frame.render(buffer, context);
+        m_sender->publish(frame.length(), &m_destinations[target], 1, dueNs, frame.topic());
+        ++generated;
+        m_generated.store(generated, std::memory_order_relaxed);
+        //整组帧发完后换到下一个目标
+        if(++frameIndex == frameCount)
+        {
+            frameIndex = 0;
+            if(++target == targetCount)
+            {
+                target = 0;
+            }
+        }
+    }
+    if(m_running.load() && total >= 0 && generated == total)
+    {
+        m_sender->flush();
+        emit completed();
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef FRAMEGENERATOR_H
+#define FRAMEGENERATOR_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "framepattern.h"
+#include "replay/replayscheduler.h"
+
+class UdpSender;
+
+/**
+ * @brief 自定义数据帧发生器
+ * 在独立线程中按固定间隔逐帧生成：依次取帧模板，写入计数器、时间戳、随机数据与校验和，
+ * 直接生成到 UdpSender 的发送队列中；多个目标时依次向每个目标发送整组帧模板。
+ * 节奏由 ReplayScheduler 给出纳秒精度的调度时刻，发送线程在该时刻（末段自旋）发出；
+ * 发生器至多领先调度时刻 LEAD_NS 生成，帧内时间戳取调度时刻，计数器与实际发送顺序一致。
+ * 间隔为 0 时尽可能快地生成，由发送队列的背压限速。
+ */
+class FrameGenerator : public QThread
+{
+    Q_OBJECT
+public:
+    ///发生器参数
+    struct Config
+    {
+        QVector<FramePattern> frames;   ///< 帧模板，按顺序循环
+        QStringList targets;            ///< 目标地址（IP:Port），多个时依次发送整组帧
+        qint64 intervalNs = 0;          ///< 帧间隔（纳秒），0 表示尽可能快
+        bool loop = false;              ///< 循环发送；否则每个模板向每个目标发送一次后结束
+        qint64 count = 0;               ///< 循环发送的总帧数，0 表示直到停止
+        int multicastTtl = 1;           ///< 组播 TTL
+        bool multicastLoopback = false; ///< 组播是否回环到本机
+    };
+
+    explicit FrameGenerator(QObject *parent = nullptr);
+    ~FrameGenerator() override;
+
+    /**
+     * @brief 配置发生器并创建发送器（需在线程未运行时调用，之后调用 start() 开始生成）
+     * @param config 发生器参数
+     * @param error 失败原因（无帧模板或目标地址无效）
+     */
+    bool configure(const Config &config, QString &error);
+
+    /**
+     * @brief 暂停或恢复，暂停期间的时长顺延到之后的调度时刻
+     * @param paused true-暂停，false-恢复
+     */
+    void pause(bool paused);
+
+    ///是否已暂停
+    bool isPaused() const { return m_paused.load(); }
+
+    ///停止生成，丢弃尚未发出的帧，并等待线程退出
+    void stop();
+
+    ///已生成的帧数
+    qint64 generatedCount() const { return m_generated.load(std::memory_order_relaxed); }
+
+    ///发送成功的帧数
+    qint64 sentCount() const;
+
+    ///发送失败的帧数
+    qint64 failedCount() const;
+
+signals:
+    ///全部帧已交给系统（非循环，或循环发送达到总帧数）
+    void completed();
+
+    /**
+     * @brief 发送器日志
+     * @param level 日志级别（DEBUG/WARN/ERROR）
+     * @param msg 日志消息
+     */
+    void logMessage(const QString &level, const QString &msg);
+
+protected:
+    void run() override;
+
+private:
+    ///暂停期间阻塞，恢复或停止后返回
+    void waitWhilePaused();
+
+    ///发生器领先调度时刻的最大时长
+    static const qint64 LEAD_NS = 2000000;
+
+    Config m_config;                        ///< 当前参数
+    QVector<int> m_destinations;            ///< 各目标在发送器中的索引
+    QScopedPointer<UdpSender> m_sender;     ///< 发送器（每次配置重新创建）
+    ReplayScheduler m_scheduler;            ///< 调度器，与发送线程共享
+    QMutex m_pauseMutex;                    ///< 暂停等待互斥锁
+    QWaitCondition m_pauseCondition;        ///< 恢复或停止时唤醒
+    std::atomic<bool> m_running{false};     ///< 是否运行中
+    std::atomic<bool> m_paused{false};      ///< 是否暂停
+    std::atomic<qint64> m_generated{0};     ///< 已生成帧数
+};
+
+#endif //FRAMEGENERATOR_H
@@ -0,0 +1,271 @@
+#include "framepattern.h"
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    ///UDP 单包最大载荷
+    const int MAX_FRAME_BYTES = 65507;
+
+    inline bool isHexDigit(QChar c)
+    {
+        return (c >= QLatin1Char('0') && c <= QLatin1Char('9'))
+               || (c >= QLatin1Char('a') && c <= QLatin1Char('f'))
+               || (c >= QLatin1Char('A') && c <= QLatin1Char('F'));
+    }
+
+    ///按宽度与字节序写入整数（超出宽度的高位截断）
+    inline void writeInteger(uchar *p, int width, bool bigEndian, quint64 value)
+    {
+        for(int i = 0; i < width; ++i)
+        {
+            p[bigEndian ? width - 1 - i : i] = static_cast<uchar>(value >> (8 * i));
+        }
+    }
+
+    ///xorshift64*
+    inline quint64 nextRandom(quint64 &state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+}
+
+bool FramePattern::compile(const QString &line, QString &error)
+{
+    m_bytes.clear();
+    m_fields.clear();
+    m_topic = 0;
+    QVector<Field> checksums;
+    QByteArray hex;
+    //将累积的十六进制字符转为字节；字段两侧的十六进制须各自成对
+    const auto flushHex = [&]()
+    {
+        if(hex.size() % 2 != 0)
+        {
+            error = QString("十六进制字符数为奇数（第 %1 字节附近）").arg(m_bytes.size() + hex.size() / 2);
+            return false;
+        }
+        m_bytes += QByteArray::fromHex(hex);
+        hex.clear();
+        return true;
+    };
+    for(int i = 0; i < line.size(); ++i)
+    {
+        const QChar c = line.at(i);
+        if(c == QLatin1Char('{'))
+        {
+            const int close = line.indexOf(QLatin1Char('}'), i + 1);
+            if(close < 0)
+            {
+                error = QString("字段缺少 }：%1").arg(line.mid(i));
+                return false;
+            }
+            if(!flushHex())
+            {
+                return false;
+            }
+            Field field;
+            if(!parseField(line.mid(i + 1, close - i - 1), field, error))
+            {
+                return false;
+            }
+            field.offset = m_bytes.size();
+            m_bytes.append(field.width, '\0');
+            (field.type == FieldType::Checksum ? checksums : m_fields).append(field);
+            i = close;
+        }
+        else if(isHexDigit(c))
+        {
+            hex.append(static_cast<char>(c.unicode()));
+        }
+        //其余字符视为分隔符
+    }
+    if(!flushHex())
+    {
+        return false;
+    }
+    if(m_bytes.isEmpty())
+    {
+        error = "空帧";
+        return false;
+    }
+    if(m_bytes.size() > MAX_FRAME_BYTES)
+    {
+        error = QString("帧长 %1 字节，超过 UDP 最大载荷 %2 字节").arg(m_bytes.size()).arg(MAX_FRAME_BYTES);
+        return false;
+    }
+    //校验字段按偏移依次计算，范围内靠前的校验字段先于后者写入
+    std::sort(checksums.begin(), checksums.end(), [](const Field &a, const Field &b) { return a.offset < b.offset; });
+    const uchar *data = reinterpret_cast<const uchar *>(m_bytes.constData());
+    for(int c = 0; c < checksums.size(); ++c)
+    {
+        Field &checksum = checksums[c];
+        if(checksum.from < 0 || checksum.from > checksum.offset)
+        {
+            error = QString("校验字段（偏移 %1）的起始偏移 %2 无效").arg(checksum.offset).arg(checksum.from);
+            return false;
+        }
+        //字段位置为 0，固定字节的和（异或）即整段的和
+        checksum.base = 0;
+        for(int i = checksum.from; i < checksum.offset; ++i)
+        {
+            checksum.base = checksum.checksum == ChecksumType::Xor8 ? (checksum.base ^ data[i]) : (checksum.base + data[i]);
+        }
+        //范围内的可变字节：取值字段与靠前的校验字段
+        const auto addSpan = [&checksum](const Field &field)
+        {
+            const int begin = qMax(field.offset, checksum.from);
+            const int end = qMin(field.offset + field.width, checksum.offset);
+            if(begin < end)
+            {
+                checksum.spans << begin << end;
+            }
+        };
+        for(const Field &field : m_fields)
+        {
+            addSpan(field);
+        }
+        for(int k = 0; k < c; ++k)
+        {
+            addSpan(checksums[k]);
+        }
+    }
+    m_fields += checksums;
+    if(m_bytes.size() >= 5)
+    {
+        m_topic = static_cast<quint16>(data[3] | (data[4] << 8));
+    }
+    return true;
+}
+
+bool FramePattern::parseField(const QString &spec, Field &field, QString &error) const
+{
+    const QStringList tokens = spec.toLower().split(QLatin1Char(':'), QString::SkipEmptyParts);
+    const QString kind = tokens.value(0).trimmed();
+    if(kind == "cnt" || kind == "counter")
+    {
+        field.type = FieldType::Counter;
+        field.width = 4;
+    }
+    else if(kind == "ts" || kind == "time")
+    {
+        field.type = FieldType::Timestamp;
+        field.width = 8;
+    }
+    else if(kind == "rand")
+    {
+        field.type = FieldType::Random;
+        field.width = 4;
+    }
+    else if(kind == "sum" || kind == "sum8" || kind == "xor")
+    {
+        field.type = FieldType::Checksum;
+        field.checksum = kind == "sum" ? ChecksumType::Sum16 : kind == "sum8" ? ChecksumType::Sum8 : ChecksumType::Xor8;
+        field.width = field.checksum == ChecksumType::Sum16 ? 2 : 1;
+    }
+    else
+    {
+        error = QString("未知字段 {%1}").arg(spec);
+        return false;
+    }
+    const bool integer = field.type == FieldType::Counter || field.type == FieldType::Timestamp;
+    for(int i = 1; i < tokens.size(); ++i)
+    {
+        const QString token = tokens.at(i).trimmed();
+        const int eq = token.indexOf(QLatin1Char('='));
+        bool ok = true;
+        if(eq > 0)
+        {
+            const QString key = token.left(eq);
+            const qint64 value = token.mid(eq + 1).toLongLong(&ok, 0);
+            if(key == "start" && field.type == FieldType::Counter)
+            {
+                field.start = static_cast<quint64>(value);
+            }
+            else if(key == "step" && field.type == FieldType::Counter)
+            {
+                field.step = static_cast<quint64>(value);
+            }
+            else if(key == "from" && field.type == FieldType::Checksum)
+            {
+                field.from = static_cast<int>(value);
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        else if(!token.isEmpty() && token.at(0).isDigit() && field.type != FieldType::Checksum)
+        {
+            field.width = token.toInt(&ok);
+            ok = ok && field.width >= 1 && field.width <= (integer ? 8 : MAX_FRAME_BYTES);
+        }
+        else if((token == "le" || token == "be") && field.type != FieldType::Random)
+        {
+            field.bigEndian = token == "be";
+        }
+        else if(token == "tgt" && field.type == FieldType::Counter)
+        {
+            field.perTarget = true;
+        }
+        else if(field.type == FieldType::Timestamp && (token == "s" || token == "ms" || token == "us" || token == "ns"))
+        {
+            field.unitNs = token == "s" ? 1000000000LL : token == "ms" ? 1000000LL : token == "us" ? 1000LL : 1LL;
+        }
+        else
+        {
+            ok = false;
+        }
+        if(!ok)
+        {
+            error = QString("字段 {%1} 的参数 \"%2\" 无效").arg(spec, token);
+            return false;
+        }
+    }
+    return true;
+}
+
+void FramePattern::render(char *out, Context &context) const
+{
+    std::memcpy(out, m_bytes.constData(), static_cast<size_t>(m_bytes.size()));
+    uchar *data = reinterpret_cast<uchar *>(out);
+    for(const Field &field : m_fields)
+    {
+        uchar *p = data + field.offset;
+        switch(field.type)
+        {
+        case FieldType::Counter:
+            writeInteger(p, field.width, field.bigEndian,
+                         field.start + field.step * (field.perTarget ? context.targetSequence : context.sequence));
+            break;
+        case FieldType::Timestamp:
+            writeInteger(p, field.width, field.bigEndian, static_cast<quint64>(context.epochNs / field.unitNs));
+            break;
+        case FieldType::Random:
+            for(int i = 0; i < field.width; i += 8)
+            {
+                const quint64 value = nextRandom(context.random);
+                std::memcpy(p + i, &value, static_cast<size_t>(qMin(8, field.width - i)));
+            }
+            break;
+        case FieldType::Checksum:
+        {
+            quint32 acc = field.base;
+            for(int s = 0; s < field.spans.size(); s += 2)
+            {
+                for(int i = field.spans[s]; i < field.spans[s + 1]; ++i)
+                {
+                    acc = field.checksum == ChecksumType::Xor8 ? (acc ^ data[i]) : (acc + data[i]);
+                }
+            }
+            const quint32 value = field.checksum == ChecksumType::Sum16 ? ((acc ^ (acc >> 16)) & 0xffff) : (acc & 0xff);
+            writeInteger(p, field.width, field.bigEndian, value);
+            break;
+        }
+        }
+    }
+}
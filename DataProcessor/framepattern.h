@@ -0,0 +1,102 @@
+#ifndef FRAMEPATTERN_H
+#define FRAMEPATTERN_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 自定义数据帧模板
+ * 一行十六进制数据中可以插入 {...} 字段，编译时记下每个字段的偏移与宽度，字段位置在模板中置 0，
+ * 校验和先按固定字节算好。生成帧时只需拷贝模板、按偏移写入字段，校验和在预算值上累加可变字节。
+ *
+ * 字段写法（参数以冒号分隔，顺序任意）：
+ * - {cnt}        计数器，默认 4 字节小端，从 0 起每帧加 1；可选宽度 1-8、be/le、start=N、step=N，
+ *                tgt 表示按目标分别计数（多个目标时每个接收端看到连续的序号）
+ * - {ts}         时间戳（Unix 时间），默认 8 字节小端微秒；可选宽度 1-8、be/le、s/ms/us/ns
+ * - {rand:N}     N 字节随机数据，每帧重新生成（默认 4 字节）
+ * - {sum}        2 字节校验和，算法与指令帧相同（字节和高低 16 位异或），小端
+ * - {sum8}       1 字节累加和
+ * - {xor}        1 字节异或校验
+ * 校验字段默认覆盖从帧首到字段之前的全部字节，from=N 指定起始偏移。
+ * 例：80 21 00 C6 00 {cnt:4} {ts:8:us} {rand:16} 00 00 {sum}
+ */
+class FramePattern
+{
+public:
+    ///字段类型
+    enum class FieldType
+    {
+        Counter,    ///< 计数器
+        Timestamp,  ///< 时间戳
+        Random,     ///< 随机数据
+        Checksum    ///< 校验和
+    };
+
+    ///校验算法
+    enum class ChecksumType
+    {
+        Sum16,  ///< 字节和高低 16 位异或（与指令帧相同），2 字节
+        Sum8,   ///< 字节和低 8 位，1 字节
+        Xor8    ///< 字节异或，1 字节
+    };
+
+    ///编译后的字段
+    struct Field
+    {
+        FieldType type = FieldType::Counter;
+        int offset = 0;                 ///< 字段在帧内的偏移
+        int width = 0;                  ///< 字段宽度（字节）
+        bool bigEndian = false;         ///< 大端写入
+        quint64 start = 0;              ///< 计数器初值
+        quint64 step = 1;               ///< 计数器步长
+        bool perTarget = false;         ///< 计数器按目标分别计数
+        qint64 unitNs = 1000;           ///< 时间戳单位（纳秒）
+        ChecksumType checksum = ChecksumType::Sum16;
+        int from = 0;                   ///< 校验范围起点（终点为字段偏移）
+        quint32 base = 0;               ///< 校验范围内固定字节的和（异或）
+        QVector<int> spans;             ///< 校验范围内可变字节区间，成对存放 [起, 止)
+    };
+
+    ///生成一帧所需的状态
+    struct Context
+    {
+        quint64 sequence = 0;       ///< 本模板已生成的帧数
+        quint64 targetSequence = 0; ///< 本模板已发往当前目标的帧数
+        qint64 epochNs = 0;         ///< 帧内时间戳（Unix 纳秒）
+        quint64 random = 1;         ///< 随机数状态（xorshift64*，不可为 0）
+    };
+
+    /**
+     * @brief 编译一行模板
+     * @param line 十六进制数据与 {...} 字段，十六进制之间的分隔符任意
+     * @param error 编译失败的原因
+     */
+    bool compile(const QString &line, QString &error);
+
+    /**
+     * @brief 生成一帧
+     * @param out 输出缓冲区，至少 length() 字节
+     * @param context 生成状态（随机数状态随之推进）
+     */
+    void render(char *out, Context &context) const;
+
+    ///帧长
+    int length() const { return m_bytes.size(); }
+
+    ///是否含有字段（不含字段时每帧相同）
+    bool hasFields() const { return !m_fields.isEmpty(); }
+
+    ///帧内主题号（第 3、4 字节，小端）
+    quint16 topic() const { return m_topic; }
+
+private:
+    ///解析一个 {...} 字段（不含花括号）
+    bool parseField(const QString &spec, Field &field, QString &error) const;
+
+    QByteArray m_bytes;         ///< 模板字节（字段位置为 0）
+    QVector<Field> m_fields;    ///< 取值字段在前，校验字段按偏移排在最后
+    quint16 m_topic = 0;        ///< 帧内主题号
+};
+
+#endif //FRAMEPATTERN_H
@@ -0,0 +1,86 @@
+#include "logbatcher.h"
+#include <QDateTime>
+
+LogBatcher::LogBatcher(int detailPerFlush, int capacity)
+    : m_detailPerFlush(qMax(0, detailPerFlush))
+    , m_capacity(qMax(1, capacity))
+{
+    m_sinceTake.start();
+}
+
+void LogBatcher::add(const QString &level, const QString &message)
+{
+    Line line;
+    line.level = LogStore::levelFromName(level);
+    line.message = message;
+    push(line);
+}
+
+void LogBatcher::addPacketSent(quint16 topic, const QString &destination, const QByteArray &payload)
+{
+    Line line;
+    line.level = LogStore::Info;
+    line.format = LogStore::Format::PacketSent;
+    line.topic = topic;
+    line.message = destination;
+    line.payload = payload;
+    push(line);
+}
+
+void LogBatcher::addTopicSkipped(quint16 topic, int length)
+{
+    Line line;
+    line.level = LogStore::Info;
+    line.format = LogStore::Format::TopicSkipped;
+    line.topic = topic;
+    line.value = length;
+    push(line);
+}
+
+void LogBatcher::push(Line &line)
+{
+    line.timeMs = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&m_mutex);
+    if(m_lines.size() >= m_capacity)
+    {
+        m_dropped++;
+        return;
+    }
+    m_lines.append(line);
+}
+
+QVector<LogBatcher::Line> LogBatcher::take()
+{
+    QVector<Line> lines;
+    qint64 dropped = 0;
+    qint64 elapsedMs = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        lines.swap(m_lines);
+        dropped = m_dropped;
+        m_dropped = 0;
+        elapsedMs = m_sinceTake.restart();
+    }
+    //本周期的明细计数清零，超出保留条数的部分即为被折叠的条数
+    const int details = m_detailCount.exchange(0, std::memory_order_relaxed);
+    const int folded = detailEnabled() ? 0 : details - m_detailPerFlush;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if(folded > 0)
+    {
+        const qint64 rate = elapsedMs > 0 ? details * 1000LL / elapsedMs : details;
+        Line summary;
+        summary.timeMs = now;
+        summary.level = LogStore::Info;
+        summary.message = QString("逐包日志已折叠 %1 条（约 %2 条/秒），勾选\"逐包明细\"可查看全部").arg(folded).arg(rate);
+        lines.append(summary);
+    }
+    if(dropped > 0)
+    {
+        Line warning;
+        warning.timeMs = now;
+        warning.level = LogStore::Warn;
+        warning.message = QString("日志缓冲区已满，丢弃 %1 条").arg(dropped);
+        lines.append(warning);
+    }
+    return lines;
+}
@@ -0,0 +1,88 @@
+#ifndef LOGBATCHER_H
+#define LOGBATCHER_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QVector>
+#include <atomic>
+#include "logstore.h"
+
+/**
+ * @brief 跨线程日志批量缓冲
+ * 工作线程（可多个）将日志写入缓冲区，界面线程按固定节奏（如 50ms）一次取走，
+ * 避免每条日志一次跨线程排队事件。
+ * 逐包明细日志每个周期最多保留 detailPerFlush 条，超出部分只计数，
+ * 取出时合并为一条速率汇总；开启明细模式后全部保留。
+ * 缓冲区有上限，界面长时间不取走时丢弃新日志并在下次取出时提示。
+ * 所有接口均线程安全。
+ */
+class LogBatcher
+{
+public:
+    ///日志行（结构化记录，显示时再格式化）
+    typedef LogStore::Record Line;
+
+    /**
+     * @brief 构造日志缓冲
+     * @param detailPerFlush 每个周期保留的逐包明细条数
+     * @param capacity 缓冲区最大行数
+     */
+    explicit LogBatcher(int detailPerFlush = 50, int capacity = 100000);
+
+    /**
+     * @brief 写入一条日志
+     * @param level 级别名称（DEBUG/INFO/WARN/ERROR）
+     * @param message 日志内容
+     */
+    void add(const QString &level, const QString &message);
+
+    /**
+     * @brief 写入一条发送成功明细（INFO），不做任何格式化
+     * @param topic 主题号
+     * @param destination 目标地址
+     * @param payload 数据包（多个目标共用同一份）
+     */
+    void addPacketSent(quint16 topic, const QString &destination, const QByteArray &payload);
+
+    /**
+     * @brief 写入一条跳过主题明细（INFO）
+     * @param topic 主题号
+     * @param length 数据包长度
+     */
+    void addTopicSkipped(quint16 topic, int length);
+
+    /**
+     * @brief 申请写入一条逐包明细日志
+     * 调用方仅在返回 true 时写入，被折叠的明细无需构造记录。
+     */
+    bool acceptDetail()
+    {
+        const int count = m_detailCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        return m_detailEnabled.load(std::memory_order_relaxed) || count <= m_detailPerFlush;
+    }
+
+    ///是否保留全部逐包明细
+    void setDetailEnabled(bool enabled) { m_detailEnabled.store(enabled, std::memory_order_relaxed); }
+    bool detailEnabled() const { return m_detailEnabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 取出自上次调用以来的全部日志（界面线程定时调用）
+     * 有明细被折叠或日志被丢弃时追加一条汇总。
+     */
+    QVector<Line> take();
+
+private:
+    ///加入缓冲区（补齐时间）
+    void push(Line &line);
+
+    mutable QMutex m_mutex;          ///< 缓冲区互斥锁
+    QVector<Line> m_lines;           ///< 待取出的日志
+    QElapsedTimer m_sinceTake;       ///< 距上次取出的时间
+    int m_detailPerFlush;            ///< 每周期保留的明细条数
+    int m_capacity;                  ///< 缓冲区上限
+    qint64 m_dropped = 0;            ///< 缓冲区满丢弃的行数
+    std::atomic<int> m_detailCount{0};      ///< 本周期申请的明细条数
+    std::atomic<bool> m_detailEnabled{false}; ///< 明细模式
+};
+
+#endif //LOGBATCHER_H
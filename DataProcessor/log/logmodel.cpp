@@ -0,0 +1,136 @@
+#include "logmodel.h"
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(capacity)
+{
+}
+
+void LogModel::setColors(const ThemeColors &colors)
+{
+    m_colors = colors;
+    if(rowCount() > 0)
+    {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::ForegroundRole});
+    }
+}
+
+void LogModel::setFilter(const QString &levelName)
+{
+    const int filter = levelName == QLatin1String("ALL") ? static_cast<int>(LogStore::AllLevels)
+                                                         : static_cast<int>(LogStore::levelFromName(levelName));
+    if(filter == m_filter)
+    {
+        return;
+    }
+    //行号映射直接由级别索引给出，重置后视图只重新请求可见行
+    beginResetModel();
+    m_filter = filter;
+    endResetModel();
+}
+
+void LogModel::append(const QVector<LogBatcher::Line> &lines)
+{
+    //超过容量的部分只保留最新的
+    const int total = lines.size();
+    const int first = qMax(0, total - m_store.capacity());
+    if(first >= total)
+    {
+        return;
+    }
+    //先淘汰腾出空间，统计其中在当前视图中可见的行数
+    const int evict = qMax(0, m_store.count() + (total - first) - m_store.capacity());
+    int visibleEvicted = 0;
+    for(int i = 0; i < evict; ++i)
+    {
+        if(isVisible(m_store.at(i).level))
+        {
+            visibleEvicted++;
+        }
+    }
+    if(visibleEvicted > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, visibleEvicted - 1);
+    }
+    for(int i = 0; i < evict; ++i)
+    {
+        m_store.removeOldest();
+    }
+    if(visibleEvicted > 0)
+    {
+        endRemoveRows();
+    }
+    int visibleAdded = 0;
+    for(int i = first; i < total; ++i)
+    {
+        if(isVisible(lines[i].level))
+        {
+            visibleAdded++;
+        }
+    }
+    const int row = m_store.count(m_filter);
+    if(visibleAdded > 0)
+    {
+        beginInsertRows(QModelIndex(), row, row + visibleAdded - 1);
+    }
+    for(int i = first; i < total; ++i)
+    {
+        m_store.append(lines[i]);
+    }
+    if(visibleAdded > 0)
+    {
+        endInsertRows();
+    }
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    m_store.clear();
+    endResetModel();
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_store.count(m_filter);
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+    const LogStore::Record &record = m_store.at(index.row(), m_filter);
+    switch(role)
+    {
+    case Qt::DisplayRole:
+        return QString("[%1] [%2] %3").arg(QDateTime::fromMSecsSinceEpoch(record.timeMs).toString(dt_format),
+                                           LogStore::levelName(record.level),
+                                           record.render());
+    case Qt::ToolTipRole:
+        return record.render();
+    case Qt::ForegroundRole:
+        return colorForLevel(record.level);
+    default:
+        return QVariant();
+    }
+}
+
+QColor LogModel::colorForLevel(LogStore::Level level) const
+{
+    //根据日志级别返回颜色
+    switch(level)
+    {
+    case LogStore::Info:
+        return m_colors.info;
+    case LogStore::Warn:
+        return m_colors.warn;
+    case LogStore::Error:
+        return m_colors.error;
+    case LogStore::Debug:
+        return m_colors.debug;
+    default:
+        return m_colors.defualt;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include "alldefine.h"
+#include "logstore.h"
+#include "logbatcher.h"
+
+/**
+ * @brief 日志列表模型
+ * 以 LogStore 为数据源，供 QListView 虚拟化显示：视图只请求可见行，
+ * 显示文本在 data() 中按需格式化，切换过滤级别只需重置模型，与日志总量无关。
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造日志模型
+     * @param capacity 最大日志条数，超出后淘汰最早的日志
+     * @param parent 父对象
+     */
+    explicit LogModel(int capacity, QObject *parent = nullptr);
+
+    ///设置各级别显示颜色
+    void setColors(const ThemeColors &colors);
+
+    /**
+     * @brief 设置过滤级别
+     * @param levelName 级别名称（DEBUG/INFO/WARN/ERROR），ALL 表示全部
+     */
+    void setFilter(const QString &levelName);
+
+    /**
+     * @brief 批量追加日志
+     * 淘汰与插入各只通知视图一次，行数变化与批大小无关。
+     * @param lines 日志行（时间顺序）
+     */
+    void append(const QVector<LogBatcher::Line> &lines);
+
+    ///清空日志
+    void clear();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    ///级别在当前过滤条件下是否可见
+    bool isVisible(LogStore::Level level) const
+    {
+        return m_filter == LogStore::AllLevels || m_filter == level;
+    }
+
+    ///级别对应的颜色
+    QColor colorForLevel(LogStore::Level level) const;
+
+    LogStore m_store;                    ///< 日志环形缓冲区
+    int m_filter = LogStore::AllLevels;  ///< 当前过滤级别
+    ThemeColors m_colors;                ///< 日志颜色
+};
+
+#endif //LOGMODEL_H
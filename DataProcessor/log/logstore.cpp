@@ -0,0 +1,139 @@
+#include "logstore.h"
+
+LogStore::LogStore(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+LogStore::Level LogStore::levelFromName(const QString &name)
+{
+    if(name == QLatin1String("DEBUG"))
+    {
+        return Debug;
+    }
+    if(name == QLatin1String("INFO"))
+    {
+        return Info;
+    }
+    if(name == QLatin1String("WARN"))
+    {
+        return Warn;
+    }
+    if(name == QLatin1String("ERROR"))
+    {
+        return Error;
+    }
+    return Other;
+}
+
+QString LogStore::levelName(Level level)
+{
+    switch(level)
+    {
+    case Debug:
+        return QStringLiteral("DEBUG");
+    case Info:
+        return QStringLiteral("INFO");
+    case Warn:
+        return QStringLiteral("WARN");
+    case Error:
+        return QStringLiteral("ERROR");
+    default:
+        return QStringLiteral("OTHER");
+    }
+}
+
+QString LogStore::Record::render() const
+{
+    //主题号文本：第 4 字节为高字节，短包只有低字节
+    const auto topicText = [this](int length)
+    {
+        return length > 4 ? QString("%1").arg(topic, 4, 16, QLatin1Char('0')).toUpper()
+                          : QString("%1").arg(topic & 0xFF, 2, 16, QLatin1Char('0')).toUpper();
+    };
+    switch(format)
+    {
+    case Format::PacketSent:
+        return QString("发送成功 [%1] [长度：%2] [%3] [%4]").arg(topicText(payload.size())).arg(payload.size())
+               .arg(message).arg(QString::fromLatin1(payload.toHex().toUpper()));
+    case Format::TopicSkipped:
+        return "跳过主题:" + topicText(value);
+    default:
+        return message;
+    }
+}
+
+int LogStore::count(int level) const
+{
+    if(level < 0 || level >= LevelCount)
+    {
+        return static_cast<int>(m_next - m_first);
+    }
+    return m_index[level].size;
+}
+
+const LogStore::Record &LogStore::at(int row, int level) const
+{
+    if(level < 0 || level >= LevelCount)
+    {
+        return recordAt(m_first + static_cast<quint64>(row));
+    }
+    const Index &index = m_index[level];
+    return recordAt(index.seqs[(index.head + row) % m_capacity]);
+}
+
+void LogStore::removeOldest()
+{
+    if(m_next == m_first)
+    {
+        return;
+    }
+    //最早的记录必然也是其所属级别索引中最早的一项
+    Index &index = m_index[recordAt(m_first).level];
+    index.head = (index.head + 1) % m_capacity;
+    index.size--;
+    Record &oldest = m_records[static_cast<int>(m_first % static_cast<quint64>(m_capacity))];
+    oldest.message.clear();
+    oldest.payload.clear();
+    m_first++;
+}
+
+void LogStore::append(const Record &record)
+{
+    if(isFull())
+    {
+        removeOldest();
+    }
+    if(m_records.size() < m_capacity)
+    {
+        m_records.append(record);
+    }
+    else
+    {
+        m_records[static_cast<int>(m_next % static_cast<quint64>(m_capacity))] = record;
+    }
+    //索引增长阶段追加到末尾，达到容量后循环覆盖已淘汰的位置
+    Index &index = m_index[record.level];
+    const int pos = (index.head + index.size) % m_capacity;
+    if(pos == index.seqs.size())
+    {
+        index.seqs.append(m_next);
+    }
+    else
+    {
+        index.seqs[pos] = m_next;
+    }
+    index.size++;
+    m_next++;
+}
+
+void LogStore::clear()
+{
+    m_records.clear();
+    m_first = 0;
+    m_next = 0;
+    for(Index &index : m_index)
+    {
+        index = Index();
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief 固定容量的日志环形缓冲区
+ * 所有级别的日志按到达顺序存放在同一个环形数组中，超出容量时淘汰最早的一条；
+ * 每个级别另有一个序号索引环，按级别过滤时第 N 行可直接定位，无需遍历或重建。
+ * 记录与索引按需增长，最多占用容量大小的空间。
+ * 记录为结构化数据（格式号 + 参数 + 数据包），显示文本在 render() 中按需生成。
+ * 仅供单个线程使用。
+ */
+class LogStore
+{
+public:
+    ///日志级别
+    enum Level : quint8
+    {
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Other,
+        LevelCount
+    };
+
+    ///按级别过滤时表示全部级别
+    static const int AllLevels = -1;
+
+    ///日志格式（决定 render() 如何组装文本）
+    enum class Format : quint8
+    {
+        Text,          ///< 纯文本：message
+        PacketSent,    ///< 发送成功：topic、message(目标地址)、payload
+        TopicSkipped   ///< 跳过主题：topic、value(包长度)
+    };
+
+    ///日志记录
+    struct Record
+    {
+        qint64 timeMs = 0;             ///< 时间（自纪元起的毫秒数）
+        Level level = Other;           ///< 级别
+        Format format = Format::Text;  ///< 格式
+        quint16 topic = 0;             ///< 主题号
+        int value = 0;                 ///< 整数参数
+        QString message;               ///< 文本参数
+        QByteArray payload;            ///< 数据包（共享，不做十六进制转换）
+
+        ///生成显示文本
+        QString render() const;
+    };
+
+    ///@param capacity 最大记录数
+    explicit LogStore(int capacity);
+
+    ///级别名称（DEBUG/INFO/WARN/ERROR）转为级别，无法识别时为 Other
+    static Level levelFromName(const QString &name);
+
+    ///级别名称
+    static QString levelName(Level level);
+
+    ///容量
+    int capacity() const { return m_capacity; }
+
+    ///是否已满（再追加将淘汰最早的记录）
+    bool isFull() const { return m_next - m_first == static_cast<quint64>(m_capacity); }
+
+    ///最早一条记录的级别（需非空）
+    Level oldestLevel() const { return recordAt(m_first).level; }
+
+    /**
+     * @brief 记录数
+     * @param level 级别，AllLevels 表示全部
+     */
+    int count(int level = AllLevels) const;
+
+    /**
+     * @brief 按行号取记录（时间顺序，第 0 行最早）
+     * @param row 行号（小于 count(level)）
+     * @param level 级别，AllLevels 表示全部
+     */
+    const Record &at(int row, int level = AllLevels) const;
+
+    ///淘汰最早的一条记录（需非空）
+    void removeOldest();
+
+    ///追加一条记录，已满时先淘汰最早的记录
+    void append(const Record &record);
+
+    ///清空
+    void clear();
+
+private:
+    ///单个级别的序号索引环
+    struct Index
+    {
+        QVector<quint64> seqs; ///< 记录序号（按需增长至容量后循环使用）
+        int head = 0;          ///< 最早一项的位置
+        int size = 0;          ///< 有效项数
+    };
+
+    const Record &recordAt(quint64 seq) const
+    {
+        return m_records[static_cast<int>(seq % static_cast<quint64>(m_capacity))];
+    }
+
+    int m_capacity;               ///< 容量
+    QVector<Record> m_records;    ///< 记录环（按需增长至容量后循环使用）
+    quint64 m_first = 0;          ///< 最早记录的序号
+    quint64 m_next = 0;           ///< 下一条记录的序号
+    Index m_index[LevelCount];    ///< 各级别索引
+};
+
+#endif //LOGSTORE_H
@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "orderSend/commandflow.h"
 #include <QApplication>
 #include <QDir>
 #include <QStandardPaths>
@@ -57,6 +58,7 @@ int main(int argc, char *argv[])
     //注册 QMap 类型，以便信号槽可以使用
     qRegisterMetaType<QMap<QString, int >> ("QMap<QString,int>");
     qRegisterMetaType<QMap<QString, double >> ("QMap<QString,double>");
+    qRegisterMetaType<FlowOptions>("FlowOptions");
     //配置应用程序信息
     QCoreApplication::setApplicationName("数据处理器");
     QCoreApplication::setOrganizationName("MaWenshui");
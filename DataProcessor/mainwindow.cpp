@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -12,12 +13,53 @@
 #include <QComboBox>
 #include <QStatusBar>
 #include <QVBoxLayout>
+#include <QScrollBar>
+#include <QHeaderView>
 #include "faultAlarmWidget/faultAlarmWidget.h"
 #include "threadmanager.h"
 
 //定义日志分类
 Q_LOGGING_CATEGORY(mainWindowLog, "[app.MainWindow]")
 
+namespace
+{
+    ///速率文本（自动选择 k/M/G 单位）
+    QString formatRate(double value, const QString &unit)
+    {
+        if(value >= 1e9)
+        {
+            return QString("%1 G%2").arg(value / 1e9, 0, 'f', 2).arg(unit);
+        }
+        if(value >= 1e6)
+        {
+            return QString("%1 M%2").arg(value / 1e6, 0, 'f', 2).arg(unit);
+        }
+        if(value >= 1e3)
+        {
+            return QString("%1 k%2").arg(value / 1e3, 0, 'f', 2).arg(unit);
+        }
+        return QString("%1 %2").arg(value, 0, 'f', 0).arg(unit);
+    }
+
+    ///时长文本（纳秒，自动选择 ns/µs/ms/s）
+    QString formatDuration(qint64 ns)
+    {
+        if(ns >= 1000000000LL)
+        {
+            return QString("%1 s").arg(ns / 1e9, 0, 'f', 3);
+        }
+        if(ns >= 1000000LL)
+        {
+            return QString("%1 ms").arg(ns / 1e6, 0, 'f', 2);
+        }
+        if(ns >= 1000LL)
+        {
+            return QString::fromUtf8("%1 µs").arg(ns / 1e3, 0, 'f', 1);
+        }
+        return QString("%1 ns").arg(ns);
+    }
+}
+
 /**
  * @brief MainWindow构造函数
  * @param parent 父窗口指针
@@ -176,7 +218,14 @@ void MainWindow::initUI()
     QToolBar *logToolBar = new QToolBar(this);
     logToolBar->addWidget(new QLabel("日志等级过滤:"));
     logToolBar->addWidget(m_pLogFilterCombo);
+    //逐包明细默认折叠为速率汇总，需要时勾选查看完整日志
+    m_pLogDetailCheck = new QCheckBox("逐包明细", this);
+    logToolBar->addWidget(m_pLogDetailCheck);
     addToolBar(Qt::TopToolBarArea, logToolBar);
+    //回放统计页：列宽均分，每 0.5 秒刷新
+    ui->statsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->statsTable->verticalHeader()->setVisible(false);
+    m_statsTimer.setInterval(500);
     // 监听主功能区标签页切换，按需构造自定义页
     connect(ui->tabWidget_2, &QTabWidget::currentChanged,
             this, &MainWindow::onMainTabChanged);
@@ -201,6 +250,10 @@ void MainWindow::loadConfig()
     ui->excludeEdit->setText(config.value("excludeTopics").toStringList().join(","));
     ui->uniqueCheck->setChecked(config.value("uniqueMode").toBool());
     ui->sendIntervalEdit->setText(config.value("sendInterval").toString());
+    ui->pacingCombo->setCurrentIndex(config.value("pacingMode").toString() == "timestamp" ? 1 : 0);
+    ui->speedSpin->setValue(config.value("speedFactor", 1.0).toDouble());
+    ui->startTimeEdit->setText(config.value("startTime").toString());
+    ui->resumeCheck->setChecked(config.value("resumeCheckpoint").toBool());
     // 加载地址列表（批量、禁用重绘，避免白屏期间耗时过长）
     const QStringList addresses = config.value("addresses").toStringList();
     ui->addrList->setUpdatesEnabled(false);
@@ -231,6 +284,10 @@ void MainWindow::saveConfig()
     config["excludeTopics"] = ui->excludeEdit->text().split(',', QString::SkipEmptyParts);
     config["uniqueMode"] = ui->uniqueCheck->isChecked();
     config["sendInterval"] = ui->sendIntervalEdit->text();
+    config["pacingMode"] = ui->pacingCombo->currentIndex() == 1 ? "timestamp" : "interval";
+    config["speedFactor"] = ui->speedSpin->value();
+    config["startTime"] = ui->startTimeEdit->text().trimmed();
+    config["resumeCheckpoint"] = ui->resumeCheck->isChecked();
     //保存地址列表
     QStringList addrList = getAddressList();
     config["addresses"] = addrList;
@@ -298,6 +355,20 @@ void MainWindow::setupConnections()
     connect(ui->startButton, &QPushButton::clicked, this, &MainWindow::onStartClicked);
     connect(ui->pauseButton, &QPushButton::clicked, this, &MainWindow::onPauseClicked);
     connect(ui->stopButton, &QPushButton::clicked, this, &MainWindow::onStopClicked);
+    connect(ui->convertButton, &QPushButton::clicked, this, &MainWindow::onConvertClicked);
+    connect(ui->recordButton, &QPushButton::clicked, this, &MainWindow::onRecordClicked);
+    connect(ui->seekButton, &QPushButton::clicked, this, &MainWindow::onSeekClicked);
+    connect(ui->exportStatsButton, &QPushButton::clicked, this, &MainWindow::onExportStatsClicked);
+    connect(&m_statsTimer, &QTimer::timeout, this, &MainWindow::refreshTelemetry);
+    //工作线程日志按 20Hz 批量取出
+    connect(&m_logFlushTimer, &QTimer::timeout, this, &MainWindow::flushWorkerLogs);
+    connect(m_pLogDetailCheck, &QCheckBox::toggled, this, [this](bool checked)
+    {
+        if(m_worker)
+        {
+            m_worker->logBatcher()->setDetailEnabled(checked);
+        }
+    });
     //连接自动保存配置定时器
     connect(&m_saveTimer, &QTimer::timeout, this, &MainWindow::saveConfig);
 
@@ -315,8 +386,13 @@ void MainWindow::setupConnections()
  */
 void MainWindow::setupLogFilter()
 {
-    //初始化日志格式
-    m_logFormat.setFont(QFont("Consolas", 10));
+    //日志视图只渲染可见行，数据保存在固定容量的环形缓冲区中
+    m_pLogModel = new LogModel(MAX_LOG_ENTRIES, this);
+    m_pLogModel->setColors(m_logColors);
+    m_pLogModel->setFilter(m_currentFilterLevel);
+    ui->logView->setModel(m_pLogModel);
+    ui->logView->setFont(QFont("Consolas", 10));
+    m_logFlushTimer.setInterval(50);
 }
 
 /**
@@ -493,10 +569,11 @@ void MainWindow::onStartClicked()
     {
         return;
     }
-    ui->logView->clear();
+    m_pLogModel->clear();
     saveConfig();
     //创建工作类对象并移动到工作线程
     m_worker.reset(new WorkerClass);
+    m_worker->logBatcher()->setDetailEnabled(m_pLogDetailCheck->isChecked());
     m_worker->setAddrList(addrList);
     if (m_configManager)
     {
@@ -511,6 +588,95 @@ void MainWindow::onStartClicked()
     //连接信号槽并启动线程
     connectWorkerSlots();
     updateButtonStates(true, false);
+    //统计页从零开始，运行期间即可导出当前统计
+    m_lastSnapshot = ReplayTelemetry::Snapshot();
+    m_lastTelemetry = QJsonObject();
+    ui->statsTable->setRowCount(0);
+    ui->exportStatsButton->setEnabled(true);
+    m_statsTimer.start();
+    m_workerThread.start();
+}
+
+/**
+ * @brief 跳转按钮点击事件处理
+ * 回放中跳转到起始位置输入框中的时间，定位在工作线程中完成
+ */
+void MainWindow::onSeekClicked()
+{
+    const QString target = ui->startTimeEdit->text().trimmed();
+    if(target.isEmpty())
+    {
+        QMessageBox::warning(this, "跳转", "请输入跳转位置");
+        return;
+    }
+    if(!m_worker || !m_worker->seekTo(target))
+    {
+        QMessageBox::warning(this, "跳转", "无法跳转到: " + target + "\n仅回放过程中可以跳转，位置格式见输入框提示");
+    }
+}
+
+/**
+ * @brief 转换按钮点击事件处理
+ * 复用工作线程与进度/日志显示，将数据目录下的文本抓包转换为 .dpcap
+ */
+void MainWindow::onConvertClicked()
+{
+    if(ui->dirEdit->text().isEmpty())
+    {
+        QMessageBox::warning(this, "配置错误", "请选择数据目录");
+        return;
+    }
+    m_pLogModel->clear();
+    saveConfig();
+    m_worker.reset(new WorkerClass);
+    m_worker->logBatcher()->setDetailEnabled(m_pLogDetailCheck->isChecked());
+    m_worker->setTask(WorkerClass::Task::Convert);
+    if (m_configManager)
+    {
+        m_worker->configure(m_configManager->getConfig());
+    }
+    else
+    {
+        m_worker->configure(QVariantMap{{"dataDir", ui->dirEdit->text()}});
+    }
+    m_worker->moveToThread(&m_workerThread);
+    connectWorkerSlots();
+    updateButtonStates(true, false);
+    ui->seekButton->setEnabled(false);
+    m_workerThread.start();
+}
+
+/**
+ * @brief 录制按钮点击事件处理
+ * 复用工作线程与日志显示，接收选中地址上的数据包写入录制文件，点击停止结束
+ */
+void MainWindow::onRecordClicked()
+{
+    QStringList addrList = getSelectedAddressList();
+    if(!validateConfig(addrList))
+    {
+        return;
+    }
+    m_pLogModel->clear();
+    saveConfig();
+    m_worker.reset(new WorkerClass);
+    m_worker->logBatcher()->setDetailEnabled(m_pLogDetailCheck->isChecked());
+    m_worker->setTask(WorkerClass::Task::Record);
+    m_worker->setAddrList(addrList);
+    if (m_configManager)
+    {
+        m_worker->configure(m_configManager->getConfig());
+    }
+    else
+    {
+        m_worker->configure(QVariantMap{{"dataDir", ui->dirEdit->text()}});
+    }
+    m_worker->moveToThread(&m_workerThread);
+    connectWorkerSlots();
+    updateButtonStates(true, false);
+    //录制不支持暂停与跳转
+    ui->pauseButton->setEnabled(false);
+    ui->seekButton->setEnabled(false);
     m_workerThread.start();
 }
 
@@ -541,6 +707,14 @@ void MainWindow::onStopClicked()
         m_workerThread.quit();
         m_workerThread.wait();
         disConnectWorkerSlots();
+        flushWorkerLogs();
+        //保留最终统计：统计页停留在最后一次刷新，导出使用停止时的数据
+        if(m_statsTimer.isActive())
+        {
+            m_statsTimer.stop();
+            refreshTelemetry();
+            m_lastTelemetry = m_worker->telemetry()->toJson();
+        }
         m_worker.reset();
         updateButtonStates(false, false);
         qCDebug(mainWindowLog) << "工作线程和资源已完全清理。";
@@ -557,8 +731,9 @@ void MainWindow::connectWorkerSlots()
     connect(&m_workerThread, &QThread::quit, m_worker.get(), &WorkerClass::stopProcessing);
     connect(m_worker.get(), &WorkerClass::finished, &m_workerThread, &QThread::quit);
     connect(m_worker.get(), &WorkerClass::statsUpdated, this, &MainWindow::handleStats);
-    connect(m_worker.get(), &WorkerClass::logMessage, this, &MainWindow::handleLog);
     connect(m_worker.get(), &WorkerClass::progressUpdated, this, &MainWindow::handleProgress);
+    //日志不走信号，由定时器批量取出
+    m_logFlushTimer.start();
 }
 
 /**
@@ -573,35 +748,32 @@ void MainWindow::disConnectWorkerSlots()
     {
         disconnect(m_worker.get(), &WorkerClass::finished, &m_workerThread, &QThread::quit);
         disconnect(m_worker.get(), &WorkerClass::statsUpdated, this, &MainWindow::handleStats);
-        disconnect(m_worker.get(), &WorkerClass::logMessage, this, &MainWindow::handleLog);
         disconnect(m_worker.get(), &WorkerClass::progressUpdated, this, &MainWindow::handleProgress);
         disconnect(m_worker.get(), nullptr, this, nullptr);
     }
 }
 
 /**
- * @brief 处理日志消息
- * @param level 日志级别
- * @param msg 日志内容
+ * @brief 取出工作线程缓冲的日志并批量追加到日志视图
  */
-void MainWindow::handleLog(const QString &level, const QString &msg)
+void MainWindow::flushWorkerLogs()
 {
-    LogEntry entry{level.toUpper(), msg, QDateTime::currentDateTime()};
-    m_logEntriesByLevel[level].append(entry);
-    //单类日志达到规定数量则清理旧日志
-    if(m_logEntriesByLevel[level].size() > MAX_LOG_ENTRIES)
+    if(!m_worker)
+    {
+        return;
+    }
+    const QVector<LogBatcher::Line> lines = m_worker->logBatcher()->take();
+    if(lines.isEmpty())
     {
-        m_logEntriesByLevel[level].removeFirst();
+        return;
     }
-    //根据过滤级别显示日志
-    if(m_currentFilterLevel == "ALL" || entry.level == m_currentFilterLevel)
+    //仅在视图停留在底部时自动滚动，便于查看历史日志
+    QScrollBar *bar = ui->logView->verticalScrollBar();
+    const bool atBottom = bar->value() == bar->maximum();
+    m_pLogModel->append(lines);
+    if(atBottom)
     {
-        QString html = QString("<div style='color:%1'>[%2] [%3] %4</div>")
-                       .arg(colorForLevel(level).name(),
-                            entry.time.toString(dt_format),
-                            level,
-                            msg.toHtmlEscaped());
-        appendLogToView(html);
+        ui->logView->scrollToBottom();
     }
 }
 
@@ -627,46 +799,111 @@ void MainWindow::handleStats(int success, int failed)
 }
 
 /**
- * @brief 刷新日志视图
+ * @brief 刷新回放统计页
+ * 运行中显示两次刷新之间的速率，结束后显示整个运行期间的平均速率
  */
-void MainWindow::refreshLogView()
+void MainWindow::refreshTelemetry()
 {
-    //清空日志视图
-    ui->logView->clear();
-    //如果当前过滤级别是 "ALL"，则显示所有日志
-    if(m_currentFilterLevel == "ALL")
+    if(!m_worker)
     {
-        for(const auto &level : m_logEntriesByLevel.keys())
+        return;
+    }
+    const ReplayTelemetry::Snapshot snapshot = m_worker->telemetry()->snapshot();
+    const double intervalSec = snapshot.finished ? snapshot.elapsedNs / 1e9
+                                                 : (snapshot.elapsedNs - m_lastSnapshot.elapsedNs) / 1e9;
+    const auto setCell = [this](int row, int column, const QString &text)
+    {
+        QTableWidgetItem *item = ui->statsTable->item(row, column);
+        if(!item)
+        {
+            item = new QTableWidgetItem();
+            ui->statsTable->setItem(row, column, item);
+        }
+        item->setText(text);
+    };
+    ui->statsTable->setRowCount(snapshot.destinations.size());
+    for(int row = 0; row < snapshot.destinations.size(); ++row)
+    {
+        const ReplayTelemetry::DestinationStats &stats = snapshot.destinations[row];
+        qint64 packets = stats.packets;
+        qint64 bytes = stats.bytes;
+        if(!snapshot.finished && row < m_lastSnapshot.destinations.size())
         {
-            const QList<LogEntry>& entries = m_logEntriesByLevel[level];
-            for(const LogEntry &entry : entries)
-            {
-                QString html = QString("<div style='color:%1'>[%2] [%3] %4</div>")
-                               .arg(colorForLevel(entry.level).name(),
-                                    entry.time.toString(dt_format),
-                                    entry.level,
-                                    entry.message.toHtmlEscaped());
-                appendLogToView(html);
-            }
+            packets -= m_lastSnapshot.destinations[row].packets;
+            bytes -= m_lastSnapshot.destinations[row].bytes;
         }
+        setCell(row, 0, stats.address);
+        setCell(row, 1, QString::number(stats.packets));
+        setCell(row, 2, QString::number(stats.bytes));
+        setCell(row, 3, formatRate(intervalSec > 0 ? packets / intervalSec : 0.0, "pps"));
+        setCell(row, 4, formatRate(intervalSec > 0 ? bytes * 8 / intervalSec : 0.0, "bit/s"));
+        setCell(row, 5, QString::number(stats.failed));
+    }
+    QStringList lines;
+    lines << QString("运行时长: %1%2    已处理文件: %3    解析耗时: %4")
+             .arg(formatDuration(snapshot.elapsedNs)).arg(snapshot.finished ? "（已结束，速率为平均值）" : "")
+             .arg(snapshot.files).arg(formatDuration(snapshot.parseNs));
+    if(!snapshot.slowestFile.path.isEmpty())
+    {
+        lines << QString("解析最慢: %1（%2，%3 包）").arg(QFileInfo(snapshot.slowestFile.path).fileName())
+                 .arg(formatDuration(snapshot.slowestFile.parseNs)).arg(snapshot.slowestFile.packets);
+    }
+    const LatencyHistogram &depth = snapshot.queueDepth;
+    lines << QString("发送队列深度: P50 %1    P99 %2    最大 %3")
+             .arg(depth.percentile(50.0)).arg(depth.percentile(99.0)).arg(depth.max());
+    const LatencyHistogram &timing = snapshot.timingError;
+    if(timing.count() > 0)
+    {
+        lines << QString("调度误差: P50 %1    P99 %2    P99.9 %3    最大 %4    （%5 包，早发 %6 包）")
+                 .arg(formatDuration(timing.percentile(50.0))).arg(formatDuration(timing.percentile(99.0)))
+                 .arg(formatDuration(timing.percentile(99.9))).arg(formatDuration(timing.max()))
+                 .arg(timing.count()).arg(snapshot.earlyPackets);
     }
     else
     {
-        //否则，只显示当前过滤级别的日志
-        if(m_logEntriesByLevel.contains(m_currentFilterLevel))
-        {
-            const QList<LogEntry>& entries = m_logEntriesByLevel[m_currentFilterLevel];
-            for(const LogEntry &entry : entries)
-            {
-                QString html = QString("<div style='color:%1'>[%2] [%3] %4</div>")
-                               .arg(colorForLevel(entry.level).name(),
-                                    entry.time.toString(dt_format),
-                                    entry.level,
-                                    entry.message.toHtmlEscaped());
-                appendLogToView(html);
-            }
-        }
+        lines << "调度误差: 无（尽可能快发送时不统计）";
     }
+    ui->statsLabel->setText(lines.join('\n'));
+    m_lastSnapshot = snapshot;
+}
+
+/**
+ * @brief 导出回放统计按钮点击事件处理
+ * 回放进行中导出当前统计，停止后导出停止时保存的统计
+ */
+void MainWindow::onExportStatsClicked()
+{
+    const QJsonObject telemetry = m_worker && m_statsTimer.isActive() ? m_worker->telemetry()->toJson() : m_lastTelemetry;
+    if(telemetry.isEmpty())
+    {
+        QMessageBox::warning(this, "导出统计", "暂无回放统计");
+        return;
+    }
+    const QString defaultPath = QDir::homePath() + "/replay_stats_"
+                                + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".json";
+    const QString path = QFileDialog::getSaveFileName(this, "导出回放统计", defaultPath, "JSON 文件 (*.json)");
+    if(path.isEmpty())
+    {
+        return;
+    }
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || file.write(QJsonDocument(telemetry).toJson(QJsonDocument::Indented)) < 0)
+    {
+        QMessageBox::warning(this, "导出统计", "写入失败：" + file.errorString());
+        return;
+    }
+    ui->statusLabel->setText("回放统计已导出: " + path);
+}
+
+/**
+ * @brief 刷新日志视图
+ */
+void MainWindow::refreshLogView()
+{
+    //切换过滤级别只重置模型，视图按需读取可见行
+    m_pLogModel->setFilter(m_currentFilterLevel);
+    ui->logView->scrollToBottom();
 }
 
 /**
@@ -691,9 +928,15 @@ void MainWindow::updateButtonStates(bool isRunning, bool isPaused)
     ui->startButton->setEnabled(!isRunning);
     ui->pauseButton->setEnabled(isRunning);
     ui->stopButton->setEnabled(isRunning && !isPaused);
+    ui->convertButton->setEnabled(!isRunning);
+    ui->recordButton->setEnabled(!isRunning);
     ui->browseButton->setEnabled(!isRunning);
     ui->addAddrButton->setEnabled(!isRunning);
     ui->removeAddrButton->setEnabled(!isRunning);
+    ui->pacingCombo->setEnabled(!isRunning);
+    ui->speedSpin->setEnabled(!isRunning);
+    ui->seekButton->setEnabled(isRunning);
+    ui->resumeCheck->setEnabled(!isRunning);
 }
 
 /**
@@ -716,44 +959,3 @@ bool MainWindow::validateConfig(const QStringList addrList)
     }
     return true;
 }
-
-/**
- * @brief 根据日志级别获取颜色
- * @param level 日志级别
- * @return 对应的颜色
- */
-QColor MainWindow::colorForLevel(const QString &level) const
-{
-    //根据日志级别返回颜色
-    if(level == "INFO")
-    {
-        return m_logColors.info;
-    }
-    if(level == "WARN")
-    {
-        return m_logColors.warn;
-    }
-    if(level == "ERROR")
-    {
-        return m_logColors.error;
-    }
-    if(level == "DEBUG")
-    {
-        return m_logColors.debug;
-    }
-    return m_logColors.defualt;
-}
-
-/**
- * @brief 添加日志到视图
- * @param html 格式化的HTML日志内容
- */
-void MainWindow::appendLogToView(const QString &html)
-{
-    //添加日志到视图
-    QTextCursor cursor(ui->logView->document());
-    cursor.movePosition(QTextCursor::End);
-    cursor.insertHtml(html);
-    cursor.insertBlock();
-    ui->logView->ensureCursorVisible();
-}
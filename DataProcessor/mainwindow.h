@@ -11,18 +11,18 @@
 #include <QLoggingCategory>
 #include <QApplication>
 #include <QElapsedTimer>
-#include <QTextDocument>
-#include <QTextCursor>
-#include <QTextCharFormat>
 #include <QComboBox>
+#include <QCheckBox>
 #include <QToolBar>
 #include <QPointer>
+#include <QJsonObject>
 
 #include "alldefine.h"
 #include "workerclass.h"
 #include "configmanager.h"
 #include "customdatasender.h"
 #include "orderSend/ordersendwidget.h"
+#include "log/logmodel.h"
 
 class FaultAlarmWidget;
 
@@ -60,11 +60,16 @@ private slots:
     void onStartClicked();           //开始处理
     void onPauseClicked();           //暂停处理
     void onStopClicked();            //停止处理
+    void onConvertClicked();         //转换为 .dpcap
+    void onRecordClicked();          //录制抓包
+    void onSeekClicked();            //回放中跳转
+    void onExportStatsClicked();     //导出回放统计
 
     //处理日志、进度和统计信息的槽函数
-    void handleLog(const QString &level, const QString &msg); //处理日志
+    void flushWorkerLogs();                                   //取出工作线程缓冲的日志
     void handleProgress(int value);                           //处理进度
     void handleStats(int success, int failed);                //处理统计信息
+    void refreshTelemetry();                                  //刷新回放统计页
 
     //日志过滤下拉框变化事件
     void onLogFilterChanged(int index);
@@ -95,8 +100,6 @@ private:
     void addAddressToUI(const QString &addr); //添加地址到 UI
 
     //日志相关函数
-    QColor colorForLevel(const QString &level) const; //根据日志级别返回颜色
-    void appendLogToView(const QString &html);       //添加日志到视图
     void refreshLogView();                           //刷新日志视图
 
     //工作线程信号槽连接管理
@@ -110,9 +113,13 @@ private:
     mutable QMutex m_configMutex;      //配置访问互斥锁
     QThread m_workerThread;            //工作线程
     QScopedPointer<WorkerClass> m_worker; //工作类对象
-    QTextCharFormat m_logFormat;       //日志文本格式
     QComboBox *m_pLogFilterCombo;      //日志过滤下拉框
-    QMap<QString, QList<LogEntry >> m_logEntriesByLevel; //日志条目缓存
+    QCheckBox *m_pLogDetailCheck;      //逐包明细开关
+    QTimer m_logFlushTimer;            //日志批量刷新定时器
+    LogModel *m_pLogModel;             //日志列表模型（环形缓冲区）
+    QTimer m_statsTimer;               //回放统计刷新定时器
+    ReplayTelemetry::Snapshot m_lastSnapshot; //上次刷新的统计快照（计算当前速率）
+    QJsonObject m_lastTelemetry;       //上一次回放停止时保存的统计（供导出）
     QString m_currentFilterLevel; //当前日志过滤级别
     ThemeColors m_logColors; //日志颜色配置
     QPointer<OrderSendWidget> m_orderSendWidget; // 懒加载：指令发送页
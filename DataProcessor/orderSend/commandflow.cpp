@@ -0,0 +1,187 @@
+//commandflow.cpp
+#include "commandflow.h"
+#include "../configmanager.h"
+#include "../alldefine.h"
+
+
+#define SHAKE_TIME 200 //应答超时时间
+#define RE_SHAKE_TIME 500 //反馈应答超时时间
+#define COMMAND_SETTLE_TIME 5 //主命令发出后进入应答阶段前的等待时间
+
+CommandFlow::Multipliers CommandFlow::Multipliers::fromConfig(ConfigManager *mgr)
+{
+    // 读取倍率（带回退与安全限制）
+    Multipliers multipliers{FLOW_FAST_MULTIPLIER, FLOW_NORMAL_MULTIPLIER, TIMEOUT_CHECKED_MULTIPLIER};
+    if(mgr)
+    {
+        multipliers.fast = mgr->get("flowFastMultiplier", FLOW_FAST_MULTIPLIER).toDouble();
+        multipliers.normal = mgr->get("flowNormalMultiplier", FLOW_NORMAL_MULTIPLIER).toDouble();
+        multipliers.checked = mgr->get("timeoutCheckedMultiplier", TIMEOUT_CHECKED_MULTIPLIER).toDouble();
+    }
+    if(multipliers.fast <= 0) multipliers.fast = FLOW_FAST_MULTIPLIER;
+    if(multipliers.normal <= 0) multipliers.normal = FLOW_NORMAL_MULTIPLIER;
+    if(multipliers.checked <= 0) multipliers.checked = TIMEOUT_CHECKED_MULTIPLIER;
+    return multipliers;
+}
+
+QString CommandFlow::stageName(Stage stage)
+{
+    switch(stage)
+    {
+        case Command:
+            return QStringLiteral("指令");
+        case Reply:
+            return QStringLiteral("应答");
+        case Return:
+            return QStringLiteral("反馈");
+        case ReReply:
+            return QStringLiteral("反馈应答");
+        default:
+            return QString();
+    }
+}
+
+bool CommandFlow::build(const QString &comname, const QMap<QString, int> &commandIdMap,
+                        const QMap<QString, int> &workIdMap, const QMap<QString, double> &timeMap,
+                        const FlowOptions &options, const Multipliers &multipliers,
+                        const FrameTemplates &templates, CommandFlow &flow, QString &error)
+{
+    if(!commandIdMap.contains(comname))
+    {
+        error = QString("未找到指令: [0x%1]").arg(comname);
+        return false;
+    }
+    flow = CommandFlow();
+    flow.name = comname;
+    int commandId = commandIdMap.value(comname, 0);
+    int workId = workIdMap.value(comname, 0);
+    // 配置中的反馈超时（单位：秒），用于作为默认的反馈超时基础
+    double timei = timeMap.value(comname, 0.0);
+    const int flowMode = options.flowMode;
+    // 勾选框优先：若任一勾选，则仅对被勾选的类型应用延迟；
+    // 若全部未勾选：根据流程模式（快速/正常/手动）计算三种延时
+    bool anyChecked = options.isReplyTimeout || options.isReturnTimeout || options.isReReplyTimeout;
+    bool applyReplyDelay = anyChecked ? options.isReplyTimeout : true;
+    bool applyReturnDelay = anyChecked ? options.isReturnTimeout : true;
+    bool applyReReplyDelay = anyChecked ? options.isReReplyTimeout : true;
+    const double mulFast = multipliers.fast;
+    const double mulNormal = multipliers.normal;
+    const double mulChecked = multipliers.checked;
+
+    // 默认基线（来自常量与配置）
+    const int defaultReplyMs = SHAKE_TIME;
+    const int defaultReturnMs = static_cast<int>(timei * 1000.0);
+    const int defaultReReplyMs = RE_SHAKE_TIME;
+    // 计算（未勾选时）三种延时的实际值：依据流程模式
+    int manualReplyMs = 0;
+    int manualReturnMs = 0;
+    int manualReReplyMs = 0;
+    if(!anyChecked)
+    {
+        if(flowMode == 1) // 快速：默认×mulFast
+        {
+            manualReplyMs   = static_cast<int>(defaultReplyMs   * mulFast);
+            manualReturnMs  = static_cast<int>(defaultReturnMs  * mulFast);
+            manualReReplyMs = static_cast<int>(defaultReReplyMs * mulFast);
+        }
+        else if(flowMode == 2) // 正常：默认×mulNormal
+        {
+            manualReplyMs   = static_cast<int>(defaultReplyMs   * mulNormal);
+            manualReturnMs  = static_cast<int>(defaultReturnMs  * mulNormal);
+            manualReReplyMs = static_cast<int>(defaultReReplyMs * mulNormal);
+        }
+        else // 手动：使用手动毫秒值（无额外倍率）
+        {
+            manualReplyMs   = (options.replyTimeoutMs   > 0) ? options.replyTimeoutMs   : defaultReplyMs;
+            manualReturnMs  = (options.returnTimeoutMs  > 0) ? options.returnTimeoutMs  : defaultReturnMs;
+            manualReReplyMs = (options.reReplyTimeoutMs > 0) ? options.reReplyTimeoutMs : defaultReReplyMs;
+        }
+    }
+
+    flow.delayMs[Reply]   = applyReplyDelay   ? (anyChecked ? static_cast<int>(defaultReplyMs   * mulChecked) : manualReplyMs)   : 0;
+    flow.delayMs[Return]  = applyReturnDelay  ? (anyChecked ? static_cast<int>(defaultReturnMs  * mulChecked) : manualReturnMs)  : 0;
+    flow.delayMs[ReReply] = applyReReplyDelay ? (anyChecked ? static_cast<int>(defaultReReplyMs * mulChecked) : manualReReplyMs) : 0;
+
+    if(anyChecked)
+    {
+        const QString mStr = QStringLiteral("默认×%1").arg(QString::number(mulChecked, 'g', 3));
+        flow.delayModes[Reply]   = options.isReplyTimeout   ? mStr : QStringLiteral("未勾选（不延时）");
+        flow.delayModes[Return]  = options.isReturnTimeout  ? mStr : QStringLiteral("未勾选（不延时）");
+        flow.delayModes[ReReply] = options.isReReplyTimeout ? mStr : QStringLiteral("未勾选（不延时）");
+    }
+    else
+    {
+        const QString fastStr   = QStringLiteral("快速流程（%1×)").arg(QString::number(mulFast, 'g', 3));
+        const QString normalStr = QStringLiteral("正常流程（%1×)").arg(QString::number(mulNormal, 'g', 3));
+        const QString manualStr = QStringLiteral("手动配置（精确）");
+        QString flowModeStr = (flowMode==1) ? fastStr : ((flowMode==2) ? normalStr : manualStr);
+        flow.delayModes[Reply] = flowModeStr;
+        flow.delayModes[Return] = flowModeStr;
+        flow.delayModes[ReReply] = flowModeStr;
+    }
+
+    const FrameTemplates::Entry *entry = templates.find(commandId);
+    if(!entry)
+    {
+        error = QString("未找到主题号: [0x%1]").arg(QString::number(commandId, 16).toUpper());
+        return false;
+    }
+    //指令帧：写入握手标志与指令命令字
+    FrameTemplate::Fields command;
+    command.flags = options.noShake ? 0x80 : 0x00;
+    command.workId = workId;
+    command.crc = !options.comCrc;
+    flow.frames[Command] = entry->command.render(command);
+    //各阶段发送时刻：在上一阶段之后累加该阶段的延时
+    int dueMs = COMMAND_SETTLE_TIME;
+    //命令应答（如果未跳过）：回填指令帧内的主题号
+    if(!options.comReply && !options.noShake)
+    {
+        FrameTemplate::Fields reply;
+        reply.echoTopic = entry->command.topic();
+        reply.crc = !options.replyCrc;
+        dueMs += flow.delayMs[Reply];
+        flow.frames[Reply] = templates.reply().render(reply);
+        flow.dueMs[Reply] = dueMs;
+    }
+    //反馈数据（如果未跳过）
+    if(!options.haveReturn)
+    {
+        if(!entry->feedback.isValid())
+        {
+            //反馈阶段到达时记录错误并结束流程（指令与应答照常发送）
+            flow.returnError = QString("未找到反馈主题号: [0x%1]").arg(QString::number(commandId, 16).toUpper());
+            flow.dueMs[Return] = dueMs;
+            flow.formatFrames();
+            return true;
+        }
+        FrameTemplate::Fields feedback;
+        feedback.workId = workId;
+        feedback.returnErr = options.returnErr;
+        feedback.crc = !options.reCrc;
+        dueMs += flow.delayMs[Return];
+        flow.frames[Return] = entry->feedback.render(feedback);
+        flow.dueMs[Return] = dueMs;
+        //反馈应答（如果未跳过）
+        if(!options.reReply && !options.noShake)
+        {
+            FrameTemplate::Fields reReply;
+            reReply.echoTopic = entry->reReplyTopic;
+            reReply.crc = !options.replyCrc;
+            dueMs += flow.delayMs[ReReply];
+            flow.frames[ReReply] = templates.reply().render(reReply);
+            flow.dueMs[ReReply] = dueMs;
+        }
+    }
+    flow.formatFrames();
+    return true;
+}
+
+void CommandFlow::formatFrames()
+{
+    for(int stage = Command; stage < StageCount; ++stage)
+    {
+        frameText[stage] = frames[stage].isEmpty() ? QString()
+                           : QString::fromLatin1(frames[stage].toHex(' ').toUpper());
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef COMMANDFLOW_H
+#define COMMANDFLOW_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QMetaType>
+#include <QString>
+#include "frametemplate.h"
+
+class ConfigManager;
+
+/**
+ * @brief 指令流程的模拟选项（对应界面上的勾选项与超时设置）
+ */
+struct FlowOptions
+{
+    bool comCrc = false;           ///< 跳过命令 CRC
+    bool reCrc = false;            ///< 跳过反馈 CRC
+    bool comReply = false;         ///< 模拟无应答
+    bool haveReturn = false;       ///< 模拟无反馈
+    bool reReply = false;          ///< 模拟反馈无应答
+    bool replyCrc = false;         ///< 跳过应答 CRC
+    bool returnErr = false;        ///< 模拟反馈错误
+    bool noShake = false;          ///< 模拟不握手
+    bool isReplyTimeout = false;   ///< 模拟应答超时
+    bool isReturnTimeout = false;  ///< 模拟反馈超时
+    bool isReReplyTimeout = false; ///< 模拟反馈应答超时
+    int replyTimeoutMs = 0;        ///< 手动应答延时（毫秒），<=0 使用默认
+    int returnTimeoutMs = 0;       ///< 手动反馈延时（毫秒），<=0 使用配置
+    int reReplyTimeoutMs = 0;      ///< 手动反馈应答延时（毫秒），<=0 使用默认
+    int flowMode = 0;              ///< 流程模式：0=手动精确，1=快速，2=正常
+};
+Q_DECLARE_METATYPE(FlowOptions)
+
+/**
+ * @brief 一次模拟的指令交互：指令、应答、反馈、反馈应答四个阶段
+ * 构建时由帧模板一次性生成各阶段的数据帧及其日志文本，并计算各阶段相对流程开始的发送时刻，
+ * 发送方只需按时刻依次发出，不再在发送过程中组包或休眠。
+ * 同一指令的流程可被任意多个模拟设备共用。
+ */
+struct CommandFlow
+{
+    ///流程阶段
+    enum Stage
+    {
+        Command,    ///< 指令
+        Reply,      ///< 应答
+        Return,     ///< 反馈
+        ReReply,    ///< 反馈应答
+        StageCount
+    };
+
+    ///倍率设置
+    struct Multipliers
+    {
+        double fast;     ///< 快速流程倍率
+        double normal;   ///< 正常流程倍率
+        double checked;  ///< 勾选超时倍率
+
+        ///从配置读取（非法值回退为默认倍率），mgr 为空时使用默认倍率
+        static Multipliers fromConfig(ConfigManager *mgr);
+    };
+
+    QString name;                     ///< 指令显示名称
+    QByteArray frames[StageCount];    ///< 各阶段数据帧（为空表示跳过该阶段）
+    QString frameText[StageCount];    ///< 各阶段数据帧的十六进制文本（日志用）
+    int dueMs[StageCount] = {};       ///< 各阶段相对流程开始的发送时刻（毫秒）
+    int delayMs[StageCount] = {};     ///< 各阶段在上一阶段之后额外等待的延时（日志用）
+    QString returnError;              ///< 反馈帧无法构建时的错误（到达反馈阶段时记录并结束流程）
+    QString delayModes[StageCount];   ///< 各阶段延时来源说明（日志用，指令阶段为空）
+
+    /**
+     * @brief 构建一次指令流程
+     * @param comname 指令显示名称（键）
+     * @param commandIdMap 指令名称到主题号映射
+     * @param workIdMap 指令名称到工作ID映射
+     * @param timeMap 指令名称到反馈超时（秒）映射
+     * @param options 模拟选项
+     * @param multipliers 倍率设置
+     * @param templates 帧模板表
+     * @param flow 输出流程
+     * @param error 失败原因（指令不存在或没有该主题号的帧模板）
+     */
+    static bool build(const QString &comname, const QMap<QString, int> &commandIdMap,
+                      const QMap<QString, int> &workIdMap, const QMap<QString, double> &timeMap,
+                      const FlowOptions &options, const Multipliers &multipliers,
+                      const FrameTemplates &templates, CommandFlow &flow, QString &error);
+
+    ///阶段名称（"指令"/"应答"/"反馈"/"反馈应答"）
+    static QString stageName(Stage stage);
+
+private:
+    ///生成各阶段数据帧的日志文本
+    void formatFrames();
+};
+
+#endif //COMMANDFLOW_H
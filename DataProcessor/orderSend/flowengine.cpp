@@ -0,0 +1,264 @@
+#include "flowengine.h"
+#include <climits>
+
+namespace
+{
+    ///各阶段发送日志
+    const char *const SEND_TEXT[CommandFlow::StageCount] = {"发送指令", "发送应答", "发送反馈", "发送反馈应答"};
+    ///各阶段延时日志
+    const char *const DELAY_TEXT[CommandFlow::StageCount] = {"", "指令应答延时", "反馈延时", "反馈应答延时"};
+    ///多设备运行统计的输出周期（毫秒）
+    const qint64 STATS_INTERVAL_MS = 1000;
+}
+
+FlowEngine::FlowEngine(LogBatcher *log, QObject *parent)
+    : QObject(parent)
+    , m_log(log)
+    , m_socket(new QUdpSocket(this))
+    , m_tick(new QTimer(this))
+{
+    //阶段延时以毫秒计，使用精确定时器避免粗粒度定时器 5% 的误差；每次只等到下一个到期时刻
+    m_tick->setTimerType(Qt::PreciseTimer);
+    m_tick->setSingleShot(true);
+    connect(m_tick, &QTimer::timeout, this, &FlowEngine::onTick);
+}
+
+void FlowEngine::start(const Config &config)
+{
+    if(m_running)
+    {
+        m_tick->stop();
+        m_running = false;
+    }
+    m_stopRequested.store(false);
+    if(config.flows.isEmpty() || config.devices <= 0)
+    {
+        m_log->add("ERROR", "没有可模拟的指令");
+        emit finished();
+        return;
+    }
+    m_config = config;
+    m_address = QHostAddress(config.address);
+    if(!m_clock.isValid())
+    {
+        m_clock.start();
+    }
+    const qint64 now = m_clock.elapsed();
+    m_wheel.reset(now);
+    m_devices = QVector<Device>(config.devices);
+    for(int i = 0; i < config.devices; ++i)
+    {
+        m_devices[i].flow = i % config.flows.size();
+        //错开首次开始时刻，避免所有设备在同一毫秒发出指令
+        const qint64 offset = (config.spread && config.intervalMs > 0)
+                              ? static_cast<qint64>(config.intervalMs) * i / config.devices : 0;
+        m_wheel.schedule(now + offset, static_cast<quint32>(i));
+    }
+    m_activeDevices = config.devices;
+    m_sent = 0;
+    m_failed = 0;
+    m_flowsDone = 0;
+    m_maxLateMs = 0;
+    m_statsSent = 0;
+    m_statsMs = now;
+    m_startedMs = now;
+    m_running = true;
+    if(config.devices > 1)
+    {
+        m_log->add("INFO", QString("开始模拟 %1 台设备，%2 条指令轮流执行，目标 %3:%4，间隔 %5 毫秒")
+                               .arg(config.devices).arg(config.flows.size())
+                               .arg(config.address).arg(config.port).arg(config.intervalMs));
+    }
+    armTimer();
+}
+
+void FlowEngine::requestStop()
+{
+    m_stopRequested.store(true);
+    QMetaObject::invokeMethod(this, "stopNow", Qt::QueuedConnection);
+}
+
+void FlowEngine::stopNow()
+{
+    if(!m_running)
+    {
+        return;
+    }
+    if(m_config.devices > 1)
+    {
+        m_log->add("WARN", "多设备模拟被中断");
+    }
+    else
+    {
+        const CommandFlow::Stage stage = static_cast<CommandFlow::Stage>(m_devices[0].stage);
+        m_log->add("WARN", QString("发送被中断: 等待%1阶段").arg(CommandFlow::stageName(stage)));
+    }
+    finish();
+}
+
+void FlowEngine::onTick()
+{
+    if(m_stopRequested.load())
+    {
+        return;
+    }
+    m_tickMs = m_clock.elapsed();
+    m_wheel.advance(m_tickMs, [this](quint32 device, qint64 dueMs)
+    {
+        runDevice(device, dueMs);
+    });
+    if(m_activeDevices == 0)
+    {
+        finish();
+        return;
+    }
+    if(m_config.devices > 1 && m_tickMs - m_statsMs >= STATS_INTERVAL_MS)
+    {
+        logStats(false);
+    }
+    armTimer();
+}
+
+void FlowEngine::armTimer()
+{
+    const qint64 now = m_clock.elapsed();
+    qint64 next = m_wheel.nextEvent();
+    if(m_config.devices > 1)
+    {
+        const qint64 statsDue = m_statsMs + STATS_INTERVAL_MS;
+        next = next < 0 ? statsDue : qMin(next, statsDue);
+    }
+    if(next < 0)
+    {
+        return;
+    }
+    //已到期时立即唤醒（定时器提前触发时在下一次唤醒中补上）
+    m_tick->start(static_cast<int>(qBound<qint64>(0, next - now, INT_MAX)));
+}
+
+void FlowEngine::runDevice(quint32 device, qint64 dueMs)
+{
+    Device &state = m_devices[device];
+    const CommandFlow &flow = m_config.flows.at(state.flow);
+    qint64 due = dueMs;
+    while(true)
+    {
+        m_maxLateMs = qMax(m_maxLateMs, m_tickMs - due);
+        const CommandFlow::Stage stage = static_cast<CommandFlow::Stage>(state.stage);
+        if(stage == CommandFlow::Command)
+        {
+            //以调度时刻而非实际时刻为基准，唤醒抖动不会累积到后续阶段
+            state.startMs = due;
+        }
+        //反馈帧无法构建：记录错误并结束本轮
+        if(flow.frames[stage].isEmpty())
+        {
+            m_log->add("ERROR", devicePrefix(device) + flow.returnError);
+            completeFlow(device);
+            return;
+        }
+        sendStage(device, flow, stage);
+        int next = state.stage + 1;
+        while(next < CommandFlow::StageCount && flow.frames[next].isEmpty()
+              && !(next == CommandFlow::Return && !flow.returnError.isEmpty()))
+        {
+            ++next;
+        }
+        if(next == CommandFlow::StageCount)
+        {
+            completeFlow(device);
+            return;
+        }
+        state.stage = next;
+        due = state.startMs + flow.dueMs[next];
+        //延时为 0 的阶段在同一时刻直接发出
+        if(due > m_wheel.now())
+        {
+            m_wheel.schedule(due, device);
+            return;
+        }
+    }
+}
+
+void FlowEngine::sendStage(quint32 device, const CommandFlow &flow, CommandFlow::Stage stage)
+{
+    const QByteArray &frame = flow.frames[stage];
+    if(m_log->acceptDetail())
+    {
+        const QString prefix = devicePrefix(device);
+        if(stage != CommandFlow::Command && flow.delayMs[stage] > 0)
+        {
+            m_log->add("DEBUG", prefix + QString("%1[%2]毫秒").arg(QString::fromUtf8(DELAY_TEXT[stage])).arg(flow.delayMs[stage]));
+        }
+        m_log->add("INFO", prefix + QString("%1: [%2]").arg(QString::fromUtf8(SEND_TEXT[stage]))
+                                       .arg(flow.frameText[stage]));
+    }
+    if(m_socket->writeDatagram(frame, m_address, m_config.port) < 0)
+    {
+        ++m_failed;
+        if(m_log->acceptDetail())
+        {
+            m_log->add("ERROR", devicePrefix(device) + QString("发送失败: [%1]").arg(m_socket->errorString()));
+        }
+        return;
+    }
+    ++m_sent;
+}
+
+void FlowEngine::completeFlow(quint32 device)
+{
+    Device &state = m_devices[device];
+    ++m_flowsDone;
+    ++state.rounds;
+    if(m_log->acceptDetail())
+    {
+        m_log->add("INFO", devicePrefix(device) + QString("指令发送完成: [%1]").arg(m_config.flows.at(state.flow).name));
+    }
+    state.stage = CommandFlow::Command;
+    if(m_config.rounds > 0 && state.rounds >= m_config.rounds)
+    {
+        --m_activeDevices;
+        return;
+    }
+    state.flow = (state.flow + 1) % m_config.flows.size();
+    m_wheel.schedule(m_wheel.now() + m_config.intervalMs, device);
+}
+
+void FlowEngine::logStats(bool final)
+{
+    const qint64 now = m_clock.elapsed();
+    if(final)
+    {
+        m_log->add("INFO", QString("模拟结束：%1 台设备，用时 %2 秒，完成流程 %3，发送 %4 包，失败 %5")
+                               .arg(m_config.devices).arg((now - m_startedMs) / 1000.0, 0, 'f', 1)
+                               .arg(m_flowsDone).arg(m_sent).arg(m_failed));
+    }
+    else
+    {
+        const qint64 elapsed = now - m_statsMs;
+        const qint64 rate = elapsed > 0 ? (m_sent - m_statsSent) * 1000 / elapsed : 0;
+        m_log->add("INFO", QString("模拟设备 %1 台（进行中 %2）：完成流程 %3，发送 %4 包（%5 包/秒），失败 %6，最大滞后 %7 毫秒")
+                               .arg(m_config.devices).arg(m_activeDevices).arg(m_flowsDone)
+                               .arg(m_sent).arg(rate).arg(m_failed).arg(m_maxLateMs));
+    }
+    m_statsSent = m_sent;
+    m_statsMs = now;
+    m_maxLateMs = 0;
+}
+
+void FlowEngine::finish()
+{
+    m_tick->stop();
+    m_wheel.reset(m_clock.elapsed());
+    m_running = false;
+    if(m_config.devices > 1)
+    {
+        logStats(true);
+    }
+    emit finished();
+}
+
+QString FlowEngine::devicePrefix(quint32 device) const
+{
+    return m_config.devices > 1 ? QString("设备%1 ").arg(device + 1) : QString();
+}
@@ -0,0 +1,114 @@
+#ifndef FLOWENGINE_H
+#define FLOWENGINE_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <atomic>
+#include "commandflow.h"
+#include "timerwheel.h"
+#include "../log/logbatcher.h"
+
+/**
+ * @brief 事件驱动的指令流程模拟引擎
+ * 在一个线程上同时模拟任意多台设备的指令/应答/反馈/反馈应答交互：
+ * 每台设备下一阶段的发送时刻放入分层时间轮，单次定时器只在时间轮的下一个到期时刻唤醒，
+ * 推进时间轮并发出到期阶段的数据帧；没有到期的阶段时不唤醒。
+ * 所有设备共用一个 UDP 套接字和预先构建好的数据帧，线程在阶段之间不阻塞，停止请求经事件队列立即生效。
+ * 单台设备、单轮即为原来的单次发送；多台设备用于按真实规模对控制端做压力测试。
+ */
+class FlowEngine : public QObject
+{
+    Q_OBJECT
+public:
+    ///运行参数
+    struct Config
+    {
+        QString address;              ///< 目标地址
+        quint16 port = 0;             ///< 目标端口
+        QVector<CommandFlow> flows;   ///< 设备轮流执行的指令流程（设备 i 从第 i % 数量 条开始）
+        int devices = 1;              ///< 模拟设备数
+        int rounds = 1;               ///< 每台设备执行的流程数，0 表示直到停止
+        int intervalMs = 0;           ///< 每台设备一次流程结束到下一次开始的间隔（毫秒）
+        bool spread = false;          ///< 设备的首次开始时刻在一个间隔内均匀错开
+    };
+
+    /**
+     * @param log 日志缓冲（逐包明细经 acceptDetail 折叠）
+     */
+    explicit FlowEngine(LogBatcher *log, QObject *parent = nullptr);
+
+    ///开始模拟（在引擎所在线程调用），已有模拟在运行时先将其停止
+    void start(const Config &config);
+
+    ///请求停止（可在任意线程调用），停止后发出 finished
+    void requestStop();
+
+signals:
+    ///全部设备完成或已停止
+    void finished();
+
+private slots:
+    ///到期：推进时间轮并发出到期阶段，再按下一个到期时刻重新定时
+    void onTick();
+
+    ///在引擎线程内执行停止
+    void stopNow();
+
+private:
+    ///模拟设备状态
+    struct Device
+    {
+        int flow = 0;            ///< 当前流程序号
+        int stage = CommandFlow::Command; ///< 下一个要执行的阶段（Command 表示开始新一轮流程）
+        qint64 startMs = 0;      ///< 当前流程的开始时刻
+        int rounds = 0;          ///< 已完成的流程数
+    };
+
+    ///执行设备到期的阶段，并连续执行此刻已到期的后续阶段
+    void runDevice(quint32 device, qint64 dueMs);
+
+    ///发出设备当前阶段的数据帧
+    void sendStage(quint32 device, const CommandFlow &flow, CommandFlow::Stage stage);
+
+    ///设备当前流程结束：安排下一轮或结束该设备
+    void completeFlow(quint32 device);
+
+    ///输出运行统计（多设备时每秒一次）
+    void logStats(bool final);
+
+    ///结束模拟并发出 finished
+    void finish();
+
+    ///将定时器设到时间轮的下一个到期时刻（多设备时不晚于下一次统计输出）
+    void armTimer();
+
+    ///日志前缀（多设备时为设备号）
+    QString devicePrefix(quint32 device) const;
+
+    LogBatcher *m_log;                ///< 日志缓冲
+    QUdpSocket *m_socket;             ///< 所有设备共用的套接字
+    QTimer *m_tick;                   ///< 下一个到期时刻的单次定时器
+    QElapsedTimer m_clock;            ///< 引擎时钟
+    TimerWheel m_wheel;               ///< 各设备下一阶段的到期时刻
+    Config m_config;                  ///< 当前运行参数
+    QHostAddress m_address;           ///< 目标地址
+    QVector<Device> m_devices;        ///< 模拟设备
+    int m_activeDevices = 0;          ///< 尚未完成的设备数
+    bool m_running = false;           ///< 是否在运行
+    std::atomic<bool> m_stopRequested{false}; ///< 停止请求
+
+    qint64 m_sent = 0;                ///< 已发送数据帧
+    qint64 m_failed = 0;              ///< 发送失败数
+    qint64 m_flowsDone = 0;           ///< 已完成流程数
+    qint64 m_tickMs = 0;              ///< 本次唤醒的时刻
+    qint64 m_maxLateMs = 0;           ///< 统计周期内阶段发送的最大滞后
+    qint64 m_statsSent = 0;           ///< 上次统计时的发送数
+    qint64 m_statsMs = 0;             ///< 上次统计时刻
+    qint64 m_startedMs = 0;           ///< 开始时刻
+};
+
+#endif //FLOWENGINE_H
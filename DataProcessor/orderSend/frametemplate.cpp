@@ -0,0 +1,262 @@
+#include "frametemplate.h"
+#include <cstring>
+#include "tinyxml/tinyxml.h"
+
+#define FRAME_MAX_LENGTH 256 //帧长上限
+#define FRAME_MIN_LENGTH 14  //帧长下限（帧头 + 至少一个数据字节 + 校验和）
+#define REPLY_TOPIC 0x2c24   //应答主题号
+#define REPLY_LENGTH 17      //应答帧长
+
+namespace
+{
+    /**
+     * @brief 编译一个 <command> 或 <return> 描述
+     * @param element 帧描述节点
+     * @param defaultTopic 未配置 topic 时使用的主题号（-1 表示必须配置）
+     */
+    bool compileFrame(const TiXmlElement *element, int defaultTopic, FrameTemplate &frame, QString &error)
+    {
+        int length = 0;
+        if(!FrameTemplates::parseNumber(element->Attribute("length"), length))
+        {
+            error = QStringLiteral("缺少 length");
+            return false;
+        }
+        int topic = defaultTopic;
+        if(element->Attribute("topic") && !FrameTemplates::parseNumber(element->Attribute("topic"), topic))
+        {
+            error = QStringLiteral("topic 无效");
+            return false;
+        }
+        if(topic < 0 || topic > 0xFFFF)
+        {
+            error = QStringLiteral("缺少 topic");
+            return false;
+        }
+        int workIdOffset = -1;
+        if(element->Attribute("workId") && !FrameTemplates::parseNumber(element->Attribute("workId"), workIdOffset))
+        {
+            error = QStringLiteral("workId 无效");
+            return false;
+        }
+        QHash<int, quint8> fixed;
+        for(const TiXmlElement *byte = element->FirstChildElement("byte"); byte; byte = byte->NextSiblingElement("byte"))
+        {
+            int offset = 0;
+            int value = 0;
+            if(!FrameTemplates::parseNumber(byte->Attribute("offset"), offset)
+               || !FrameTemplates::parseNumber(byte->Attribute("value"), value) || value < 0 || value > 0xFF)
+            {
+                error = QString("第 %1 行 byte 无效").arg(byte->Row());
+                return false;
+            }
+            fixed.insert(offset, static_cast<quint8>(value));
+        }
+        QVector<FrameTemplate::Status> status;
+        for(const TiXmlElement *item = element->FirstChildElement("status"); item; item = item->NextSiblingElement("status"))
+        {
+            int offset = 0;
+            int ok = 0;
+            int err = 0;
+            if(!FrameTemplates::parseNumber(item->Attribute("offset"), offset)
+               || !FrameTemplates::parseNumber(item->Attribute("ok"), ok) || ok < 0 || ok > 0xFF
+               || !FrameTemplates::parseNumber(item->Attribute("err"), err) || err < 0 || err > 0xFF)
+            {
+                error = QString("第 %1 行 status 无效").arg(item->Row());
+                return false;
+            }
+            status.append(FrameTemplate::Status{offset, static_cast<quint8>(ok), static_cast<quint8>(err)});
+        }
+        return frame.build(length, static_cast<quint16>(topic), fixed, workIdOffset, -1, status, error);
+    }
+}
+
+bool FrameTemplate::build(int length, quint16 topic, const QHash<int, quint8> &fixed, int workIdOffset,
+                          int echoOffset, const QVector<Status> &status, QString &error)
+{
+    m_bytes.clear();
+    if(length < FRAME_MIN_LENGTH || length > FRAME_MAX_LENGTH)
+    {
+        error = QString("帧长 %1 超出范围 %2~%3").arg(length).arg(FRAME_MIN_LENGTH).arg(FRAME_MAX_LENGTH);
+        return false;
+    }
+    //第 0 字节为握手标志，第 1、3、4 字节为帧长与主题号，末两字节为校验和，均不可配置；
+    //第 5 字节缺省为 0x11，只能由固定字节覆盖
+    QVector<bool> used(length, false);
+    used[0] = used[1] = used[3] = used[4] = used[5] = true;
+    used[length - 2] = used[length - 1] = true;
+    auto claim = [&](int offset, const char *name) -> bool {
+        if(offset < 0 || offset >= length || used[offset])
+        {
+            error = QString("%1 偏移 %2 越界或与其他字段重叠").arg(QString::fromUtf8(name)).arg(offset);
+            return false;
+        }
+        used[offset] = true;
+        return true;
+    };
+    if(workIdOffset >= 0 && !(claim(workIdOffset, "workId") && claim(workIdOffset + 1, "workId")))
+    {
+        return false;
+    }
+    if(echoOffset >= 0 && !(claim(echoOffset, "回填主题号") && claim(echoOffset + 1, "回填主题号")))
+    {
+        return false;
+    }
+    for(const Status &item : status)
+    {
+        if(!claim(item.offset, "status"))
+        {
+            return false;
+        }
+    }
+    QByteArray bytes(length, '\0');
+    uchar *data = reinterpret_cast<uchar *>(bytes.data());
+    data[1] = static_cast<uchar>(length - 13);
+    data[3] = static_cast<uchar>(topic & 0xFF);
+    data[4] = static_cast<uchar>(topic >> 8);
+    data[5] = 0x11;
+    for(auto it = fixed.constBegin(); it != fixed.constEnd(); ++it)
+    {
+        if(it.key() != 5 && !claim(it.key(), "byte"))
+        {
+            return false;
+        }
+        data[it.key()] = it.value();
+    }
+    m_sum = 0;
+    for(int i = 0; i < length - 2; ++i)
+    {
+        m_sum += data[i];
+    }
+    m_bytes = bytes;
+    m_topic = topic;
+    m_workIdOffset = workIdOffset;
+    m_echoOffset = echoOffset;
+    m_status = status;
+    return true;
+}
+
+QByteArray FrameTemplate::render(const Fields &fields) const
+{
+    const int length = m_bytes.size();
+    QByteArray frame(length, Qt::Uninitialized);
+    uchar *data = reinterpret_cast<uchar *>(frame.data());
+    std::memcpy(data, m_bytes.constData(), static_cast<size_t>(length));
+    //可变字段在模板中为 0，写入后把取值累加到模板字节和上
+    quint32 sum = m_sum;
+    auto put = [&](int offset, quint8 value) {
+        data[offset] = value;
+        sum += value;
+    };
+    put(0, fields.flags);
+    if(m_workIdOffset >= 0)
+    {
+        put(m_workIdOffset, static_cast<quint8>(fields.workId & 0xFF));
+        put(m_workIdOffset + 1, static_cast<quint8>((fields.workId >> 8) & 0xFF));
+    }
+    if(m_echoOffset >= 0)
+    {
+        put(m_echoOffset, static_cast<quint8>(fields.echoTopic & 0xFF));
+        put(m_echoOffset + 1, static_cast<quint8>(fields.echoTopic >> 8));
+    }
+    for(const Status &item : m_status)
+    {
+        put(item.offset, fields.returnErr ? item.err : item.ok);
+    }
+    if(fields.crc)
+    {
+        const int calCrc = (sum ^ (sum >> 16)) & 0xffff;
+        data[length - 2] = calCrc & 0xff;
+        data[length - 1] = (calCrc >> 8) & 0xff;
+    }
+    return frame;
+}
+
+FrameTemplates::FrameTemplates()
+{
+    //应答帧：回填被应答的主题号，第 13 字节为成功标志
+    QHash<int, quint8> fixed;
+    fixed.insert(13, 1);
+    QString error;
+    m_reply.build(REPLY_LENGTH, REPLY_TOPIC, fixed, -1, 11, QVector<FrameTemplate::Status>(), error);
+}
+
+int FrameTemplates::load(const TiXmlElement *root, QStringList &warnings)
+{
+    m_entries.clear();
+    const TiXmlElement *frames = root ? root->FirstChildElement("frames") : nullptr;
+    if(!frames)
+    {
+        return 0;
+    }
+    for(const TiXmlElement *frame = frames->FirstChildElement("frame"); frame; frame = frame->NextSiblingElement("frame"))
+    {
+        int id = 0;
+        if(!parseNumber(frame->Attribute("id"), id) || id < 0)
+        {
+            warnings << QString("第 %1 行帧描述缺少有效的 id，已跳过").arg(frame->Row());
+            continue;
+        }
+        Entry entry;
+        QString error;
+        const TiXmlElement *command = frame->FirstChildElement("command");
+        if(!command)
+        {
+            warnings << QString("主题号 %1 缺少指令帧描述，已跳过").arg(id);
+            continue;
+        }
+        if(!compileFrame(command, id, entry.command, error))
+        {
+            warnings << QString("主题号 %1 的指令帧无效: %2，已跳过").arg(id).arg(error);
+            continue;
+        }
+        //反馈帧无效时仍可发送指令与应答，到反馈阶段报错
+        const TiXmlElement *feedback = frame->FirstChildElement("return");
+        if(feedback)
+        {
+            if(!compileFrame(feedback, -1, entry.feedback, error))
+            {
+                warnings << QString("主题号 %1 的反馈帧无效: %2").arg(id).arg(error);
+            }
+            int reReplyTopic = 0;
+            entry.reReplyTopic = parseNumber(feedback->Attribute("reReplyTopic"), reReplyTopic)
+                                 ? static_cast<quint16>(reReplyTopic) : entry.feedback.topic();
+        }
+        if(m_entries.contains(id))
+        {
+            warnings << QString("主题号 %1 的帧描述重复，使用第 %2 行").arg(id).arg(frame->Row());
+        }
+        m_entries.insert(id, entry);
+    }
+    return m_entries.size();
+}
+
+const FrameTemplates::Entry *FrameTemplates::find(int id) const
+{
+    auto it = m_entries.constFind(id);
+    return it == m_entries.constEnd() ? nullptr : &it.value();
+}
+
+bool FrameTemplates::parseNumber(const char *text, int &value)
+{
+    if(!text)
+    {
+        return false;
+    }
+    //与任务配置相同：支持 0x/x 前缀的十六进制和十进制
+    QString temps = QString::fromLatin1(text).trimmed();
+    int base = 10;
+    if(temps.startsWith("0x", Qt::CaseInsensitive))
+    {
+        temps = temps.mid(2);
+        base = 16;
+    }
+    else if(temps.startsWith("x", Qt::CaseInsensitive))
+    {
+        temps = temps.mid(1);
+        base = 16;
+    }
+    bool ok = false;
+    value = temps.toInt(&ok, base);
+    return ok;
+}
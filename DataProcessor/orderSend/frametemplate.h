@@ -0,0 +1,109 @@
+#ifndef FRAMETEMPLATE_H
+#define FRAMETEMPLATE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+class TiXmlElement;
+
+/**
+ * @brief 预编译的数据帧模板
+ * 帧头（长度、主题号、0x11）与固定字节在加载时写好，可变字段（握手标志、指令命令字、反馈状态）置 0，
+ * 同时记下除校验和以外所有字节之和。生成帧时只需拷贝模板、写入可变字段，
+ * 校验和按可变字段的取值在模板和上增量计算，不再逐字节组包与求和。
+ */
+class FrameTemplate
+{
+public:
+    ///反馈状态字节
+    struct Status
+    {
+        int offset;   ///< 偏移
+        quint8 ok;    ///< 正常时的取值
+        quint8 err;   ///< 模拟反馈错误时的取值
+    };
+
+    ///可变字段取值
+    struct Fields
+    {
+        quint8 flags = 0;       ///< 第 0 字节（不握手时为 0x80）
+        int workId = 0;         ///< 指令命令字（模板含 workId 偏移时写入）
+        quint16 echoTopic = 0;  ///< 回填主题号（应答帧写入被应答的主题号）
+        bool returnErr = false; ///< 状态字节取错误值
+        bool crc = true;        ///< 是否写入校验和（false 时末两字节为 0）
+    };
+
+    /**
+     * @brief 构建模板
+     * @param length 帧长
+     * @param topic 帧内主题号
+     * @param fixed 固定字节（偏移 -> 取值）
+     * @param workIdOffset 指令命令字偏移（-1 表示无）
+     * @param echoOffset 回填主题号偏移（-1 表示无）
+     * @param status 反馈状态字节
+     * @param error 偏移越界时的原因
+     */
+    bool build(int length, quint16 topic, const QHash<int, quint8> &fixed, int workIdOffset,
+               int echoOffset, const QVector<Status> &status, QString &error);
+
+    ///生成一帧
+    QByteArray render(const Fields &fields) const;
+
+    ///帧内主题号
+    quint16 topic() const { return m_topic; }
+
+    ///是否已构建
+    bool isValid() const { return !m_bytes.isEmpty(); }
+
+private:
+    QByteArray m_bytes;        ///< 模板字节（可变字段与校验和为 0）
+    quint32 m_sum = 0;         ///< 除校验和以外的字节和
+    quint16 m_topic = 0;       ///< 帧内主题号
+    int m_workIdOffset = -1;   ///< 指令命令字偏移
+    int m_echoOffset = -1;     ///< 回填主题号偏移
+    QVector<Status> m_status;  ///< 反馈状态字节
+};
+
+/**
+ * @brief 指令帧模板表
+ * 从指令配置 XML 的 <frames> 节加载，每个主题号编译一次指令帧与反馈帧模板，加载后只读，可跨线程共享。
+ * 应答与反馈应答的格式对所有指令相同，由内置模板生成。
+ */
+class FrameTemplates
+{
+public:
+    ///一个主题号的帧模板
+    struct Entry
+    {
+        FrameTemplate command;      ///< 指令帧
+        FrameTemplate feedback;     ///< 反馈帧（未配置时无效）
+        quint16 reReplyTopic = 0;   ///< 反馈应答回填的主题号
+    };
+
+    FrameTemplates();
+
+    /**
+     * @brief 编译配置根节点下 <frames> 中的全部帧描述
+     * @param root 配置根节点
+     * @param warnings 被跳过的描述及原因
+     * @return 编译成功的主题号数
+     */
+    int load(const TiXmlElement *root, QStringList &warnings);
+
+    ///查找主题号对应的模板，不存在时返回 nullptr
+    const Entry *find(int id) const;
+
+    ///应答帧（含反馈应答）模板
+    const FrameTemplate &reply() const { return m_reply; }
+
+    ///解析十进制或 0x/x 前缀的十六进制数
+    static bool parseNumber(const char *text, int &value);
+
+private:
+    QHash<int, Entry> m_entries;  ///< 主题号 -> 模板
+    FrameTemplate m_reply;        ///< 应答帧模板
+};
+
+#endif //FRAMETEMPLATE_H
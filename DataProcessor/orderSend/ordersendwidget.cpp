@@ -64,10 +64,15 @@ OrderSendWidget::OrderSendWidget(QWidget *parent) :
     m_sendWorker = new SendWorker();
     // 注入共享配置管理器，确保发送线程读取到最新倍率
     m_sendWorker->setConfigManager(m_flowConfig);
+    m_sendWorker->setFrameTemplates(&m_frames);
     m_sendWorker->moveToThread(m_sendThread);
-    connect(m_sendWorker, &SendWorker::logMessage, this, &OrderSendWidget::handleLogMessage);
+    //发送线程日志按 20Hz 批量取出
+    m_logFlushTimer.setInterval(50);
+    connect(&m_logFlushTimer, &QTimer::timeout, this, &OrderSendWidget::flushWorkerLogs);
+    m_logFlushTimer.start();
     connect(m_sendWorker, &SendWorker::finished, this, &OrderSendWidget::handleSendFinished);
     connect(this, &OrderSendWidget::startSendCommand, m_sendWorker, &SendWorker::sendCommand);
+    connect(this, &OrderSendWidget::startFleet, m_sendWorker, &SendWorker::simulateFleet);
     ThreadManager::instance().registerThread(m_sendThread, "OrderSendThread", [this]()
     {
         if (m_sendWorker)
@@ -154,7 +159,22 @@ void OrderSendWidget::filterComboBoxItems(const QString &filterText)
 
 void OrderSendWidget::handleSendFinished()
 {
+    if(m_fleetRunning)
+    {
+        m_fleetRunning = false;
+        flushWorkerLogs();
+        ui->pushButtonStop->setEnabled(false);
+        ui->pushButton->setEnabled(true);
+        ui->btnLoopSingle->setEnabled(true);
+        ui->btnFleet->setEnabled(true);
+        ui->pushButtonstart->setEnabled(true);
+        setUILockedForSending(false);
+        emit logMessage("DEBUG", "多设备模拟已停止");
+        return;
+    }
     ui->pushButtonstart->setEnabled(true);
+    //先输出发送线程尚未取出的日志，保持顺序
+    flushWorkerLogs();
     emit logMessage("DEBUG", "指令发送完成");
     emit logMessage("DEBUG", "**********************************************************");
     // 恢复 UI 超时编辑框为默认值，确保本次修改不影响后续发送
@@ -168,6 +188,7 @@ void OrderSendWidget::handleSendFinished()
     else
     {
         // 单次发送结束，解锁界面
+        ui->btnFleet->setEnabled(true);
         setUILockedForSending(false);
     }
 }
@@ -183,6 +204,33 @@ void OrderSendWidget::handleLogMessage(QString level, QString message)
     appendLogToView(html);
 }
 
+void OrderSendWidget::flushWorkerLogs()
+{
+    if(!m_sendWorker)
+    {
+        return;
+    }
+    const QVector<LogBatcher::Line> lines = m_sendWorker->logBatcher()->take();
+    if(lines.isEmpty())
+    {
+        return;
+    }
+    //一批日志只移动一次光标、滚动一次
+    QTextCursor cursor(ui->textEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    for(const LogBatcher::Line &line : lines)
+    {
+        const QString level = LogStore::levelName(line.level);
+        cursor.insertHtml(QString("<div style='color:%1'>[%2] [%3] %4</div>")
+                          .arg(colorForLevel(level).name(),
+                               QDateTime::fromMSecsSinceEpoch(line.timeMs).toString(dt_format),
+                               level,
+                               line.render().toHtmlEscaped()));
+        cursor.insertBlock();
+    }
+    ui->textEdit->ensureCursorVisible();
+}
+
 /**
  * @brief 根据日志级别获取颜色
  * @param level 日志级别
@@ -242,15 +290,17 @@ void OrderSendWidget::getconfig()
     }
     //构建配置文件路径（跨平台兼容）
     QString configPath = QDir::cleanPath(parentDir.absolutePath() + QDir::separator() + "config" + QDir::separator() + "sibugz_config.xml");
-    TiXmlDocument* treeDoc = new TiXmlDocument();
+    //配置只读一遍：文档建在 arena 上，函数返回时整棵树一次释放
+    TiXmlDocument treeDoc;
+    treeDoc.SetUseArena(true);
     //加载XML文件
-    if(!treeDoc->LoadFile(configPath.toStdString().c_str()))
+    if(!treeDoc.LoadFile(configPath.toStdString().c_str()))
     {
         qCritical() << "MainWindow::getconfig()::配置文件加载失败：" << configPath;
         return;
     }
     //获取根节点
-    TiXmlElement* root = treeDoc->RootElement();
+    TiXmlElement* root = treeDoc.RootElement();
     //遍历一级子节点（task节点）
     for(TiXmlElement *elem = root->FirstChildElement(); elem != NULL; elem = elem->NextSiblingElement())
     {
@@ -328,7 +378,23 @@ void OrderSendWidget::getconfig()
             m_workId.insert(QString("【0x%1】%2").arg(QString::number(id, 16).toUpper()).arg(name), comid);
         }
     }
-    delete treeDoc; //释放XML文档内存
+    //编译 <frames> 中的帧描述，发送时只按模板生成数据帧
+    QStringList warnings;
+    const int frameCount = m_frames.load(root, warnings);
+    for(const QString &warning : warnings)
+    {
+        qCWarning(OrderSendLog) << "帧描述:" << warning;
+        handleLogMessage("WARN", QString("帧描述被跳过：%1").arg(warning));
+    }
+    if(frameCount == 0)
+    {
+        //没有帧模板时所有指令都无法发送，必须让用户看到
+        qCWarning(OrderSendLog) << "配置文件中没有可用的帧描述:" << configPath;
+        handleLogMessage("ERROR", QString("配置文件中没有可用的帧描述（<frames>）：%1").arg(configPath));
+        QMessageBox::warning(this, "错误",
+                             QString("配置文件中没有可用的帧描述（<frames>），指令将无法发送。\n"
+                                     "请在配置文件中补充 <frames> 节：%1").arg(configPath));
+    }
 }
 
 /**
@@ -412,6 +478,7 @@ OrderSendWidget::~OrderSendWidget()
         m_sendThread->quit();
         m_sendThread->wait();
     }
+    m_logFlushTimer.stop();
     delete m_sendWorker;
     delete ui;
 }
@@ -439,28 +506,70 @@ void OrderSendWidget::setUILockedForSending(bool locked)
     {
         ui->spinLoopInterval->setEnabled(!locked);
     }
+    ui->spinDeviceCount->setEnabled(!locked);
     // 编辑框根据当前逻辑或锁定状态刷新
     updateTimeoutEditEnableState();
 }
 
 /**
- * @brief 开始发送按钮点击处理函数
+ * @brief 读取并校验目标地址与端口
  */
-void OrderSendWidget::on_pushButtonstart_clicked()
+bool OrderSendWidget::readTarget(QString &address, quint16 &port)
 {
-    QString address = ui->lineEditIP->text();
-    quint16 port = static_cast<quint16>(ui->lineEditPort->text().toUInt());
+    address = ui->lineEditIP->text();
+    port = static_cast<quint16>(ui->lineEditPort->text().toUInt());
     //验证IP地址格式
     QHostAddress addressCheck;
     if(!addressCheck.setAddress(address))
     {
         QMessageBox::warning(this, "错误", "无效的IP地址格式");
-        return;
+        return false;
     }
     //验证端口范围
     if(port < 1 || port > 65535)
     {
         QMessageBox::warning(this, "错误", "端口号必须为1-65535");
+        return false;
+    }
+    return true;
+}
+
+FlowOptions OrderSendWidget::currentFlowOptions() const
+{
+    // 手动超时为空或无效时按 0 处理，由各指令的默认值补齐
+    auto toMs = [](const QString &text) -> int {
+        bool ok = false;
+        int v = text.trimmed().toInt(&ok);
+        return (ok && v > 0) ? v : 0;
+    };
+    FlowOptions options;
+    options.comCrc = ui->noCRC->isChecked();
+    options.reCrc = ui->reNOCRC->isChecked();
+    options.comReply = ui->noreplay->isChecked();
+    options.haveReturn = ui->noreturn->isChecked();
+    options.reReply = ui->noReturnReply->isChecked();
+    options.replyCrc = ui->replyNOCRC->isChecked();
+    options.returnErr = ui->ReERR->isChecked();
+    options.noShake = ui->noShake->isChecked();
+    options.isReplyTimeout = ui->isReplyTimeout->isChecked();
+    options.isReturnTimeout = ui->isReturnTimeout->isChecked();
+    options.isReReplyTimeout = ui->isReReplyTimeout->isChecked();
+    options.replyTimeoutMs = toMs(ui->lineEdit_yingda->text());
+    options.returnTimeoutMs = toMs(ui->lineEdit_fankui->text());
+    options.reReplyTimeoutMs = toMs(ui->lineEdit_fankuiyingda->text());
+    options.flowMode = ui->radioFlowFast->isChecked() ? 1 : (ui->radioFlowNormal->isChecked() ? 2 : 0);
+    return options;
+}
+
+/**
+ * @brief 开始发送按钮点击处理函数
+ */
+void OrderSendWidget::on_pushButtonstart_clicked()
+{
+    QString address;
+    quint16 port = 0;
+    if(!readTarget(address, port))
+    {
         return;
     }
     if(ui->comboBox->count() == 0)
@@ -524,6 +633,7 @@ void OrderSendWidget::on_pushButtonstart_clicked()
     }
     //禁用按钮防止重复点击
     ui->pushButtonstart->setEnabled(false);
+    ui->btnFleet->setEnabled(false);
     emit logMessage("DEBUG", "**********************************************************");
     emit logMessage("DEBUG", QString("执行单次发送指令：[%1]").arg(comname));
     emit logMessage("DEBUG", QString("本次使用超时(ms)：应答=%1，反馈=%2，反馈应答=%3")
@@ -620,6 +730,7 @@ void OrderSendWidget::on_pushButton_clicked()
     ui->pushButtonStop->setEnabled(true);
     ui->pushButton->setEnabled(false);
     ui->btnLoopSingle->setEnabled(false);
+    ui->btnFleet->setEnabled(false);
     ui->pushButtonstart->setEnabled(false);
     m_loopRunning = true;
     m_isSingleLoopMode = false;
@@ -638,6 +749,7 @@ void OrderSendWidget::sendNextLoopCommand()
         ui->pushButtonStop->setEnabled(false);
         ui->pushButton->setEnabled(true);
         ui->btnLoopSingle->setEnabled(true);
+        ui->btnFleet->setEnabled(true);
         ui->pushButtonstart->setEnabled(true);
         // 解锁界面
         setUILockedForSending(false);
@@ -683,10 +795,19 @@ void OrderSendWidget::on_pushButtonClearLog_clicked()
  */
 void OrderSendWidget::on_pushButtonStop_clicked()
 {
+    //多设备模拟：停止后由 handleSendFinished 恢复界面
+    if(m_fleetRunning)
+    {
+        ui->pushButtonStop->setEnabled(false);
+        m_sendWorker->requestStop();
+        emit logMessage("DEBUG", "点击停止按钮，多设备模拟停止中");
+        return;
+    }
     m_loopRunning = false; //停止循环
     ui->pushButtonStop->setEnabled(false);
     ui->pushButton->setEnabled(true);
     ui->btnLoopSingle->setEnabled(true);
+    ui->btnFleet->setEnabled(true);
     ui->pushButtonstart->setEnabled(true);
     // 停止后解锁界面
     setUILockedForSending(false);
@@ -702,6 +823,7 @@ void OrderSendWidget::on_btnLoopSingle_clicked()
     ui->pushButtonStop->setEnabled(true);
     ui->pushButton->setEnabled(false);
     ui->btnLoopSingle->setEnabled(false);
+    ui->btnFleet->setEnabled(false);
     ui->pushButtonstart->setEnabled(false);
     m_loopRunning = true;
     m_isSingleLoopMode = true;
@@ -710,3 +832,41 @@ void OrderSendWidget::on_btnLoopSingle_clicked()
     on_pushButtonstart_clicked(); //开始第一次发送
 }
 
+/**
+ * @brief 多设备模拟按钮点击处理
+ *        列表中的指令一次性构建后交给发送线程，各设备轮流执行，直到点击停止
+ */
+void OrderSendWidget::on_btnFleet_clicked()
+{
+    QString address;
+    quint16 port = 0;
+    if(!readTarget(address, port))
+    {
+        return;
+    }
+    if(ui->comboBox->count() == 0)
+    {
+        QMessageBox::warning(this, "错误", "未加载到指令信息");
+        return;
+    }
+    //使用下拉框当前显示的指令（受搜索框过滤）
+    QStringList comnames;
+    for(int i = 0; i < ui->comboBox->count(); ++i)
+    {
+        comnames.append(ui->comboBox->itemText(i));
+    }
+    const int devices = ui->spinDeviceCount->value();
+    const int interval = ui->spinLoopInterval->value();
+    ui->pushButtonStop->setEnabled(true);
+    ui->pushButton->setEnabled(false);
+    ui->btnLoopSingle->setEnabled(false);
+    ui->btnFleet->setEnabled(false);
+    ui->pushButtonstart->setEnabled(false);
+    m_fleetRunning = true;
+    setUILockedForSending(true);
+    emit logMessage("DEBUG", "**********************************************************");
+    emit logMessage("DEBUG", QString("多设备模拟开始：%1 台设备，%2 条指令，循环间隔 %3 毫秒，在点击停止按钮前持续发送")
+                                 .arg(devices).arg(comnames.size()).arg(interval));
+    emit startFleet(address, port, comnames, m_commandId, m_workId, m_time,
+                    currentFlowOptions(), devices, interval);
+}
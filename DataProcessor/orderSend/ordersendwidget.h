@@ -11,6 +11,7 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QMetaType>
 #include <QSpinBox>
+#include <QTimer>
 
 #include "tinyxml/tinyxml.h"
 #include "sendworker.h"
@@ -49,9 +50,11 @@ private slots:
     void on_pushButton_clicked();            ///<循环发送按钮点击事件
     void on_pushButtonStop_clicked();        ///<停止循环发送按钮点击事件
     void on_btnLoopSingle_clicked();         ///<单个循环发送按钮点击事件
+    void on_btnFleet_clicked();              ///<多设备模拟按钮点击事件
 
     void handleSendFinished();
     void handleLogMessage(QString level, QString message);
+    void flushWorkerLogs();                  ///<取出发送线程缓冲的日志
     void sendNextLoopCommand();
 
     void filterComboBoxItems(const QString &filterText);
@@ -73,6 +76,10 @@ signals:
                           bool isReplyTimeout, bool isReturnTimeout, bool isReReplyTimeout,
                           int replyTimeoutMs, int returnTimeoutMs, int reReplyTimeoutMs,
                           int flowMode);
+    void startFleet(const QString &address, quint16 port, const QStringList &comnames,
+                    const QMap<QString, int>& commandIdMap, const QMap<QString, int>& workIdMap,
+                    const QMap<QString, double>& timeMap, const FlowOptions &options,
+                    int devices, int intervalMs);
 
 private:
     QThread* m_sendThread;
@@ -83,6 +90,8 @@ private:
     double m_mulChecked;          ///< 当前勾选超时倍率
     
     bool m_isSingleLoopMode;      ///< 是否为单指令循环模式
+    bool m_fleetRunning = false;  ///< 是否正在进行多设备模拟
+    FrameTemplates m_frames;      ///< 指令帧模板（getconfig 加载，发送线程只读）
 
 private:
     Ui::OrderSendWidget* ui;             ///<UI指针
@@ -114,6 +123,15 @@ private:
      */
     void setUILockedForSending(bool locked);
 
+    /**
+     * @brief 读取并校验目标地址与端口，无效时弹出提示
+     * @return 地址与端口均有效时返回 true
+     */
+    bool readTarget(QString &address, quint16 &port);
+
+    ///按界面勾选项与超时设置生成模拟选项
+    FlowOptions currentFlowOptions() const;
+
 private:
 
     //配置数据存储容器
@@ -129,6 +147,7 @@ private:
     void appendLogToView(const QString &html);
     QColor colorForLevel(const QString &level) const;
     ThemeColors m_logColors; //日志颜色配置
+    QTimer m_logFlushTimer;  //发送线程日志批量刷新定时器
 
     bool m_uiLocked;                ///<发送期间界面锁定标志
 };
@@ -3,13 +3,18 @@
 #define SENDWORKER_H
 
 #include <QObject>
-#include <QUdpSocket>
-#include <QHostAddress>
 #include <QThread>
 #include <QDebug>
-#include <atomic>
+#include <QStringList>
 #include "../configmanager.h"
+#include "../log/logbatcher.h"
+#include "commandflow.h"
+#include "flowengine.h"
 
+/**
+ * @brief 指令发送线程对象
+ * 将界面参数构建为指令流程后交给事件驱动的 FlowEngine 执行，线程在各阶段之间不阻塞。
+ */
 class SendWorker : public QObject
 {
     Q_OBJECT
@@ -23,8 +28,18 @@ public:
      */
     void setConfigManager(ConfigManager* mgr);
 
+    /**
+     * @brief 注入帧模板表
+     * @param templates 由界面加载并持有的模板表（加载后只读）
+     */
+    void setFrameTemplates(const FrameTemplates *templates);
+
+    ///停止正在执行的单次发送或多设备模拟（可在任意线程调用）
     void requestStop();
 
+    ///日志缓冲（界面线程定时取出）
+    LogBatcher *logBatcher() { return &m_log; }
+
 public slots:
     /**
      * @brief 发送命令主流程
@@ -59,16 +74,34 @@ public slots:
                      int replyTimeoutMs, int returnTimeoutMs, int reReplyTimeoutMs,
                      int flowMode);
 
+    /**
+     * @brief 多设备并发模拟，直到 requestStop
+     * @param address 目标地址
+     * @param port 目标端口
+     * @param comnames 设备轮流执行的指令（设备 i 从第 i 条开始）
+     * @param commandIdMap 指令名称到主题号映射
+     * @param workIdMap 指令名称到工作ID映射
+     * @param timeMap 指令名称到反馈超时（秒）映射
+     * @param options 模拟选项（所有设备相同）
+     * @param devices 模拟设备数
+     * @param intervalMs 每台设备一次流程结束到下一次开始的间隔（毫秒）
+     */
+    void simulateFleet(const QString &address, quint16 port, const QStringList &comnames,
+                       const QMap<QString, int>& commandIdMap, const QMap<QString, int>& workIdMap,
+                       const QMap<QString, double>& timeMap, const FlowOptions &options,
+                       int devices, int intervalMs);
+
 signals:
-    void logMessage(QString level, QString message);
     void finished();
 
 private:
-    QUdpSocket* m_sender;
+    ///当前使用的帧模板表
+    const FrameTemplates &frameTemplates() const;
+
     ConfigManager* m_configMgr = nullptr;  ///< 共享配置管理器（由外部注入）
-    void crcData(unsigned char* data, int len);
-    std::atomic<bool> m_stopRequested{false};
-    bool sleepInterruptible(int ms);
+    const FrameTemplates *m_templates = nullptr;  ///< 帧模板表（由外部注入）
+    LogBatcher m_log;                      ///< 日志缓冲，避免每条日志一次跨线程事件
+    FlowEngine *m_engine;                  ///< 流程模拟引擎（与本对象同一线程）
 };
 
 #endif //SENDWORKER_H
@@ -0,0 +1,166 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(qint64 nowMs)
+    : m_heads(EXPIRING + 1, -1)
+    , m_tails(EXPIRING + 1, -1)
+    , m_now(nowMs)
+{
+}
+
+void TimerWheel::reset(qint64 nowMs)
+{
+    m_nodes.clear();
+    m_heads.fill(-1);
+    m_tails.fill(-1);
+    m_free = -1;
+    m_count = 0;
+    m_now = nowMs;
+}
+
+TimerWheel::Handle TimerWheel::schedule(qint64 dueMs, quint32 payload)
+{
+    int index = m_free;
+    if(index >= 0)
+    {
+        m_free = m_nodes[index].next;
+    }
+    else
+    {
+        index = m_nodes.size();
+        m_nodes.append(Node());
+    }
+    Node &node = m_nodes[index];
+    node.due = dueMs;
+    node.payload = payload;
+    place(index, m_now + 1);
+    ++m_count;
+    return (static_cast<qint64>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(Handle handle)
+{
+    if(handle < 0)
+    {
+        return false;
+    }
+    const int index = static_cast<int>(handle & 0xFFFFFFFF);
+    const quint32 generation = static_cast<quint32>(handle >> 32);
+    if(index >= m_nodes.size() || m_nodes[index].list < 0 || m_nodes[index].generation != generation)
+    {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+qint64 TimerWheel::nextEvent() const
+{
+    if(m_count == 0)
+    {
+        return -1;
+    }
+    qint64 next = -1;
+    for(int level = 0; level < LEVELS; ++level)
+    {
+        //第 level 层的第 k 个后续槽位在 ((m_now >> shift) + k) << shift 时刻到期（最低层）或下沉（上层）
+        const int shift = level * SLOT_BITS;
+        const qint64 base = m_now >> shift;
+        for(int k = 1; k <= SLOTS; ++k)
+        {
+            if(m_heads[level * SLOTS + static_cast<int>((base + k) & SLOT_MASK)] >= 0)
+            {
+                const qint64 due = (base + k) << shift;
+                next = next < 0 ? due : qMin(next, due);
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+void TimerWheel::place(int index, qint64 earliest)
+{
+    qint64 target = qMax(m_nodes[index].due, earliest);
+    qint64 delta = target - m_now;
+    int level = 0;
+    while(level < LEVELS && delta >= (Q_INT64_C(1) << ((level + 1) * SLOT_BITS)))
+    {
+        ++level;
+    }
+    //超出时间轮范围：先放在最高层的最远槽位，到期时重新放置
+    if(level == LEVELS)
+    {
+        level = LEVELS - 1;
+        target = m_now + (Q_INT64_C(1) << (LEVELS * SLOT_BITS)) - 1;
+    }
+    const int slot = static_cast<int>((target >> (level * SLOT_BITS)) & SLOT_MASK);
+    link(level * SLOTS + slot, index);
+}
+
+void TimerWheel::link(int list, int index)
+{
+    Node &node = m_nodes[index];
+    node.list = list;
+    node.prev = m_tails[list];
+    node.next = -1;
+    if(node.prev >= 0)
+    {
+        m_nodes[node.prev].next = index;
+    }
+    else
+    {
+        m_heads[list] = index;
+    }
+    m_tails[list] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+    Node &node = m_nodes[index];
+    if(node.prev >= 0)
+    {
+        m_nodes[node.prev].next = node.next;
+    }
+    else
+    {
+        m_heads[node.list] = node.next;
+    }
+    if(node.next >= 0)
+    {
+        m_nodes[node.next].prev = node.prev;
+    }
+    else
+    {
+        m_tails[node.list] = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+    node.list = -2;
+}
+
+void TimerWheel::release(int index)
+{
+    Node &node = m_nodes[index];
+    node.list = -1;
+    ++node.generation;
+    node.next = m_free;
+    m_free = index;
+    --m_count;
+}
+
+void TimerWheel::cascade(int level, int slot)
+{
+    const int list = level * SLOTS + slot;
+    int index = m_heads[list];
+    m_heads[list] = -1;
+    m_tails[list] = -1;
+    while(index >= 0)
+    {
+        const int next = m_nodes[index].next;
+        m_nodes[index].list = -2;
+        //下沉发生在处理当前刻度之前，恰好此刻到期的仍在本刻度到期
+        place(index, m_now);
+        index = next;
+    }
+}
@@ -0,0 +1,160 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief 分层时间轮
+ * 以 1 毫秒为刻度，4 层各 64 个槽，可直接容纳约 4.6 小时内的定时，更远的定时逐层下沉。
+ * 添加、取消均为 O(1)；推进时直接跳到下一个有定时器的槽位，上层槽位在低层转完一圈时整体下沉一次，
+ * 适合大量同时存在、绝大多数会按时到期的短定时（如成千上万个模拟设备的流程阶段）。
+ * 定时器节点放在连续的节点池中复用，运行中不做逐个分配。非线程安全。
+ */
+class TimerWheel
+{
+public:
+    ///定时器句柄（包含节点序号与复用代数，已到期或已取消的句柄再取消时返回 false）
+    typedef qint64 Handle;
+
+    ///无效句柄
+    static const Handle InvalidHandle = -1;
+
+    ///@param nowMs 时间轮的起始时刻（毫秒）
+    explicit TimerWheel(qint64 nowMs = 0);
+
+    /**
+     * @brief 添加定时器
+     * @param dueMs 到期时刻（毫秒），不晚于当前时刻时在下一次推进时到期
+     * @param payload 到期时回传的调用方数据
+     */
+    Handle schedule(qint64 dueMs, quint32 payload);
+
+    ///取消定时器
+    bool cancel(Handle handle);
+
+    /**
+     * @brief 推进到 nowMs，按到期时刻顺序对每个到期的定时器调用 expired(payload, dueMs)
+     * 回调中可以添加或取消定时器；新添加的定时器不早于下一个刻度到期。
+     */
+    template<typename Callback>
+    void advance(qint64 nowMs, Callback expired);
+
+    ///当前时刻（毫秒）
+    qint64 now() const { return m_now; }
+
+    /**
+     * @brief 下一次需要推进的时刻（毫秒）：最近的到期槽位或需要下沉的上层槽位
+     * 返回值不晚于最早的到期时刻，调用方可以一直休眠到该时刻再调用 advance()。
+     * @return 没有定时器时返回 -1
+     */
+    qint64 nextEvent() const;
+
+    ///未到期的定时器数
+    int size() const { return m_count; }
+
+    ///清空全部定时器并把时刻设为 nowMs
+    void reset(qint64 nowMs);
+
+private:
+    enum
+    {
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS,
+        SLOT_MASK = SLOTS - 1,
+        LEVELS = 4,
+        EXPIRING = LEVELS * SLOTS  ///< 正在处理的到期链表
+    };
+
+    ///定时器节点（双向链表挂在槽位上）
+    struct Node
+    {
+        qint64 due = 0;       ///< 到期时刻
+        quint32 payload = 0;  ///< 调用方数据
+        quint32 generation = 0; ///< 复用代数
+        int list = -1;        ///< 所在链表（-1 表示空闲，-2 表示已摘下）
+        int prev = -1;        ///< 前一个节点
+        int next = -1;        ///< 后一个节点（空闲时指向下一个空闲节点）
+    };
+
+    ///按到期时刻放入对应层的槽位（节点须已从链表摘下）
+    ///@param earliest 最早的到期刻度
+    void place(int index, qint64 earliest);
+
+    ///挂到链表尾部
+    void link(int list, int index);
+
+    ///从所在链表摘下
+    void unlink(int index);
+
+    ///释放节点
+    void release(int index);
+
+    ///把某一层的一个槽位整体下沉到更低的层
+    void cascade(int level, int slot);
+
+    QVector<Node> m_nodes;            ///< 节点池
+    QVector<int> m_heads;             ///< 各链表的首节点（最后一个为到期链表）
+    QVector<int> m_tails;             ///< 各链表的尾节点
+    int m_free = -1;                  ///< 空闲节点链表
+    int m_count = 0;                  ///< 未到期的定时器数
+    qint64 m_now = 0;                 ///< 当前时刻
+};
+
+template<typename Callback>
+void TimerWheel::advance(qint64 nowMs, Callback expired)
+{
+    while(m_now < nowMs)
+    {
+        //跳过空槽位：直接前进到下一个有定时器到期或需要下沉的刻度，没有时跳到目标时刻
+        const qint64 next = nextEvent();
+        if(next < 0 || next > nowMs)
+        {
+            m_now = nowMs;
+            return;
+        }
+        m_now = next;
+        const int slot = static_cast<int>(m_now & SLOT_MASK);
+        //最低层转完一圈：依次把上层当前槽位下沉
+        if(slot == 0)
+        {
+            for(int level = 1; level < LEVELS; ++level)
+            {
+                const int upper = static_cast<int>((m_now >> (level * SLOT_BITS)) & SLOT_MASK);
+                cascade(level, upper);
+                if(upper != 0)
+                {
+                    break;
+                }
+            }
+        }
+        //先整体移到到期链表，回调中新加的定时器不会混入本轮
+        if(m_heads[slot] < 0)
+        {
+            continue;
+        }
+        while(m_heads[slot] >= 0)
+        {
+            const int index = m_heads[slot];
+            unlink(index);
+            link(EXPIRING, index);
+        }
+        while(m_heads[EXPIRING] >= 0)
+        {
+            const int index = m_heads[EXPIRING];
+            unlink(index);
+            //超出时间轮范围的定时器曾被截短放置，未到期时重新放置
+            if(m_nodes[index].due > m_now)
+            {
+                place(index, m_now + 1);
+                continue;
+            }
+            const quint32 payload = m_nodes[index].payload;
+            const qint64 due = m_nodes[index].due;
+            release(index);
+            expired(payload, due);
+        }
+    }
+}
+
+#endif //TIMERWHEEL_H
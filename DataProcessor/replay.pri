@@ -0,0 +1,55 @@
+# 回放引擎（日志缓冲、回放组件、UDP 发送器与 WorkerClass），不含任何界面代码
+# 由 DataProcessor.pro、replay_cli 与 benchmarks/udpsend_bench 共同包含，新增引擎源文件只需加在这里
+
+# 回放调度器在 Windows 下需要 timeBeginPeriod 提升系统定时精度
+win32: LIBS += -lwinmm
+# .txt.gz 抓包的流式解压使用 zlib：Linux 链接系统库，Windows 使用 Qt 自带的 zlib（由 Qt5Core 导出）
+unix: LIBS += -lz
+win32: INCLUDEPATH += $$[QT_INSTALL_HEADERS]/QtZlib
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/log/logstore.cpp \
+    $$PWD/log/logbatcher.cpp \
+    $$PWD/replay/capturereader.cpp \
+    $$PWD/replay/hexdecoder.cpp \
+    $$PWD/replay/replayscheduler.cpp \
+    $$PWD/replay/packetring.cpp \
+    $$PWD/replay/tokenbucket.cpp \
+    $$PWD/replay/dpcapfile.cpp \
+    $$PWD/replay/dpcapconverter.cpp \
+    $$PWD/replay/topicfilter.cpp \
+    $$PWD/replay/parsepipeline.cpp \
+    $$PWD/replay/filewalker.cpp \
+    $$PWD/replay/latencyhistogram.cpp \
+    $$PWD/replay/replaytelemetry.cpp \
+    $$PWD/replay/capturerecorder.cpp \
+    $$PWD/replay/packetarena.cpp \
+    $$PWD/replay/gzipstream.cpp \
+    $$PWD/replay/seekindex.cpp \
+    $$PWD/udpsender.cpp \
+    $$PWD/workerclass.cpp
+
+HEADERS += \
+    $$PWD/log/logstore.h \
+    $$PWD/log/logbatcher.h \
+    $$PWD/replay/capturereader.h \
+    $$PWD/replay/hexdecoder.h \
+    $$PWD/replay/replayscheduler.h \
+    $$PWD/replay/packetring.h \
+    $$PWD/replay/tokenbucket.h \
+    $$PWD/replay/dpcapfile.h \
+    $$PWD/replay/dpcapconverter.h \
+    $$PWD/replay/topicfilter.h \
+    $$PWD/replay/parsepipeline.h \
+    $$PWD/replay/filewalker.h \
+    $$PWD/replay/latencyhistogram.h \
+    $$PWD/replay/replaytelemetry.h \
+    $$PWD/replay/capturerecorder.h \
+    $$PWD/replay/packetarena.h \
+    $$PWD/replay/gzipstream.h \
+    $$PWD/replay/seekindex.h \
+    $$PWD/udpsender.h \
+    $$PWD/workerclass.h
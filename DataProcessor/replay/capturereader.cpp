@@ -0,0 +1,215 @@
+#include "capturereader.h"
+#include "gzipstream.h"
+#include <cstring>
+
+namespace
+{
+    ///判断 ASCII 空白字符（与 QString::trimmed 对 ASCII 的处理一致）
+    inline bool isAsciiSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+}
+
+CaptureReader::~CaptureReader()
+{
+    close();
+}
+
+bool CaptureReader::open(const QString &filePath)
+{
+    close();
+    //压缩抓包：边解压边读取，不映射文件
+    if(GzipStream::isGzipFile(filePath))
+    {
+        m_stream.reset(new GzipStream());
+        if(!m_stream->open(filePath))
+        {
+            m_error = m_stream->errorString();
+            m_stream.reset();
+            return false;
+        }
+        m_fileSize = m_stream->compressedSize();
+        refill();
+        if(m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0)
+        {
+            m_pos = 3;
+        }
+        return true;
+    }
+    m_file.setFileName(filePath);
+    if(!m_file.open(QIODevice::ReadOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if(m_size > 0)
+    {
+        m_mapped = m_file.map(0, m_size);
+        if(m_mapped)
+        {
+            m_data = reinterpret_cast<const char *>(m_mapped);
+        }
+        else
+        {
+            //部分文件系统不支持映射，回退为一次性读取
+            m_fallback = m_file.readAll();
+            m_data = m_fallback.constData();
+            m_size = m_fallback.size();
+        }
+    }
+    m_fileSize = m_size;
+    //跳过 UTF-8 BOM（QTextStream 会自动识别并丢弃）
+    if(m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0)
+    {
+        m_pos = 3;
+    }
+    return true;
+}
+
+void CaptureReader::close()
+{
+    if(m_mapped)
+    {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if(m_file.isOpen())
+    {
+        m_file.close();
+    }
+    m_fallback.clear();
+    m_stream.reset();
+    m_window.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_fileSize = 0;
+    m_pos = 0;
+    m_base = 0;
+    m_lineNumber = 0;
+    m_error.clear();
+}
+
+bool CaptureReader::refill()
+{
+    if(!m_stream)
+    {
+        return false;
+    }
+    QByteArray block;
+    if(!m_stream->read(block))
+    {
+        if(!m_stream->errorString().isEmpty())
+        {
+            m_error = m_stream->errorString();
+        }
+        return false;
+    }
+    //未读完的半行移到窗口开头，其后追加新块；窗口容量只随最长的行增长
+    const int tail = static_cast<int>(m_size - m_pos);
+    if(m_window.isEmpty())
+    {
+        m_window.reserve(2 * block.size());
+    }
+    if(tail > 0)
+    {
+        std::memmove(m_window.data(), m_window.constData() + m_pos, static_cast<size_t>(tail));
+    }
+    m_window.resize(tail + block.size());
+    std::memcpy(m_window.data() + tail, block.constData(), static_cast<size_t>(block.size()));
+    m_stream->recycle(block);
+    m_base += m_pos;
+    m_data = m_window.constData();
+    m_size = m_window.size();
+    m_pos = 0;
+    return true;
+}
+
+bool CaptureReader::seek(qint64 offset, int lineNumber)
+{
+    //解压流只能向后：丢弃目标之前的数据
+    while(m_stream && offset > m_base + m_size)
+    {
+        m_pos = m_size;
+        if(!refill())
+        {
+            return false;
+        }
+    }
+    if(offset < m_base || offset > m_base + m_size)
+    {
+        return false;
+    }
+    m_pos = offset - m_base;
+    m_lineNumber = lineNumber;
+    return true;
+}
+
+CaptureReader::LineResult CaptureReader::next(CaptureRecord &record)
+{
+    while(m_pos < m_size || refill())
+    {
+        //定位行边界
+        const char *begin = m_data + m_pos;
+        const char *limit = m_data + m_size;
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(limit - begin)));
+        //解压窗口内没有完整的一行：补充数据后重新查找（数据流结束时按最后一行处理）
+        if(!newline && refill())
+        {
+            continue;
+        }
+        const char *end = newline ? newline : limit;
+        m_pos = (newline ? newline + 1 : limit) - m_data;
+        ++m_lineNumber;
+        //去除首尾空白
+        while(begin < end && isAsciiSpace(*begin))
+        {
+            ++begin;
+        }
+        while(end > begin && isAsciiSpace(*(end - 1)))
+        {
+            --end;
+        }
+        if(begin == end)
+        {
+            continue;
+        }
+        //按制表符切分，跳过空字段，只需前两个字段
+        const char *fields[2] = {nullptr, nullptr};
+        int lengths[2] = {0, 0};
+        int count = 0;
+        const char *cursor = begin;
+        while(cursor < end && count < 2)
+        {
+            const char *tab = static_cast<const char *>(std::memchr(cursor, '\t', static_cast<size_t>(end - cursor)));
+            const char *fieldEnd = tab ? tab : end;
+            if(fieldEnd > cursor)
+            {
+                fields[count] = cursor;
+                lengths[count] = static_cast<int>(fieldEnd - cursor);
+                ++count;
+            }
+            cursor = tab ? tab + 1 : end;
+        }
+        record.lineNumber = m_lineNumber;
+        if(count < 2)
+        {
+            record.timestamp = QLatin1String();
+            record.hexData = QLatin1String();
+            return LineResult::FormatError;
+        }
+        //识别数据格式（首字段去空白后以 '[' 开头视为时间戳）
+        const char *first = fields[0];
+        const char *firstEnd = fields[0] + lengths[0];
+        while(first < firstEnd && isAsciiSpace(*first))
+        {
+            ++first;
+        }
+        const int tsIndex = (first < firstEnd && *first == '[') ? 0 : 1;
+        record.timestamp = QLatin1String(fields[tsIndex], lengths[tsIndex]);
+        record.hexData = QLatin1String(fields[1 - tsIndex], lengths[1 - tsIndex]);
+        return LineResult::Record;
+    }
+    return LineResult::End;
+}
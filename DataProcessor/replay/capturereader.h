@@ -0,0 +1,100 @@
+#ifndef CAPTUREREADER_H
+#define CAPTUREREADER_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QLatin1String>
+#include <QScopedPointer>
+
+class GzipStream;
+
+/**
+ * @brief 抓包文件中的一条记录
+ * 所有字段均为指向文件映射区的视图，不做任何拷贝，仅在下一次 next() 之前有效。
+ */
+struct CaptureRecord
+{
+    QLatin1String timestamp; ///< 时间戳字段（可能为空）
+    QLatin1String hexData;   ///< 十六进制数据字段
+    int lineNumber = 0;      ///< 行号（从 1 开始）
+};
+
+/**
+ * @brief 抓包文本文件读取器
+ * 通过内存映射直接扫描原始字节中的换行符与制表符，按行输出记录视图，
+ * 避免 QTextStream 解码和逐行构造 QString/QStringList 的开销。
+ * 支持 "[时间戳]\t数据" 与 "数据\t时间戳" 两种格式。
+ *
+ * .gz 压缩的抓包不做映射，由 GzipStream 在独立线程中流式解压，本类在一个滑动窗口内按行切分，
+ * 窗口只保留跨块的半行，内存占用与文件大小无关。此时偏移均为解压后数据流中的偏移，
+ * seek() 只能向后，需要解压并丢弃目标之前的数据。
+ */
+class CaptureReader
+{
+public:
+    ///解析结果
+    enum class LineResult
+    {
+        Record,      ///< 成功解析出一条记录
+        FormatError, ///< 字段数量不足（数据格式错误）
+        End          ///< 文件结束
+    };
+
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    ///打开并映射文件（.gz 启动流式解压）
+    ///@return 成功返回 true，失败可通过 errorString() 获取原因
+    bool open(const QString &filePath);
+
+    ///关闭文件并解除映射
+    void close();
+
+    ///读取下一条非空行
+    ///@param record 输出参数，解析出的记录
+    ///@return 解析结果，FormatError 时 record.lineNumber 仍然有效
+    LineResult next(CaptureRecord &record);
+
+    /**
+     * @brief 从指定行首继续读取（偏移来自定位索引）
+     * @param offset 行首字节偏移
+     * @param lineNumber 该行之前已读取的行数（后续行号由此递增）
+     */
+    bool seek(qint64 offset, int lineNumber);
+
+    ///当前读取位置（字节，.gz 为解压后的偏移）
+    qint64 position() const { return m_base + m_pos; }
+
+    ///已读取的行数
+    int lineNumber() const { return m_lineNumber; }
+
+    ///文件总大小（字节，.gz 为压缩文件大小）
+    qint64 size() const { return m_fileSize; }
+
+    ///错误信息
+    QString errorString() const { return m_error; }
+
+private:
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+    ///从解压流取下一块数据追加到窗口（保留未读完的半行）
+    ///@return 数据流已结束返回 false
+    bool refill();
+
+    QFile m_file;              ///< 文件对象
+    const char *m_data = nullptr; ///< 映射区首地址（或回退缓冲区、解压窗口）
+    qint64 m_size = 0;         ///< 数据长度（解压时为窗口内的数据长度）
+    qint64 m_fileSize = 0;     ///< 文件大小
+    qint64 m_pos = 0;          ///< 当前扫描位置（相对 m_data）
+    qint64 m_base = 0;         ///< m_data 在数据流中的偏移（仅解压时非 0）
+    int m_lineNumber = 0;      ///< 当前行号
+    uchar *m_mapped = nullptr; ///< 映射指针（用于解除映射）
+    QByteArray m_fallback;     ///< 无法映射时的回退缓冲区
+    QScopedPointer<GzipStream> m_stream; ///< 流式解压（仅 .gz）
+    QByteArray m_window;       ///< 解压窗口
+    QString m_error;           ///< 错误信息
+};
+
+#endif //CAPTUREREADER_H
@@ -0,0 +1,736 @@
+#include "capturerecorder.h"
+#include "dpcapfile.h"
+#include "log/logbatcher.h"
+#include <QThread>
+#include <QFile>
+#include <QDateTime>
+#include <QHostAddress>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#else
+#include <QUdpSocket>
+#include <QNetworkInterface>
+#include <QEventLoop>
+#include <QTimer>
+#endif
+
+namespace
+{
+    ///单次 recvmmsg 的最大包数
+    const int RECV_BATCH = 64;
+    ///单个数据报的最大长度
+    const int MAX_DATAGRAM = 65536;
+    ///缓冲块内每包的记录头（i64 到达时刻 + i32 长度）
+    const int BLOCK_RECORD_HEADER = 12;
+    ///接收空闲的轮询间隔（毫秒）：决定停止响应时间与空闲时缓冲块的写盘延迟
+    const int POLL_MS = 50;
+    ///单个套接字每轮最多连续接收的批次数，避免一个地址长期独占接收线程
+    const int MAX_ROUNDS_PER_SOCKET = 16;
+    ///文本输出的写缓冲阈值
+    const int TEXT_FLUSH_BYTES = 1024 * 1024;
+    const qint64 NS_PER_SEC = 1000000000LL;
+    const qint64 US_PER_DAY = 86400LL * 1000000LL;
+
+    ///解析 "IP:Port"
+    bool parseAddress(const QString &address, QHostAddress &ip, quint16 &port)
+    {
+        const int colon = address.lastIndexOf(':');
+        if(colon <= 0)
+        {
+            return false;
+        }
+        ip = QHostAddress(address.left(colon));
+        port = address.mid(colon + 1).toUShort();
+        return !ip.isNull() && port != 0;
+    }
+
+    ///是否为 IPv4 组播地址（224.0.0.0/4）
+    bool isMulticast(const QHostAddress &ip)
+    {
+        return ip.protocol() == QAbstractSocket::IPv4Protocol && (ip.toIPv4Address() >> 28) == 0xE;
+    }
+}
+
+/**
+ * @brief 录制输出文件（写盘线程独占）
+ * 到达时刻按秒缓存本地时间的日期前缀与当日微秒基准，同一秒内的数据包只做整数运算。
+ * .dpcap 的时间与文本时间戳转换后的值一致（本地时间的儒略日微秒），两种格式回放节奏相同。
+ */
+class CaptureRecorder::Output
+{
+public:
+    bool open(const QString &path, Format format, QString &error)
+    {
+        m_format = format;
+        if(format == Format::Dpcap)
+        {
+            if(!m_dpcap.open(path))
+            {
+                error = m_dpcap.errorString();
+                return false;
+            }
+            return true;
+        }
+        m_file.setFileName(path);
+        if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            error = m_file.errorString();
+            return false;
+        }
+        m_buffer.reserve(TEXT_FLUSH_BYTES + 3 * MAX_DATAGRAM + 64);
+        return true;
+    }
+
+    bool write(qint64 arrivalNs, const char *data, int length)
+    {
+        const qint64 second = arrivalNs / NS_PER_SEC;
+        if(second != m_second)
+        {
+            updateSecond(second);
+        }
+        const int fractionUs = static_cast<int>(arrivalNs % NS_PER_SEC / 1000);
+        if(m_format == Format::Dpcap)
+        {
+            const quint16 topic = length >= 4 ? Dpcap::topicOf(data, length) : 0;
+            const quint16 flags = static_cast<quint16>(Dpcap::TimestampValid | Dpcap::TimestampHasDate);
+            if(!m_dpcap.append(m_secondUs + fractionUs, flags, topic, data, length))
+            {
+                m_error = m_dpcap.errorString();
+                return false;
+            }
+            return true;
+        }
+        static const char digits[] = "0123456789ABCDEF";
+        m_buffer.append(m_prefix);
+        char fraction[8];
+        fraction[0] = '.';
+        for(int i = 6, value = fractionUs; i >= 1; --i, value /= 10)
+        {
+            fraction[i] = static_cast<char>('0' + value % 10);
+        }
+        fraction[7] = ']';
+        m_buffer.append(fraction, sizeof(fraction));
+        m_buffer.append('\t');
+        //"AA BB CC"：每字节两位大写十六进制，以空格分隔
+        const int start = m_buffer.size();
+        m_buffer.resize(start + length * 3);
+        char *out = m_buffer.data() + start;
+        for(int i = 0; i < length; ++i)
+        {
+            const uchar byte = static_cast<uchar>(data[i]);
+            *out++ = digits[byte >> 4];
+            *out++ = digits[byte & 0x0F];
+            *out++ = ' ';
+        }
+        //末字节后的空格替换为换行
+        m_buffer[m_buffer.size() - 1] = '\n';
+        return m_buffer.size() < TEXT_FLUSH_BYTES || flush();
+    }
+
+    ///将文本写缓冲写入文件（.dpcap 由写入器自行缓冲）
+    bool flush()
+    {
+        if(m_format != Format::Text || m_buffer.isEmpty())
+        {
+            return true;
+        }
+        if(m_file.write(m_buffer) != m_buffer.size())
+        {
+            m_error = m_file.errorString();
+            return false;
+        }
+        //resize(0) 保留 open() 中预留的容量（clear() 会释放），写盘线程不再反复分配
+        m_buffer.resize(0);
+        return m_file.flush();
+    }
+
+    bool close(QString &error)
+    {
+        if(m_format == Format::Dpcap)
+        {
+            if(!m_dpcap.commit())
+            {
+                error = m_dpcap.errorString();
+                return false;
+            }
+            return true;
+        }
+        const bool ok = flush();
+        m_file.close();
+        if(!ok)
+        {
+            error = m_error;
+        }
+        return ok;
+    }
+
+    void cancel()
+    {
+        if(m_format == Format::Dpcap)
+        {
+            m_dpcap.cancel();
+        }
+        else
+        {
+            m_file.close();
+        }
+    }
+
+    QString errorString() const { return m_error; }
+
+private:
+    void updateSecond(qint64 second)
+    {
+        m_second = second;
+        const QDateTime local = QDateTime::fromMSecsSinceEpoch(second * 1000);
+        m_prefix = local.toString(QStringLiteral("[yyyy-MM-dd hh:mm:ss")).toLatin1();
+        m_secondUs = local.date().toJulianDay() * US_PER_DAY
+                     + static_cast<qint64>(QTime(0, 0).secsTo(local.time())) * 1000000LL;
+    }
+
+    Format m_format = Format::Text;
+    QFile m_file;               ///< 文本输出
+    QByteArray m_buffer;        ///< 文本写缓冲
+    DpcapWriter m_dpcap;        ///< .dpcap 输出
+    qint64 m_second = -1;       ///< 缓存对应的 Unix 秒
+    QByteArray m_prefix;        ///< "[yyyy-MM-dd hh:mm:ss"
+    qint64 m_secondUs = 0;      ///< 该秒起点（本地时间儒略日微秒）
+    QString m_error;            ///< 错误信息
+};
+
+CaptureRecorder::CaptureRecorder()
+{
+}
+
+CaptureRecorder::~CaptureRecorder()
+{
+    QString error;
+    stop(error);
+}
+
+QString CaptureRecorder::defaultFileName(Format format)
+{
+    return QDateTime::currentDateTime().toString(QStringLiteral("'record_'yyyyMMdd_hhmmss"))
+           + (format == Format::Dpcap ? QStringLiteral(".dpcap") : QStringLiteral(".txt"));
+}
+
+CaptureRecorder::Format CaptureRecorder::formatFromString(const QString &name)
+{
+    return name.compare(QLatin1String("dpcap"), Qt::CaseInsensitive) == 0 ? Format::Dpcap : Format::Text;
+}
+
+bool CaptureRecorder::start(const Options &options, QString &error)
+{
+    if(m_receiveThread)
+    {
+        error = QStringLiteral("录制已在进行");
+        return false;
+    }
+    if(options.addresses.isEmpty())
+    {
+        error = QStringLiteral("没有接收地址");
+        return false;
+    }
+    m_options = options;
+    m_options.blockBytes = qMax(m_options.blockBytes, BLOCK_RECORD_HEADER + MAX_DATAGRAM);
+    m_options.blockCount = qMax(m_options.blockCount, 2);
+    //预先分配并写零全部缓冲块，突发到来时不再触发内存分配与缺页
+    m_blocks.clear();
+    m_blocks.resize(m_options.blockCount);
+    m_free.clear();
+    m_full.clear();
+    for(Block &block : m_blocks)
+    {
+        block.data = QByteArray(m_options.blockBytes, '\0');
+        m_free.append(&block);
+    }
+    m_current = m_free.takeLast();
+    m_packets.store(0);
+    m_bytes.store(0);
+    m_dropped.store(0);
+    m_written.store(0);
+    m_writeError.clear();
+    m_receiveDone = false;
+    m_receiveThread.reset(QThread::create([this]() { receiveLoop(); }));
+    m_writeThread.reset(QThread::create([this]() { writeLoop(); }));
+    if(!openSockets(error))
+    {
+        closeSockets();
+        m_receiveThread.reset();
+        m_writeThread.reset();
+        return false;
+    }
+    m_output.reset(new Output());
+    if(!m_output->open(m_options.outputPath, m_options.format, error))
+    {
+        closeSockets();
+        m_output.reset();
+        m_receiveThread.reset();
+        m_writeThread.reset();
+        return false;
+    }
+    m_running.store(true);
+    m_writeThread->start();
+    //接收线程优先于写盘线程获得 CPU
+    m_receiveThread->start(QThread::TimeCriticalPriority);
+    log("INFO", QString("开始录制 %1 个地址 -> %2").arg(m_options.addresses.size()).arg(m_options.outputPath));
+    return true;
+}
+
+bool CaptureRecorder::stop(QString &error)
+{
+    if(!m_receiveThread)
+    {
+        return true;
+    }
+    m_running.store(false);
+    //接收线程退出前交出最后一个缓冲块并置 m_receiveDone，写盘线程写完剩余缓冲块后退出
+    m_receiveThread->wait();
+    m_writeThread->wait();
+    m_receiveThread.reset();
+    m_writeThread.reset();
+    closeSockets();
+    bool ok = m_writeError.isEmpty();
+    if(ok)
+    {
+        ok = m_output->close(m_writeError);
+    }
+    else
+    {
+        m_output->cancel();
+    }
+    m_output.reset();
+    const Stats result = stats();
+    if(!ok)
+    {
+        error = m_writeError;
+        log("ERROR", "录制文件写入失败: " + m_writeError);
+    }
+    log("INFO", QString("录制结束：接收 %1 包 %2 字节，写入 %3 包，丢弃 %4 包")
+                .arg(result.packets).arg(result.bytes).arg(result.written).arg(result.dropped));
+    return ok;
+}
+
+CaptureRecorder::Stats CaptureRecorder::stats() const
+{
+    Stats result;
+    result.packets = m_packets.load(std::memory_order_relaxed);
+    result.bytes = m_bytes.load(std::memory_order_relaxed);
+    result.dropped = m_dropped.load(std::memory_order_relaxed);
+    result.written = m_written.load(std::memory_order_relaxed);
+    QMutexLocker locker(&m_mutex);
+    result.pendingBlocks = m_full.size();
+    return result;
+}
+
+void CaptureRecorder::log(const QString &level, const QString &message)
+{
+    if(m_log)
+    {
+        m_log->add(level, message);
+    }
+}
+
+void CaptureRecorder::appendPacket(const char *data, int length, qint64 arrivalNs)
+{
+    if(length <= 0)
+    {
+        return;
+    }
+    m_packets.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(length, std::memory_order_relaxed);
+    const int need = BLOCK_RECORD_HEADER + length;
+    if(m_current && m_current->used + need > m_current->data.size())
+    {
+        publishBlock();
+    }
+    if(!m_current)
+    {
+        QMutexLocker locker(&m_mutex);
+        if(m_free.isEmpty())
+        {
+            //写盘跟不上：丢弃而不阻塞接收
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_current = m_free.takeLast();
+    }
+    char *out = m_current->data.data() + m_current->used;
+    const qint32 stored = length;
+    std::memcpy(out, &arrivalNs, sizeof(arrivalNs));
+    std::memcpy(out + sizeof(arrivalNs), &stored, sizeof(stored));
+    std::memcpy(out + BLOCK_RECORD_HEADER, data, static_cast<size_t>(length));
+    m_current->used += need;
+    m_current->packets++;
+}
+
+void CaptureRecorder::publishBlock()
+{
+    if(!m_current || m_current->packets == 0)
+    {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_full.enqueue(m_current);
+    m_current = m_free.isEmpty() ? nullptr : m_free.takeLast();
+    m_fullReady.wakeOne();
+}
+
+void CaptureRecorder::writeLoop()
+{
+    bool reported = false;
+    while(true)
+    {
+        Block *block = nullptr;
+        bool idle = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            while(m_full.isEmpty() && !m_receiveDone)
+            {
+                m_fullReady.wait(&m_mutex);
+            }
+            if(m_full.isEmpty())
+            {
+                break;
+            }
+            block = m_full.dequeue();
+            idle = m_full.isEmpty();
+        }
+        //写盘出错后继续取走缓冲块（丢弃），保证接收线程不因缓冲块耗尽而停滞
+        if(m_writeError.isEmpty())
+        {
+            const char *p = block->data.constData();
+            const char *end = p + block->used;
+            qint64 written = 0;
+            while(p < end)
+            {
+                qint64 arrivalNs = 0;
+                qint32 length = 0;
+                std::memcpy(&arrivalNs, p, sizeof(arrivalNs));
+                std::memcpy(&length, p + sizeof(arrivalNs), sizeof(length));
+                if(!m_output->write(arrivalNs, p + BLOCK_RECORD_HEADER, length))
+                {
+                    m_writeError = m_output->errorString();
+                    break;
+                }
+                p += BLOCK_RECORD_HEADER + length;
+                ++written;
+            }
+            //队列已空时把文本缓冲落盘，录制中断也只丢失最近一个缓冲块
+            if(m_writeError.isEmpty() && idle && !m_output->flush())
+            {
+                m_writeError = m_output->errorString();
+            }
+            m_written.fetch_add(written, std::memory_order_relaxed);
+        }
+        if(!m_writeError.isEmpty() && !reported)
+        {
+            reported = true;
+            log("ERROR", "录制文件写入失败，后续数据将被丢弃: " + m_writeError);
+        }
+        block->used = 0;
+        block->packets = 0;
+        QMutexLocker locker(&m_mutex);
+        m_free.append(block);
+    }
+}
+
+#if defined(Q_OS_LINUX)
+
+bool CaptureRecorder::openSockets(QString &error)
+{
+    in_addr interfaceAddr;
+    interfaceAddr.s_addr = htonl(INADDR_ANY);
+    if(!m_options.interfaceAddress.isEmpty())
+    {
+        const QHostAddress iface(m_options.interfaceAddress);
+        if(iface.protocol() != QAbstractSocket::IPv4Protocol)
+        {
+            error = "无效的网卡地址: " + m_options.interfaceAddress;
+            return false;
+        }
+        interfaceAddr.s_addr = htonl(iface.toIPv4Address());
+    }
+    for(const QString &address : m_options.addresses)
+    {
+        QHostAddress ip;
+        quint16 port = 0;
+        if(!parseAddress(address, ip, port))
+        {
+            error = "无效的接收地址: " + address;
+            return false;
+        }
+        if(ip.protocol() != QAbstractSocket::IPv4Protocol)
+        {
+            error = "录制仅支持 IPv4 地址: " + address;
+            return false;
+        }
+        const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if(fd < 0)
+        {
+            error = QString("创建套接字失败 %1: %2").arg(address).arg(QString::fromLocal8Bit(std::strerror(errno)));
+            return false;
+        }
+        m_fds.append(fd);
+        const int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+        //SO_RCVBUFFORCE 可突破 rmem_max（需要 CAP_NET_ADMIN），失败时退回普通设置
+        const int requested = m_options.receiveBufferBytes;
+        if(::setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &requested, sizeof(requested)) != 0)
+        {
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &requested, sizeof(requested));
+        }
+        int actual = 0;
+        socklen_t optionLength = sizeof(actual);
+        ::getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &actual, &optionLength);
+        //内核返回值为设置值的两倍（含簿记开销），折半后才是实际生效的设置值
+        actual /= 2;
+        if(actual < requested)
+        {
+            log("WARN", QString("%1 接收缓冲区仅 %2 KB（期望 %3 KB），突发流量可能丢包，可调大 net.core.rmem_max")
+                        .arg(address).arg(actual / 1024).arg(requested / 1024));
+        }
+        const bool multicast = isMulticast(ip);
+        sockaddr_in sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(port);
+        //组播绑定组地址，只接收本组数据；单播绑定本机地址，非本机地址时退回任意地址
+        sa.sin_addr.s_addr = htonl(ip.toIPv4Address());
+        if(::bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) != 0)
+        {
+            if(errno != EADDRNOTAVAIL)
+            {
+                error = QString("绑定 %1 失败: %2").arg(address).arg(QString::fromLocal8Bit(std::strerror(errno)));
+                return false;
+            }
+            sa.sin_addr.s_addr = htonl(INADDR_ANY);
+            if(::bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) != 0)
+            {
+                error = QString("绑定 %1 失败: %2").arg(address).arg(QString::fromLocal8Bit(std::strerror(errno)));
+                return false;
+            }
+            log("WARN", QString("%1 不是本机地址，改为接收端口 %2 上的全部数据").arg(address).arg(port));
+        }
+        if(multicast)
+        {
+            ip_mreq mreq;
+            mreq.imr_multiaddr.s_addr = htonl(ip.toIPv4Address());
+            mreq.imr_interface = interfaceAddr;
+            if(::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0)
+            {
+                error = QString("加入组播 %1 失败: %2").arg(address).arg(QString::fromLocal8Bit(std::strerror(errno)));
+                return false;
+            }
+        }
+        log("DEBUG", QString("录制地址 %1%2 接收缓冲区 %3 KB")
+                     .arg(address).arg(multicast ? "（组播）" : "").arg(actual / 1024));
+    }
+    return true;
+}
+
+void CaptureRecorder::closeSockets()
+{
+    //关闭套接字时内核自动退出组播组
+    for(int fd : m_fds)
+    {
+        ::close(fd);
+    }
+    m_fds.clear();
+}
+
+void CaptureRecorder::receiveLoop()
+{
+    //接收缓冲与控制消息区在进入循环前一次性分配
+    QByteArray staging(RECV_BATCH * MAX_DATAGRAM, '\0');
+    QByteArray controls(RECV_BATCH * static_cast<int>(CMSG_SPACE(sizeof(timespec))), '\0');
+    const int controlSize = static_cast<int>(CMSG_SPACE(sizeof(timespec)));
+    QVector<mmsghdr> msgs(RECV_BATCH);
+    QVector<iovec> iov(RECV_BATCH);
+    QVector<pollfd> pfds(m_fds.size());
+    for(int i = 0; i < m_fds.size(); ++i)
+    {
+        pfds[i].fd = m_fds[i];
+        pfds[i].events = POLLIN;
+    }
+    for(int i = 0; i < RECV_BATCH; ++i)
+    {
+        iov[i].iov_base = staging.data() + i * MAX_DATAGRAM;
+        iov[i].iov_len = MAX_DATAGRAM;
+    }
+    while(m_running.load(std::memory_order_relaxed))
+    {
+        if(::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), POLL_MS) <= 0)
+        {
+            //空闲时交出未满的缓冲块，低速流量也能及时落盘
+            publishBlock();
+            continue;
+        }
+        for(const pollfd &pfd : pfds)
+        {
+            if(!(pfd.revents & POLLIN))
+            {
+                continue;
+            }
+            for(int round = 0; round < MAX_ROUNDS_PER_SOCKET; ++round)
+            {
+                for(int i = 0; i < RECV_BATCH; ++i)
+                {
+                    std::memset(&msgs[i], 0, sizeof(mmsghdr));
+                    msgs[i].msg_hdr.msg_iov = &iov[i];
+                    msgs[i].msg_hdr.msg_iovlen = 1;
+                    msgs[i].msg_hdr.msg_control = controls.data() + i * controlSize;
+                    msgs[i].msg_hdr.msg_controllen = static_cast<size_t>(controlSize);
+                }
+                const int n = ::recvmmsg(pfd.fd, msgs.data(), RECV_BATCH, MSG_DONTWAIT, nullptr);
+                if(n <= 0)
+                {
+                    break;
+                }
+                timespec now;
+                ::clock_gettime(CLOCK_REALTIME, &now);
+                const qint64 fallbackNs = static_cast<qint64>(now.tv_sec) * NS_PER_SEC + now.tv_nsec;
+                for(int i = 0; i < n; ++i)
+                {
+                    qint64 arrivalNs = fallbackNs;
+                    for(cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg;
+                        cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+                    {
+                        if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+                        {
+                            timespec ts;
+                            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                            arrivalNs = static_cast<qint64>(ts.tv_sec) * NS_PER_SEC + ts.tv_nsec;
+                        }
+                    }
+                    appendPacket(staging.constData() + i * MAX_DATAGRAM, static_cast<int>(msgs[i].msg_len), arrivalNs);
+                }
+                if(n < RECV_BATCH)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    publishBlock();
+    QMutexLocker locker(&m_mutex);
+    m_receiveDone = true;
+    m_fullReady.wakeAll();
+}
+
+#else
+
+bool CaptureRecorder::openSockets(QString &error)
+{
+    //按地址查找加入组播使用的网卡
+    QNetworkInterface iface;
+    if(!m_options.interfaceAddress.isEmpty())
+    {
+        const QHostAddress ifaceIp(m_options.interfaceAddress);
+        for(const QNetworkInterface &candidate : QNetworkInterface::allInterfaces())
+        {
+            for(const QNetworkAddressEntry &entry : candidate.addressEntries())
+            {
+                if(entry.ip() == ifaceIp)
+                {
+                    iface = candidate;
+                }
+            }
+        }
+        if(!iface.isValid())
+        {
+            error = "未找到网卡地址: " + m_options.interfaceAddress;
+            return false;
+        }
+    }
+    for(const QString &address : m_options.addresses)
+    {
+        QHostAddress ip;
+        quint16 port = 0;
+        if(!parseAddress(address, ip, port))
+        {
+            error = "无效的接收地址: " + address;
+            return false;
+        }
+        QUdpSocket *socket = new QUdpSocket();
+        m_sockets.append(socket);
+        const bool multicast = ip.isMulticast();
+        const QHostAddress bindAddress = multicast ? (ip.protocol() == QAbstractSocket::IPv6Protocol
+                                                      ? QHostAddress(QHostAddress::AnyIPv6)
+                                                      : QHostAddress(QHostAddress::AnyIPv4))
+                                                   : ip;
+        if(!socket->bind(bindAddress, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+        {
+            error = QString("绑定 %1 失败: %2").arg(address).arg(socket->errorString());
+            return false;
+        }
+        socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, m_options.receiveBufferBytes);
+        if(multicast)
+        {
+            const bool joined = iface.isValid() ? socket->joinMulticastGroup(ip, iface) : socket->joinMulticastGroup(ip);
+            if(!joined)
+            {
+                error = QString("加入组播 %1 失败: %2").arg(address).arg(socket->errorString());
+                return false;
+            }
+        }
+        //套接字由接收线程使用
+        socket->moveToThread(m_receiveThread.data());
+        log("DEBUG", QString("录制地址 %1%2").arg(address).arg(multicast ? "（组播）" : ""));
+    }
+    return true;
+}
+
+void CaptureRecorder::closeSockets()
+{
+    qDeleteAll(m_sockets);
+    m_sockets.clear();
+}
+
+void CaptureRecorder::receiveLoop()
+{
+    QByteArray buffer(MAX_DATAGRAM, '\0');
+    QEventLoop loop;
+    for(QUdpSocket *socket : m_sockets)
+    {
+        QObject::connect(socket, &QUdpSocket::readyRead, &loop, [this, socket, &buffer]()
+        {
+            while(socket->hasPendingDatagrams())
+            {
+                const qint64 length = socket->readDatagram(buffer.data(), buffer.size());
+                if(length < 0)
+                {
+                    break;
+                }
+                const qint64 arrivalNs = QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+                appendPacket(buffer.constData(), static_cast<int>(length), arrivalNs);
+            }
+        });
+    }
+    QTimer timer;
+    QObject::connect(&timer, &QTimer::timeout, &loop, [this, &loop]()
+    {
+        publishBlock();
+        if(!m_running.load(std::memory_order_relaxed))
+        {
+            loop.quit();
+        }
+    });
+    timer.start(POLL_MS);
+    loop.exec();
+    publishBlock();
+    QMutexLocker locker(&m_mutex);
+    m_receiveDone = true;
+    m_fullReady.wakeAll();
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef CAPTURERECORDER_H
+#define CAPTURERECORDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QScopedPointer>
+#include <atomic>
+
+class QThread;
+class QUdpSocket;
+class LogBatcher;
+
+/**
+ * @brief 抓包录制器
+ * 加入配置的单播/组播地址接收数据包，写成可直接回放的抓包文件（文本或 .dpcap）。
+ *
+ * 接收与写盘各占一个线程：接收线程把数据包连同到达时刻追加到预先分配的缓冲块中，
+ * 写满（或接收空闲）时整块交给写盘线程，写盘线程格式化并写入文件后归还缓冲块。
+ * 接收线程从不等待磁盘；缓冲块全部占用时丢弃新到的数据包并计数，而不是阻塞接收导致内核缓冲区溢出。
+ *
+ * Linux 下每个地址一个原生套接字，poll 后用 recvmmsg 批量接收，到达时刻取内核时间戳（SO_TIMESTAMPNS）；
+ * 其他平台使用 QUdpSocket，到达时刻取读出时的系统时间。
+ */
+class CaptureRecorder
+{
+public:
+    ///输出格式
+    enum class Format
+    {
+        Text,  ///< "[yyyy-MM-dd hh:mm:ss.ffffff]\t十六进制" 文本
+        Dpcap  ///< .dpcap 二进制
+    };
+
+    ///录制参数
+    struct Options
+    {
+        QStringList addresses;          ///< 接收地址 (IP:Port)，组播地址自动加入组
+        QString outputPath;             ///< 输出文件路径
+        Format format = Format::Text;   ///< 输出格式
+        QString interfaceAddress;       ///< 加入组播使用的本机网卡地址（为空由系统选择）
+        int receiveBufferBytes = 16 * 1024 * 1024; ///< 期望的套接字接收缓冲区
+        int blockBytes = 1024 * 1024;   ///< 单个缓冲块大小
+        int blockCount = 64;            ///< 缓冲块数量
+    };
+
+    ///录制统计
+    struct Stats
+    {
+        qint64 packets = 0;       ///< 接收的包数
+        qint64 bytes = 0;         ///< 接收的字节数
+        qint64 dropped = 0;       ///< 缓冲块耗尽而丢弃的包数
+        qint64 written = 0;       ///< 已写入文件的包数
+        qint64 pendingBlocks = 0; ///< 等待写盘的缓冲块数
+    };
+
+    CaptureRecorder();
+    ~CaptureRecorder();
+
+    ///日志输出（可选，需在 start() 之前设置）
+    void setLog(LogBatcher *log) { m_log = log; }
+
+    /**
+     * @brief 打开套接字与输出文件并启动接收、写盘线程
+     * @param options 录制参数
+     * @param error 输出参数，失败原因
+     */
+    bool start(const Options &options, QString &error);
+
+    /**
+     * @brief 停止接收，等待缓冲数据全部写盘后关闭文件
+     * @param error 输出参数，写盘失败的原因
+     * @return 写盘过程中出错时返回 false
+     */
+    bool stop(QString &error);
+
+    ///当前统计（任意线程可调用）
+    Stats stats() const;
+
+    ///按格式生成默认文件名（record_yyyyMMdd_hhmmss.txt / .dpcap）
+    static QString defaultFileName(Format format);
+
+    ///解析格式名（"text" / "dpcap"）
+    static Format formatFromString(const QString &name);
+
+private:
+    CaptureRecorder(const CaptureRecorder &) = delete;
+    CaptureRecorder &operator=(const CaptureRecorder &) = delete;
+
+    class Output;
+
+    ///缓冲块：依次排列 i64 到达时刻（Unix 纳秒） | i32 长度 | 载荷
+    struct Block
+    {
+        QByteArray data;  ///< 预分配存储
+        int used = 0;     ///< 已用字节
+        int packets = 0;  ///< 包数
+    };
+
+    ///打开全部接收地址
+    bool openSockets(QString &error);
+
+    ///关闭全部套接字
+    void closeSockets();
+
+    ///接收线程主循环
+    void receiveLoop();
+
+    ///写盘线程主循环
+    void writeLoop();
+
+    ///追加一个数据包到当前缓冲块（接收线程）
+    void appendPacket(const char *data, int length, qint64 arrivalNs);
+
+    ///将当前缓冲块交给写盘线程（接收线程）
+    void publishBlock();
+
+    ///记录日志
+    void log(const QString &level, const QString &message);
+
+    Options m_options;                     ///< 录制参数
+    LogBatcher *m_log = nullptr;           ///< 日志输出
+    QVector<Block> m_blocks;               ///< 全部缓冲块
+    QVector<Block *> m_free;               ///< 空闲缓冲块
+    QQueue<Block *> m_full;                ///< 待写盘缓冲块
+    Block *m_current = nullptr;            ///< 接收线程正在填充的缓冲块
+    mutable QMutex m_mutex;                ///< 保护 m_free / m_full
+    QWaitCondition m_fullReady;            ///< 有待写盘缓冲块或已停止
+    QScopedPointer<QThread> m_receiveThread; ///< 接收线程
+    QScopedPointer<QThread> m_writeThread;   ///< 写盘线程
+    QScopedPointer<Output> m_output;        ///< 输出文件
+    QString m_writeError;                  ///< 写盘错误
+    std::atomic<bool> m_running{false};    ///< 接收线程运行标志
+    bool m_receiveDone = false;            ///< 接收线程已退出（m_mutex 保护）
+    std::atomic<qint64> m_packets{0};      ///< 接收的包数
+    std::atomic<qint64> m_bytes{0};        ///< 接收的字节数
+    std::atomic<qint64> m_dropped{0};      ///< 丢弃的包数
+    std::atomic<qint64> m_written{0};      ///< 已写入的包数
+#if defined(Q_OS_LINUX)
+    QVector<int> m_fds;                    ///< 原生套接字
+#else
+    QVector<QUdpSocket *> m_sockets;       ///< 接收套接字（归接收线程所有）
+#endif
+};
+
+#endif //CAPTURERECORDER_H
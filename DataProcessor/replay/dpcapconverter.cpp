@@ -0,0 +1,99 @@
+#include "dpcapconverter.h"
+#include "capturereader.h"
+#include "dpcapfile.h"
+#include "gzipstream.h"
+#include "hexdecoder.h"
+#include "replayscheduler.h"
+#include <QFileInfo>
+#include <QDir>
+
+QString DpcapConverter::outputPath(const QString &textPath)
+{
+    //压缩抓包先去掉 .gz 再换扩展名
+    const QFileInfo info(GzipStream::isGzipFile(textPath) ? textPath.left(textPath.size() - 3) : textPath);
+    return info.dir().filePath(info.completeBaseName() + QStringLiteral(".dpcap"));
+}
+
+bool DpcapConverter::isUpToDate(const QString &textPath)
+{
+    const QFileInfo output(outputPath(textPath));
+    return output.exists() && output.lastModified() >= QFileInfo(textPath).lastModified();
+}
+
+bool DpcapConverter::convert(const QString &textPath, const QString &outputPath, Result &result, QString &error,
+                             const std::function<bool()> &cancelled)
+{
+    result = Result();
+    CaptureReader reader;
+    if(!reader.open(textPath))
+    {
+        error = reader.errorString();
+        return false;
+    }
+    DpcapWriter writer;
+    if(!writer.open(outputPath))
+    {
+        error = writer.errorString();
+        return false;
+    }
+    QByteArray buffer;
+    CaptureRecord record;
+    while(true)
+    {
+        //每 4096 行检查一次取消条件
+        if(cancelled && ((result.packets + result.skipped) & 4095) == 0 && cancelled())
+        {
+            writer.cancel();
+            error = QStringLiteral("已取消");
+            return false;
+        }
+        const CaptureReader::LineResult lineResult = reader.next(record);
+        if(lineResult == CaptureReader::LineResult::End)
+        {
+            //压缩抓包损坏或不完整：不生成只含部分数据的 .dpcap
+            if(!reader.errorString().isEmpty())
+            {
+                writer.cancel();
+                error = reader.errorString();
+                return false;
+            }
+            break;
+        }
+        if(lineResult == CaptureReader::LineResult::FormatError)
+        {
+            ++result.skipped;
+            continue;
+        }
+        const int capacity = HexDecoder::maxDecodedSize(record.hexData.size());
+        if(buffer.size() < capacity)
+        {
+            buffer.resize(capacity);
+        }
+        const int size = HexDecoder::decode(record.hexData.data(), record.hexData.size(), buffer.data(), capacity);
+        if(size < 4)
+        {
+            ++result.skipped;
+            continue;
+        }
+        qint64 timestampUs = 0;
+        bool hasDate = false;
+        quint16 flags = 0;
+        if(ReplayScheduler::parseTimestamp(record.timestamp, timestampUs, &hasDate))
+        {
+            flags = static_cast<quint16>(Dpcap::TimestampValid | (hasDate ? Dpcap::TimestampHasDate : 0));
+        }
+        if(!writer.append(timestampUs, flags, Dpcap::topicOf(buffer.constData(), size), buffer.constData(), size))
+        {
+            writer.cancel();
+            error = writer.errorString();
+            return false;
+        }
+        ++result.packets;
+    }
+    if(!writer.commit())
+    {
+        error = writer.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef DPCAPCONVERTER_H
+#define DPCAPCONVERTER_H
+
+#include <QString>
+#include <functional>
+
+/**
+ * @brief 文本抓包 → .dpcap 转换
+ * 逐行解析时间戳、解码十六进制并提取主题号，与回放时的处理规则一致：
+ * 格式错误、无效十六进制或长度不足 4 字节的行被跳过（回放时同样不会发送）。
+ */
+namespace DpcapConverter
+{
+    ///转换结果统计
+    struct Result
+    {
+        qint64 packets = 0;  ///< 写入的数据包数
+        qint64 skipped = 0;  ///< 跳过的行数
+    };
+
+    ///与文本文件同目录、同名的 .dpcap 路径（a.txt 与 a.txt.gz 均对应 a.dpcap）
+    QString outputPath(const QString &textPath);
+
+    ///目标 .dpcap 已存在且不早于文本文件
+    bool isUpToDate(const QString &textPath);
+
+    /**
+     * @brief 转换单个文件
+     * @param textPath 文本抓包路径
+     * @param outputPath 输出路径（成功后才会出现）
+     * @param result 输出参数，统计信息
+     * @param error 输出参数，失败原因
+     * @param cancelled 取消条件，逐行检查
+     * @return 成功返回 true
+     */
+    bool convert(const QString &textPath, const QString &outputPath, Result &result, QString &error,
+                 const std::function<bool()> &cancelled = std::function<bool()>());
+}
+
+#endif //DPCAPCONVERTER_H
@@ -0,0 +1,311 @@
+#include "dpcapfile.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    const char FILE_MAGIC[4] = {'D', 'P', 'C', 'P'};
+    const char TRAILER_MAGIC[4] = {'D', 'P', 'I', 'X'};
+    ///写缓冲达到该大小时落盘
+    const int WRITE_CHUNK = 1 << 20;
+
+    template <typename T>
+    void put(QByteArray &out, T value)
+    {
+        uchar bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        out.append(reinterpret_cast<const char *>(bytes), static_cast<int>(sizeof(T)));
+    }
+
+    template <typename T>
+    T get(const char *p)
+    {
+        return qFromLittleEndian<T>(reinterpret_cast<const uchar *>(p));
+    }
+}
+
+bool Dpcap::isDpcapFile(const QString &filePath)
+{
+    return filePath.endsWith(QLatin1String(".dpcap"), Qt::CaseInsensitive);
+}
+
+//================ DpcapWriter ================
+
+bool DpcapWriter::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if(!m_file.open(QIODevice::WriteOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_buffer.clear();
+    m_buffer.reserve(WRITE_CHUNK + 64 * 1024);
+    m_buffer.append(FILE_MAGIC, 4);
+    put<quint16>(m_buffer, Dpcap::VERSION);
+    put<quint16>(m_buffer, 0);
+    put<quint64>(m_buffer, 0);
+    m_offset = Dpcap::FILE_HEADER_SIZE;
+    m_packetCount = 0;
+    m_hasTimestamp = false;
+    m_timeIndex.clear();
+    m_topics.clear();
+    m_error.clear();
+    return true;
+}
+
+bool DpcapWriter::append(qint64 timestampUs, quint16 flags, quint16 topic, const char *data, int length)
+{
+    const bool timestampValid = (flags & Dpcap::TimestampValid) != 0;
+    if(timestampValid)
+    {
+        if(!m_hasTimestamp)
+        {
+            m_firstTimestampUs = timestampUs;
+            m_lastTimestampUs = timestampUs;
+            m_hasTimestamp = true;
+        }
+        //记录最大时间：合并或校时导致时间戳回退时索引仍单调，按时间定位不会越过目标
+        m_lastTimestampUs = qMax(m_lastTimestampUs, timestampUs);
+    }
+    //时间索引仅记录有效时间戳，步长内第一个有效包作为索引点，时间取截至该包的最大时间
+    if(timestampValid && (m_timeIndex.isEmpty()
+                          || m_packetCount - m_timeIndex.last().packetIndex >= Dpcap::TIME_INDEX_STRIDE))
+    {
+        m_timeIndex.append(Dpcap::TimeEntry{m_lastTimestampUs, m_offset, m_packetCount});
+    }
+    auto it = m_topics.find(topic);
+    if(it == m_topics.end())
+    {
+        m_topics.insert(topic, Dpcap::TopicEntry{topic, 1, m_offset});
+    }
+    else
+    {
+        ++it->count;
+    }
+    put<qint64>(m_buffer, timestampUs);
+    put<quint32>(m_buffer, static_cast<quint32>(length));
+    put<quint16>(m_buffer, topic);
+    put<quint16>(m_buffer, flags);
+    m_buffer.append(data, length);
+    m_offset += Dpcap::RECORD_HEADER_SIZE + length;
+    ++m_packetCount;
+    return m_buffer.size() < WRITE_CHUNK || flushBuffer();
+}
+
+bool DpcapWriter::commit()
+{
+    const qint64 indexOffset = m_offset;
+    for(const Dpcap::TimeEntry &entry : m_timeIndex)
+    {
+        put<qint64>(m_buffer, entry.timestampUs);
+        put<quint64>(m_buffer, static_cast<quint64>(entry.offset));
+        put<quint64>(m_buffer, static_cast<quint64>(entry.packetIndex));
+    }
+    for(const Dpcap::TopicEntry &entry : m_topics)
+    {
+        put<quint16>(m_buffer, entry.topic);
+        put<quint16>(m_buffer, 0);
+        put<quint32>(m_buffer, entry.count);
+        put<quint64>(m_buffer, static_cast<quint64>(entry.firstOffset));
+    }
+    put<quint64>(m_buffer, static_cast<quint64>(m_packetCount));
+    put<quint64>(m_buffer, static_cast<quint64>(indexOffset));
+    put<quint32>(m_buffer, static_cast<quint32>(m_timeIndex.size()));
+    put<quint32>(m_buffer, static_cast<quint32>(m_topics.size()));
+    put<qint64>(m_buffer, m_firstTimestampUs);
+    put<qint64>(m_buffer, m_lastTimestampUs);
+    m_buffer.append(TRAILER_MAGIC, 4);
+    put<quint32>(m_buffer, 0);
+    if(!flushBuffer())
+    {
+        m_file.cancelWriting();
+        return false;
+    }
+    if(!m_file.commit())
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void DpcapWriter::cancel()
+{
+    if(m_file.isOpen())
+    {
+        m_file.cancelWriting();
+        m_file.commit();
+    }
+    m_buffer.clear();
+}
+
+bool DpcapWriter::flushBuffer()
+{
+    if(m_buffer.isEmpty())
+    {
+        return true;
+    }
+    if(m_file.write(m_buffer) != m_buffer.size())
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_buffer.resize(0);
+    return true;
+}
+
+//================ DpcapReader ================
+
+DpcapReader::~DpcapReader()
+{
+    close();
+}
+
+bool DpcapReader::open(const QString &filePath)
+{
+    close();
+    m_file.setFileName(filePath);
+    if(!m_file.open(QIODevice::ReadOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if(m_size > 0)
+    {
+        m_mapped = m_file.map(0, m_size);
+        if(m_mapped)
+        {
+            m_data = reinterpret_cast<const char *>(m_mapped);
+        }
+        else
+        {
+            m_fallback = m_file.readAll();
+            m_data = m_fallback.constData();
+            m_size = m_fallback.size();
+        }
+    }
+    if(m_size < Dpcap::FILE_HEADER_SIZE || std::memcmp(m_data, FILE_MAGIC, 4) != 0)
+    {
+        m_error = QStringLiteral("不是有效的 dpcap 文件");
+        return false;
+    }
+    if(get<quint16>(m_data + 4) > Dpcap::VERSION)
+    {
+        m_error = QStringLiteral("不支持的 dpcap 版本: %1").arg(get<quint16>(m_data + 4));
+        return false;
+    }
+    m_pos = Dpcap::FILE_HEADER_SIZE;
+    m_dataEnd = m_size;
+    m_hasIndex = loadIndex();
+    return true;
+}
+
+void DpcapReader::close()
+{
+    if(m_mapped)
+    {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if(m_file.isOpen())
+    {
+        m_file.close();
+    }
+    m_fallback.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_dataEnd = 0;
+    m_pos = 0;
+    m_index = 0;
+    m_hasIndex = false;
+    m_packetCount = -1;
+    m_firstTimestampUs = 0;
+    m_lastTimestampUs = 0;
+    m_timeIndex.clear();
+    m_topicIndex.clear();
+    m_error.clear();
+}
+
+bool DpcapReader::loadIndex()
+{
+    if(m_size < Dpcap::FILE_HEADER_SIZE + Dpcap::TRAILER_SIZE)
+    {
+        return false;
+    }
+    const char *trailer = m_data + m_size - Dpcap::TRAILER_SIZE;
+    if(std::memcmp(trailer + 40, TRAILER_MAGIC, 4) != 0)
+    {
+        return false;
+    }
+    const qint64 packetCount = static_cast<qint64>(get<quint64>(trailer));
+    const qint64 indexOffset = static_cast<qint64>(get<quint64>(trailer + 8));
+    const qint64 timeCount = get<quint32>(trailer + 16);
+    const qint64 topicCount = get<quint32>(trailer + 20);
+    //索引区必须恰好填满记录区与文件尾之间的空间
+    if(indexOffset < Dpcap::FILE_HEADER_SIZE
+            || indexOffset + timeCount * Dpcap::TIME_ENTRY_SIZE + topicCount * Dpcap::TOPIC_ENTRY_SIZE
+               != m_size - Dpcap::TRAILER_SIZE)
+    {
+        return false;
+    }
+    const char *p = m_data + indexOffset;
+    m_timeIndex.reserve(static_cast<int>(timeCount));
+    for(qint64 i = 0; i < timeCount; ++i, p += Dpcap::TIME_ENTRY_SIZE)
+    {
+        m_timeIndex.append(Dpcap::TimeEntry{get<qint64>(p),
+                                            static_cast<qint64>(get<quint64>(p + 8)),
+                                            static_cast<qint64>(get<quint64>(p + 16))});
+    }
+    m_topicIndex.reserve(static_cast<int>(topicCount));
+    for(qint64 i = 0; i < topicCount; ++i, p += Dpcap::TOPIC_ENTRY_SIZE)
+    {
+        m_topicIndex.append(Dpcap::TopicEntry{get<quint16>(p), get<quint32>(p + 4),
+                                              static_cast<qint64>(get<quint64>(p + 8))});
+    }
+    m_packetCount = packetCount;
+    m_firstTimestampUs = get<qint64>(trailer + 24);
+    m_lastTimestampUs = get<qint64>(trailer + 32);
+    m_dataEnd = indexOffset;
+    return true;
+}
+
+bool DpcapReader::next(Dpcap::Record &record)
+{
+    if(m_pos >= m_dataEnd)
+    {
+        return false;
+    }
+    if(m_dataEnd - m_pos < Dpcap::RECORD_HEADER_SIZE)
+    {
+        m_error = QStringLiteral("记录头不完整（偏移 %1）").arg(m_pos);
+        return false;
+    }
+    const char *p = m_data + m_pos;
+    const quint32 length = get<quint32>(p + 8);
+    if(static_cast<qint64>(length) > m_dataEnd - m_pos - Dpcap::RECORD_HEADER_SIZE)
+    {
+        m_error = QStringLiteral("记录长度越界（偏移 %1）").arg(m_pos);
+        return false;
+    }
+    record.timestampUs = get<qint64>(p);
+    record.topic = get<quint16>(p + 12);
+    record.flags = get<quint16>(p + 14);
+    record.data = p + Dpcap::RECORD_HEADER_SIZE;
+    record.length = static_cast<int>(length);
+    record.index = m_index++;
+    m_pos += Dpcap::RECORD_HEADER_SIZE + length;
+    return true;
+}
+
+bool DpcapReader::seek(qint64 offset, qint64 packetIndex)
+{
+    if(offset < Dpcap::FILE_HEADER_SIZE || offset > m_dataEnd)
+    {
+        return false;
+    }
+    m_pos = offset;
+    m_index = packetIndex;
+    return true;
+}
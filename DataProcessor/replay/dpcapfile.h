@@ -0,0 +1,207 @@
+#ifndef DPCAPFILE_H
+#define DPCAPFILE_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QMap>
+
+/**
+ * @brief .dpcap 二进制抓包格式
+ * 由文本抓包一次性转换而来，回放时无需任何文本解析。所有整数均为小端序。
+ *
+ *   文件头（16 字节）：magic "DPCP" | u16 版本 | u16 保留 | u64 保留
+ *   数据包记录（16 字节头 + 载荷，依次排列）：
+ *       i64 抓包时间（微秒） | u32 载荷长度 | u16 主题号 | u16 标志 | 载荷
+ *   索引区（位于全部记录之后）：
+ *       时间索引：每 TIME_INDEX_STRIDE 包一项，i64 时间 | u64 记录偏移 | u64 包序号
+ *           （时间为截至该包的最大时间戳，时间戳回退的抓包索引仍单调；时间单调时即该包的时间）
+ *       主题索引：按主题号升序，u16 主题号 | u16 保留 | u32 包数 | u64 首包偏移
+ *   文件尾（48 字节）：u64 包数 | u64 索引区偏移 | u32 时间索引项数 | u32 主题索引项数 |
+ *       i64 首包时间 | i64 最大时间（时间单调时即末包时间）| magic "DPIX" | u32 保留
+ *
+ * 文件尾缺失（例如转换中断）时读取器退化为顺序扫描，索引不可用。
+ */
+namespace Dpcap
+{
+    const quint16 VERSION = 1;
+    const int FILE_HEADER_SIZE = 16;
+    const int RECORD_HEADER_SIZE = 16;
+    const int TIME_ENTRY_SIZE = 24;
+    const int TOPIC_ENTRY_SIZE = 16;
+    const int TRAILER_SIZE = 48;
+    const int TIME_INDEX_STRIDE = 1024;
+
+    ///记录标志
+    enum RecordFlag
+    {
+        TimestampValid = 0x0001,   ///< 时间戳有效
+        TimestampHasDate = 0x0002  ///< 时间戳含日期（仅时分秒时跨零点需回绕）
+    };
+
+    ///一个数据包记录，载荷指向文件映射区，仅在下一次 next() 之前有效
+    struct Record
+    {
+        qint64 timestampUs = 0; ///< 抓包时间（微秒）
+        quint16 topic = 0;      ///< 主题号
+        quint16 flags = 0;      ///< 标志位
+        const char *data = nullptr; ///< 载荷
+        int length = 0;         ///< 载荷长度
+        qint64 index = 0;       ///< 包序号（从 0 开始）
+    };
+
+    ///时间索引项
+    struct TimeEntry
+    {
+        qint64 timestampUs;
+        qint64 offset;
+        qint64 packetIndex;
+    };
+
+    ///主题索引项
+    struct TopicEntry
+    {
+        quint16 topic;
+        quint32 count;
+        qint64 firstOffset;
+    };
+
+    ///判断文件名是否为 .dpcap
+    bool isDpcapFile(const QString &filePath);
+
+    ///从载荷提取主题号（第 4 字节为高位、第 3 字节为低位，长度至少 4）
+    inline quint16 topicOf(const char *data, int length)
+    {
+        return static_cast<quint16>((length > 4 ? static_cast<quint8>(data[4]) << 8 : 0)
+                                    | static_cast<quint8>(data[3]));
+    }
+}
+
+/**
+ * @brief .dpcap 文件写入器
+ * 通过 QSaveFile 写入，commit() 成功后才替换目标文件，转换中断不会留下半个文件。
+ */
+class DpcapWriter
+{
+public:
+    DpcapWriter() = default;
+
+    ///创建文件并写入文件头
+    bool open(const QString &filePath);
+
+    /**
+     * @brief 追加一个数据包
+     * @param timestampUs 抓包时间（微秒）
+     * @param flags 记录标志（Dpcap::RecordFlag）
+     * @param topic 主题号
+     * @param data 载荷
+     * @param length 载荷长度
+     */
+    bool append(qint64 timestampUs, quint16 flags, quint16 topic, const char *data, int length);
+
+    ///写入索引与文件尾并提交
+    bool commit();
+
+    ///放弃写入
+    void cancel();
+
+    ///已写入包数
+    qint64 packetCount() const { return m_packetCount; }
+
+    ///错误信息
+    QString errorString() const { return m_error; }
+
+private:
+    DpcapWriter(const DpcapWriter &) = delete;
+    DpcapWriter &operator=(const DpcapWriter &) = delete;
+
+    bool flushBuffer();
+
+    QSaveFile m_file;               ///< 输出文件
+    QByteArray m_buffer;            ///< 写缓冲
+    qint64 m_offset = 0;            ///< 下一条记录的文件偏移
+    qint64 m_packetCount = 0;       ///< 包数
+    qint64 m_firstTimestampUs = 0;  ///< 首个有效时间
+    qint64 m_lastTimestampUs = 0;   ///< 最大有效时间
+    bool m_hasTimestamp = false;    ///< 是否出现过有效时间
+    QVector<Dpcap::TimeEntry> m_timeIndex;   ///< 时间索引
+    QMap<quint16, Dpcap::TopicEntry> m_topics; ///< 主题索引
+    QString m_error;                ///< 错误信息
+};
+
+/**
+ * @brief .dpcap 文件读取器
+ * 通过内存映射顺序读取记录，载荷直接引用映射区。
+ */
+class DpcapReader
+{
+public:
+    DpcapReader() = default;
+    ~DpcapReader();
+
+    ///打开并映射文件，校验文件头并加载索引
+    bool open(const QString &filePath);
+
+    ///关闭文件并解除映射
+    void close();
+
+    ///读取下一条记录
+    ///@return 文件结束或记录损坏时返回 false（损坏时 errorString() 非空）
+    bool next(Dpcap::Record &record);
+
+    ///从指定记录偏移与包序号继续读取（偏移来自索引）
+    bool seek(qint64 offset, qint64 packetIndex);
+
+    ///是否带有完整索引
+    bool hasIndex() const { return m_hasIndex; }
+
+    ///包数（无索引时为 -1）
+    qint64 packetCount() const { return m_packetCount; }
+
+    ///时间索引
+    const QVector<Dpcap::TimeEntry> &timeIndex() const { return m_timeIndex; }
+
+    ///主题索引
+    const QVector<Dpcap::TopicEntry> &topicIndex() const { return m_topicIndex; }
+
+    ///首个有效时间（无索引时为 0）
+    qint64 firstTimestampUs() const { return m_firstTimestampUs; }
+
+    ///最大有效时间，时间单调时即末包时间（无索引时为 0）
+    qint64 lastTimestampUs() const { return m_lastTimestampUs; }
+
+    ///当前读取位置（字节）
+    qint64 position() const { return m_pos; }
+
+    ///文件总大小（字节）
+    qint64 size() const { return m_size; }
+
+    ///错误信息
+    QString errorString() const { return m_error; }
+
+private:
+    DpcapReader(const DpcapReader &) = delete;
+    DpcapReader &operator=(const DpcapReader &) = delete;
+
+    bool loadIndex();
+
+    QFile m_file;                  ///< 文件对象
+    const char *m_data = nullptr;  ///< 映射区首地址（或回退缓冲区）
+    qint64 m_size = 0;             ///< 文件长度
+    qint64 m_dataEnd = 0;          ///< 记录区结束位置
+    qint64 m_pos = 0;              ///< 当前读取位置
+    qint64 m_index = 0;            ///< 下一条记录的包序号
+    uchar *m_mapped = nullptr;     ///< 映射指针
+    QByteArray m_fallback;         ///< 无法映射时的回退缓冲区
+    bool m_hasIndex = false;       ///< 是否带有完整索引
+    qint64 m_packetCount = -1;     ///< 包数
+    qint64 m_firstTimestampUs = 0; ///< 首个有效时间
+    qint64 m_lastTimestampUs = 0;  ///< 最大有效时间
+    QVector<Dpcap::TimeEntry> m_timeIndex;   ///< 时间索引
+    QVector<Dpcap::TopicEntry> m_topicIndex; ///< 主题索引
+    QString m_error;               ///< 错误信息
+};
+
+#endif //DPCAPFILE_H
@@ -0,0 +1,154 @@
+#include "filewalker.h"
+#include "dpcapconverter.h"
+#include "dpcapfile.h"
+#include <QDir>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+
+FileWalker::FileWalker(const QString &rootPath, bool descending, const QStringList &nameFilters)
+    : m_nameFilters(nameFilters)
+    , m_descending(descending)
+    , m_preferDpcap(nameFilters.contains("*.dpcap"))
+{
+    enter(rootPath, 0);
+}
+
+void FileWalker::enter(const QString &path, int depth)
+{
+    QDir dir(path);
+    Frame frame;
+    frame.path = dir.absolutePath();
+    frame.fileIndex = 0;
+    frame.subDirIndex = 0;
+    frame.depth = depth;
+    //当前目录文件（始终正序）
+    QStringList files = dir.entryList(m_nameFilters, QDir::Files);
+    files.sort();
+    //同一抓包（a.txt、a.txt.gz、a.dpcap 对应同一个 .dpcap 输出）只保留一个来源，避免重复发送：
+    //.dpcap 不旧于最新的文本来源时用 .dpcap，否则用最新的文本来源，过期的 .dpcap 丢弃
+    struct Capture
+    {
+        QString dpcap;      //已转换的 .dpcap（不存在时为空）
+        QString text;       //最新的文本来源（不存在时为空）
+        QDateTime textTime; //文本来源的修改时间
+    };
+    QVector<Capture> captures;
+    QHash<QString, int> captureIndex;
+    for(const QString &file : files)
+    {
+        const QString filePath = dir.absoluteFilePath(file);
+        const bool dpcap = Dpcap::isDpcapFile(file);
+        const QString key = dpcap ? filePath : DpcapConverter::outputPath(filePath);
+        auto it = captureIndex.constFind(key);
+        if(it == captureIndex.constEnd())
+        {
+            it = captureIndex.insert(key, captures.size());
+            captures.append(Capture());
+        }
+        Capture &capture = captures[it.value()];
+        if(dpcap)
+        {
+            capture.dpcap = filePath;
+            continue;
+        }
+        const QDateTime modified = QFileInfo(filePath).lastModified();
+        if(capture.text.isEmpty() || modified > capture.textTime)
+        {
+            capture.text = filePath;
+            capture.textTime = modified;
+        }
+    }
+    for(const Capture &capture : captures)
+    {
+        if(capture.text.isEmpty())
+        {
+            frame.files.append(capture.dpcap);
+        }
+        else if(m_preferDpcap && !capture.dpcap.isEmpty()
+                && QFileInfo(capture.dpcap).lastModified() >= capture.textTime)
+        {
+            frame.files.append(capture.dpcap);
+        }
+        else
+        {
+            frame.files.append(capture.text);
+        }
+    }
+    //子目录（根据 order 参数控制顺序）
+    frame.subDirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    frame.subDirs.sort();
+    if(m_descending)
+    {
+        std::reverse(frame.subDirs.begin(), frame.subDirs.end());
+    }
+    //更新该层统计
+    if(m_levels.size() <= depth)
+    {
+        m_levels.resize(depth + 1);
+    }
+    LevelStats &level = m_levels[depth];
+    level.directories++;
+    level.files += frame.files.size();
+    level.subDirs += frame.subDirs.size();
+    m_directoriesVisited++;
+    m_stack.append(frame);
+}
+
+bool FileWalker::next(QString &filePath)
+{
+    while(!m_stack.isEmpty())
+    {
+        Frame &top = m_stack.last();
+        if(top.fileIndex < top.files.size())
+        {
+            filePath = top.files[top.fileIndex++];
+            m_filesFound++;
+            return true;
+        }
+        if(top.subDirIndex < top.subDirs.size())
+        {
+            const QString path = top.path + QLatin1Char('/') + top.subDirs[top.subDirIndex++];
+            enter(path, top.depth + 1);
+            continue;
+        }
+        m_stack.removeLast();
+    }
+    m_finished = true;
+    return false;
+}
+
+double FileWalker::expectedFiles(int depth) const
+{
+    //自底向上：E(d) = 平均文件数(d) + 平均子目录数(d) × E(d+1)；未观测到的层按空目录计
+    double expected = 0.0;
+    for(int d = m_levels.size() - 1; d >= depth; --d)
+    {
+        const LevelStats &level = m_levels[d];
+        if(level.directories == 0)
+        {
+            expected = 0.0;
+            continue;
+        }
+        expected = (static_cast<double>(level.files) + static_cast<double>(level.subDirs) * expected)
+                   / level.directories;
+    }
+    return expected;
+}
+
+int FileWalker::estimatedTotal() const
+{
+    if(m_finished)
+    {
+        return m_filesFound;
+    }
+    double pending = 0.0;
+    for(const Frame &frame : m_stack)
+    {
+        pending += frame.files.size() - frame.fileIndex;
+        pending += (frame.subDirs.size() - frame.subDirIndex) * expectedFiles(frame.depth + 1);
+    }
+    return m_filesFound + static_cast<int>(pending + 0.5);
+}
@@ -0,0 +1,88 @@
+#ifndef FILEWALKER_H
+#define FILEWALKER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief 增量式有序目录遍历器
+ * 每次 next() 只在需要时列出下一个目录，发现文件即返回，无需等待整棵目录树遍历完成。
+ * 顺序与一次性递归收集一致：
+ *   - 目录内文件始终按名称正序；
+ *   - 先返回当前目录的文件，再依次进入子目录；
+ *   - 子目录按名称排序，倒序遍历时反转。
+ * 同时统计各层目录的平均文件数与子目录数，用于估算文件总数（进度显示）。
+ * 仅供单个线程使用。
+ */
+class FileWalker
+{
+public:
+    /**
+     * @brief 构造遍历器
+     * @param rootPath 根目录
+     * @param descending 子目录是否倒序
+     * @param nameFilters 文件名过滤（如 *.txt）
+     */
+    FileWalker(const QString &rootPath, bool descending, const QStringList &nameFilters);
+
+    /**
+     * @brief 取下一个文件
+     * @param filePath 输出参数，文件完整路径
+     * @return 遍历结束返回 false
+     */
+    bool next(QString &filePath);
+
+    ///遍历是否已结束
+    bool atEnd() const { return m_finished; }
+
+    ///已返回的文件数
+    int filesFound() const { return m_filesFound; }
+
+    ///已列出的目录数
+    int directoriesVisited() const { return m_directoriesVisited; }
+
+    /**
+     * @brief 估算文件总数
+     * 已发现文件 + 已列出但未返回的文件 + 未列出子目录按同层平均值外推的文件数；
+     * 遍历结束后即为准确值。
+     */
+    int estimatedTotal() const;
+
+private:
+    ///已列出的目录
+    struct Frame
+    {
+        QString path;        ///< 目录路径
+        QStringList files;   ///< 目录内文件（已排序、已过滤）
+        int fileIndex;       ///< 下一个要返回的文件
+        QStringList subDirs; ///< 子目录（已排序）
+        int subDirIndex;     ///< 下一个要进入的子目录
+        int depth;           ///< 目录深度（根目录为 0）
+    };
+
+    ///各层目录统计
+    struct LevelStats
+    {
+        int directories = 0; ///< 已列出的目录数
+        qint64 files = 0;    ///< 文件总数
+        qint64 subDirs = 0;  ///< 子目录总数
+    };
+
+    ///列出目录并压栈
+    void enter(const QString &path, int depth);
+
+    ///估算以 depth 层某目录为根的子树文件数
+    double expectedFiles(int depth) const;
+
+    QStringList m_nameFilters;     ///< 文件名过滤
+    bool m_descending;             ///< 子目录倒序
+    bool m_preferDpcap;            ///< 已转换的文本抓包由 .dpcap 代替
+    QVector<Frame> m_stack;        ///< 遍历栈
+    QVector<LevelStats> m_levels;  ///< 各层统计
+    int m_filesFound = 0;          ///< 已返回文件数
+    int m_directoriesVisited = 0;  ///< 已列出目录数
+    bool m_finished = false;       ///< 遍历结束
+};
+
+#endif //FILEWALKER_H
@@ -0,0 +1,216 @@
+#include "gzipstream.h"
+#include <QFile>
+#include <QThread>
+#include <zlib.h>
+
+namespace
+{
+    ///解压缓冲块大小
+    const int BLOCK_BYTES = 1024 * 1024;
+    ///解压缓冲块数量（解压线程最多领先读取方的块数）
+    const int BLOCK_COUNT = 4;
+    ///每次从文件读取的压缩数据量
+    const int INPUT_BYTES = 256 * 1024;
+}
+
+GzipStream::GzipStream() = default;
+
+GzipStream::~GzipStream()
+{
+    close();
+}
+
+bool GzipStream::isGzipFile(const QString &filePath)
+{
+    return filePath.endsWith(QStringLiteral(".gz"), Qt::CaseInsensitive);
+}
+
+bool GzipStream::open(const QString &filePath)
+{
+    close();
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        m_error = file.errorString();
+        return false;
+    }
+    m_filePath = filePath;
+    m_compressedSize = file.size();
+    m_error.clear();
+    m_finished = false;
+    m_stopped = false;
+    m_full.clear();
+    m_free.clear();
+    for(int i = 0; i < BLOCK_COUNT; ++i)
+    {
+        m_free.enqueue(QByteArray(BLOCK_BYTES, Qt::Uninitialized));
+    }
+    m_thread.reset(QThread::create([this]() { inflateLoop(); }));
+    m_thread->start();
+    return true;
+}
+
+void GzipStream::close()
+{
+    if(!m_thread)
+    {
+        return;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_freeReady.wakeAll();
+        m_fullReady.wakeAll();
+    }
+    m_thread->wait();
+    m_thread.reset();
+    m_full.clear();
+    m_free.clear();
+}
+
+bool GzipStream::read(QByteArray &block)
+{
+    QMutexLocker locker(&m_mutex);
+    while(m_full.isEmpty() && !m_finished)
+    {
+        m_fullReady.wait(&m_mutex);
+    }
+    if(m_full.isEmpty())
+    {
+        return false;
+    }
+    block = m_full.dequeue();
+    return true;
+}
+
+void GzipStream::recycle(QByteArray &block)
+{
+    QMutexLocker locker(&m_mutex);
+    //最后一块可能被截短；容量不变，恢复长度时不会重新分配
+    block.resize(BLOCK_BYTES);
+    m_free.enqueue(block);
+    block = QByteArray();
+    m_freeReady.wakeOne();
+}
+
+QString GzipStream::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+bool GzipStream::takeFree(QByteArray &block)
+{
+    QMutexLocker locker(&m_mutex);
+    while(m_free.isEmpty() && !m_stopped)
+    {
+        m_freeReady.wait(&m_mutex);
+    }
+    if(m_stopped)
+    {
+        return false;
+    }
+    block = m_free.dequeue();
+    return true;
+}
+
+bool GzipStream::pushBlock(QByteArray &block)
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_stopped)
+    {
+        return false;
+    }
+    m_full.enqueue(block);
+    block = QByteArray();
+    m_fullReady.wakeOne();
+    return true;
+}
+
+void GzipStream::inflateLoop()
+{
+    QString error;
+    QFile file(m_filePath);
+    z_stream zs = {};
+    //窗口位数加 32：自动识别 gzip 与 zlib 头
+    const bool initialized = inflateInit2(&zs, 15 + 32) == Z_OK;
+    QByteArray input(INPUT_BYTES, Qt::Uninitialized);
+    QByteArray block;
+    int used = 0;
+    bool memberEnd = false;
+    if(!initialized)
+    {
+        error = QStringLiteral("zlib 初始化失败");
+    }
+    else if(!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+    }
+    else if(takeFree(block))
+    {
+        while(true)
+        {
+            if(zs.avail_in == 0)
+            {
+                const qint64 read = file.read(input.data(), INPUT_BYTES);
+                if(read < 0)
+                {
+                    error = file.errorString();
+                    break;
+                }
+                if(read == 0)
+                {
+                    if(!memberEnd)
+                    {
+                        error = QStringLiteral("压缩数据不完整");
+                    }
+                    break;
+                }
+                zs.next_in = reinterpret_cast<Bytef *>(input.data());
+                zs.avail_in = static_cast<uInt>(read);
+            }
+            //上一个 gzip 成员已结束且后面还有数据：按下一个成员继续解压
+            if(memberEnd)
+            {
+                inflateReset(&zs);
+                memberEnd = false;
+            }
+            zs.next_out = reinterpret_cast<Bytef *>(block.data() + used);
+            zs.avail_out = static_cast<uInt>(BLOCK_BYTES - used);
+            const int ret = inflate(&zs, Z_NO_FLUSH);
+            used = BLOCK_BYTES - static_cast<int>(zs.avail_out);
+            if(ret == Z_STREAM_END)
+            {
+                memberEnd = true;
+            }
+            else if(ret != Z_OK && ret != Z_BUF_ERROR)
+            {
+                error = QStringLiteral("解压失败: %1").arg(zs.msg ? QString::fromLatin1(zs.msg) : QString::number(ret));
+                break;
+            }
+            //缓冲块写满后交给读取方，取下一个空闲块
+            if(used == BLOCK_BYTES)
+            {
+                if(!pushBlock(block) || !takeFree(block))
+                {
+                    used = 0;
+                    break;
+                }
+                used = 0;
+            }
+        }
+        if(used > 0)
+        {
+            block.resize(used);
+            pushBlock(block);
+        }
+    }
+    if(initialized)
+    {
+        inflateEnd(&zs);
+    }
+    QMutexLocker locker(&m_mutex);
+    m_error = error;
+    m_finished = true;
+    m_fullReady.wakeAll();
+}
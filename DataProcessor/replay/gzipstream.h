@@ -0,0 +1,78 @@
+#ifndef GZIPSTREAM_H
+#define GZIPSTREAM_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QWaitCondition>
+#include <QScopedPointer>
+
+class QThread;
+
+/**
+ * @brief gzip 压缩抓包的流式解压
+ * 独立的解压线程从文件中按块读取并用 zlib 解压，解压结果放入固定数量的缓冲块，
+ * 读取方（CaptureReader）逐块取用后归还，解压与解析、发送在不同线程中重叠进行。
+ * 缓冲块预先分配且数量固定，内存占用与文件大小无关；不需要先解压到磁盘。
+ * 支持多个 gzip 成员首尾相接的文件（如分段压缩后直接拼接）。
+ */
+class GzipStream
+{
+public:
+    GzipStream();
+    ~GzipStream();
+
+    ///判断文件名是否为 gzip 压缩（.gz）
+    static bool isGzipFile(const QString &filePath);
+
+    ///打开文件并启动解压线程
+    bool open(const QString &filePath);
+
+    ///停止解压线程并关闭文件
+    void close();
+
+    /**
+     * @brief 取出下一块解压数据（阻塞）
+     * @param block 输出参数，用完后需通过 recycle() 归还
+     * @return 数据结束或解压出错时返回 false（出错时 errorString() 非空）
+     */
+    bool read(QByteArray &block);
+
+    ///归还 read() 取出的缓冲块
+    void recycle(QByteArray &block);
+
+    ///压缩文件大小（字节）
+    qint64 compressedSize() const { return m_compressedSize; }
+
+    ///错误信息
+    QString errorString() const;
+
+private:
+    GzipStream(const GzipStream &) = delete;
+    GzipStream &operator=(const GzipStream &) = delete;
+
+    ///解压线程主循环
+    void inflateLoop();
+
+    ///提交一块解压数据，没有空闲块时等待
+    bool pushBlock(QByteArray &block);
+
+    ///取一个空闲块，停止时返回 false
+    bool takeFree(QByteArray &block);
+
+    QString m_filePath;                 ///< 文件路径
+    qint64 m_compressedSize = 0;        ///< 压缩文件大小
+    QScopedPointer<QThread> m_thread;   ///< 解压线程
+
+    mutable QMutex m_mutex;             ///< 队列互斥锁
+    QWaitCondition m_freeReady;         ///< 有空闲块
+    QWaitCondition m_fullReady;         ///< 有解压数据或已结束
+    QQueue<QByteArray> m_free;          ///< 空闲块
+    QQueue<QByteArray> m_full;          ///< 待取用的解压数据
+    bool m_finished = false;            ///< 解压线程已结束
+    bool m_stopped = false;             ///< 读取方已关闭
+    QString m_error;                    ///< 错误信息
+};
+
+#endif //GZIPSTREAM_H
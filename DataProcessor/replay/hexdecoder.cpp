@@ -0,0 +1,317 @@
+#include "hexdecoder.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HEXDECODER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(HEXDECODER_X86) && defined(__GNUC__)
+#define HEXDECODER_TARGET_SSE2 __attribute__((target("sse2")))
+#define HEXDECODER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HEXDECODER_TARGET_SSE2
+#define HEXDECODER_TARGET_AVX2
+#endif
+
+namespace
+{
+    ///字符到半字节的查找表，非十六进制字符为 -1
+    struct NibbleTable
+    {
+        signed char value[256];
+
+        NibbleTable()
+        {
+            for(int i = 0; i < 256; ++i)
+            {
+                value[i] = -1;
+            }
+            for(int i = 0; i < 10; ++i)
+            {
+                value['0' + i] = static_cast<signed char>(i);
+            }
+            for(int i = 0; i < 6; ++i)
+            {
+                value['A' + i] = static_cast<signed char>(10 + i);
+                value['a' + i] = static_cast<signed char>(10 + i);
+            }
+        }
+    };
+
+    const NibbleTable &nibbleTable()
+    {
+        static const NibbleTable table;
+        return table;
+    }
+
+    ///解码状态：输出指针与跨分隔符待配对的高半字节
+    struct DecodeState
+    {
+        char *out;
+        int pending; ///< -1 表示没有待配对的半字节
+    };
+
+    ///写入一个半字节
+    inline void pushNibble(DecodeState &st, int nibble)
+    {
+        if(st.pending < 0)
+        {
+            st.pending = nibble;
+        }
+        else
+        {
+            *st.out++ = static_cast<char>((st.pending << 4) | nibble);
+            st.pending = -1;
+        }
+    }
+
+    ///标量处理 [p, end)
+    inline void decodeScalar(const unsigned char *p, const unsigned char *end, DecodeState &st)
+    {
+        const signed char *table = nibbleTable().value;
+        for(; p < end; ++p)
+        {
+            const int nibble = table[*p];
+            if(nibble >= 0)
+            {
+                pushNibble(st, nibble);
+            }
+        }
+    }
+
+    ///最低置位比特的下标
+    inline int lowestBit(quint32 mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    ///按掩码逐个写入已转换好的半字节（块中夹杂分隔符时使用）
+    inline void pushMasked(const unsigned char *nibbles, quint32 mask, DecodeState &st)
+    {
+        while(mask)
+        {
+            pushNibble(st, nibbles[lowestBit(mask)]);
+            mask &= mask - 1;
+        }
+    }
+
+#if defined(HEXDECODER_X86)
+    /**
+     * @brief 将 16 个字符转换为半字节并返回十六进制字符掩码
+     * 非十六进制字符对应的半字节为 0。
+     */
+    HEXDECODER_TARGET_SSE2
+    inline __m128i classifySse2(__m128i v, quint32 &mask)
+    {
+        const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                            _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+        const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                            _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+        mask = static_cast<quint32>(_mm_movemask_epi8(_mm_or_si128(digit, alpha)));
+        return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                            _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    }
+
+    HEXDECODER_TARGET_SSE2
+    void decodeSse2(const unsigned char *p, const unsigned char *end, DecodeState &st)
+    {
+        alignas(16) unsigned char nibbles[16];
+        while(end - p >= 16)
+        {
+            quint32 mask;
+            const __m128i nib = classifySse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), mask);
+            if(mask == 0xFFFFu && st.pending < 0)
+            {
+                //全部为十六进制字符：相邻半字节合并为 8 个字节
+                const __m128i hi = _mm_and_si128(nib, _mm_set1_epi16(0x00FF));
+                const __m128i lo = _mm_srli_epi16(nib, 8);
+                const __m128i bytes = _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(st.out), _mm_packus_epi16(bytes, bytes));
+                st.out += 8;
+            }
+            else if(mask)
+            {
+                _mm_store_si128(reinterpret_cast<__m128i *>(nibbles), nib);
+                pushMasked(nibbles, mask, st);
+            }
+            p += 16;
+        }
+        decodeScalar(p, end, st);
+    }
+
+    HEXDECODER_TARGET_AVX2
+    void decodeAvx2(const unsigned char *p, const unsigned char *end, DecodeState &st)
+    {
+        alignas(32) unsigned char nibbles[32];
+        while(end - p >= 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                                   _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+            const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                                   _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+            const quint32 mask = static_cast<quint32>(_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)));
+            const __m256i nib = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(v, _mm256_set1_epi8('0'))),
+                                                _mm256_and_si256(alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+            if(mask == 0xFFFFFFFFu && st.pending < 0)
+            {
+                //全部为十六进制字符：相邻半字节合并为 16 个字节
+                const __m256i hi = _mm256_and_si256(nib, _mm256_set1_epi16(0x00FF));
+                const __m256i lo = _mm256_srli_epi16(nib, 8);
+                const __m256i bytes = _mm256_or_si256(_mm256_slli_epi16(hi, 4), lo);
+                //packus 在两个 128 位通道内分别打包，需要重新排列 64 位块
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes),
+                                                                _MM_SHUFFLE(3, 1, 2, 0));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(st.out), _mm256_castsi256_si128(packed));
+                st.out += 16;
+            }
+            else if(mask)
+            {
+                _mm256_store_si256(reinterpret_cast<__m256i *>(nibbles), nib);
+                pushMasked(nibbles, mask, st);
+            }
+            p += 32;
+        }
+        decodeSse2(p, end, st);
+    }
+
+    bool cpuHasAvx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if(info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        //需要操作系统启用 YMM 状态保存
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if(!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool cpuHasSse2()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+#endif //HEXDECODER_X86
+}
+
+namespace HexDecoder
+{
+    bool isSupported(Isa isa)
+    {
+        switch(isa)
+        {
+#if defined(HEXDECODER_X86)
+            case Isa::Avx2:
+                {
+                    static const bool avx2 = cpuHasAvx2();
+                    return avx2;
+                }
+            case Isa::Sse2:
+                {
+                    static const bool sse2 = cpuHasSse2();
+                    return sse2;
+                }
+#else
+            case Isa::Avx2:
+            case Isa::Sse2:
+                return false;
+#endif
+            case Isa::Scalar:
+                return true;
+        }
+        return false;
+    }
+
+    Isa activeIsa()
+    {
+        static const Isa isa = isSupported(Isa::Avx2) ? Isa::Avx2
+                               : (isSupported(Isa::Sse2) ? Isa::Sse2 : Isa::Scalar);
+        return isa;
+    }
+
+    const char *isaName(Isa isa)
+    {
+        switch(isa)
+        {
+            case Isa::Avx2:
+                return "AVX2";
+            case Isa::Sse2:
+                return "SSE2";
+            case Isa::Scalar:
+                return "Scalar";
+        }
+        return "Unknown";
+    }
+
+    int decodeWith(Isa isa, const char *src, int len, char *dst, int capacity)
+    {
+        if(!src || len <= 0 || !dst || capacity < maxDecodedSize(len))
+        {
+            return -1;
+        }
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+        DecodeState st{dst, -1};
+        if(!isSupported(isa))
+        {
+            isa = Isa::Scalar;
+        }
+        switch(isa)
+        {
+#if defined(HEXDECODER_X86)
+            case Isa::Avx2:
+                decodeAvx2(p, p + len, st);
+                break;
+            case Isa::Sse2:
+                decodeSse2(p, p + len, st);
+                break;
+#endif
+            default:
+                decodeScalar(p, p + len, st);
+                break;
+        }
+        //奇数个十六进制字符或没有任何十六进制字符均视为无效
+        const int written = static_cast<int>(st.out - dst);
+        if(st.pending >= 0 || written == 0)
+        {
+            return -1;
+        }
+        return written;
+    }
+
+    int decode(const char *src, int len, char *dst, int capacity)
+    {
+        return decodeWith(activeIsa(), src, len, dst, capacity);
+    }
+}
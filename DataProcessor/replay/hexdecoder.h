@@ -0,0 +1,54 @@
+#ifndef HEXDECODER_H
+#define HEXDECODER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 十六进制文本解码器
+ * 单趟扫描输入：跳过所有非十六进制字符（空格、分隔符等），将剩余的十六进制字符
+ * 两两配对后直接写入调用方提供的缓冲区。根据 CPU 能力在运行期选择 AVX2/SSE2
+ * 向量实现，不支持时回退到标量实现。
+ *
+ * 拒绝规则与原 cleanHexData 保持一致：没有任何十六进制字符，或十六进制字符
+ * 个数为奇数时视为无效输入。
+ */
+namespace HexDecoder
+{
+    ///指令集实现
+    enum class Isa
+    {
+        Scalar, ///< 标量实现
+        Sse2,   ///< SSE2 实现（16 字符/批）
+        Avx2    ///< AVX2 实现（32 字符/批）
+    };
+
+    ///解码输出所需的最大缓冲区大小
+    inline int maxDecodedSize(int srcLen)
+    {
+        return srcLen / 2;
+    }
+
+    /**
+     * @brief 使用当前 CPU 支持的最优实现解码
+     * @param src 十六进制文本
+     * @param len 文本长度
+     * @param dst 输出缓冲区
+     * @param capacity 输出缓冲区容量，应不小于 maxDecodedSize(len)
+     * @return 写入的字节数，无效输入或容量不足时返回 -1
+     */
+    int decode(const char *src, int len, char *dst, int capacity);
+
+    ///使用指定实现解码（用于基准测试与校验），不支持的实现回退到标量
+    int decodeWith(Isa isa, const char *src, int len, char *dst, int capacity);
+
+    ///当前 CPU 是否支持指定实现
+    bool isSupported(Isa isa);
+
+    ///decode() 实际使用的实现
+    Isa activeIsa();
+
+    ///实现名称
+    const char *isaName(Isa isa);
+}
+
+#endif //HEXDECODER_H
@@ -0,0 +1,124 @@
+#include "latencyhistogram.h"
+#include <QJsonArray>
+#include <QtAlgorithms>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : m_counts(BUCKET_COUNT, 0)
+{
+}
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    const quint64 v = qMin(static_cast<quint64>(value), (Q_UINT64_C(1) << MAX_VALUE_BITS) - 1);
+    if(v < static_cast<quint64>(SUB_BUCKET_HALF * 2))
+    {
+        return static_cast<int>(v);
+    }
+    //段号由最高有效位决定，段内取最高 SUB_BUCKET_BITS 位作为子桶
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(v));
+    const int shift = msb - (SUB_BUCKET_BITS - 1);
+    return shift * SUB_BUCKET_HALF + static_cast<int>(v >> shift);
+}
+
+qint64 LatencyHistogram::bucketLower(int index)
+{
+    if(index < SUB_BUCKET_HALF * 2)
+    {
+        return index;
+    }
+    const int shift = index / SUB_BUCKET_HALF - 1;
+    return static_cast<qint64>(index - shift * SUB_BUCKET_HALF) << shift;
+}
+
+qint64 LatencyHistogram::bucketUpper(int index)
+{
+    if(index < SUB_BUCKET_HALF * 2)
+    {
+        return index;
+    }
+    const int shift = index / SUB_BUCKET_HALF - 1;
+    return (static_cast<qint64>(index - shift * SUB_BUCKET_HALF + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 value)
+{
+    value = qMax<qint64>(0, value);
+    m_counts[bucketIndex(value)]++;
+    if(m_count == 0 || value < m_min)
+    {
+        m_min = value;
+    }
+    m_max = qMax(m_max, value);
+    m_sum += static_cast<double>(value);
+    m_count++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if(other.m_count == 0)
+    {
+        return;
+    }
+    for(int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = m_count == 0 ? other.m_min : qMin(m_min, other.m_min);
+    m_max = qMax(m_max, other.m_max);
+    m_sum += other.m_sum;
+    m_count += other.m_count;
+}
+
+void LatencyHistogram::reset()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    if(m_count == 0)
+    {
+        return 0;
+    }
+    //第 rank 个样本（从 1 计）所在桶的上界
+    const double clamped = qBound(0.0, percent, 100.0);
+    const qint64 rank = qMax<qint64>(1, static_cast<qint64>(std::ceil(clamped / 100.0 * static_cast<double>(m_count))));
+    qint64 seen = 0;
+    for(int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_counts[i];
+        if(seen >= rank)
+        {
+            return qBound(m_min, bucketUpper(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    QJsonObject object;
+    object["count"] = m_count;
+    object["min"] = min();
+    object["mean"] = mean();
+    object["p50"] = percentile(50.0);
+    object["p90"] = percentile(90.0);
+    object["p99"] = percentile(99.0);
+    object["p999"] = percentile(99.9);
+    object["max"] = m_max;
+    QJsonArray buckets;
+    for(int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if(m_counts[i] > 0)
+        {
+            buckets.append(QJsonArray{bucketLower(i), bucketUpper(i), m_counts[i]});
+        }
+    }
+    object["buckets"] = buckets;
+    return object;
+}
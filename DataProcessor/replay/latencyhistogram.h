@@ -0,0 +1,77 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QJsonObject>
+
+/**
+ * @brief 对数线性分桶直方图（HDR 风格）
+ * 数值按最高有效位分段，每段再等分为 64 个子桶，相对误差不超过 1/64（约 1.6%），
+ * 小于 128 的数值精确记录。记录为 O(1)，百分位按桶累计计数求得，
+ * 返回所在桶的上界（不超过实际最大值）。
+ * 超过上限（约 18 分钟的纳秒数）的数值计入最高桶，最大值仍按实际记录。
+ * 非线程安全，由调用方加锁。
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    ///记录一个数值（负数按 0 记录）
+    void record(qint64 value);
+
+    ///合并另一个直方图
+    void merge(const LatencyHistogram &other);
+
+    ///清空
+    void reset();
+
+    ///样本数
+    qint64 count() const { return m_count; }
+
+    ///最小值（无样本时为 0）
+    qint64 min() const { return m_count > 0 ? m_min : 0; }
+
+    ///最大值（无样本时为 0）
+    qint64 max() const { return m_max; }
+
+    ///平均值
+    double mean() const { return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0; }
+
+    /**
+     * @brief 百分位数
+     * @param percent 百分位（0-100）
+     * @return 至少 percent% 的样本不大于该值
+     */
+    qint64 percentile(double percent) const;
+
+    /**
+     * @brief 导出为 JSON
+     * 包含样本数、最小/平均/最大值、常用百分位以及非空桶（[下界, 上界, 计数]）
+     */
+    QJsonObject toJson() const;
+
+private:
+    ///数值所在的桶
+    static int bucketIndex(qint64 value);
+
+    ///桶的下界
+    static qint64 bucketLower(int index);
+
+    ///桶的上界（含）
+    static qint64 bucketUpper(int index);
+
+    static const int SUB_BUCKET_BITS = 7;                        ///< 子桶位数（段内 64 个子桶）
+    static const int SUB_BUCKET_HALF = 1 << (SUB_BUCKET_BITS - 1); ///< 每段子桶数
+    static const int MAX_VALUE_BITS = 40;                        ///< 可区分的最大数值位数
+    static const int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF; ///< 桶总数
+
+    QVector<qint64> m_counts; ///< 各桶计数
+    qint64 m_count = 0;       ///< 样本数
+    qint64 m_min = 0;         ///< 最小值
+    qint64 m_max = 0;         ///< 最大值
+    double m_sum = 0.0;       ///< 数值总和
+};
+
+#endif //LATENCYHISTOGRAM_H
@@ -0,0 +1,73 @@
+#include "packetarena.h"
+#include <cstring>
+
+void PacketArena::reset(qint64 budgetBytes)
+{
+    release();
+    m_budgetBytes = budgetBytes;
+    m_collecting = budgetBytes > 0;
+}
+
+void PacketArena::release()
+{
+    m_collecting = false;
+    m_segments = QVector<QByteArray>();
+    m_segmentUsed = 0;
+    m_segmentBytes = 0;
+    m_packets = QVector<Packet>();
+    m_fileStarts = QVector<int>();
+    m_payloadBytes = 0;
+}
+
+void PacketArena::beginFile()
+{
+    if(m_collecting)
+    {
+        m_fileStarts.append(m_packets.size());
+    }
+}
+
+qint64 PacketArena::usedBytes() const
+{
+    return m_segmentBytes + static_cast<qint64>(m_packets.capacity()) * sizeof(Packet);
+}
+
+bool PacketArena::append(qint64 timestampUs, quint16 flags, quint16 topic, const char *data, int length)
+{
+    if(!m_collecting)
+    {
+        return false;
+    }
+    //当前段放不下时开新段，单包不跨段；超过段大小的包（.dpcap 记录长度只受文件大小限制）单独占用一段，
+    //其后的包因已用字节超过段大小而另开新段
+    if(m_segments.isEmpty() || m_segmentUsed + static_cast<qint64>(length) > SEGMENT_SIZE)
+    {
+        const qint64 segmentSize = length > SEGMENT_SIZE ? static_cast<qint64>(length) : SEGMENT_SIZE;
+        if(usedBytes() + segmentSize > m_budgetBytes)
+        {
+            release();
+            return false;
+        }
+        m_segments.append(QByteArray(static_cast<int>(segmentSize), Qt::Uninitialized));
+        m_segmentBytes += segmentSize;
+        m_segmentUsed = 0;
+    }
+    //包表扩容前检查预算（QVector 按倍数增长）
+    if(m_packets.size() == m_packets.capacity()
+            && usedBytes() + static_cast<qint64>(m_packets.capacity()) * sizeof(Packet) > m_budgetBytes)
+    {
+        release();
+        return false;
+    }
+    Packet packet;
+    packet.timestampUs = timestampUs;
+    packet.offset = (static_cast<qint64>(m_segments.size() - 1) << SEGMENT_BITS) | m_segmentUsed;
+    packet.length = length;
+    packet.topic = topic;
+    packet.flags = flags;
+    std::memcpy(m_segments.last().data() + m_segmentUsed, data, static_cast<size_t>(length));
+    m_segmentUsed += length;
+    m_payloadBytes += length;
+    m_packets.append(packet);
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef PACKETARENA_H
+#define PACKETARENA_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief 循环回放的数据包预载区
+ * 第一轮回放时把解码、过滤后的数据包依次追加到连续的存储段中，并记录每包的偏移、长度、
+ * 时间戳与主题号；之后的每一轮直接从内存发送，不再打开文件、解析文本或解码十六进制。
+ *
+ * 载荷按 16 MB 的段连续存放（单包不跨段），超过 16 MB 的包单独占用一段，段一经分配不再移动。
+ * 载荷与包表的总占用超过预算时立即释放全部内存并停止收集，调用方改为逐文件读取。
+ * 仅供单个线程使用。
+ */
+class PacketArena
+{
+public:
+    ///预载的数据包
+    struct Packet
+    {
+        qint64 timestampUs; ///< 抓包时间（微秒）
+        qint64 offset;      ///< 载荷位置（高位为段号，低位为段内偏移）
+        int length;         ///< 载荷长度
+        quint16 topic;      ///< 主题号
+        quint16 flags;      ///< 时间戳标志（Dpcap::RecordFlag）
+    };
+
+    PacketArena() = default;
+
+    ///清空并按预算开始收集
+    ///@param budgetBytes 内存预算（字节），不大于 0 时不收集
+    void reset(qint64 budgetBytes);
+
+    ///释放全部内存并停止收集
+    void release();
+
+    ///预载区是否可用（已开始收集且未超出预算）
+    bool isActive() const { return m_collecting; }
+
+    ///开始下一个文件（文件序号与调用次数一一对应）
+    void beginFile();
+
+    /**
+     * @brief 追加一个数据包
+     * @return 超出预算时释放全部内存并返回 false，之后的调用均被忽略
+     */
+    bool append(qint64 timestampUs, quint16 flags, quint16 topic, const char *data, int length);
+
+    ///文件数
+    int fileCount() const { return m_fileStarts.size(); }
+
+    ///文件的首包序号
+    int fileBegin(int file) const { return m_fileStarts[file]; }
+
+    ///文件的末包序号之后
+    int fileEnd(int file) const { return file + 1 < m_fileStarts.size() ? m_fileStarts[file + 1] : m_packets.size(); }
+
+    ///包数
+    int packetCount() const { return m_packets.size(); }
+
+    ///数据包
+    const Packet &packet(int index) const { return m_packets[index]; }
+
+    ///数据包载荷
+    const char *data(const Packet &packet) const
+    {
+        return m_segments[static_cast<int>(packet.offset >> SEGMENT_BITS)].constData() + (packet.offset & SEGMENT_MASK);
+    }
+
+    ///载荷字节数
+    qint64 payloadBytes() const { return m_payloadBytes; }
+
+    ///内存占用（已分配的段与包表）
+    qint64 usedBytes() const;
+
+private:
+    static const int SEGMENT_BITS = 24;
+    static const qint64 SEGMENT_SIZE = Q_INT64_C(1) << SEGMENT_BITS;
+    static const qint64 SEGMENT_MASK = SEGMENT_SIZE - 1;
+
+    qint64 m_budgetBytes = 0;       ///< 内存预算
+    bool m_collecting = false;      ///< 是否正在收集
+    QVector<QByteArray> m_segments; ///< 载荷存储段
+    int m_segmentUsed = 0;          ///< 最后一段的已用字节
+    qint64 m_segmentBytes = 0;      ///< 全部段的字节数
+    QVector<Packet> m_packets;      ///< 包表
+    QVector<int> m_fileStarts;      ///< 各文件的首包序号
+    qint64 m_payloadBytes = 0;      ///< 载荷字节数
+};
+
+#endif //PACKETARENA_H
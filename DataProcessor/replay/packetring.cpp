@@ -0,0 +1,86 @@
+#include "packetring.h"
+
+PacketRing::PacketRing(int slotCount, int arenaBytes)
+{
+    int capacity = 1;
+    while(capacity < slotCount)
+    {
+        capacity <<= 1;
+    }
+    m_slots.resize(capacity);
+    m_slotMask = static_cast<quint64>(capacity - 1);
+    m_arenaSize = arenaBytes;
+    m_arena.resize(arenaBytes);
+}
+
+char *PacketRing::reserve(int maxLength, int fanout)
+{
+    if(maxLength <= 0 || maxLength > m_arenaSize || fanout <= 0 || fanout > slotCapacity())
+    {
+        return nullptr;
+    }
+    //槽位检查
+    const quint64 head = m_head.load(std::memory_order_relaxed);
+    if(head - m_tail.load(std::memory_order_acquire) + static_cast<quint64>(fanout) > m_slotMask + 1)
+    {
+        return nullptr;
+    }
+    //字节区检查：载荷必须连续，尾部放不下时跳到开头
+    const quint64 arenaSize = static_cast<quint64>(m_arenaSize);
+    quint64 start = m_arenaWrite;
+    const quint64 pos = start % arenaSize;
+    if(pos + static_cast<quint64>(maxLength) > arenaSize)
+    {
+        start += arenaSize - pos;
+    }
+    if(start + static_cast<quint64>(maxLength) - m_arenaRead.load(std::memory_order_acquire) > arenaSize)
+    {
+        return nullptr;
+    }
+    m_reserved = start;
+    return m_arena.data() + static_cast<int>(start % arenaSize);
+}
+
+void PacketRing::publish(int length, const int *destinations, int fanout, qint64 dueNs, quint16 topic)
+{
+    const quint64 head = m_head.load(std::memory_order_relaxed);
+    const quint64 end = m_reserved + static_cast<quint64>(length);
+    const int offset = static_cast<int>(m_reserved % static_cast<quint64>(m_arenaSize));
+    for(int i = 0; i < fanout; ++i)
+    {
+        Slot &slot = m_slots[static_cast<int>((head + static_cast<quint64>(i)) & m_slotMask)];
+        slot.dueNs = dueNs;
+        //共用载荷只在最后一个槽位释放时回收
+        slot.arenaEnd = (i == fanout - 1) ? end : 0;
+        slot.offset = offset;
+        slot.length = length;
+        slot.destination = destinations[i];
+        slot.topic = topic;
+    }
+    m_arenaWrite = end;
+    m_head.store(head + static_cast<quint64>(fanout), std::memory_order_release);
+    const int depth = static_cast<int>(head + static_cast<quint64>(fanout) - m_tail.load(std::memory_order_relaxed));
+    if(depth > m_highWater.load(std::memory_order_relaxed))
+    {
+        m_highWater.store(depth, std::memory_order_relaxed);
+    }
+}
+
+void PacketRing::release(int count)
+{
+    const quint64 tail = m_tail.load(std::memory_order_relaxed);
+    quint64 arenaEnd = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        const Slot &slot = m_slots[static_cast<int>((tail + static_cast<quint64>(i)) & m_slotMask)];
+        if(slot.arenaEnd > arenaEnd)
+        {
+            arenaEnd = slot.arenaEnd;
+        }
+    }
+    if(arenaEnd > m_arenaRead.load(std::memory_order_relaxed))
+    {
+        m_arenaRead.store(arenaEnd, std::memory_order_release);
+    }
+    m_tail.store(tail + static_cast<quint64>(count), std::memory_order_release);
+}
@@ -0,0 +1,120 @@
+#ifndef PACKETRING_H
+#define PACKETRING_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief 单生产者/单消费者无锁数据包环形队列
+ * 由两部分预分配内存组成：
+ *   - 字节区（arena）：连续存放数据包载荷，不足以容纳时跳到开头（尾部留空）；
+ *   - 槽位环：每个槽位记录载荷位置、长度、目标索引、调度时刻与主题号。
+ * 同一载荷发往多个目标时共用一份字节，只占用多个槽位。
+ *
+ * 生产者调用 reserve() 取得可写区域，直接在其中解码数据，再调用 publish() 发布；
+ * 未发布的预留区域在下次 reserve() 时被覆盖，无需回滚。
+ * 消费者通过 available()/peek() 读取，处理完成后 release() 归还空间。
+ * 队列本身不阻塞，满/空时的等待策略由使用者决定。
+ */
+class PacketRing
+{
+public:
+    ///槽位
+    struct Slot
+    {
+        qint64 dueNs;       ///< 调度时刻
+        quint64 arenaEnd;   ///< 释放该槽位后字节区可回收到的位置（0 表示不回收）
+        int offset;         ///< 载荷在字节区中的偏移
+        int length;         ///< 载荷长度
+        int destination;    ///< 目标索引
+        quint16 topic;      ///< 主题号
+    };
+
+    /**
+     * @brief 构造环形队列
+     * @param slotCount 槽位数量（向上取整为 2 的幂）
+     * @param arenaBytes 字节区容量
+     */
+    PacketRing(int slotCount, int arenaBytes);
+
+    ///单个载荷的最大长度
+    int maxPayload() const { return m_arenaSize; }
+
+    ///槽位容量
+    int slotCapacity() const { return static_cast<int>(m_slotMask + 1); }
+
+    //---------------- 生产者接口 ----------------
+
+    /**
+     * @brief 预留载荷空间
+     * @param maxLength 载荷最大长度
+     * @param fanout 需要的槽位数（目标数）
+     * @return 可写指针，空间或槽位不足时返回 nullptr
+     */
+    char *reserve(int maxLength, int fanout);
+
+    /**
+     * @brief 发布最近一次预留的载荷
+     * @param length 实际长度（不超过预留长度）
+     * @param destinations 目标索引数组
+     * @param fanout 目标数（与 reserve 一致）
+     * @param dueNs 调度时刻
+     * @param topic 主题号
+     */
+    void publish(int length, const int *destinations, int fanout, qint64 dueNs, quint16 topic);
+
+    //---------------- 消费者接口 ----------------
+
+    ///待处理槽位数
+    int available() const
+    {
+        return static_cast<int>(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed));
+    }
+
+    ///第 index 个待处理槽位（index < available()）
+    const Slot &peek(int index) const
+    {
+        return m_slots[static_cast<int>((m_tail.load(std::memory_order_relaxed) + static_cast<quint64>(index)) & m_slotMask)];
+    }
+
+    ///槽位载荷
+    const char *payload(const Slot &slot) const
+    {
+        return m_arena.constData() + slot.offset;
+    }
+
+    ///释放前 count 个槽位
+    void release(int count);
+
+    //---------------- 统计 ----------------
+
+    ///当前深度（槽位数，任意线程可读）
+    int depth() const
+    {
+        return static_cast<int>(m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed));
+    }
+
+    ///历史最大深度
+    int highWater() const { return m_highWater.load(std::memory_order_relaxed); }
+
+private:
+    QVector<Slot> m_slots;          ///< 槽位环
+    QVector<char> m_arena;          ///< 载荷字节区
+    quint64 m_slotMask = 0;         ///< 槽位下标掩码
+    int m_arenaSize = 0;            ///< 字节区容量
+
+    //生产者私有状态
+    quint64 m_arenaWrite = 0;       ///< 字节区写入位置（单调递增）
+    quint64 m_reserved = 0;         ///< 最近一次预留的起始位置
+    char m_padProducer[64];         ///< 避免与消费者变量伪共享
+
+    std::atomic<quint64> m_head{0};      ///< 已发布槽位计数（生产者写）
+    char m_padHead[64];
+    std::atomic<quint64> m_tail{0};      ///< 已释放槽位计数（消费者写）
+    std::atomic<quint64> m_arenaRead{0}; ///< 字节区可回收位置（消费者写）
+    char m_padTail[64];
+    std::atomic<int> m_highWater{0};     ///< 历史最大深度
+};
+
+#endif //PACKETRING_H
@@ -0,0 +1,282 @@
+#include "parsepipeline.h"
+#include "capturereader.h"
+#include "dpcapfile.h"
+#include "hexdecoder.h"
+#include "replayscheduler.h"
+#include "seekindex.h"
+#include <QtConcurrent>
+#include <QElapsedTimer>
+
+namespace
+{
+    ///单个数据块的载荷上限
+    const int CHUNK_BYTES = 4 * 1024 * 1024;
+    ///单个数据块的数据包上限
+    const int CHUNK_PACKETS = 65536;
+    ///每个解析线程最多领先消费者的文件数
+    const int FILES_AHEAD_PER_THREAD = 2;
+}
+
+ParsePipeline::ParsePipeline(int threads, qint64 budgetBytes)
+    : m_threads(qMax(1, threads))
+    , m_budgetBytes(budgetBytes)
+{
+    m_pool.setMaxThreadCount(m_threads);
+    for(int i = 0; i < m_threads; ++i)
+    {
+        m_futures.append(QtConcurrent::run(&m_pool, [this]() { run(); }));
+    }
+}
+
+ParsePipeline::~ParsePipeline()
+{
+    stop();
+    for(QFuture<void> &future : m_futures)
+    {
+        future.waitForFinished();
+    }
+}
+
+int ParsePipeline::addFile(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_files.append(filePath);
+    m_spaceReady.wakeAll();
+    return m_files.size() - 1;
+}
+
+void ParsePipeline::finishInput()
+{
+    QMutexLocker locker(&m_mutex);
+    m_inputFinished = true;
+    m_spaceReady.wakeAll();
+}
+
+void ParsePipeline::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopped = true;
+    m_slots.clear();
+    m_bufferedBytes = 0;
+    m_chunkReady.wakeAll();
+    m_spaceReady.wakeAll();
+}
+
+qint64 ParsePipeline::peakBufferedBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_peakBytes;
+}
+
+bool ParsePipeline::take(int fileIndex, Chunk &chunk)
+{
+    QMutexLocker locker(&m_mutex);
+    //消费者前进：丢弃之前文件的剩余缓存，并允许解析线程领取更多文件
+    if(fileIndex > m_consumerFile)
+    {
+        dropBefore(fileIndex);
+    }
+    while(!m_stopped)
+    {
+        auto it = m_slots.find(fileIndex);
+        if(it != m_slots.end() && !it->chunks.isEmpty())
+        {
+            chunk = it->chunks.dequeue();
+            m_bufferedBytes -= chunkBytes(chunk);
+            if(chunk.last)
+            {
+                m_slots.erase(it);
+            }
+            m_spaceReady.wakeAll();
+            return true;
+        }
+        m_chunkReady.wait(&m_mutex);
+    }
+    return false;
+}
+
+void ParsePipeline::skipTo(int fileIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    if(fileIndex > m_consumerFile)
+    {
+        dropBefore(fileIndex);
+    }
+    m_nextFile = qMax(m_nextFile, fileIndex);
+}
+
+void ParsePipeline::dropBefore(int fileIndex)
+{
+    auto it = m_slots.begin();
+    while(it != m_slots.end() && it.key() < fileIndex)
+    {
+        for(const Chunk &stale : it->chunks)
+        {
+            m_bufferedBytes -= chunkBytes(stale);
+        }
+        it = m_slots.erase(it);
+    }
+    m_consumerFile = fileIndex;
+    m_spaceReady.wakeAll();
+}
+
+void ParsePipeline::run()
+{
+    while(true)
+    {
+        QMutexLocker locker(&m_mutex);
+        //按序领取文件，且不超过领先窗口
+        while(!m_stopped && (m_nextFile >= m_files.size()
+                             || m_nextFile >= m_consumerFile + m_threads * FILES_AHEAD_PER_THREAD))
+        {
+            if(m_inputFinished && m_nextFile >= m_files.size())
+            {
+                return;
+            }
+            m_spaceReady.wait(&m_mutex);
+        }
+        if(m_stopped)
+        {
+            return;
+        }
+        const int fileIndex = m_nextFile++;
+        const QString filePath = m_files[fileIndex];
+        locker.unlock();
+        parseFile(fileIndex, filePath);
+    }
+}
+
+void ParsePipeline::parseFile(int fileIndex, const QString &filePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+    qint64 pushNs = 0;
+    Chunk chunk;
+    chunk.last = true;
+    //.dpcap 无需解析
+    if(Dpcap::isDpcapFile(filePath))
+    {
+        chunk.kind = ChunkKind::Passthrough;
+        pushChunk(fileIndex, chunk);
+        return;
+    }
+    CaptureReader reader;
+    if(!reader.open(filePath))
+    {
+        chunk.kind = ChunkKind::Error;
+        chunk.error = reader.errorString();
+        pushChunk(fileIndex, chunk);
+        return;
+    }
+    chunk.last = false;
+    chunk.payload.resize(CHUNK_BYTES);
+    int used = 0;
+    //旁路定位索引缺失或过期时顺带生成（时间戳与主题号本来就要解析）
+    const bool indexing = !SeekIndex::isUpToDate(filePath);
+    SeekIndexBuilder indexBuilder;
+    CaptureRecord record;
+    while(true)
+    {
+        const qint64 lineOffset = reader.position();
+        const int lineIndex = reader.lineNumber();
+        const CaptureReader::LineResult result = reader.next(record);
+        if(result == CaptureReader::LineResult::End)
+        {
+            break;
+        }
+        Packet packet{0, used, 0, record.lineNumber, 0, 0, LineStatus::Ok, reader.position()};
+        if(result == CaptureReader::LineResult::FormatError)
+        {
+            packet.status = LineStatus::FormatError;
+        }
+        else
+        {
+            //直接解码到块载荷末尾
+            const int capacity = HexDecoder::maxDecodedSize(record.hexData.size());
+            if(used + capacity > chunk.payload.size())
+            {
+                chunk.payload.resize(used + capacity);
+            }
+            const int size = capacity > 0
+                             ? HexDecoder::decode(record.hexData.data(), record.hexData.size(), chunk.payload.data() + used, capacity)
+                             : -1;
+            if(size <= 0)
+            {
+                packet.status = LineStatus::InvalidHex;
+            }
+            else if(size < 4)
+            {
+                packet.status = LineStatus::TooShort;
+            }
+            else
+            {
+                bool hasDate = false;
+                if(ReplayScheduler::parseTimestamp(record.timestamp, packet.timestampUs, &hasDate))
+                {
+                    packet.flags = static_cast<quint16>(Dpcap::TimestampValid | (hasDate ? Dpcap::TimestampHasDate : 0));
+                }
+                packet.topic = Dpcap::topicOf(chunk.payload.constData() + used, size);
+                packet.length = size;
+                used += size;
+                if(indexing)
+                {
+                    indexBuilder.add(lineOffset, lineIndex, (packet.flags & Dpcap::TimestampValid) != 0,
+                                     packet.timestampUs, hasDate, packet.topic);
+                }
+            }
+        }
+        chunk.packets.append(packet);
+        if(used >= CHUNK_BYTES || chunk.packets.size() >= CHUNK_PACKETS)
+        {
+            chunk.payload.resize(used);
+            //提交时可能因预算等待，该段时间不计入解析耗时
+            const qint64 pushStartNs = timer.nsecsElapsed();
+            if(!pushChunk(fileIndex, chunk))
+            {
+                return;
+            }
+            pushNs += timer.nsecsElapsed() - pushStartNs;
+            chunk = Chunk();
+            chunk.payload.resize(CHUNK_BYTES);
+            used = 0;
+        }
+    }
+    chunk.payload.resize(used);
+    chunk.last = true;
+    chunk.parseNs = timer.nsecsElapsed() - pushNs;
+    chunk.error = reader.errorString();
+    if(indexing && chunk.error.isEmpty())
+    {
+        //写入失败（如只读目录）不影响回放，需要定位时再扫描生成
+        QString error;
+        indexBuilder.save(filePath, error);
+    }
+    pushChunk(fileIndex, chunk);
+}
+
+bool ParsePipeline::pushChunk(int fileIndex, Chunk &chunk)
+{
+    const qint64 bytes = chunkBytes(chunk);
+    QMutexLocker locker(&m_mutex);
+    //超出预算时等待；消费者当前文件不受限制，保证总能前进
+    while(!m_stopped && fileIndex > m_consumerFile && m_bufferedBytes > 0
+          && m_bufferedBytes + bytes > m_budgetBytes)
+    {
+        m_spaceReady.wait(&m_mutex);
+    }
+    //已停止或消费者已越过该文件：放弃
+    if(m_stopped || fileIndex < m_consumerFile)
+    {
+        return false;
+    }
+    m_slots[fileIndex].chunks.enqueue(chunk);
+    m_bufferedBytes += bytes;
+    m_peakBytes = qMax(m_peakBytes, m_bufferedBytes);
+    m_chunkReady.wakeAll();
+    return true;
+}
+
+qint64 ParsePipeline::chunkBytes(const Chunk &chunk)
+{
+    return chunk.payload.size() + static_cast<qint64>(chunk.packets.size()) * static_cast<qint64>(sizeof(Packet));
+}
@@ -0,0 +1,149 @@
+#ifndef PARSEPIPELINE_H
+#define PARSEPIPELINE_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+/**
+ * @brief 多线程解析流水线
+ * 若干解析线程提前解析后续的文本抓包（解码十六进制、解析时间戳、提取主题号），
+ * 结果以数据块的形式缓存；消费者（WorkerClass）按文件序号依次取用，
+ * 因此发送顺序与文件列表、行顺序完全一致，与解析线程的完成先后无关。
+ *
+ * 缓存总量受预算限制：超出预算时，除消费者当前所在文件外的解析线程暂停，
+ * 当前文件始终可以继续解析，不会因预算而死锁。
+ * .dpcap 文件无需解析，以直通块交由消费者直接读取。
+ * 文本抓包的旁路定位索引（SeekIndex）过期时，在完整解析该文件的同时生成。
+ */
+class ParsePipeline
+{
+public:
+    ///单行解析结果
+    enum class LineStatus : quint8
+    {
+        Ok,          ///< 有效数据包
+        FormatError, ///< 字段数量不足
+        InvalidHex,  ///< 无效十六进制数据
+        TooShort     ///< 数据长度不足 4 字节
+    };
+
+    ///解析后的数据包
+    struct Packet
+    {
+        qint64 timestampUs; ///< 抓包时间（微秒）
+        int offset;         ///< 载荷在块内的偏移
+        int length;         ///< 载荷长度
+        int lineNumber;     ///< 行号
+        quint16 topic;      ///< 主题号
+        quint16 flags;      ///< 时间戳标志（Dpcap::RecordFlag）
+        LineStatus status;  ///< 解析结果
+        qint64 endOffset;   ///< 该行之后的字节偏移（断点续播的读取起点）
+    };
+
+    ///数据块类型
+    enum class ChunkKind
+    {
+        Data,        ///< 已解析数据
+        Passthrough, ///< 无需解析（.dpcap），由消费者直接读取
+        Error        ///< 文件打开失败
+    };
+
+    ///数据块
+    struct Chunk
+    {
+        ChunkKind kind = ChunkKind::Data;
+        QByteArray payload;      ///< 连续存放的载荷
+        QVector<Packet> packets; ///< 数据包
+        QString error;           ///< 错误信息（Error 块；最后一块非空表示文件未能读完，如压缩数据损坏）
+        bool last = false;       ///< 是否为该文件的最后一块
+        qint64 parseNs = 0;      ///< 整个文件的解析耗时（纳秒，仅最后一块填写，不含等待缓存空间）
+    };
+
+    /**
+     * @brief 构造流水线
+     * @param threads 解析线程数
+     * @param budgetBytes 缓存预算（字节）
+     */
+    ParsePipeline(int threads, qint64 budgetBytes);
+    ~ParsePipeline();
+
+    ///追加待解析文件（按回放顺序），返回文件序号
+    int addFile(const QString &filePath);
+
+    ///文件列表已全部给出
+    void finishInput();
+
+    /**
+     * @brief 取出指定文件的下一个数据块（阻塞）
+     * 取用新文件时，之前文件的剩余缓存被丢弃。
+     * @param fileIndex 文件序号
+     * @param chunk 输出参数
+     * @return 流水线已停止时返回 false
+     */
+    bool take(int fileIndex, Chunk &chunk);
+
+    /**
+     * @brief 跳过指定序号之前的文件（跳转后由消费者调用）
+     * 之前文件的缓存被丢弃，尚未领取的文件不再解析，正在解析的结果提交时被放弃。
+     */
+    void skipTo(int fileIndex);
+
+    ///停止所有解析线程（可在任意线程调用）
+    void stop();
+
+    ///解析线程数
+    int threadCount() const { return m_threads; }
+
+    ///缓存历史峰值（字节）
+    qint64 peakBufferedBytes() const;
+
+private:
+    ParsePipeline(const ParsePipeline &) = delete;
+    ParsePipeline &operator=(const ParsePipeline &) = delete;
+
+    ///单个文件的解析状态
+    struct FileSlot
+    {
+        QQueue<Chunk> chunks;    ///< 已解析、待取用的数据块
+    };
+
+    ///解析线程主循环
+    void run();
+
+    ///解析单个文件
+    void parseFile(int fileIndex, const QString &filePath);
+
+    ///丢弃指定序号之前文件的缓存（需持有锁）
+    void dropBefore(int fileIndex);
+
+    ///提交数据块，超出预算时等待（当前文件除外）
+    bool pushChunk(int fileIndex, Chunk &chunk);
+
+    static qint64 chunkBytes(const Chunk &chunk);
+
+    const int m_threads;           ///< 解析线程数
+    const qint64 m_budgetBytes;    ///< 缓存预算
+    QThreadPool m_pool;            ///< 解析线程池
+    QVector<QFuture<void>> m_futures; ///< 解析任务
+
+    mutable QMutex m_mutex;        ///< 状态互斥锁
+    QWaitCondition m_chunkReady;   ///< 有新数据块
+    QWaitCondition m_spaceReady;   ///< 缓存有空余或文件可领取
+    QStringList m_files;           ///< 文件列表
+    QMap<int, FileSlot> m_slots;   ///< 尚未取用完毕的文件
+    int m_nextFile = 0;            ///< 下一个待领取的文件序号
+    int m_consumerFile = 0;        ///< 消费者当前文件序号
+    bool m_inputFinished = false;  ///< 文件列表是否完整
+    bool m_stopped = false;        ///< 是否已停止
+    qint64 m_bufferedBytes = 0;    ///< 当前缓存量
+    qint64 m_peakBytes = 0;        ///< 缓存峰值
+};
+
+#endif //PARSEPIPELINE_H
@@ -0,0 +1,382 @@
+#include "replayscheduler.h"
+#include <QDate>
+#include <QThread>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <time.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+namespace
+{
+    ///粗睡眠单次最长时长，保证暂停/停止能及时响应
+    const qint64 COARSE_SLICE_NS = 2000000;
+
+#if defined(Q_OS_WIN)
+    ///Windows 即便设置 1ms 定时精度，睡眠仍可能超出 1~2ms，需要更长的自旋窗口
+    const qint64 SPIN_WINDOW_NS = 2000000;
+#else
+    ///Linux 下 clock_nanosleep 的超时通常在 50~100us
+    const qint64 SPIN_WINDOW_NS = 200000;
+#endif
+
+    const qint64 US_PER_DAY = 86400LL * 1000000LL;
+
+    void sleepNs(qint64 ns)
+    {
+        if(ns <= 0)
+        {
+            return;
+        }
+#if defined(Q_OS_LINUX)
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+#else
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+#endif
+    }
+
+    inline bool isTrimChar(char c)
+    {
+        return c == ' ' || c == '\t' || c == '[' || c == ']';
+    }
+
+    ///读取至多 maxDigits 位十进制数，返回实际位数
+    int readDigits(const char *&p, const char *end, int maxDigits, qint64 &value)
+    {
+        int count = 0;
+        value = 0;
+        while(p < end && count < maxDigits && *p >= '0' && *p <= '9')
+        {
+            value = value * 10 + (*p - '0');
+            ++p;
+            ++count;
+        }
+        return count;
+    }
+
+    ///读取小数部分（不含小数点）并换算为微秒，超过 6 位的部分截断
+    qint64 readFractionUs(const char *&p, const char *end)
+    {
+        qint64 us = 0;
+        int digits = 0;
+        while(p < end && *p >= '0' && *p <= '9')
+        {
+            if(digits < 6)
+            {
+                us = us * 10 + (*p - '0');
+                ++digits;
+            }
+            ++p;
+        }
+        while(digits < 6)
+        {
+            us *= 10;
+            ++digits;
+        }
+        return us;
+    }
+}
+
+ReplayScheduler::~ReplayScheduler()
+{
+    finish();
+}
+
+void ReplayScheduler::configure(Mode mode, double speedFactor, int intervalMs)
+{
+    m_mode = mode;
+    m_speed = speedFactor;
+    m_intervalNs = intervalMs > 0 ? static_cast<qint64>(intervalMs) * 1000000LL : 0;
+}
+
+void ReplayScheduler::configureInterval(qint64 intervalNs)
+{
+    m_mode = Mode::Interval;
+    m_speed = 1.0;
+    m_intervalNs = intervalNs > 0 ? intervalNs : 0;
+}
+
+void ReplayScheduler::start()
+{
+#if defined(Q_OS_WIN)
+    //默认 15.6ms 的系统定时精度无法支撑粗睡眠阶段，回放期间提升到 1ms
+    if(!m_highResolution && timeBeginPeriod(1) == TIMERR_NOERROR)
+    {
+        m_highResolution = true;
+    }
+#endif
+    m_pauseOffsetNs.store(0);
+    m_pauseStartNs.store(0);
+    m_lastDueNs = nowNs();
+    m_anchorDueNs = m_lastDueNs;
+    m_anchorCaptureUs = 0;
+    m_lastCaptureUs = 0;
+    m_hasCapture = false;
+}
+
+void ReplayScheduler::rebase()
+{
+    //调度时刻不含暂停偏移，换算回当前的调度时间
+    m_lastDueNs = nowNs() - m_pauseOffsetNs.load();
+    m_anchorDueNs = m_lastDueNs;
+    m_hasCapture = false;
+}
+
+void ReplayScheduler::finish()
+{
+#if defined(Q_OS_WIN)
+    if(m_highResolution)
+    {
+        timeEndPeriod(1);
+    }
+#endif
+    m_highResolution = false;
+}
+
+qint64 ReplayScheduler::schedule(QLatin1String timestamp)
+{
+    if(m_mode == Mode::Interval)
+    {
+        return nextInterval();
+    }
+    if(m_speed <= 0.0)
+    {
+        return AsFastAsPossible;
+    }
+    qint64 captureUs = 0;
+    bool hasDate = false;
+    const bool valid = parseTimestamp(timestamp, captureUs, &hasDate);
+    return scheduleCapture(valid, captureUs, hasDate);
+}
+
+qint64 ReplayScheduler::nextInterval()
+{
+    if(m_intervalNs <= 0)
+    {
+        return AsFastAsPossible;
+    }
+    //首包立即发送，之后每包在上一包基础上顺延固定间隔（绝对时刻，不累积误差）
+    if(!m_hasCapture)
+    {
+        m_hasCapture = true;
+        return m_lastDueNs;
+    }
+    m_lastDueNs += m_intervalNs;
+    return m_lastDueNs;
+}
+
+qint64 ReplayScheduler::scheduleCapture(bool valid, qint64 captureUs, bool hasDate)
+{
+    if(m_mode == Mode::Interval)
+    {
+        return nextInterval();
+    }
+    if(m_speed <= 0.0)
+    {
+        return AsFastAsPossible;
+    }
+    if(!valid)
+    {
+        //无法识别的时间戳：紧随上一包发送
+        return m_lastDueNs;
+    }
+    if(!m_hasCapture)
+    {
+        m_hasCapture = true;
+        m_anchorCaptureUs = captureUs;
+        m_lastCaptureUs = captureUs;
+        return m_lastDueNs;
+    }
+    qint64 delta = captureUs - m_lastCaptureUs;
+    //仅有时分秒的时间戳跨越零点
+    if(!hasDate && delta < -US_PER_DAY / 2)
+    {
+        captureUs += US_PER_DAY;
+        delta += US_PER_DAY;
+    }
+    if(delta < 0)
+    {
+        //时间倒退（文件切换或时钟回拨）：以上一包为新基准，立即发送
+        m_anchorDueNs = m_lastDueNs;
+        m_anchorCaptureUs = captureUs;
+    }
+    m_lastCaptureUs = captureUs;
+    //相对基准计算，避免逐包取整误差累积
+    const double offsetNs = static_cast<double>(captureUs - m_anchorCaptureUs) * 1000.0 / m_speed;
+    m_lastDueNs = m_anchorDueNs + static_cast<qint64>(offsetNs);
+    return m_lastDueNs;
+}
+
+void ReplayScheduler::pause()
+{
+    qint64 expected = 0;
+    m_pauseStartNs.compare_exchange_strong(expected, nowNs());
+}
+
+void ReplayScheduler::resume()
+{
+    const qint64 startedNs = m_pauseStartNs.exchange(0);
+    if(startedNs > 0)
+    {
+        m_pauseOffsetNs.fetch_add(nowNs() - startedNs);
+    }
+}
+
+qint64 ReplayScheduler::toWallNs(qint64 dueNs) const
+{
+    return dueNs + m_pauseOffsetNs.load(std::memory_order_relaxed);
+}
+
+bool ReplayScheduler::waitUntil(qint64 dueNs, const std::function<bool()> &abort, bool precise) const
+{
+    if(dueNs == AsFastAsPossible)
+    {
+        return true;
+    }
+    const qint64 spinWindowNs = precise ? SPIN_WINDOW_NS : 0;
+    while(true)
+    {
+        if(abort && abort())
+        {
+            return false;
+        }
+        const qint64 remaining = toWallNs(dueNs) - nowNs();
+        if(remaining <= 0)
+        {
+            return true;
+        }
+        if(remaining > spinWindowNs)
+        {
+            //粗睡眠：分片进行，留出自旋窗口
+            sleepNs(qMin(remaining - spinWindowNs, COARSE_SLICE_NS));
+            continue;
+        }
+        //末段自旋，让出时间片但不进入内核睡眠
+        while(nowNs() < toWallNs(dueNs))
+        {
+            QThread::yieldCurrentThread();
+        }
+        return true;
+    }
+}
+
+qint64 ReplayScheduler::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool ReplayScheduler::parseTimestamp(QLatin1String text, qint64 &captureUs, bool *hasDate)
+{
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while(p < end && isTrimChar(*p))
+    {
+        ++p;
+    }
+    while(end > p && isTrimChar(*(end - 1)))
+    {
+        --end;
+    }
+    if(p == end)
+    {
+        return false;
+    }
+    qint64 value = 0;
+    //纯数字：Unix 时间
+    if(!std::memchr(p, ':', static_cast<size_t>(end - p)))
+    {
+        if(readDigits(p, end, 18, value) == 0)
+        {
+            return false;
+        }
+        if(p < end && (*p == '.' || *p == ','))
+        {
+            ++p;
+            captureUs = value * 1000000LL + readFractionUs(p, end);
+        }
+        else if(value >= 100000000000000LL)
+        {
+            captureUs = value;                //微秒
+        }
+        else if(value >= 100000000000LL)
+        {
+            captureUs = value * 1000LL;       //毫秒
+        }
+        else
+        {
+            captureUs = value * 1000000LL;    //秒
+        }
+        if(hasDate)
+        {
+            *hasDate = true;
+        }
+        return p == end;
+    }
+    //可选日期部分：yyyy-MM-dd / yyyy/MM/dd / yyyy.MM.dd
+    qint64 dayUs = 0;
+    bool withDate = false;
+    const char *dateStart = p;
+    qint64 year = 0;
+    qint64 month = 0;
+    qint64 day = 0;
+    if(readDigits(p, end, 4, year) == 4 && p < end && (*p == '-' || *p == '/' || *p == '.'))
+    {
+        const char sep = *p++;
+        if(readDigits(p, end, 2, month) == 0 || p >= end || *p++ != sep
+                || readDigits(p, end, 2, day) == 0 || p >= end
+                || (*p != ' ' && *p != 'T' && *p != '_'))
+        {
+            return false;
+        }
+        const QDate date(static_cast<int>(year), static_cast<int>(month), static_cast<int>(day));
+        if(!date.isValid())
+        {
+            return false;
+        }
+        while(p < end && (*p == ' ' || *p == 'T' || *p == '_'))
+        {
+            ++p;
+        }
+        dayUs = date.toJulianDay() * US_PER_DAY;
+        withDate = true;
+    }
+    else
+    {
+        p = dateStart;
+    }
+    //时间部分：hh:mm:ss[.ffffff]
+    qint64 hour = 0;
+    qint64 minute = 0;
+    qint64 second = 0;
+    if(readDigits(p, end, 2, hour) == 0 || p >= end || *p++ != ':'
+            || readDigits(p, end, 2, minute) != 2 || p >= end || *p++ != ':'
+            || readDigits(p, end, 2, second) != 2)
+    {
+        return false;
+    }
+    qint64 fractionUs = 0;
+    if(p < end && (*p == '.' || *p == ','))
+    {
+        ++p;
+        fractionUs = readFractionUs(p, end);
+    }
+    if(p != end || hour > 23 || minute > 59 || second > 60)
+    {
+        return false;
+    }
+    captureUs = dayUs + ((hour * 60 + minute) * 60 + second) * 1000000LL + fractionUs;
+    if(hasDate)
+    {
+        *hasDate = withDate;
+    }
+    return true;
+}
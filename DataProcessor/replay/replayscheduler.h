@@ -0,0 +1,126 @@
+#ifndef REPLAYSCHEDULER_H
+#define REPLAYSCHEDULER_H
+
+#include <QtGlobal>
+#include <QLatin1String>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief 回放调度器
+ * 将抓包中每一行的时间戳（或固定发送间隔）换算为单调时钟上的发送时刻，
+ * 并提供"粗睡眠 + 末段自旋"的高精度等待，使包间抖动保持在几十微秒量级。
+ *
+ * 调度时刻以"调度时间"表示，暂停期间累计的时长记为偏移量，
+ * 生产者（WorkerClass）与发送线程（UdpSender）共享同一偏移，暂停恢复后二者一致顺延。
+ */
+class ReplayScheduler
+{
+public:
+    ///节奏模式
+    enum class Mode
+    {
+        Interval,  ///< 固定发送间隔
+        Timestamp  ///< 按抓包时间戳还原原始节奏
+    };
+
+    ///表示"立即发送"的调度时刻
+    static const qint64 AsFastAsPossible = -1;
+
+    ReplayScheduler() = default;
+    ~ReplayScheduler();
+
+    /**
+     * @brief 配置调度参数
+     * @param mode 节奏模式
+     * @param speedFactor 回放倍速（仅时间戳模式），<=0 表示尽可能快
+     * @param intervalMs 固定发送间隔（仅间隔模式），<=0 表示尽可能快
+     */
+    void configure(Mode mode, double speedFactor, int intervalMs);
+
+    /**
+     * @brief 配置纳秒精度的固定间隔（自定义数据发送的帧发生器使用）
+     * @param intervalNs 帧间隔（纳秒），<=0 表示尽可能快
+     */
+    void configureInterval(qint64 intervalNs);
+
+    ///开始调度（以当前时刻为基准，清空暂停偏移）
+    void start();
+
+    ///跳转后重新定基准：下一包以当前时刻立即发送，之后按新位置的时间戳继续（保留暂停偏移）
+    void rebase();
+
+    ///结束调度，释放高精度定时资源
+    void finish();
+
+    /**
+     * @brief 计算下一包的调度时刻
+     * @param timestamp 该行的时间戳字段（间隔模式下忽略）
+     * @return 调度时刻（纳秒），或 AsFastAsPossible
+     */
+    qint64 schedule(QLatin1String timestamp);
+
+    /**
+     * @brief 按已解析的抓包时间计算下一包的调度时刻（.dpcap 回放使用）
+     * @param valid 时间戳是否有效（无效时紧随上一包）
+     * @param captureUs 抓包时间（微秒）
+     * @param hasDate 是否包含日期
+     * @return 调度时刻（纳秒），或 AsFastAsPossible
+     */
+    qint64 scheduleCapture(bool valid, qint64 captureUs, bool hasDate);
+
+    ///记录暂停开始
+    void pause();
+
+    ///恢复，并将暂停时长累计到偏移量
+    void resume();
+
+    ///调度时刻换算为单调时钟时刻
+    qint64 toWallNs(qint64 dueNs) const;
+
+    /**
+     * @brief 等待直到调度时刻
+     * @param dueNs 调度时刻，AsFastAsPossible 时立即返回
+     * @param abort 中断条件，粗睡眠阶段周期性检查
+     * @param precise 是否在末段自旋以获得微秒级精度
+     * @return 到达时刻返回 true，被中断返回 false
+     */
+    bool waitUntil(qint64 dueNs, const std::function<bool()> &abort, bool precise = true) const;
+
+    ///当前单调时钟时刻（纳秒）
+    static qint64 nowNs();
+
+    /**
+     * @brief 解析抓包时间戳
+     * 支持 "[yyyy-MM-dd hh:mm:ss.ffffff]"、"[hh:mm:ss.fff]" 以及纯数字的
+     * Unix 时间（秒，可带小数；或按量级识别的毫秒/微秒）。
+     * @param text 时间戳字段（可带方括号）
+     * @param captureUs 输出参数，微秒
+     * @param hasDate 输出参数，是否包含日期（仅时分秒时跨零点需要回绕处理）
+     * @return 解析成功返回 true
+     */
+    static bool parseTimestamp(QLatin1String text, qint64 &captureUs, bool *hasDate = nullptr);
+
+private:
+    ReplayScheduler(const ReplayScheduler &) = delete;
+    ReplayScheduler &operator=(const ReplayScheduler &) = delete;
+
+    ///固定间隔模式的下一调度时刻
+    qint64 nextInterval();
+
+    Mode m_mode = Mode::Interval;  ///< 节奏模式
+    double m_speed = 1.0;          ///< 回放倍速
+    qint64 m_intervalNs = 0;       ///< 固定间隔（纳秒）
+
+    qint64 m_lastDueNs = 0;        ///< 上一包调度时刻
+    qint64 m_anchorDueNs = 0;      ///< 时间戳模式的基准调度时刻
+    qint64 m_anchorCaptureUs = 0;  ///< 与基准调度时刻对应的抓包时间
+    qint64 m_lastCaptureUs = 0;    ///< 上一包抓包时间
+    bool m_hasCapture = false;     ///< 是否已有基准抓包时间
+
+    std::atomic<qint64> m_pauseOffsetNs{0}; ///< 累计暂停时长
+    std::atomic<qint64> m_pauseStartNs{0};  ///< 本次暂停开始时刻（0 表示未暂停）
+    bool m_highResolution = false; ///< 是否已申请系统高精度定时
+};
+
+#endif //REPLAYSCHEDULER_H
@@ -0,0 +1,189 @@
+#include "replaytelemetry.h"
+#include "replayscheduler.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace
+{
+    ///速率窗口长度
+    const qint64 RATE_WINDOW_NS = 1000000000LL;
+}
+
+ReplayTelemetry::ReplayTelemetry()
+{
+}
+
+void ReplayTelemetry::start(const QStringList &destinations)
+{
+    QMutexLocker locker(&m_mutex);
+    m_startTime = QDateTime::currentDateTime();
+    m_startNs = ReplayScheduler::nowNs();
+    m_finishNs = 0;
+    m_destinations.clear();
+    for(const QString &address : destinations)
+    {
+        DestinationStats stats;
+        stats.address = address;
+        m_destinations.append(stats);
+    }
+    m_windows.fill(RateWindow(), destinations.size());
+    m_timingError.reset();
+    m_queueDepth.reset();
+    m_earlyPackets = 0;
+    m_files.clear();
+    m_parseNs = 0;
+    m_slowestFile = -1;
+}
+
+void ReplayTelemetry::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_finishNs == 0)
+    {
+        m_finishNs = ReplayScheduler::nowNs();
+    }
+}
+
+void ReplayTelemetry::recordBatch(const Sample *samples, int count, int queueDepth, qint64 nowNs)
+{
+    QMutexLocker locker(&m_mutex);
+    if(queueDepth >= 0)
+    {
+        m_queueDepth.record(queueDepth);
+    }
+    for(int i = 0; i < count; ++i)
+    {
+        const Sample &sample = samples[i];
+        if(sample.destination < 0 || sample.destination >= m_destinations.size())
+        {
+            continue;
+        }
+        DestinationStats &stats = m_destinations[sample.destination];
+        if(!sample.sent)
+        {
+            stats.failed++;
+            continue;
+        }
+        stats.packets++;
+        stats.bytes += sample.bytes;
+        //滚动速率窗口：相邻窗口首尾相接，中间有空档（暂停）时从当前时刻重新开始
+        RateWindow &window = m_windows[sample.destination];
+        if(window.startNs == 0)
+        {
+            window.startNs = nowNs;
+        }
+        else if(nowNs - window.startNs >= RATE_WINDOW_NS)
+        {
+            stats.perSecond.record(window.packets);
+            window.startNs = nowNs - window.startNs < 2 * RATE_WINDOW_NS ? window.startNs + RATE_WINDOW_NS : nowNs;
+            window.packets = 0;
+        }
+        window.packets++;
+        if(sample.timed)
+        {
+            if(sample.errorNs < 0)
+            {
+                m_earlyPackets++;
+            }
+            m_timingError.record(sample.errorNs);
+        }
+    }
+}
+
+void ReplayTelemetry::recordFile(const FileStats &file)
+{
+    QMutexLocker locker(&m_mutex);
+    m_files.append(file);
+    m_parseNs += file.parseNs;
+    if(m_slowestFile < 0 || file.parseNs > m_files[m_slowestFile].parseNs)
+    {
+        m_slowestFile = m_files.size() - 1;
+    }
+}
+
+qint64 ReplayTelemetry::elapsedNsLocked() const
+{
+    if(m_startNs == 0)
+    {
+        return 0;
+    }
+    return (m_finishNs != 0 ? m_finishNs : ReplayScheduler::nowNs()) - m_startNs;
+}
+
+ReplayTelemetry::Snapshot ReplayTelemetry::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    Snapshot snapshot;
+    snapshot.elapsedNs = elapsedNsLocked();
+    snapshot.finished = m_finishNs != 0;
+    snapshot.destinations = m_destinations;
+    snapshot.timingError = m_timingError;
+    snapshot.queueDepth = m_queueDepth;
+    snapshot.earlyPackets = m_earlyPackets;
+    snapshot.files = m_files.size();
+    snapshot.parseNs = m_parseNs;
+    if(m_slowestFile >= 0)
+    {
+        snapshot.slowestFile = m_files[m_slowestFile];
+    }
+    return snapshot;
+}
+
+QJsonObject ReplayTelemetry::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 elapsedNs = elapsedNsLocked();
+    const double seconds = elapsedNs / 1e9;
+    QJsonObject root;
+    root["startTime"] = m_startTime.toString(Qt::ISODate);
+    root["durationSec"] = seconds;
+    root["finished"] = m_finishNs != 0;
+    QJsonArray destinations;
+    for(const DestinationStats &stats : m_destinations)
+    {
+        QJsonObject object;
+        object["address"] = stats.address;
+        object["packets"] = stats.packets;
+        object["bytes"] = stats.bytes;
+        object["failed"] = stats.failed;
+        object["packetsPerSec"] = seconds > 0 ? stats.packets / seconds : 0.0;
+        object["bitsPerSec"] = seconds > 0 ? stats.bytes * 8 / seconds : 0.0;
+        object["perSecondPackets"] = stats.perSecond.toJson();
+        destinations.append(object);
+    }
+    root["destinations"] = destinations;
+    root["timingErrorNs"] = m_timingError.toJson();
+    root["earlyPackets"] = m_earlyPackets;
+    root["queueDepth"] = m_queueDepth.toJson();
+    QJsonArray files;
+    for(const FileStats &file : m_files)
+    {
+        QJsonObject object;
+        object["path"] = file.path;
+        object["packets"] = file.packets;
+        object["parseMs"] = file.parseNs / 1e6;
+        object["elapsedMs"] = file.elapsedNs / 1e6;
+        files.append(object);
+    }
+    root["parseMsTotal"] = m_parseNs / 1e6;
+    root["files"] = files;
+    return root;
+}
+
+bool ReplayTelemetry::writeJson(const QString &path, QString &error) const
+{
+    const QByteArray json = QJsonDocument(toJson()).toJson(QJsonDocument::Indented);
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        error = file.errorString();
+        return false;
+    }
+    if(file.write(json) != json.size())
+    {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+#ifndef REPLAYTELEMETRY_H
+#define REPLAYTELEMETRY_H
+
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <QJsonObject>
+#include "latencyhistogram.h"
+
+/**
+ * @brief 回放运行统计
+ * 发送线程每发出一批数据包记录一次（各目标包数/字节数、调度误差、队列深度），
+ * 工作线程每处理完一个文件记录一次（包数、解析耗时）；界面线程定时取快照显示，
+ * 运行结束后可导出为 JSON，用于证明回放达到了预期的速率与定时精度。
+ *
+ * 调度误差 = 实际发出时刻 - 调度时刻（纳秒），仅统计带调度时刻的数据包；
+ * 各目标另按 1 秒窗口统计包速率分布，窗口在有数据到达时滚动，暂停期间不计空窗口。
+ * 所有接口均线程安全。
+ */
+class ReplayTelemetry
+{
+public:
+    ///单个数据包的发送结果（发送线程按批提交）
+    struct Sample
+    {
+        int destination = -1; ///< 目标索引
+        int bytes = 0;        ///< 载荷长度
+        bool sent = false;    ///< 是否发送成功
+        bool timed = false;   ///< 是否带调度时刻
+        qint64 errorNs = 0;   ///< 调度误差（纳秒）
+    };
+
+    ///单个目标的统计
+    struct DestinationStats
+    {
+        QString address;            ///< 目标地址
+        qint64 packets = 0;         ///< 发送成功包数
+        qint64 bytes = 0;           ///< 发送成功字节数
+        qint64 failed = 0;          ///< 发送失败或限速丢弃包数
+        LatencyHistogram perSecond; ///< 每秒包数分布
+    };
+
+    ///单个文件的统计
+    struct FileStats
+    {
+        QString path;        ///< 文件路径
+        qint64 packets = 0;  ///< 发布的数据包数
+        qint64 parseNs = 0;  ///< 解析耗时（纳秒，不含等待调度与背压）
+        qint64 elapsedNs = 0; ///< 处理总耗时（纳秒）
+    };
+
+    ///统计快照
+    struct Snapshot
+    {
+        qint64 elapsedNs = 0;                    ///< 运行时长（结束后冻结）
+        bool finished = false;                   ///< 是否已结束
+        QVector<DestinationStats> destinations;  ///< 各目标统计
+        LatencyHistogram timingError;            ///< 调度误差分布（纳秒）
+        LatencyHistogram queueDepth;             ///< 发送队列深度分布（每批采样）
+        qint64 earlyPackets = 0;                 ///< 早于调度时刻发出的包数
+        int files = 0;                           ///< 已处理文件数
+        qint64 parseNs = 0;                      ///< 累计解析耗时
+        FileStats slowestFile;                   ///< 解析最慢的文件
+    };
+
+    ReplayTelemetry();
+
+    /**
+     * @brief 开始新一轮统计（清空之前的数据）
+     * @param destinations 目标地址，顺序与发送器的目标索引一致
+     */
+    void start(const QStringList &destinations);
+
+    ///结束统计，运行时长不再增长
+    void finish();
+
+    /**
+     * @brief 记录一批发送结果（发送线程调用）
+     * @param samples 发送结果数组
+     * @param count 数量
+     * @param queueDepth 本批发送前的队列深度，-1 表示不采样
+     * @param nowNs 发出时刻（ReplayScheduler::nowNs）
+     */
+    void recordBatch(const Sample *samples, int count, int queueDepth, qint64 nowNs);
+
+    ///记录一个文件的处理结果（工作线程调用）
+    void recordFile(const FileStats &file);
+
+    ///取统计快照
+    Snapshot snapshot() const;
+
+    ///导出为 JSON（包含逐文件统计）
+    QJsonObject toJson() const;
+
+    /**
+     * @brief 将 JSON 写入文件
+     * @param path 文件路径
+     * @param error 输出参数，失败原因
+     * @return 是否成功
+     */
+    bool writeJson(const QString &path, QString &error) const;
+
+private:
+    ///单个目标的 1 秒速率窗口
+    struct RateWindow
+    {
+        qint64 startNs = 0;  ///< 窗口起始时刻
+        qint64 packets = 0;  ///< 窗口内包数
+    };
+
+    ///运行时长（需持锁）
+    qint64 elapsedNsLocked() const;
+
+    mutable QMutex m_mutex;              ///< 互斥锁
+    QDateTime m_startTime;               ///< 开始时间
+    qint64 m_startNs = 0;                ///< 开始时刻
+    qint64 m_finishNs = 0;               ///< 结束时刻，0 表示运行中
+    QVector<DestinationStats> m_destinations; ///< 各目标统计
+    QVector<RateWindow> m_windows;       ///< 各目标速率窗口
+    LatencyHistogram m_timingError;      ///< 调度误差分布
+    LatencyHistogram m_queueDepth;       ///< 队列深度分布
+    qint64 m_earlyPackets = 0;           ///< 早于调度时刻发出的包数
+    QVector<FileStats> m_files;          ///< 逐文件统计
+    qint64 m_parseNs = 0;                ///< 累计解析耗时
+    int m_slowestFile = -1;              ///< 解析最慢的文件
+};
+
+#endif //REPLAYTELEMETRY_H
@@ -0,0 +1,347 @@
+#include "seekindex.h"
+#include "capturereader.h"
+#include "hexdecoder.h"
+#include "replayscheduler.h"
+#include "topicfilter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+    const char SIDECAR_MAGIC[4] = {'D', 'P', 'S', 'I'};
+    const quint16 SIDECAR_VERSION = 2;
+    const int SIDECAR_HEADER_SIZE = 48;
+    const qint64 US_PER_DAY = 86400LL * 1000000LL;
+
+    template <typename T>
+    void put(QByteArray &out, T value)
+    {
+        uchar bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        out.append(reinterpret_cast<const char *>(bytes), static_cast<int>(sizeof(T)));
+    }
+
+    template <typename T>
+    T get(const char *p)
+    {
+        return qFromLittleEndian<T>(reinterpret_cast<const uchar *>(p));
+    }
+
+    ///索引时间取累计最大值（兼容旧版 .dpcap 按原始时间记录的索引，只能修正索引点之间的回退）
+    void makeMonotonic(QVector<Dpcap::TimeEntry> &timeIndex, qint64 &lastUs)
+    {
+        for(int i = 1; i < timeIndex.size(); ++i)
+        {
+            timeIndex[i].timestampUs = qMax(timeIndex[i].timestampUs, timeIndex[i - 1].timestampUs);
+        }
+        if(!timeIndex.isEmpty())
+        {
+            lastUs = qMax(lastUs, timeIndex.last().timestampUs);
+        }
+    }
+}
+
+//================ SeekIndex ================
+
+QString SeekIndex::sidecarPath(const QString &capturePath)
+{
+    return capturePath + QStringLiteral(".dpidx");
+}
+
+bool SeekIndex::isUpToDate(const QString &capturePath)
+{
+    const QFileInfo sidecar(sidecarPath(capturePath));
+    return sidecar.exists() && sidecar.lastModified() >= QFileInfo(capturePath).lastModified();
+}
+
+bool SeekIndex::load(const QString &capturePath)
+{
+    *this = SeekIndex();
+    m_valid = Dpcap::isDpcapFile(capturePath) ? loadDpcap(capturePath) : loadSidecar(capturePath);
+    return m_valid;
+}
+
+bool SeekIndex::loadDpcap(const QString &capturePath)
+{
+    DpcapReader reader;
+    if(!reader.open(capturePath) || !reader.hasIndex())
+    {
+        return false;
+    }
+    m_packetCount = reader.packetCount();
+    m_timeIndex = reader.timeIndex();
+    m_topicIndex = reader.topicIndex();
+    m_firstUs = reader.firstTimestampUs();
+    m_lastUs = reader.lastTimestampUs();
+    makeMonotonic(m_timeIndex, m_lastUs);
+    //日期标志取首个索引包的记录标志
+    Dpcap::Record record;
+    if(!m_timeIndex.isEmpty() && reader.seek(m_timeIndex.first().offset, m_timeIndex.first().packetIndex)
+            && reader.next(record))
+    {
+        m_hasDate = (record.flags & Dpcap::TimestampHasDate) != 0;
+    }
+    return true;
+}
+
+bool SeekIndex::loadSidecar(const QString &capturePath)
+{
+    if(!isUpToDate(capturePath))
+    {
+        return false;
+    }
+    QFile file(sidecarPath(capturePath));
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    const char *p = data.constData();
+    if(data.size() < SIDECAR_HEADER_SIZE || std::memcmp(p, SIDECAR_MAGIC, 4) != 0
+            || get<quint16>(p + 4) != SIDECAR_VERSION
+            || get<qint64>(p + 8) != QFileInfo(capturePath).size())
+    {
+        return false;
+    }
+    const qint64 timeCount = get<quint32>(p + 40);
+    const qint64 topicCount = get<quint32>(p + 44);
+    if(SIDECAR_HEADER_SIZE + timeCount * Dpcap::TIME_ENTRY_SIZE + topicCount * Dpcap::TOPIC_ENTRY_SIZE != data.size())
+    {
+        return false;
+    }
+    m_hasDate = (get<quint16>(p + 6) & 1) != 0;
+    m_packetCount = static_cast<qint64>(get<quint64>(p + 16));
+    m_firstUs = get<qint64>(p + 24);
+    m_lastUs = get<qint64>(p + 32);
+    p += SIDECAR_HEADER_SIZE;
+    m_timeIndex.reserve(static_cast<int>(timeCount));
+    for(qint64 i = 0; i < timeCount; ++i, p += Dpcap::TIME_ENTRY_SIZE)
+    {
+        m_timeIndex.append(Dpcap::TimeEntry{get<qint64>(p),
+                                            static_cast<qint64>(get<quint64>(p + 8)),
+                                            static_cast<qint64>(get<quint64>(p + 16))});
+    }
+    m_topicIndex.reserve(static_cast<int>(topicCount));
+    for(qint64 i = 0; i < topicCount; ++i, p += Dpcap::TOPIC_ENTRY_SIZE)
+    {
+        m_topicIndex.append(Dpcap::TopicEntry{get<quint16>(p), get<quint32>(p + 4),
+                                              static_cast<qint64>(get<quint64>(p + 8))});
+    }
+    return true;
+}
+
+bool SeekIndex::build(const QString &capturePath, QString &error, const std::function<bool()> &cancelled)
+{
+    *this = SeekIndex();
+    CaptureReader reader;
+    if(!reader.open(capturePath))
+    {
+        error = reader.errorString();
+        return false;
+    }
+    SeekIndexBuilder builder;
+    CaptureRecord record;
+    QByteArray buffer;
+    while(true)
+    {
+        const qint64 offset = reader.position();
+        const qint64 lineIndex = reader.lineNumber();
+        //每 4096 行检查一次取消条件
+        if(cancelled && (lineIndex & 4095) == 0 && cancelled())
+        {
+            error = QStringLiteral("已取消");
+            return false;
+        }
+        const CaptureReader::LineResult result = reader.next(record);
+        if(result == CaptureReader::LineResult::End)
+        {
+            if(!reader.errorString().isEmpty())
+            {
+                error = reader.errorString();
+                return false;
+            }
+            break;
+        }
+        if(result == CaptureReader::LineResult::FormatError)
+        {
+            continue;
+        }
+        //与回放相同的有效性判断：十六进制有效且不少于 4 字节
+        const int capacity = HexDecoder::maxDecodedSize(record.hexData.size());
+        if(buffer.size() < capacity)
+        {
+            buffer.resize(capacity);
+        }
+        const int size = capacity > 0 ? HexDecoder::decode(record.hexData.data(), record.hexData.size(), buffer.data(), capacity) : -1;
+        if(size < 4)
+        {
+            continue;
+        }
+        qint64 timestampUs = 0;
+        bool hasDate = false;
+        const bool valid = ReplayScheduler::parseTimestamp(record.timestamp, timestampUs, &hasDate);
+        builder.add(offset, lineIndex, valid, timestampUs, hasDate, Dpcap::topicOf(buffer.constData(), size));
+    }
+    *this = builder.index();
+    //旁路索引写入失败（如只读目录）时本次仍可使用内存中的索引
+    builder.save(capturePath, error);
+    return true;
+}
+
+void SeekIndex::locate(qint64 timestampUs, qint64 &offset, qint64 &index) const
+{
+    offset = -1;
+    index = 0;
+    //索引时间为截至索引点的最大时间，单调不减：最后一个不晚于目标时间的索引点之前没有晚于目标的数据包，
+    //从该点起由调用方逐包跳过早于目标的数据包，时间戳回退的抓包也不会越过目标
+    auto it = std::upper_bound(m_timeIndex.constBegin(), m_timeIndex.constEnd(), timestampUs,
+                               [](qint64 value, const Dpcap::TimeEntry &entry) { return value < entry.timestampUs; });
+    if(it != m_timeIndex.constBegin())
+    {
+        --it;
+        offset = it->offset;
+        index = it->packetIndex;
+    }
+}
+
+qint64 SeekIndex::alignTarget(qint64 targetUs, bool targetHasDate) const
+{
+    if(targetHasDate == m_hasDate)
+    {
+        return targetUs;
+    }
+    if(m_hasDate)
+    {
+        return m_firstUs - m_firstUs % US_PER_DAY + targetUs;
+    }
+    return targetUs % US_PER_DAY;
+}
+
+bool SeekIndex::containsAllowed(const TopicFilter &filter) const
+{
+    if(m_topicIndex.isEmpty())
+    {
+        return m_packetCount != 0 || !m_valid;
+    }
+    for(const Dpcap::TopicEntry &entry : m_topicIndex)
+    {
+        if(filter.allowed(entry.topic))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SeekIndex::parseTarget(const QString &text, qint64 &us, bool &hasDate, bool &relative)
+{
+    QString trimmed = text.trimmed();
+    relative = trimmed.startsWith('+');
+    if(relative)
+    {
+        trimmed = trimmed.mid(1).trimmed();
+        //纯数字按秒解析（可带小数），避免被当作 Unix 时间的毫秒/微秒
+        bool ok = false;
+        const double seconds = trimmed.toDouble(&ok);
+        if(ok)
+        {
+            us = static_cast<qint64>(seconds * 1e6);
+            hasDate = false;
+            return seconds >= 0;
+        }
+    }
+    const QByteArray latin = trimmed.toLatin1();
+    if(latin.isEmpty() || !ReplayScheduler::parseTimestamp(QLatin1String(latin.constData(), latin.size()), us, &hasDate))
+    {
+        return false;
+    }
+    //相对偏移只接受 hh:mm:ss
+    return !relative || !hasDate;
+}
+
+//================ SeekIndexBuilder ================
+
+void SeekIndexBuilder::add(qint64 offset, qint64 lineIndex, bool timestampValid, qint64 timestampUs, bool hasDate,
+                           quint16 topic)
+{
+    if(timestampValid)
+    {
+        if(!m_hasTimestamp)
+        {
+            m_hasTimestamp = true;
+            m_hasDate = hasDate;
+            m_firstUs = timestampUs;
+            m_lastUs = timestampUs;
+        }
+        //与 .dpcap 相同，索引项记录截至该包的最大时间
+        m_lastUs = qMax(m_lastUs, timestampUs);
+        if(m_timeIndex.isEmpty() || m_packetCount - m_lastEntryPacket >= Dpcap::TIME_INDEX_STRIDE)
+        {
+            m_timeIndex.append(Dpcap::TimeEntry{m_lastUs, offset, lineIndex});
+            m_lastEntryPacket = m_packetCount;
+        }
+    }
+    auto it = m_topics.find(topic);
+    if(it == m_topics.end())
+    {
+        m_topics.insert(topic, Dpcap::TopicEntry{topic, 1, offset});
+    }
+    else
+    {
+        ++it->count;
+    }
+    ++m_packetCount;
+}
+
+SeekIndex SeekIndexBuilder::index() const
+{
+    SeekIndex index;
+    index.m_valid = true;
+    index.m_hasDate = m_hasDate;
+    index.m_packetCount = m_packetCount;
+    index.m_firstUs = m_firstUs;
+    index.m_lastUs = m_lastUs;
+    index.m_timeIndex = m_timeIndex;
+    index.m_topicIndex = m_topics.values().toVector();
+    return index;
+}
+
+bool SeekIndexBuilder::save(const QString &capturePath, QString &error) const
+{
+    QByteArray out;
+    out.reserve(SIDECAR_HEADER_SIZE + m_timeIndex.size() * Dpcap::TIME_ENTRY_SIZE
+                + m_topics.size() * Dpcap::TOPIC_ENTRY_SIZE);
+    out.append(SIDECAR_MAGIC, 4);
+    put<quint16>(out, SIDECAR_VERSION);
+    put<quint16>(out, m_hasDate ? 1 : 0);
+    put<qint64>(out, QFileInfo(capturePath).size());
+    put<quint64>(out, static_cast<quint64>(m_packetCount));
+    put<qint64>(out, m_firstUs);
+    put<qint64>(out, m_lastUs);
+    put<quint32>(out, static_cast<quint32>(m_timeIndex.size()));
+    put<quint32>(out, static_cast<quint32>(m_topics.size()));
+    for(const Dpcap::TimeEntry &entry : m_timeIndex)
+    {
+        put<qint64>(out, entry.timestampUs);
+        put<quint64>(out, static_cast<quint64>(entry.offset));
+        put<quint64>(out, static_cast<quint64>(entry.packetIndex));
+    }
+    for(const Dpcap::TopicEntry &entry : m_topics)
+    {
+        put<quint16>(out, entry.topic);
+        put<quint16>(out, 0);
+        put<quint32>(out, entry.count);
+        put<quint64>(out, static_cast<quint64>(entry.firstOffset));
+    }
+    QSaveFile file(SeekIndex::sidecarPath(capturePath));
+    if(!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit())
+    {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
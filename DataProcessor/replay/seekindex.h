@@ -0,0 +1,150 @@
+#ifndef SEEKINDEX_H
+#define SEEKINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QLatin1String>
+#include <functional>
+#include "dpcapfile.h"
+
+class TopicFilter;
+
+/**
+ * @brief 抓包文件的定位索引
+ * 将时间与主题映射到文件内的字节偏移，用于从指定时间开始回放、断点续播与运行中跳转，
+ * 定位代价只与索引大小有关，与抓包文件大小无关。
+ *
+ * .dpcap 直接使用文件末尾的索引；文本抓包使用同目录下的旁路索引文件（"<文件名>.dpidx"），
+ * 在首次完整回放时顺带生成，或在第一次需要定位该文件时扫描生成。
+ * 时间索引与 .dpcap 相同：每 Dpcap::TIME_INDEX_STRIDE 包取步长内第一个有效时间戳的包，
+ * 时间为截至该包的最大时间戳，合并或校时导致时间戳回退的抓包也能正确定位；
+ * 文本抓包的"包序号"为该行之前已读取的行数，与 CaptureReader::seek() 对应。
+ *
+ *   旁路索引格式（小端序）：magic "DPSI" | u16 版本（2）| u16 标志（bit0 含日期）| i64 源文件大小 |
+ *       u64 包数 | i64 首包时间 | i64 最大时间 | u32 时间索引项数 | u32 主题索引项数 |
+ *       时间索引项（同 .dpcap）| 主题索引项（同 .dpcap）
+ *   .txt.gz 的偏移为解压后的偏移：gzip 流不能随机访问，定位时仍要从文件开头解压到该偏移
+ *   （只省去逐行解析），耗时与偏移成正比；只有 .dpcap 与未压缩的文本抓包的定位与文件大小无关。
+ */
+class SeekIndex
+{
+public:
+    SeekIndex() = default;
+
+    ///旁路索引路径
+    static QString sidecarPath(const QString &capturePath);
+
+    ///文本抓包的旁路索引是否存在且不早于抓包文件
+    static bool isUpToDate(const QString &capturePath);
+
+    /**
+     * @brief 加载索引（.dpcap 读取文件索引，文本读取旁路索引）
+     * @return 索引不存在、过期或损坏时返回 false
+     */
+    bool load(const QString &capturePath);
+
+    /**
+     * @brief 扫描文本抓包生成索引并写入旁路索引文件
+     * @param capturePath 文本抓包路径
+     * @param error 输出参数，失败原因（旁路索引写入失败不视为失败，索引仍可使用）
+     * @param cancelled 取消条件，逐行检查；取消时不写旁路索引并返回 false
+     */
+    bool build(const QString &capturePath, QString &error,
+               const std::function<bool()> &cancelled = std::function<bool()>());
+
+    ///是否已加载
+    bool isValid() const { return m_valid; }
+
+    ///是否含有效时间戳
+    bool hasTimestamps() const { return !m_timeIndex.isEmpty(); }
+
+    ///首包时间（微秒）
+    qint64 firstUs() const { return m_firstUs; }
+
+    ///最大时间（微秒），时间单调时即末包时间
+    qint64 lastUs() const { return m_lastUs; }
+
+    ///时间戳是否含日期
+    bool hasDate() const { return m_hasDate; }
+
+    /**
+     * @brief 按抓包时间定位
+     * @param timestampUs 目标时间（需先经 alignTarget() 换算）
+     * @param offset 输出参数，读取起点的字节偏移（-1 表示从文件开头读取）
+     * @param index 输出参数，起点之前的包序号（文本为行数）
+     */
+    void locate(qint64 timestampUs, qint64 &offset, qint64 &index) const;
+
+    /**
+     * @brief 将跳转目标换算到本文件的时间表示
+     * 目标只有时分秒而文件含日期时取文件首包所在日期；反之去掉目标的日期部分。
+     */
+    qint64 alignTarget(qint64 targetUs, bool targetHasDate) const;
+
+    ///文件中是否含有过滤器允许的主题（没有主题索引时返回 true）
+    bool containsAllowed(const TopicFilter &filter) const;
+
+    /**
+     * @brief 解析跳转目标
+     * 支持抓包时间戳（格式同 ReplayScheduler::parseTimestamp）与 "+偏移"（秒数或 hh:mm:ss，相对首包时间）。
+     * @param text 目标文本
+     * @param us 输出参数，时间或偏移（微秒）
+     * @param hasDate 输出参数，时间是否含日期
+     * @param relative 输出参数，是否为相对首包的偏移
+     */
+    static bool parseTarget(const QString &text, qint64 &us, bool &hasDate, bool &relative);
+
+private:
+    friend class SeekIndexBuilder;
+
+    bool loadDpcap(const QString &capturePath);
+    bool loadSidecar(const QString &capturePath);
+
+    bool m_valid = false;                    ///< 是否已加载
+    bool m_hasDate = false;                  ///< 时间戳是否含日期
+    qint64 m_packetCount = 0;                ///< 包数
+    qint64 m_firstUs = 0;                    ///< 首包时间
+    qint64 m_lastUs = 0;                     ///< 最大时间
+    QVector<Dpcap::TimeEntry> m_timeIndex;   ///< 时间索引
+    QVector<Dpcap::TopicEntry> m_topicIndex; ///< 主题索引
+};
+
+/**
+ * @brief 文本抓包索引生成器
+ * 回放或扫描时逐包调用 add()，完整读完文件后 save() 写出旁路索引。
+ */
+class SeekIndexBuilder
+{
+public:
+    SeekIndexBuilder() = default;
+
+    /**
+     * @brief 记录一个有效数据包
+     * @param offset 该行起始的字节偏移（CaptureReader::position() 在读取该行之前的值）
+     * @param lineIndex 该行之前已读取的行数
+     * @param timestampValid 时间戳是否有效
+     * @param timestampUs 抓包时间
+     * @param hasDate 时间戳是否含日期
+     * @param topic 主题号
+     */
+    void add(qint64 offset, qint64 lineIndex, bool timestampValid, qint64 timestampUs, bool hasDate, quint16 topic);
+
+    ///生成索引（不写文件）
+    SeekIndex index() const;
+
+    ///写出旁路索引
+    bool save(const QString &capturePath, QString &error) const;
+
+private:
+    qint64 m_packetCount = 0;                     ///< 包数
+    qint64 m_lastEntryPacket = 0;                 ///< 最后一个时间索引项对应的包序号
+    bool m_hasTimestamp = false;                  ///< 是否出现过有效时间戳
+    bool m_hasDate = false;                       ///< 时间戳是否含日期
+    qint64 m_firstUs = 0;                         ///< 首个有效时间
+    qint64 m_lastUs = 0;                          ///< 最大有效时间
+    QVector<Dpcap::TimeEntry> m_timeIndex;        ///< 时间索引
+    QMap<quint16, Dpcap::TopicEntry> m_topics;    ///< 主题索引
+};
+
+#endif //SEEKINDEX_H
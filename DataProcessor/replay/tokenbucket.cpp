@@ -0,0 +1,65 @@
+#include "tokenbucket.h"
+#include <cmath>
+
+void TokenBucket::configure(double packetsPerSecond, double bitsPerSecond, int burstPackets, int burstBytes, qint64 nowNs)
+{
+    m_pps = packetsPerSecond > 0.0 ? packetsPerSecond : 0.0;
+    m_bps = bitsPerSecond > 0.0 ? bitsPerSecond : 0.0;
+    m_packetCapacity = burstPackets > 1 ? burstPackets : 1.0;
+    m_bitCapacity = burstBytes > 0 ? burstBytes * 8.0 : 0.0;
+    m_packetTokens = m_packetCapacity;
+    m_bitTokens = m_bitCapacity;
+    m_lastNs = nowNs;
+}
+
+void TokenBucket::refill(qint64 nowNs)
+{
+    const qint64 elapsedNs = nowNs - m_lastNs;
+    if(elapsedNs <= 0)
+    {
+        return;
+    }
+    m_lastNs = nowNs;
+    const double seconds = elapsedNs / 1e9;
+    if(m_pps > 0.0)
+    {
+        m_packetTokens = qMin(m_packetCapacity, m_packetTokens + seconds * m_pps);
+    }
+    if(m_bps > 0.0)
+    {
+        m_bitTokens = qMin(m_bitCapacity, m_bitTokens + seconds * m_bps);
+    }
+}
+
+bool TokenBucket::tryConsume(int bytes, qint64 nowNs)
+{
+    refill(nowNs);
+    if((m_pps > 0.0 && m_packetTokens < 1.0) || (m_bps > 0.0 && m_bitTokens < 0.0))
+    {
+        return false;
+    }
+    if(m_pps > 0.0)
+    {
+        m_packetTokens -= 1.0;
+    }
+    if(m_bps > 0.0)
+    {
+        m_bitTokens -= bytes * 8.0;
+    }
+    return true;
+}
+
+qint64 TokenBucket::nextAvailableNs(qint64 nowNs)
+{
+    refill(nowNs);
+    double waitSeconds = 0.0;
+    if(m_pps > 0.0 && m_packetTokens < 1.0)
+    {
+        waitSeconds = (1.0 - m_packetTokens) / m_pps;
+    }
+    if(m_bps > 0.0 && m_bitTokens < 0.0)
+    {
+        waitSeconds = qMax(waitSeconds, -m_bitTokens / m_bps);
+    }
+    return nowNs + static_cast<qint64>(std::ceil(waitSeconds * 1e9));
+}
@@ -0,0 +1,54 @@
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 令牌桶限速器（包速率 + 比特速率）
+ * 两个桶同时生效：包令牌不足 1 个或比特令牌为负时拒绝发送。
+ * 比特桶允许透支一个数据包，保证超过突发容量的大包仍能按平均速率发出。
+ * 时间由调用方传入（单调时钟纳秒），本类不做任何等待，也不是线程安全的。
+ */
+class TokenBucket
+{
+public:
+    /**
+     * @brief 配置速率
+     * @param packetsPerSecond 包速率，<=0 表示不限
+     * @param bitsPerSecond 比特速率，<=0 表示不限
+     * @param burstPackets 包突发容量（至少 1）
+     * @param burstBytes 比特桶突发容量（字节），0 表示严格平滑
+     * @param nowNs 当前时刻，桶以满令牌开始
+     */
+    void configure(double packetsPerSecond, double bitsPerSecond, int burstPackets, int burstBytes, qint64 nowNs);
+
+    ///是否配置了任一速率限制
+    bool isLimited() const { return m_pps > 0.0 || m_bps > 0.0; }
+
+    /**
+     * @brief 尝试为一个数据包扣除令牌
+     * @param bytes 数据包长度
+     * @param nowNs 当前时刻
+     * @return true-允许发送（已扣除），false-令牌不足
+     */
+    bool tryConsume(int bytes, qint64 nowNs);
+
+    /**
+     * @brief 令牌足够发送下一个数据包的最早时刻
+     * @param nowNs 当前时刻
+     */
+    qint64 nextAvailableNs(qint64 nowNs);
+
+private:
+    void refill(qint64 nowNs);
+
+    double m_pps = 0.0;           ///< 包速率
+    double m_bps = 0.0;           ///< 比特速率
+    double m_packetCapacity = 1.0; ///< 包令牌上限
+    double m_bitCapacity = 0.0;   ///< 比特令牌上限
+    double m_packetTokens = 0.0;  ///< 当前包令牌
+    double m_bitTokens = 0.0;     ///< 当前比特令牌（可为负）
+    qint64 m_lastNs = 0;          ///< 上次补充时刻
+};
+
+#endif //TOKENBUCKET_H
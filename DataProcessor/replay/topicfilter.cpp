@@ -0,0 +1,95 @@
+#include "topicfilter.h"
+#include <algorithm>
+
+TopicFilter::TopicFilter()
+{
+    std::fill(m_allowed, m_allowed + WORDS, ~Q_UINT64_C(0));
+    std::fill(m_sent, m_sent + WORDS, Q_UINT64_C(0));
+}
+
+QStringList TopicFilter::compile(const QStringList &include, const QStringList &exclude, bool unique)
+{
+    QStringList invalid;
+    quint16 topic = 0;
+    //包含列表：为空时全部允许
+    bool hasInclude = false;
+    quint64 allowed[WORDS] = {};
+    for(const QString &text : include)
+    {
+        if(text.trimmed().isEmpty())
+        {
+            continue;
+        }
+        //无效条目同样视为设置了包含列表，与按文本匹配时的行为一致
+        hasInclude = true;
+        if(!parseTopic(text, topic))
+        {
+            invalid.append(text);
+            continue;
+        }
+        allowed[topic >> 6] |= Q_UINT64_C(1) << (topic & 63);
+    }
+    if(!hasInclude)
+    {
+        std::fill(allowed, allowed + WORDS, ~Q_UINT64_C(0));
+    }
+    //排除列表优先于包含列表
+    for(const QString &text : exclude)
+    {
+        if(text.trimmed().isEmpty())
+        {
+            continue;
+        }
+        if(!parseTopic(text, topic))
+        {
+            invalid.append(text);
+            continue;
+        }
+        allowed[topic >> 6] &= ~(Q_UINT64_C(1) << (topic & 63));
+    }
+    std::copy(allowed, allowed + WORDS, m_allowed);
+    m_allowsAll = std::all_of(allowed, allowed + WORDS, [](quint64 word) { return word == ~Q_UINT64_C(0); });
+    std::fill(m_sent, m_sent + WORDS, Q_UINT64_C(0));
+    m_unique = unique;
+    return invalid;
+}
+
+void TopicFilter::resetUnique()
+{
+    std::fill(m_sent, m_sent + WORDS, Q_UINT64_C(0));
+}
+
+bool TopicFilter::parseTopic(const QString &text, quint16 &topic)
+{
+    //只接受与按文本匹配时相同的 4 位 "XXYY" 形式，不接受 0x 前缀或省略前导零
+    const QString trimmed = text.trimmed();
+    if(trimmed.size() != 4)
+    {
+        return false;
+    }
+    uint value = 0;
+    for(const QChar ch : trimmed)
+    {
+        const ushort c = ch.unicode();
+        uint digit = 0;
+        if(c >= '0' && c <= '9')
+        {
+            digit = c - '0';
+        }
+        else if(c >= 'a' && c <= 'f')
+        {
+            digit = c - 'a' + 10;
+        }
+        else if(c >= 'A' && c <= 'F')
+        {
+            digit = c - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    topic = static_cast<quint16>(value);
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef TOPICFILTER_H
+#define TOPICFILTER_H
+
+#include <QtGlobal>
+#include <QStringList>
+
+/**
+ * @brief 主题号过滤器
+ * 主题号为 16 位整数，包含/排除列表在开始回放时一次性编译为 65536 位的位图，
+ * 逐包过滤只需一次位测试，无需格式化字符串、加锁或查找列表。
+ * 唯一模式使用另一张位图记录已发送的主题。
+ * 仅供单个线程使用。
+ */
+class TopicFilter
+{
+public:
+    TopicFilter();
+
+    /**
+     * @brief 编译过滤配置，同时清空唯一模式记录
+     * @param include 包含列表（十六进制文本，空表示全部包含）
+     * @param exclude 排除列表
+     * @param unique 是否每个主题只发送一次
+     * @return 无法识别的条目
+     */
+    QStringList compile(const QStringList &include, const QStringList &exclude, bool unique);
+
+    ///清空唯一模式记录（循环回放的每一轮重新开始）
+    void resetUnique();
+
+    ///主题是否满足包含/排除列表（不影响唯一模式记录）
+    bool allowed(quint16 topic) const
+    {
+        return (m_allowed[topic >> 6] >> (topic & 63)) & 1;
+    }
+
+    ///是否允许全部主题（未设置包含列表且排除列表为空）
+    bool allowsAll() const { return m_allowsAll; }
+
+    ///主题是否需要发送；唯一模式下首次通过后记录该主题
+    bool accept(quint16 topic)
+    {
+        if(!allowed(topic))
+        {
+            return false;
+        }
+        if(m_unique)
+        {
+            quint64 &word = m_sent[topic >> 6];
+            const quint64 bit = Q_UINT64_C(1) << (topic & 63);
+            if(word & bit)
+            {
+                return false;
+            }
+            word |= bit;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 解析主题号文本（4 位十六进制 "XXYY"，不区分大小写）
+     * @return 成功返回 true
+     */
+    static bool parseTopic(const QString &text, quint16 &topic);
+
+private:
+    static const int WORDS = 65536 / 64;
+
+    quint64 m_allowed[WORDS];    ///< 允许发送的主题位图
+    quint64 m_sent[WORDS];       ///< 已发送的主题位图（唯一模式）
+    bool m_unique = false;       ///< 唯一模式
+    bool m_allowsAll = true;     ///< 是否允许全部主题
+};
+
+#endif //TOPICFILTER_H
@@ -0,0 +1,394 @@
+//DataProcessorCli
+//无界面回放：与图形界面共用 WorkerClass / UdpSender 回放引擎，按固定周期在控制台输出速率统计，
+//用于在实验室服务器上通过脚本长时间高速率回放。
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+
+#include "workerclass.h"
+
+namespace
+{
+    ///收到的 Ctrl+C（SIGINT）/ SIGTERM 信号值，由主线程定时器检查
+    std::atomic<int> g_signal{0};
+
+    void onSignal(int signo)
+    {
+        g_signal.store(signo);
+    }
+
+    QTextStream &out()
+    {
+        static QTextStream stream(stdout);
+        return stream;
+    }
+
+    QTextStream &err()
+    {
+        static QTextStream stream(stderr);
+        return stream;
+    }
+
+    ///速率文本（自动选择 k/M/G 单位）
+    QString formatRate(double value, const QString &unit)
+    {
+        if(value >= 1e9)
+        {
+            return QString("%1 G%2").arg(value / 1e9, 0, 'f', 2).arg(unit);
+        }
+        if(value >= 1e6)
+        {
+            return QString("%1 M%2").arg(value / 1e6, 0, 'f', 2).arg(unit);
+        }
+        if(value >= 1e3)
+        {
+            return QString("%1 k%2").arg(value / 1e3, 0, 'f', 2).arg(unit);
+        }
+        return QString("%1 %2").arg(value, 0, 'f', 0).arg(unit);
+    }
+
+    ///时长文本（微秒，保留一位小数）
+    QString formatMicros(qint64 ns)
+    {
+        return QString("%1us").arg(ns / 1e3, 0, 'f', 1);
+    }
+
+    /**
+     * @brief 周期性输出日志与速率统计
+     */
+    class ConsoleReporter
+    {
+    public:
+        ConsoleReporter(WorkerClass *worker, LogStore::Level minLevel)
+            : m_worker(worker)
+            , m_minLevel(minLevel)
+        {
+        }
+
+        ///输出缓冲的日志（低于最低级别的丢弃）
+        void flushLogs()
+        {
+            const QVector<LogBatcher::Line> lines = m_worker->logBatcher()->take();
+            for(const LogBatcher::Line &line : lines)
+            {
+                if(line.level < m_minLevel || line.level == LogStore::Other)
+                {
+                    continue;
+                }
+                QTextStream &stream = line.level >= LogStore::Warn ? err() : out();
+                stream << QDateTime::fromMSecsSinceEpoch(line.timeMs).toString("hh:mm:ss.zzz") << ' '
+                       << LogStore::levelName(line.level) << ' ' << line.render() << '\n';
+                stream.flush();
+            }
+        }
+
+        ///输出一行速率统计（结束时输出全程平均值）
+        void printRates()
+        {
+            const ReplayTelemetry::Snapshot snapshot = m_worker->telemetry()->snapshot();
+            if(snapshot.destinations.isEmpty())
+            {
+                return;
+            }
+            const double intervalSec = snapshot.finished ? snapshot.elapsedNs / 1e9
+                                                         : (snapshot.elapsedNs - m_last.elapsedNs) / 1e9;
+            QStringList parts;
+            for(int i = 0; i < snapshot.destinations.size(); ++i)
+            {
+                const ReplayTelemetry::DestinationStats &stats = snapshot.destinations[i];
+                qint64 packets = stats.packets;
+                qint64 bytes = stats.bytes;
+                if(!snapshot.finished && i < m_last.destinations.size())
+                {
+                    packets -= m_last.destinations[i].packets;
+                    bytes -= m_last.destinations[i].bytes;
+                }
+                QString part = QString("%1 %2 %3").arg(stats.address)
+                               .arg(formatRate(intervalSec > 0 ? packets / intervalSec : 0.0, "pps"))
+                               .arg(formatRate(intervalSec > 0 ? bytes * 8 / intervalSec : 0.0, "bit/s"));
+                if(stats.failed > 0)
+                {
+                    part += QString(" 失败 %1").arg(stats.failed);
+                }
+                parts << part;
+            }
+            const LatencyHistogram &timing = snapshot.timingError;
+            QString line = QString("[%1s]%2 %3 | 队列 P99 %4 | 文件 %5")
+                           .arg(snapshot.elapsedNs / 1e9, 0, 'f', 1)
+                           .arg(snapshot.finished ? " 平均" : "")
+                           .arg(parts.join(" | "))
+                           .arg(snapshot.queueDepth.percentile(99.0))
+                           .arg(snapshot.files);
+            if(timing.count() > 0)
+            {
+                line += QString(" | 误差 P50 %1 P99 %2 P99.9 %3 最大 %4")
+                        .arg(formatMicros(timing.percentile(50.0))).arg(formatMicros(timing.percentile(99.0)))
+                        .arg(formatMicros(timing.percentile(99.9))).arg(formatMicros(timing.max()));
+            }
+            out() << line << '\n';
+            out().flush();
+            m_last = snapshot;
+        }
+
+    private:
+        WorkerClass *m_worker;
+        LogStore::Level m_minLevel;
+        ReplayTelemetry::Snapshot m_last;
+    };
+
+    ///逗号分隔的列表（去除空项）
+    QStringList splitList(const QString &text)
+    {
+        QStringList items;
+        for(const QString &item : text.split(',', QString::SkipEmptyParts))
+        {
+            if(!item.trimmed().isEmpty())
+            {
+                items << item.trimmed();
+            }
+        }
+        return items;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("My_Tools_Project");
+    QCoreApplication::setApplicationName("DataProcessorCli");
+    QCoreApplication::setApplicationVersion("1.0.3");
+    //引擎内部的 qCDebug 输出与控制台统计混杂，默认只保留警告及以上
+    QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面回放抓包数据（与 DataProcessor 共用回放引擎）。\n"
+                                     "命令行参数覆盖 --config 文件中的同名配置。");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption configOption({"c", "config"}, "JSON 配置文件（与 DataProcessor 的 config.json 键相同）", "file");
+    const QCommandLineOption dirOption({"d", "data-dir"}, "数据目录", "dir");
+    const QCommandLineOption addressOption({"a", "address"}, "目标地址 IP:Port，可重复或以逗号分隔", "addr");
+    const QCommandLineOption modeOption({"m", "mode"}, "回放节奏：interval（固定间隔）或 timestamp（按时间戳）", "mode");
+    const QCommandLineOption intervalOption({"i", "interval"}, "固定间隔模式的发送间隔（毫秒）", "ms");
+    const QCommandLineOption speedOption({"s", "speed"}, "按时间戳回放的倍速，0 表示尽可能快", "factor");
+    const QCommandLineOption reverseOption("reverse", "子目录按倒序遍历");
+    const QCommandLineOption includeOption("include", "主题白名单（逗号分隔的十六进制主题号）", "topics");
+    const QCommandLineOption excludeOption("exclude", "主题黑名单（逗号分隔的十六进制主题号）", "topics");
+    const QCommandLineOption uniqueOption("unique", "每个主题号仅发送一次");
+    const QCommandLineOption threadsOption("parse-threads", "解析线程数（0-自动，1-在回放线程内解析）", "n");
+    const QCommandLineOption loopOption("loop", "回放轮数（0 表示循环直到中断），之后的轮次从内存预载区发送", "n");
+    const QCommandLineOption startOption("start", "起始位置：抓包时间或相对首包的偏移（+秒数 或 +hh:mm:ss）", "time");
+    const QCommandLineOption resumeOption("resume", "从上次未完成的断点继续");
+    const QCommandLineOption checkpointOption("checkpoint", "断点文件（默认为数据目录下的 .dataprocessor_checkpoint.json）", "file");
+    const QCommandLineOption telemetryOption({"t", "telemetry"}, "回放结束后将统计写入该 JSON 文件", "file");
+    const QCommandLineOption statsOption("stats-interval", "速率统计输出周期（毫秒，默认 1000）", "ms", "1000");
+    const QCommandLineOption logLevelOption("log-level", "最低日志级别：DEBUG/INFO/WARN/ERROR（默认 WARN）", "level", "WARN");
+    const QCommandLineOption detailOption("detail", "输出全部逐包明细日志（默认每周期折叠为汇总）");
+    parser.addOptions({configOption, dirOption, addressOption, modeOption, intervalOption, speedOption,
+                       reverseOption, includeOption, excludeOption, uniqueOption, threadsOption, loopOption,
+                       startOption, resumeOption, checkpointOption, telemetryOption, statsOption, logLevelOption, detailOption});
+    parser.process(app);
+
+    //配置文件作为基础，命令行参数逐项覆盖
+    QVariantMap config;
+    if(parser.isSet(configOption))
+    {
+        QFile file(parser.value(configOption));
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            err() << "无法打开配置文件: " << file.fileName() << " (" << file.errorString() << ")\n";
+            return EXIT_FAILURE;
+        }
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        if(!document.isObject())
+        {
+            err() << "配置文件格式错误: " << error.errorString() << '\n';
+            return EXIT_FAILURE;
+        }
+        config = document.object().toVariantMap();
+    }
+    if(parser.isSet(dirOption))
+    {
+        config["dataDir"] = parser.value(dirOption);
+    }
+    if(parser.isSet(addressOption))
+    {
+        QStringList addresses;
+        for(const QString &value : parser.values(addressOption))
+        {
+            addresses << splitList(value);
+        }
+        config["addresses"] = addresses;
+    }
+    if(parser.isSet(modeOption))
+    {
+        const QString mode = parser.value(modeOption).toLower();
+        if(mode != "interval" && mode != "timestamp")
+        {
+            err() << "无效的回放节奏: " << mode << "（应为 interval 或 timestamp）\n";
+            return EXIT_FAILURE;
+        }
+        config["pacingMode"] = mode;
+    }
+    if(parser.isSet(intervalOption))
+    {
+        config["sendInterval"] = parser.value(intervalOption).toInt();
+    }
+    if(parser.isSet(speedOption))
+    {
+        config["speedFactor"] = parser.value(speedOption).toDouble();
+    }
+    if(parser.isSet(reverseOption))
+    {
+        config["order"] = "倒序";
+    }
+    if(parser.isSet(includeOption))
+    {
+        config["includeTopics"] = splitList(parser.value(includeOption));
+    }
+    if(parser.isSet(excludeOption))
+    {
+        config["excludeTopics"] = splitList(parser.value(excludeOption));
+    }
+    if(parser.isSet(uniqueOption))
+    {
+        config["uniqueMode"] = true;
+    }
+    if(parser.isSet(threadsOption))
+    {
+        config["parseThreads"] = parser.value(threadsOption).toInt();
+    }
+    if(parser.isSet(loopOption))
+    {
+        config["loopCount"] = parser.value(loopOption).toInt();
+    }
+    if(parser.isSet(startOption))
+    {
+        config["startTime"] = parser.value(startOption);
+    }
+    if(parser.isSet(resumeOption))
+    {
+        config["resumeCheckpoint"] = true;
+    }
+    if(parser.isSet(checkpointOption))
+    {
+        config["checkpointFile"] = parser.value(checkpointOption);
+    }
+    if(parser.isSet(telemetryOption))
+    {
+        config["telemetryFile"] = parser.value(telemetryOption);
+    }
+    //配置文件中的主题列表可能写成逗号分隔的字符串
+    for(const char *key : {"includeTopics", "excludeTopics", "addresses"})
+    {
+        if(config.value(key).type() == QVariant::String)
+        {
+            config[key] = splitList(config.value(key).toString());
+        }
+    }
+    const QStringList addresses = config.value("addresses").toStringList();
+    if(config.value("dataDir").toString().isEmpty() || addresses.isEmpty())
+    {
+        err() << "需要指定数据目录（--data-dir）和至少一个目标地址（--address）\n\n";
+        err() << parser.helpText();
+        return EXIT_FAILURE;
+    }
+    const QString logLevel = parser.value(logLevelOption).toUpper();
+    const LogStore::Level minLevel = LogStore::levelFromName(logLevel);
+    if(minLevel == LogStore::Other)
+    {
+        err() << "无效的日志级别: " << logLevel << "（应为 DEBUG、INFO、WARN 或 ERROR）\n";
+        return EXIT_FAILURE;
+    }
+    const int statsInterval = qMax(100, parser.value(statsOption).toInt());
+
+    //工作对象在独立线程中运行，主线程只负责定时输出
+    QThread workerThread;
+    WorkerClass worker;
+    worker.logBatcher()->setDetailEnabled(parser.isSet(detailOption));
+    worker.setAddrList(addresses);
+    worker.configure(config);
+    worker.moveToThread(&workerThread);
+    ConsoleReporter reporter(&worker, minLevel);
+
+    int success = 0;
+    int failed = 0;
+    bool finished = false;
+    QObject::connect(&workerThread, &QThread::started, &worker, &WorkerClass::startProcessing);
+    QObject::connect(&worker, &WorkerClass::statsUpdated, &app, [&success, &failed](int s, int f)
+    {
+        success = s;
+        failed = f;
+    });
+    QObject::connect(&worker, &WorkerClass::finished, &app, [&finished, &app]()
+    {
+        finished = true;
+        app.quit();
+    }, Qt::QueuedConnection);
+
+    QTimer statsTimer;
+    statsTimer.setInterval(statsInterval);
+    QObject::connect(&statsTimer, &QTimer::timeout, &app, [&]()
+    {
+        reporter.flushLogs();
+        reporter.printRates();
+    });
+    //信号处理函数只置位标志，在主线程中停止
+    QTimer signalTimer;
+    signalTimer.setInterval(100);
+    QObject::connect(&signalTimer, &QTimer::timeout, &app, [&app]()
+    {
+        if(g_signal.load() != 0)
+        {
+            err() << "收到中断信号，正在停止...\n";
+            err().flush();
+            app.quit();
+        }
+    });
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    out() << "回放开始: " << config.value("dataDir").toString() << " -> " << addresses.join(", ") << '\n';
+    out().flush();
+    statsTimer.start();
+    signalTimer.start();
+    workerThread.start();
+    app.exec();
+
+    statsTimer.stop();
+    signalTimer.stop();
+    //停止回放也会发出 finished，须在此之前记下是否被中断
+    const int signo = g_signal.load();
+    //中断时停止回放；正常结束时统计与导出已在工作线程中完成
+    worker.stopProcessing();
+    workerThread.quit();
+    workerThread.wait();
+    QCoreApplication::processEvents();
+    reporter.flushLogs();
+    reporter.printRates();
+    const bool completed = finished && signo == 0;
+    out() << (completed ? "回放完成" : "回放已中断") << " 成功: " << success << " 失败: " << failed << '\n';
+    out().flush();
+    if(!completed)
+    {
+        //与 shell 约定相同：128 + 信号值（SIGINT 为 130，SIGTERM 为 143）
+        return 128 + (signo != 0 ? signo : SIGINT);
+    }
+    //配置无效（如没有可用的目标地址）时回放未开始
+    if(worker.telemetry()->snapshot().destinations.isEmpty())
+    {
+        return EXIT_FAILURE;
+    }
+    return failed > 0 ? 2 : EXIT_SUCCESS;
+}
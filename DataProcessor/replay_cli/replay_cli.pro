@@ -0,0 +1,27 @@
+QT       += core network concurrent
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG += utf8
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Werror=return-type
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+TARGET = DataProcessorCli
+TEMPLATE = app
+
+# 与图形界面共用回放引擎源码（不含任何界面代码）
+include(../replay.pri)
+
+CONFIG(debug, debug|release) {
+    DESTDIR = $$PWD/../bin_debug
+} else {
+    DESTDIR = $$PWD/../bin_release
+}
+OBJECTS_DIR = $$DESTDIR/.obj_cli
+MOC_DIR = $$DESTDIR/.moc_cli
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,61 @@
+//packetarena_test
+//PacketArena 的段分配：超过段大小（16 MB）的数据包单独占用一段，不越界写入
+
+#include <QtTest>
+#include <QByteArray>
+
+#include "replay/packetarena.h"
+
+class PacketArenaTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    ///段大小 + 1 字节的包单独占用一段，前后的小包不受影响
+    void oversizedPacket()
+    {
+        const int segmentSize = 1 << 24;
+        QByteArray big(segmentSize + 1, Qt::Uninitialized);
+        for(int i = 0; i < big.size(); ++i)
+        {
+            big[i] = static_cast<char>(i * 31);
+        }
+        const QByteArray small("\x80\x21\x00\xC6\x00", 5);
+        PacketArena arena;
+        arena.reset(Q_INT64_C(64) << 20);
+        arena.beginFile();
+        QVERIFY(arena.append(1, 0, 0x00C6, small.constData(), small.size()));
+        QVERIFY(arena.append(2, 0, 0x00C6, big.constData(), big.size()));
+        QVERIFY(arena.append(3, 0, 0x00C6, small.constData(), small.size()));
+        QVERIFY(arena.isActive());
+        QCOMPARE(arena.packetCount(), 3);
+        QCOMPARE(arena.payloadBytes(), static_cast<qint64>(big.size() + 2 * small.size()));
+        for(int i = 0; i < arena.packetCount(); ++i)
+        {
+            const PacketArena::Packet &packet = arena.packet(i);
+            const QByteArray &expected = i == 1 ? big : small;
+            QCOMPARE(packet.timestampUs, static_cast<qint64>(i + 1));
+            QCOMPARE(packet.length, expected.size());
+            QVERIFY(QByteArray::fromRawData(arena.data(packet), packet.length) == expected);
+        }
+        //小段 + 单独的大段 + 小段
+        QVERIFY(arena.usedBytes() >= 2 * static_cast<qint64>(segmentSize) + big.size());
+    }
+
+    ///单独一段超出预算时释放并停止收集
+    void oversizedPacketOverBudget()
+    {
+        QByteArray big((1 << 24) + 1, '\x5A');
+        PacketArena arena;
+        arena.reset(Q_INT64_C(16) << 20);
+        arena.beginFile();
+        QVERIFY(!arena.append(1, 0, 0, big.constData(), big.size()));
+        QVERIFY(!arena.isActive());
+        QCOMPARE(arena.packetCount(), 0);
+        QCOMPARE(arena.usedBytes(), Q_INT64_C(0));
+    }
+};
+
+QTEST_APPLESS_MAIN(PacketArenaTest)
+
+#include "main.moc"
@@ -0,0 +1,21 @@
+QT       += core testlib
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+CONFIG += utf8
+
+QMAKE_CXXFLAGS += -Wall -Wextra -Werror=return-type
+
+TARGET = packetarena_test
+TEMPLATE = app
+
+# 直接复用 DataProcessor 的预载区源码
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    ../../replay/packetarena.cpp
+
+HEADERS += \
+    ../../replay/packetarena.h
@@ -30,18 +30,15 @@ distribution.
 const TiXmlString::size_type TiXmlString::npos = static_cast< TiXmlString::size_type >(-1);
 
 
-// Null rep.
-TiXmlString::Rep TiXmlString::nullrep_ = { 0, 0, { '\0' } };
-
-
 void TiXmlString::reserve (size_type cap)
 {
 	if (cap > capacity())
 	{
-		TiXmlString tmp;
-		tmp.init(length(), cap);
-		memcpy(tmp.start(), data(), length());
-		swap(tmp);
+		char* buffer = allocate(cap);
+		memcpy(buffer, data(), length() + 1);
+		quit();
+		start_ = buffer;
+		capacity_ = cap;
 	}
 }
 
@@ -49,12 +46,11 @@ void TiXmlString::reserve (size_type cap)
 TiXmlString& TiXmlString::assign(const char* str, size_type len)
 {
 	size_type cap = capacity();
-	if (len > cap || cap > 3*(len + 8))
+	if (len > cap || (!isLocal() && cap > 3*(len + 8)))
 	{
-		TiXmlString tmp;
-		tmp.init(len);
-		memcpy(tmp.start(), str, len);
-		swap(tmp);
+		// 'str' may point into this string, so copy before letting go.
+		TiXmlString tmp(str, len);
+		*this = static_cast<TiXmlString&&>(tmp);
 	}
 	else
 	{
@@ -70,9 +66,19 @@ TiXmlString& TiXmlString::append(const char* str, size_type len)
 	size_type newsize = length() + len;
 	if (newsize > capacity())
 	{
-		reserve (newsize + capacity());
+		// Grow into a new buffer first: 'str' may point into the old one.
+		const size_type cap = newsize + capacity();
+		char* buffer = allocate(cap);
+		memcpy(buffer, data(), length());
+		memcpy(buffer + length(), str, len);
+		quit();
+		start_ = buffer;
+		capacity_ = cap;
+	}
+	else
+	{
+		memmove(finish(), str, len);
 	}
-	memmove(finish(), str, len);
 	set_size(newsize);
 	return *this;
 }
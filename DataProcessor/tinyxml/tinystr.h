@@ -29,6 +29,9 @@ distribution.
 
 #include <assert.h>
 #include <string.h>
+#include <new>
+
+#include "tinyxmlarena.h"
 
 /*	The support for explicit isn't that universal, and it isn't really
 	required - it is used to check that the TiXmlString class isn't incorrectly
@@ -49,8 +52,11 @@ distribution.
    TiXmlString is an emulation of a subset of the std::string template.
    Its purpose is to allow compiling TinyXML on compilers with no or poor STL support.
    Only the member functions relevant to the TinyXML project have been implemented.
-   The buffer allocation is made by a simplistic power of 2 like mechanism : if we increase
-   a string and there's no more room, we allocate a buffer twice as big as we need.
+   Strings of up to LOCAL_CAPACITY characters are stored inside the object itself, which
+   covers nearly every element name, attribute and short text in a document; longer ones
+   use a buffer from TiXmlAllocate. The buffer allocation is made by a simplistic power of
+   2 like mechanism : if we increase a string and there's no more room, we allocate a
+   buffer twice as big as we need.
 */
 class TiXmlString
 {
@@ -63,26 +69,33 @@ class TiXmlString
 
 
 	// TiXmlString empty constructor
-	TiXmlString () : rep_(&nullrep_)
+	TiXmlString () : start_(local_), size_(0)
 	{
+		local_[0] = '\0';
 	}
 
 	// TiXmlString copy constructor
-	TiXmlString ( const TiXmlString & copy) : rep_(0)
+	TiXmlString ( const TiXmlString & copy) : start_(local_), size_(0)
 	{
 		init(copy.length());
 		memcpy(start(), copy.data(), length());
 	}
 
+	// TiXmlString move constructor. Takes over a heap buffer; short strings are copied.
+	TiXmlString ( TiXmlString && other) : start_(local_), size_(0)
+	{
+		take(other);
+	}
+
 	// TiXmlString constructor, based on a string
-	TIXML_EXPLICIT TiXmlString ( const char * copy) : rep_(0)
+	TIXML_EXPLICIT TiXmlString ( const char * copy) : start_(local_), size_(0)
 	{
 		init( static_cast<size_type>( strlen(copy) ));
 		memcpy(start(), copy, length());
 	}
 
 	// TiXmlString constructor, based on a string
-	TIXML_EXPLICIT TiXmlString ( const char * str, size_type len) : rep_(0)
+	TIXML_EXPLICIT TiXmlString ( const char * str, size_type len) : start_(local_), size_(0)
 	{
 		init(len);
 		memcpy(start(), str, len);
@@ -104,6 +117,16 @@ class TiXmlString
 		return assign(copy.start(), copy.length());
 	}
 
+	TiXmlString& operator = (TiXmlString && other)
+	{
+		if (this != &other)
+		{
+			quit();
+			take(other);
+		}
+		return *this;
+	}
+
 
 	// += operator. Maps to append
 	TiXmlString& operator += (const char * suffix)
@@ -114,6 +137,13 @@ class TiXmlString
 	// += operator. Maps to append
 	TiXmlString& operator += (char single)
 	{
+		// The parser appends text one character at a time.
+		if (size_ < capacity())
+		{
+			start_[size_] = single;
+			set_size(size_ + 1);
+			return *this;
+		}
 		return append(&single, 1);
 	}
 
@@ -125,36 +155,36 @@ class TiXmlString
 
 
 	// Convert a TiXmlString into a null-terminated char *
-	const char * c_str () const { return rep_->str; }
+	const char * c_str () const { return start_; }
 
 	// Convert a TiXmlString into a char * (need not be null terminated).
-	const char * data () const { return rep_->str; }
+	const char * data () const { return start_; }
 
 	// Return the length of a TiXmlString
-	size_type length () const { return rep_->size; }
+	size_type length () const { return size_; }
 
 	// Alias for length()
-	size_type size () const { return rep_->size; }
+	size_type size () const { return size_; }
 
 	// Checks if a TiXmlString is empty
-	bool empty () const { return rep_->size == 0; }
+	bool empty () const { return size_ == 0; }
 
 	// Return capacity of string
-	size_type capacity () const { return rep_->capacity; }
+	size_type capacity () const { return isLocal() ? size_type(LOCAL_CAPACITY) : capacity_; }
 
 
 	// single char extraction
 	const char& at (size_type index) const
 	{
 		assert( index < length() );
-		return rep_->str[ index ];
+		return start_[ index ];
 	}
 
 	// [] operator
 	char& operator [] (size_type index) const
 	{
 		assert( index < length() );
-		return rep_->str[ index ];
+		return start_[ index ];
 	}
 
 	// find a char in a string. Return TiXmlString::npos if not found
@@ -196,58 +226,84 @@ class TiXmlString
 
 	void swap (TiXmlString& other)
 	{
-		Rep* r = rep_;
-		rep_ = other.rep_;
-		other.rep_ = r;
+		TiXmlString tmp(static_cast<TiXmlString&&>(other));
+		other = static_cast<TiXmlString&&>(*this);
+		*this = static_cast<TiXmlString&&>(tmp);
 	}
 
   private:
 
-	void init(size_type sz) { init(sz, sz); }
-	void set_size(size_type sz) { rep_->str[ rep_->size = sz ] = '\0'; }
-	char* start() const { return rep_->str; }
-	char* finish() const { return rep_->str + rep_->size; }
+	// Characters stored in the object itself, not counting the terminator.
+	enum { LOCAL_CAPACITY = 15 };
 
-	struct Rep
-	{
-		size_type size, capacity;
-		char str[1];
-	};
+	bool isLocal() const { return start_ == local_; }
+	void init(size_type sz) { init(sz, sz); }
+	void set_size(size_type sz) { start_[ size_ = sz ] = '\0'; }
+	char* start() const { return start_; }
+	char* finish() const { return start_ + size_; }
 
 	void init(size_type sz, size_type cap)
 	{
-		if (cap)
+		if (cap > LOCAL_CAPACITY)
 		{
 			// Lee: the original form:
 			//	rep_ = static_cast<Rep*>(operator new(sizeof(Rep) + cap));
-			// doesn't work in some cases of new being overloaded. Switching
-			// to the normal allocation, although use an 'int' for systems
-			// that are overly picky about structure alignment.
-			const size_type bytesNeeded = sizeof(Rep) + cap;
-			const size_type intsNeeded = ( bytesNeeded + sizeof(int) - 1 ) / sizeof( int ); 
-			rep_ = reinterpret_cast<Rep*>( new int[ intsNeeded ] );
-
-			rep_->str[ rep_->size = sz ] = '\0';
-			rep_->capacity = cap;
+			// doesn't work in some cases of new being overloaded.
+			// TiXmlAllocate returns aligned memory from the current arena
+			// (see TiXmlDocument::SetUseArena) or the heap.
+			start_ = allocate(cap);
+			capacity_ = cap;
 		}
 		else
 		{
-			rep_ = &nullrep_;
+			start_ = local_;
 		}
+		set_size(sz);
 	}
 
 	void quit()
 	{
-		if (rep_ != &nullrep_)
+		if (!isLocal())
+		{
+			// Arena blocks are left to the arena. (see the allocator, above).
+			TiXmlDeallocate( start_ );
+		}
+	}
+
+	static char* allocate(size_type cap)
+	{
+		void* block = TiXmlAllocate( cap + 1 );
+		if ( !block )
+			throw std::bad_alloc();		// as new int[] did
+		return static_cast<char*>( block );
+	}
+
+	// Take over the contents of 'other' and leave it empty. This string must hold no buffer.
+	void take(TiXmlString& other)
+	{
+		if (other.isLocal())
 		{
-			// The rep_ is really an array of ints. (see the allocator, above).
-			// Cast it back before delete, so the compiler won't incorrectly call destructors.
-			delete [] ( reinterpret_cast<int*>( rep_ ) );
+			start_ = local_;
+			memcpy(local_, other.local_, other.size_ + 1);
+			size_ = other.size_;
 		}
+		else
+		{
+			start_ = other.start_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			other.start_ = other.local_;
+		}
+		other.set_size(0);
 	}
 
-	Rep * rep_;
-	static Rep nullrep_;
+	char* start_;
+	size_type size_;
+	union
+	{
+		size_type capacity_;					// when start_ points to a buffer
+		char local_[ LOCAL_CAPACITY + 1 ];		// when start_ == local_
+	};
 
 } ;
 
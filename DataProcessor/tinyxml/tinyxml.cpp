@@ -812,6 +812,15 @@ void TiXmlElement::SetAttribute( const char * cname, const char * cvalue )
 }
 
 
+void TiXmlElement::SetAttribute( const char * cname, TIXML_STRING&& _value )
+{
+	TiXmlAttribute* attrib = attributeSet.FindOrCreate( cname );
+	if ( attrib ) {
+		attrib->SetValue( std::move( _value ) );
+	}
+}
+
+
 #ifdef TIXML_USE_STL
 void TiXmlElement::SetAttribute( const std::string& _name, const std::string& _value )
 {
@@ -936,14 +945,14 @@ const char* TiXmlElement::GetText() const
 }
 
 
-TiXmlDocument::TiXmlDocument() : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT )
+TiXmlDocument::TiXmlDocument() : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT ), arena( 0 )
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
 	ClearError();
 }
 
-TiXmlDocument::TiXmlDocument( const char * documentName ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT )
+TiXmlDocument::TiXmlDocument( const char * documentName ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT ), arena( 0 )
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
@@ -953,7 +962,7 @@ TiXmlDocument::TiXmlDocument( const char * documentName ) : TiXmlNode( TiXmlNode
 
 
 #ifdef TIXML_USE_STL
-TiXmlDocument::TiXmlDocument( const std::string& documentName ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT )
+TiXmlDocument::TiXmlDocument( const std::string& documentName ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT ), arena( 0 )
 {
 	tabsize = 4;
 	useMicrosoftBOM = false;
@@ -963,12 +972,55 @@ TiXmlDocument::TiXmlDocument( const std::string& documentName ) : TiXmlNode( TiX
 #endif
 
 
-TiXmlDocument::TiXmlDocument( const TiXmlDocument& copy ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT )
+TiXmlDocument::TiXmlDocument( const TiXmlDocument& copy ) : TiXmlNode( TiXmlNode::TINYXML_DOCUMENT ), arena( 0 )
 {
 	copy.CopyTo( this );
 }
 
 
+TiXmlDocument::~TiXmlDocument()
+{
+	if ( arena )
+	{
+		// The tree and the strings filled in while parsing point into the
+		// arena, so they have to go before it does. Deleting arena nodes only
+		// runs their destructors; heap nodes linked in later are freed.
+		Clear();
+		{
+			TIXML_STRING releasedValue;
+			TIXML_STRING releasedError;
+			value.swap( releasedValue );
+			errorDesc.swap( releasedError );
+		}
+		delete arena;
+	}
+}
+
+
+void TiXmlDocument::SetUseArena( bool useArena )
+{
+	if ( useArena && !arena )
+	{
+		arena = new TiXmlArena();
+	}
+	else if ( !useArena && arena )
+	{
+		// Nodes already parsed still live in the arena; keep it until the
+		// document goes away.
+		if ( !firstChild )
+		{
+			{
+				// Keep the last error, on the heap.
+				TIXML_STRING heapError( errorDesc.c_str() );
+				errorDesc.swap( heapError );
+			}
+			delete arena;
+			arena = 0;
+		}
+	}
+}
+
+
 TiXmlDocument& TiXmlDocument::operator=( const TiXmlDocument& copy )
 {
 	Clear();
@@ -991,7 +1043,7 @@ bool TiXmlDocument::SaveFile() const
 bool TiXmlDocument::LoadFile( const char* _filename, TiXmlEncoding encoding )
 {
 	TIXML_STRING filename( _filename );
-	value = filename;
+	value = std::move( filename );
 
 	// reading in binary mode so that tinyxml can normalize the EOL
     FILE* file = TiXmlFOpen( value.c_str (), "rb" );
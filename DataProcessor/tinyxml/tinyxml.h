@@ -37,6 +37,10 @@ distribution.
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <new>
+#include <utility>
+
+#include "tinyxmlarena.h"
 
 // Help out windows:
 #if defined( _DEBUG ) && !defined( DEBUG )
@@ -201,6 +205,19 @@ public:
 	TiXmlBase()	:	userData(0)		{}
 	virtual ~TiXmlBase()			{}
 
+	/**	Nodes and attributes are allocated with TiXmlAllocate, so the ones
+		created while an arena document parses live in its arena.
+		@sa TiXmlDocument::SetUseArena()
+	*/
+	static void* operator new( size_t size )
+	{
+		void* p = TiXmlAllocate( size );
+		if ( !p )
+			throw std::bad_alloc();
+		return p;
+	}
+	static void operator delete( void* p )	{ TiXmlDeallocate( p ); }
+
 	/**	All TinyXml classes can print themselves to a filestream
 		or the string class (TiXmlString in non-STL mode, std::string
 		in STL mode.) Either or both cfile and str can be null.
@@ -507,6 +524,9 @@ public:
 	*/
 	void SetValue(const char * _value) { value = _value;}
 
+	/// Take over the characters of '_value' instead of copying them.
+	void SetValue( TIXML_STRING&& _value )	{ value = std::move( _value ); }
+
     #ifdef TIXML_USE_STL
 	/// STL std::string form.
 	void SetValue( const std::string& _value )	{ value = _value; }
@@ -834,6 +854,8 @@ public:
 
 	void SetName( const char* _name )	{ name = _name; }				///< Set the name of this attribute.
 	void SetValue( const char* _value )	{ value = _value; }				///< Set the value.
+	void SetName( TIXML_STRING&& _name )	{ name = std::move( _name ); }		///< Set the name, taking over the string.
+	void SetValue( TIXML_STRING&& _value )	{ value = std::move( _value ); }	///< Set the value, taking over the string.
 
     void SetIntValue( int _value );
     void SetUIntValue( unsigned val );
@@ -1051,6 +1073,8 @@ public:
 		will be created if it does not exist, or changed if it does.
 	*/
 	void SetAttribute( const char* name, const char * _value );
+	/// Sets an attribute of name to a given value, taking over the string.
+	void SetAttribute( const char* name, TIXML_STRING&& _value );
 
     #ifdef TIXML_USE_STL
 	const std::string* Attribute( const std::string& name ) const;
@@ -1413,7 +1437,21 @@ public:
 	TiXmlDocument( const TiXmlDocument& copy );
 	TiXmlDocument& operator=( const TiXmlDocument& copy );
 
-	virtual ~TiXmlDocument() {}
+	virtual ~TiXmlDocument();
+
+	/**	Parse into an arena owned by the document. Every node, attribute and
+		string the parser creates is carved out of a few large blocks instead
+		of being allocated one by one, and the whole tree is released in one
+		shot when the document is destroyed. Clearing or reloading the document
+		keeps the arena's memory until then, so this suits documents that are
+		loaded once and read. Set it before LoadFile() or Parse(). Copies of
+		an arena document use the heap.
+	*/
+	void SetUseArena( bool useArena );
+	/// True if SetUseArena( true ) has been called.
+	bool UsesArena() const					{ return arena != 0; }
+	/// The document's arena, or null. Useful for statistics.
+	const TiXmlArena* Arena() const			{ return arena; }
 
 	/** Load a file using the current document value.
 		Returns true if successful. Will delete any existing
@@ -1559,6 +1597,7 @@ private:
 	int tabsize;
 	TiXmlCursor errorLocation;
 	bool useMicrosoftBOM;		// the UTF-8 BOM were found when read. Note this, and try to write.
+	TiXmlArena* arena;			// owns the parsed tree when SetUseArena( true ), else null
 };
 
 
@@ -0,0 +1,156 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#include <stdlib.h>
+
+#include "tinyxmlarena.h"
+
+namespace
+{
+	// Prefixed to every allocation. The union makes it as large and as
+	// aligned as anything the DOM stores (pointers, size_t, double), so the
+	// payload stays aligned.
+	union AllocHeader
+	{
+		TiXmlArena* arena;		// null for heap allocations
+		double d;
+		long long ll;
+		void* p;
+	};
+
+	const size_t ALIGNMENT = sizeof( AllocHeader );
+	const size_t MIN_BLOCK = 64 * 1024;
+	const size_t MAX_BLOCK = 1024 * 1024;
+
+	inline size_t AlignUp( size_t size )
+	{
+		return ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+	}
+
+	thread_local TiXmlArena* currentArena = 0;
+	thread_local TiXmlAllocationStats allocationStats = { 0, 0 };
+}
+
+
+TiXmlArena::TiXmlArena() : blocks( 0 ), cursor( 0 ), limit( 0 ), used( 0 ), reserved( 0 )
+{
+}
+
+
+TiXmlArena::~TiXmlArena()
+{
+	Clear();
+}
+
+
+void* TiXmlArena::Allocate( size_t size )
+{
+	size = AlignUp( size );
+	if ( size > (size_t)( limit - cursor ) )
+	{
+		// Blocks grow with the document up to MAX_BLOCK; a larger request
+		// gets a block of its own.
+		size_t blockSize = reserved < MIN_BLOCK ? MIN_BLOCK : ( reserved > MAX_BLOCK ? MAX_BLOCK : reserved );
+		if ( blockSize < size )
+			blockSize = size;
+		const size_t headerSize = AlignUp( sizeof( Block ) );
+		Block* block = static_cast<Block*>( malloc( headerSize + blockSize ) );
+		if ( !block )
+			return 0;
+		++allocationStats.heap;
+		block->next = blocks;
+		block->size = blockSize;
+		blocks = block;
+		cursor = reinterpret_cast<char*>( block ) + headerSize;
+		limit = cursor + blockSize;
+		reserved += blockSize;
+	}
+	void* p = cursor;
+	cursor += size;
+	used += size;
+	return p;
+}
+
+
+void TiXmlArena::Clear()
+{
+	while ( blocks )
+	{
+		Block* next = blocks->next;
+		free( blocks );
+		blocks = next;
+	}
+	cursor = limit = 0;
+	used = reserved = 0;
+}
+
+
+TiXmlArena* TiXmlArena::Current()
+{
+	return currentArena;
+}
+
+
+TiXmlArena::Scope::Scope( TiXmlArena* arena ) : previous( currentArena )
+{
+	currentArena = arena;
+}
+
+
+TiXmlArena::Scope::~Scope()
+{
+	currentArena = previous;
+}
+
+
+void* TiXmlAllocate( size_t size )
+{
+	TiXmlArena* arena = currentArena;
+	AllocHeader* header = static_cast<AllocHeader*>( arena ? arena->Allocate( sizeof( AllocHeader ) + size )
+															: malloc( sizeof( AllocHeader ) + size ) );
+	if ( !header )
+		return 0;
+	if ( !arena )
+		++allocationStats.heap;
+	else
+		++allocationStats.arena;
+	header->arena = arena;
+	return header + 1;
+}
+
+
+void TiXmlDeallocate( void* p )
+{
+	if ( !p )
+		return;
+	AllocHeader* header = static_cast<AllocHeader*>( p ) - 1;
+	// Arena memory is released with the arena.
+	if ( !header->arena )
+		free( header );
+}
+
+
+TiXmlAllocationStats TiXmlGetAllocationStats()
+{
+	return allocationStats;
+}
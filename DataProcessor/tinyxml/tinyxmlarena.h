@@ -0,0 +1,121 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+/*	Altered source: arena allocation for the DOM, added for DataProcessor.
+	Not part of the original TinyXML distribution.
+*/
+
+
+#ifndef TIXML_ARENA_INCLUDED
+#define TIXML_ARENA_INCLUDED
+
+#include <stddef.h>
+
+/**
+	A bump allocator that hands out memory from large blocks and releases
+	all of it at once.
+
+	A TiXmlDocument with SetUseArena( true ) installs its arena while it parses,
+	so every node, attribute and string created by the parser comes from the
+	arena instead of a separate heap allocation. Deleting such an object only
+	runs its destructor; the memory is returned when the document is destroyed.
+	Objects created outside a parse (Clone(), new TiXmlElement, SetValue()
+	growing a string) still come from the heap and are freed normally, so an
+	arena document can be edited like any other.
+
+	The arena is not thread safe. The "current" arena is per thread.
+*/
+class TiXmlArena
+{
+public:
+	TiXmlArena();
+	~TiXmlArena();
+
+	/// Allocate 'size' bytes. Returns null if the system is out of memory.
+	void* Allocate( size_t size );
+
+	/// Release every block. All memory handed out becomes invalid.
+	void Clear();
+
+	/// Bytes handed out since construction or the last Clear().
+	size_t BytesUsed() const		{ return used; }
+	/// Bytes held in blocks.
+	size_t BytesReserved() const	{ return reserved; }
+
+	/// The arena allocations on this thread go to, or null for the heap.
+	static TiXmlArena* Current();
+
+	/**	Makes an arena current for its lifetime and restores the previous one
+		on destruction. A null arena sends allocations to the heap.
+	*/
+	class Scope
+	{
+	public:
+		explicit Scope( TiXmlArena* arena );
+		~Scope();
+
+	private:
+		Scope( const Scope& );				// not implemented.
+		void operator=( const Scope& );		// not allowed.
+
+		TiXmlArena* previous;
+	};
+
+private:
+	TiXmlArena( const TiXmlArena& );		// not implemented.
+	void operator=( const TiXmlArena& );	// not allowed.
+
+	struct Block
+	{
+		Block* next;
+		size_t size;
+	};
+
+	Block* blocks;		// most recent block first
+	char* cursor;		// next free byte in the current block
+	char* limit;		// end of the current block
+	size_t used;
+	size_t reserved;
+};
+
+/*	Allocation used by the DOM (TiXmlBase::operator new) and TiXmlString.
+	Goes to the current arena if there is one, otherwise to the heap. Every
+	block carries a small header naming its arena, so TiXmlDeallocate knows
+	whether to free it or leave it to the arena.
+*/
+void* TiXmlAllocate( size_t size );
+void TiXmlDeallocate( void* p );
+
+/**	Counts of the allocations made through TiXmlAllocate on this thread,
+	since the thread started. Take two snapshots and subtract them to see what
+	a Parse() cost.
+*/
+struct TiXmlAllocationStats
+{
+	size_t heap;		///< Blocks taken from malloc: one per heap allocation, one per arena block.
+	size_t arena;		///< Allocations served from an arena block.
+};
+
+TiXmlAllocationStats TiXmlGetAllocationStats();
+
+#endif	// TIXML_ARENA_INCLUDED
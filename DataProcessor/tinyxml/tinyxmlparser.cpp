@@ -703,6 +703,8 @@ void TiXmlDocument::StreamIn( std::istream * in, TIXML_STRING * tag )
 
 const char* TiXmlDocument::Parse( const char* p, TiXmlParsingData* prevData, TiXmlEncoding encoding )
 {
+	// Everything created below comes from the arena, if the document has one.
+	TiXmlArena::Scope arenaScope( arena );
 	ClearError();
 
 	// Parse away, at the document level. Since a document
@@ -1075,9 +1077,6 @@ const char* TiXmlElement::Parse( const char* p, TiXmlParsingData* data, TiXmlEnc
 		return 0;
 	}
 
-    TIXML_STRING endTag ("</");
-	endTag += value;
-
 	// Check for and read attributes. Also look for an empty
 	// tag or an end tag.
 	while ( p && *p )
@@ -1119,9 +1118,11 @@ const char* TiXmlElement::Parse( const char* p, TiXmlParsingData* data, TiXmlEnc
 			// </foo > and
 			// </foo> 
 			// are both valid end tags.
-			if ( StringEqual( p, endTag.c_str(), false, encoding ) )
+			// (Compared in place rather than through a "</" + value string,
+			// which cost an allocation per element.)
+			if ( p[0] == '<' && p[1] == '/' && StringEqual( p + 2, value.c_str(), false, encoding ) )
 			{
-				p += endTag.length();
+				p += 2 + value.length();
 				p = SkipWhiteSpace( p, encoding );
 				if ( p && *p && *p == '>' ) {
 					++p;
@@ -0,0 +1,631 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <qfile.h>
+#include <qstring.h>
+
+#include "tinyxmlreader.h"
+
+namespace
+{
+	const size_t INITIAL_SCRATCH = 256;
+
+	inline bool IsSpace( char c )
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// Characters that end a name.
+	inline bool EndsName( char c )
+	{
+		return IsSpace( c ) || c == '/' || c == '>' || c == '=' || c == '<';
+	}
+
+	// Encode a code point as UTF-8. Returns the number of bytes written.
+	int EncodeUtf8( unsigned long code, char* out )
+	{
+		if ( code < 0x80 )
+		{
+			out[0] = (char)code;
+			return 1;
+		}
+		if ( code < 0x800 )
+		{
+			out[0] = (char)( 0xC0 | ( code >> 6 ) );
+			out[1] = (char)( 0x80 | ( code & 0x3F ) );
+			return 2;
+		}
+		if ( code < 0x10000 )
+		{
+			out[0] = (char)( 0xE0 | ( code >> 12 ) );
+			out[1] = (char)( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+			out[2] = (char)( 0x80 | ( code & 0x3F ) );
+			return 3;
+		}
+		if ( code < 0x110000 )
+		{
+			out[0] = (char)( 0xF0 | ( code >> 18 ) );
+			out[1] = (char)( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+			out[2] = (char)( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+			out[3] = (char)( 0x80 | ( code & 0x3F ) );
+			return 4;
+		}
+		return 0;
+	}
+
+	/*	Decode the entity at p ('&'). Writes up to 4 bytes to 'out' and returns
+		the number written, and in 'used' the length of the entity. Returns 0
+		if p does not start a known entity; the '&' is then kept as is, as
+		TiXmlBase::GetEntity does.
+	*/
+	int DecodeEntity( const char* p, const char* last, char* out, size_t* used )
+	{
+		const char* semi = static_cast<const char*>( memchr( p, ';', last - p < 12 ? last - p : 12 ) );
+		if ( !semi )
+			return 0;
+		const size_t length = semi - p + 1;
+		if ( p[1] == '#' )
+		{
+			unsigned long code = 0;
+			const char* q = p + 2;
+			const bool hex = ( q < semi && ( *q == 'x' || *q == 'X' ) );
+			if ( hex )
+				++q;
+			if ( q == semi )
+				return 0;
+			for ( ; q < semi; ++q )
+			{
+				int digit;
+				if ( *q >= '0' && *q <= '9' )
+					digit = *q - '0';
+				else if ( hex && *q >= 'a' && *q <= 'f' )
+					digit = *q - 'a' + 10;
+				else if ( hex && *q >= 'A' && *q <= 'F' )
+					digit = *q - 'A' + 10;
+				else
+					return 0;
+				code = code * ( hex ? 16 : 10 ) + digit;
+			}
+			const int n = EncodeUtf8( code, out );
+			if ( n )
+				*used = length;
+			return n;
+		}
+		static const struct { const char* str; size_t length; char chr; } entities[] =
+		{
+			{ "&amp;", 5, '&' }, { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&quot;", 6, '\"' }, { "&apos;", 6, '\'' }
+		};
+		for ( size_t i = 0; i < sizeof( entities ) / sizeof( entities[0] ); ++i )
+		{
+			if ( length == entities[i].length && memcmp( p, entities[i].str, length ) == 0 )
+			{
+				*out = entities[i].chr;
+				*used = length;
+				return 1;
+			}
+		}
+		return 0;
+	}
+}
+
+
+TiXmlReader::TiXmlReader()
+	: file( 0 ), begin( 0 ), end( 0 ), p( 0 ), eventStart( 0 ),
+	  event( TINYXML_END_DOCUMENT ), depth( 0 ), openElements( 0 ), pendingEnd( false ),
+	  scratch( 0 ), scratchSize( 0 ), scratchCapacity( 0 ), nameOffset( 0 ), textOffset( 0 ),
+	  attributes( 0 ), attributeCount( 0 ), attributeCapacity( 0 ),
+	  stack( 0 ), stackSize( 0 ), stackCapacity( 0 ),
+	  rowScan( 0 ), row( 1 ), errorRow( 0 )
+{
+	// Offset 0 of the scratch buffer is always an empty string, so Name()
+	// and Text() are valid before the first event.
+	Reserve( scratch, scratchCapacity, INITIAL_SCRATCH );
+	scratch[0] = 0;
+	errorDesc[0] = 0;
+}
+
+
+TiXmlReader::~TiXmlReader()
+{
+	Close();
+	free( scratch );
+	free( attributes );
+	free( stack );
+}
+
+
+bool TiXmlReader::OpenFile( const char* filename )
+{
+	Close();
+	file = new QFile( QString::fromUtf8( filename ) );
+	if ( !file->open( QIODevice::ReadOnly ) )
+	{
+		Close();
+		SetError( "Failed to open file", 0 );
+		return false;
+	}
+	const qint64 size = file->size();
+	if ( size <= 0 )
+	{
+		Close();
+		SetError( "Document empty", 0 );
+		return false;
+	}
+	const uchar* data = file->map( 0, size );
+	if ( !data )
+	{
+		Close();
+		SetError( "Failed to map file", 0 );
+		return false;
+	}
+	OpenBuffer( reinterpret_cast<const char*>( data ), static_cast<size_t>( size ) );
+	return true;
+}
+
+
+void TiXmlReader::OpenBuffer( const char* data, size_t length )
+{
+	begin = data;
+	end = data + length;
+	// Skip the UTF-8 BOM.
+	if ( length >= 3 && (unsigned char)data[0] == 0xEF && (unsigned char)data[1] == 0xBB && (unsigned char)data[2] == 0xBF )
+		begin += 3;
+	p = eventStart = rowScan = begin;
+	row = 1;
+	event = TINYXML_START_ELEMENT;	// anything but end or error
+	depth = openElements = 0;
+	pendingEnd = false;
+	scratchSize = 1;
+	nameOffset = textOffset = 0;
+	attributeCount = 0;
+	stackSize = 0;
+	errorDesc[0] = 0;
+	errorRow = 0;
+}
+
+
+void TiXmlReader::Close()
+{
+	if ( file )
+	{
+		// Unmapped by close().
+		delete file;
+		file = 0;
+	}
+	begin = end = p = eventStart = rowScan = 0;
+	row = 1;
+	event = TINYXML_END_DOCUMENT;
+	depth = openElements = 0;
+	pendingEnd = false;
+	scratchSize = 1;
+	nameOffset = textOffset = 0;
+	attributeCount = 0;
+	stackSize = 0;
+}
+
+
+TiXmlReader::EventType TiXmlReader::Next()
+{
+	if ( event == TINYXML_END_DOCUMENT || event == TINYXML_READ_ERROR )
+		return event;
+
+	scratchSize = 1;
+	nameOffset = textOffset = 0;
+	attributeCount = 0;
+
+	if ( pendingEnd )
+	{
+		// The end of a self-closing element.
+		pendingEnd = false;
+		return CloseElement( 0, 0 );
+	}
+
+	while ( p < end )
+	{
+		eventStart = p;
+		if ( *p != '<' )
+		{
+			const char* next = static_cast<const char*>( memchr( p, '<', end - p ) );
+			if ( !next )
+				next = end;
+			// Most text between tags is indentation; check before decoding.
+			const char* first = p;
+			while ( first < next && IsSpace( *first ) )
+				++first;
+			p = next;
+			if ( first == next || openElements == 0 )
+				continue;
+			const char* last = next;
+			while ( IsSpace( *( last - 1 ) ) )
+				--last;
+			eventStart = first;
+			textOffset = AppendDecoded( first, last );
+			if ( !textOffset )
+				return SetError( "Out of memory", first );
+			depth = openElements;
+			return event = TINYXML_TEXT;
+		}
+
+		const size_t left = end - p;
+		if ( left >= 4 && memcmp( p, "<!--", 4 ) == 0 )
+		{
+			const char* close = Find( p + 4, "-->" );
+			if ( !close )
+				return SetError( "Error parsing Comment.", p );
+			p = close + 3;
+		}
+		else if ( left >= 9 && memcmp( p, "<![CDATA[", 9 ) == 0 )
+		{
+			const char* close = Find( p + 9, "]]>" );
+			if ( !close )
+				return SetError( "Error parsing CDATA.", p );
+			const char* text = p + 9;
+			p = close + 3;
+			if ( openElements == 0 )
+				continue;
+			textOffset = AppendRaw( text, close - text );
+			if ( !textOffset )
+				return SetError( "Out of memory", text );
+			depth = openElements;
+			return event = TINYXML_TEXT;
+		}
+		else if ( left >= 2 && p[1] == '?' )
+		{
+			const char* close = Find( p + 2, "?>" );
+			if ( !close )
+				return SetError( "Error parsing Declaration.", p );
+			p = close + 2;
+		}
+		else if ( left >= 2 && p[1] == '!' )
+		{
+			// DOCTYPE and friends; an internal subset is bracketed.
+			int brackets = 0;
+			const char* q = p + 2;
+			for ( ; q < end; ++q )
+			{
+				if ( *q == '[' )
+					++brackets;
+				else if ( *q == ']' )
+					--brackets;
+				else if ( *q == '>' && brackets <= 0 )
+					break;
+			}
+			if ( q == end )
+				return SetError( "Error parsing Unknown.", p );
+			p = q + 1;
+		}
+		else if ( left >= 2 && p[1] == '/' )
+		{
+			// "</name>"
+			const char* nameStart = p + 2;
+			const char* q = ReadName( nameStart );
+			if ( !q )
+				return SetError( "Error reading end tag.", p );
+			const char* nameEnd = q;
+			while ( q < end && IsSpace( *q ) )
+				++q;
+			if ( q == end || *q != '>' )
+				return SetError( "Error reading end tag.", p );
+			p = q + 1;
+			return CloseElement( nameStart, nameEnd - nameStart );
+		}
+		else
+		{
+			return ReadStartTag();
+		}
+	}
+
+	if ( openElements )
+		return SetError( "Error reading end tag.", end );
+	return event = TINYXML_END_DOCUMENT;
+}
+
+
+const char* TiXmlReader::Attribute( const char* name ) const
+{
+	for ( int i = 0; i < attributeCount; ++i )
+	{
+		if ( strcmp( scratch + attributes[ 2 * i ], name ) == 0 )
+			return scratch + attributes[ 2 * i + 1 ];
+	}
+	return 0;
+}
+
+
+bool TiXmlReader::SkipElement()
+{
+	if ( event != TINYXML_START_ELEMENT )
+		return false;
+	const int level = depth;
+	for ( ;; )
+	{
+		const EventType next = Next();
+		if ( next == TINYXML_END_ELEMENT && depth == level )
+			return true;
+		if ( next == TINYXML_END_DOCUMENT || next == TINYXML_READ_ERROR )
+			return false;
+	}
+}
+
+
+int TiXmlReader::Row() const
+{
+	// Events only move forward, so the count only ever extends.
+	while ( rowScan < eventStart )
+	{
+		const char* newline = static_cast<const char*>( memchr( rowScan, '\n', eventStart - rowScan ) );
+		if ( !newline )
+		{
+			rowScan = eventStart;
+			break;
+		}
+		++row;
+		rowScan = newline + 1;
+	}
+	return row;
+}
+
+
+TiXmlReader::EventType TiXmlReader::SetError( const char* desc, const char* at )
+{
+	eventStart = ( at && at > eventStart ) ? at : eventStart;
+	errorRow = begin ? Row() : 0;
+	size_t length = strlen( desc );
+	if ( length >= sizeof( errorDesc ) )
+		length = sizeof( errorDesc ) - 1;
+	memcpy( errorDesc, desc, length );
+	errorDesc[ length ] = 0;
+	return event = TINYXML_READ_ERROR;
+}
+
+
+TiXmlReader::EventType TiXmlReader::ReadStartTag()
+{
+	const char* nameStart = p + 1;
+	const char* q = ReadName( nameStart );
+	if ( !q )
+		return SetError( "Failed to read Element name", p );
+	const size_t nameLength = q - nameStart;
+	nameOffset = AppendRaw( nameStart, nameLength );
+	if ( !nameOffset )
+		return SetError( "Out of memory", p );
+	p = q;
+	if ( !ReadAttributes() )
+		return event;
+
+	if ( !Reserve( stack, stackCapacity, stackSize + nameLength + 1 ) )
+		return SetError( "Out of memory", eventStart );
+	memcpy( stack + stackSize, nameStart, nameLength );
+	stackSize += nameLength;
+	stack[ stackSize++ ] = 0;
+
+	depth = openElements++;
+	return event = TINYXML_START_ELEMENT;
+}
+
+
+TiXmlReader::EventType TiXmlReader::CloseElement( const char* name, size_t length )
+{
+	if ( openElements == 0 )
+		return SetError( "Error reading end tag.", eventStart );
+	// The innermost open element.
+	size_t top = stackSize - 1;
+	while ( top > 0 && stack[ top - 1 ] )
+		--top;
+	const size_t topLength = stackSize - 1 - top;
+	if ( name && ( length != topLength || memcmp( name, stack + top, topLength ) != 0 ) )
+		return SetError( "Error reading end tag.", eventStart );
+	nameOffset = AppendRaw( stack + top, topLength );
+	if ( !nameOffset )
+		return SetError( "Out of memory", eventStart );
+	stackSize = top;
+	depth = --openElements;
+	return event = TINYXML_END_ELEMENT;
+}
+
+
+const char* TiXmlReader::ReadName( const char* q )
+{
+	const char* start = q;
+	while ( q < end && !EndsName( *q ) )
+		++q;
+	return ( q == start || q == end ) ? 0 : q;
+}
+
+
+bool TiXmlReader::ReadAttributes()
+{
+	for ( ;; )
+	{
+		while ( p < end && IsSpace( *p ) )
+			++p;
+		if ( p == end )
+		{
+			SetError( "Error reading Attributes.", eventStart );
+			return false;
+		}
+		if ( *p == '>' )
+		{
+			++p;
+			return true;
+		}
+		if ( *p == '/' )
+		{
+			if ( p + 1 == end || p[1] != '>' )
+			{
+				SetError( "Error parsing Empty tag.", p );
+				return false;
+			}
+			p += 2;
+			pendingEnd = true;
+			return true;
+		}
+
+		const char* nameStart = p;
+		const char* q = ReadName( nameStart );
+		if ( !q )
+		{
+			SetError( "Error reading Attributes.", p );
+			return false;
+		}
+		const char* nameEnd = q;
+		while ( q < end && IsSpace( *q ) )
+			++q;
+		if ( q == end || *q != '=' )
+		{
+			SetError( "Error reading Attributes.", p );
+			return false;
+		}
+		++q;
+		while ( q < end && IsSpace( *q ) )
+			++q;
+		if ( q == end || ( *q != '\"' && *q != '\'' ) )
+		{
+			SetError( "Error reading Attributes.", p );
+			return false;
+		}
+		const char* valueStart = q + 1;
+		const char* valueEnd = static_cast<const char*>( memchr( valueStart, *q, end - valueStart ) );
+		if ( !valueEnd )
+		{
+			SetError( "Error reading Attributes.", p );
+			return false;
+		}
+		const size_t nameAt = AppendRaw( nameStart, nameEnd - nameStart );
+		const size_t valueAt = nameAt ? AppendDecoded( valueStart, valueEnd ) : 0;
+		if ( !valueAt || !PushAttribute( nameAt, valueAt ) )
+		{
+			SetError( "Out of memory", p );
+			return false;
+		}
+		p = valueEnd + 1;
+	}
+}
+
+
+const char* TiXmlReader::Find( const char* q, const char* token ) const
+{
+	const size_t length = strlen( token );
+	while ( q < end )
+	{
+		q = static_cast<const char*>( memchr( q, token[0], end - q ) );
+		if ( !q || (size_t)( end - q ) < length )
+			return 0;
+		if ( memcmp( q, token, length ) == 0 )
+			return q;
+		++q;
+	}
+	return 0;
+}
+
+
+size_t TiXmlReader::AppendRaw( const char* text, size_t length )
+{
+	if ( !Reserve( scratch, scratchCapacity, scratchSize + length + 1 ) )
+		return 0;
+	const size_t at = scratchSize;
+	memcpy( scratch + at, text, length );
+	scratch[ at + length ] = 0;
+	scratchSize += length + 1;
+	return at;
+}
+
+
+size_t TiXmlReader::AppendDecoded( const char* text, const char* last )
+{
+	// Decoding never makes the text longer.
+	if ( !Reserve( scratch, scratchCapacity, scratchSize + ( last - text ) + 1 ) )
+		return 0;
+	const size_t at = scratchSize;
+	char* out = scratch + at;
+	while ( text < last )
+	{
+		const char* special = text;
+		while ( special < last && *special != '&' && *special != '\r' )
+			++special;
+		memcpy( out, text, special - text );
+		out += special - text;
+		text = special;
+		if ( text == last )
+			break;
+		if ( *text == '\r' )
+		{
+			// CR and CR+LF become LF, as TiXmlDocument::LoadFile does.
+			*out++ = '\n';
+			++text;
+			if ( text < last && *text == '\n' )
+				++text;
+			continue;
+		}
+		size_t used = 0;
+		const int n = DecodeEntity( text, last, out, &used );
+		if ( n )
+		{
+			out += n;
+			text += used;
+		}
+		else
+		{
+			*out++ = *text++;
+		}
+	}
+	*out = 0;
+	scratchSize = out + 1 - scratch;
+	return at;
+}
+
+
+bool TiXmlReader::Reserve( char*& buffer, size_t& capacity, size_t needed )
+{
+	if ( needed <= capacity )
+		return true;
+	size_t grown = capacity ? capacity * 2 : INITIAL_SCRATCH;
+	while ( grown < needed )
+		grown *= 2;
+	char* bigger = static_cast<char*>( realloc( buffer, grown ) );
+	if ( !bigger )
+		return false;
+	buffer = bigger;
+	capacity = grown;
+	return true;
+}
+
+
+bool TiXmlReader::PushAttribute( size_t nameAt, size_t valueAt )
+{
+	if ( attributeCount == attributeCapacity )
+	{
+		const int grown = attributeCapacity ? attributeCapacity * 2 : 8;
+		size_t* bigger = static_cast<size_t*>( realloc( attributes, grown * 2 * sizeof( size_t ) ) );
+		if ( !bigger )
+			return false;
+		attributes = bigger;
+		attributeCapacity = grown;
+	}
+	attributes[ 2 * attributeCount ] = nameAt;
+	attributes[ 2 * attributeCount + 1 ] = valueAt;
+	++attributeCount;
+	return true;
+}
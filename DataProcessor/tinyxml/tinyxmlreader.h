@@ -0,0 +1,178 @@
+/*
+www.sourceforge.net/projects/tinyxml
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any
+damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any
+purpose, including commercial applications, and to alter it and
+redistribute it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must
+not claim that you wrote the original software. If you use this
+software in a product, an acknowledgment in the product documentation
+would be appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and
+must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any source
+distribution.
+*/
+
+/*	Altered source: a forward-only pull reader, added for DataProcessor.
+	Not part of the original TinyXML distribution.
+*/
+
+
+#ifndef TIXML_READER_INCLUDED
+#define TIXML_READER_INCLUDED
+
+#include <stddef.h>
+
+class QFile;
+
+/**
+	A forward-only pull reader. Instead of building a DOM, Next() steps through
+	the document and reports one event at a time: the start of an element with
+	its attributes, a run of text, or the end of an element. Nothing is kept
+	once the reader has moved on, so memory use does not grow with the document.
+
+	OpenFile() memory maps the file and parses straight from the mapping;
+	OpenBuffer() parses memory owned by the caller. Neither copies the input.
+	Names, attribute values and text are decoded into one internal buffer that
+	is reused for every event; the pointers returned stay valid until the next
+	call to Next().
+
+	@verbatim
+	TiXmlReader reader;
+	if ( reader.OpenFile( "config.xml" ) )
+	{
+		while ( reader.Next() == TiXmlReader::TINYXML_START_ELEMENT )
+		...
+	}
+	@endverbatim
+
+	Compared to TiXmlDocument:
+	- Comments, declarations, processing instructions and DOCTYPE are skipped.
+	- Text is trimmed; text that is only white space is not reported. White
+	  space inside text is kept as is (no condensing).
+	- The five predefined entities and character references are decoded.
+	- Input is treated as UTF-8; a leading BOM is skipped.
+	- Start and end tags must match. A self-closing element reports a start
+	  and an end event.
+*/
+class TiXmlReader
+{
+public:
+	/// What Next() found.
+	enum EventType
+	{
+		TINYXML_START_ELEMENT,		///< Name() and the attributes are set.
+		TINYXML_END_ELEMENT,		///< Name() is set.
+		TINYXML_TEXT,				///< Text() is set. Also used for CDATA.
+		TINYXML_END_DOCUMENT,		///< The input is exhausted.
+		TINYXML_READ_ERROR			///< ErrorDesc() tells why. Next() keeps returning this.
+	};
+
+	TiXmlReader();
+	~TiXmlReader();
+
+	/// Memory map a file and start reading it. Returns false if the file can not be mapped.
+	bool OpenFile( const char* filename );
+	/// Start reading 'length' bytes at 'data'. The memory must outlive the reader or the next Open.
+	void OpenBuffer( const char* data, size_t length );
+	/// Unmap the file and reset the reader.
+	void Close();
+
+	/// Advance to the next event.
+	EventType Next();
+
+	/// The current event.
+	EventType Event() const				{ return event; }
+
+	/**	Number of elements enclosing the current event. The root element is
+		at depth 0, its children and its text at depth 1.
+	*/
+	int Depth() const					{ return depth; }
+
+	/// Element name for start and end events.
+	const char* Name() const			{ return scratch + nameOffset; }
+
+	/// Decoded text for text events.
+	const char* Text() const			{ return scratch + textOffset; }
+
+	/// Value of the named attribute of the current start element, or null if it has none.
+	const char* Attribute( const char* name ) const;
+
+	/// Number of attributes of the current start element.
+	int AttributeCount() const			{ return attributeCount; }
+	/// Name of attribute 'index'.
+	const char* AttributeName( int index ) const	{ return scratch + attributes[ 2 * index ]; }
+	/// Value of attribute 'index'.
+	const char* AttributeValue( int index ) const	{ return scratch + attributes[ 2 * index + 1 ]; }
+
+	/**	Skip the rest of the current element, up to and including its end
+		event. Call it on a start event. Returns false on error or end of input.
+	*/
+	bool SkipElement();
+
+	/// The 1-based line of the current event (counted lazily, so it costs nothing unless called).
+	int Row() const;
+
+	/// True once an error has been found.
+	bool Error() const					{ return event == TINYXML_READ_ERROR; }
+	/// A description of the error.
+	const char* ErrorDesc() const		{ return errorDesc; }
+	/// The line of the error.
+	int ErrorRow() const				{ return errorRow; }
+
+private:
+	TiXmlReader( const TiXmlReader& );		// not implemented.
+	void operator=( const TiXmlReader& );	// not allowed.
+
+	EventType SetError( const char* desc, const char* at );
+	EventType ReadStartTag();
+	EventType CloseElement( const char* name, size_t length );
+	const char* ReadName( const char* p );
+	bool ReadAttributes();
+	const char* Find( const char* p, const char* token ) const;
+	size_t AppendRaw( const char* p, size_t length );
+	size_t AppendDecoded( const char* p, const char* last );
+	bool Reserve( char*& buffer, size_t& capacity, size_t needed );
+	bool PushAttribute( size_t nameAt, size_t valueAt );
+
+	QFile* file;				// mapped file, or null
+	const char* begin;
+	const char* end;
+	const char* p;				// read head
+	const char* eventStart;		// where the current event starts, for Row()
+
+	EventType event;
+	int depth;
+	int openElements;
+	bool pendingEnd;			// the last start tag was self-closing
+
+	char* scratch;				// decoded names, values and text of the current event
+	size_t scratchSize;
+	size_t scratchCapacity;
+	size_t nameOffset;
+	size_t textOffset;
+
+	size_t* attributes;			// name and value offsets into scratch
+	int attributeCount;
+	int attributeCapacity;
+
+	char* stack;				// names of the open elements, each null terminated
+	size_t stackSize;
+	size_t stackCapacity;
+
+	mutable const char* rowScan;	// Row() has counted lines up to here
+	mutable int row;
+
+	char errorDesc[ 128 ];
+	int errorRow;
+};
+
+#endif	// TIXML_READER_INCLUDED
@@ -1,13 +1,24 @@
 #include "udpsender.h"
 #include <QNetworkInterface>
 #include <QThread>
-#include <QElapsedTimer>
+#include <cstring>
+#include "replay/replayscheduler.h"
+#include "replay/replaytelemetry.h"
+#include "replay/packetring.h"
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 //定义日志分类
 Q_LOGGING_CATEGORY(udpLog, "[app.UdpSender]")
 
 UdpSender::UdpSender(QObject *parent)
     : QObject(parent)
+    , m_ring(new PacketRing(RING_SLOTS, RING_ARENA_BYTES))
 {
     //将对象移动到工作线程
     this->moveToThread(&m_workerThread);
@@ -23,23 +34,174 @@ UdpSender::~UdpSender()
 {
     stop();
     waitForStop();
+#if defined(Q_OS_LINUX)
+    if (m_fd4 >= 0)
+    {
+        ::close(m_fd4);
+    }
+    if (m_fd6 >= 0)
+    {
+        ::close(m_fd6);
+    }
+#endif
     qCDebug(udpLog) << "UDP 发送器已销毁";
     emit logMessage("DEBUG", "UDP 发送器已销毁");
 }
 
-bool UdpSender::send(const QString &address, const QByteArray &data, const QString &topic)
+int UdpSender::addDestination(const QString &address)
+{
+    QStringList parts = address.split(':');
+    if (parts.size() != 2)
+    {
+        qCWarning(udpLog) << "无效的目标地址格式：" << address;
+        emit logMessage("ERROR", "无效的目标地址格式：" + address);
+        return -1;
+    }
+    Destination dest;
+    dest.address = address;
+    dest.ip = QHostAddress(parts[0]);
+    dest.port = parts[1].toUShort();
+    if (dest.ip.isNull() || dest.port == 0)
+    {
+        qCWarning(udpLog) << "无效的 IP 或端口：" << address;
+        emit logMessage("ERROR", "无效的 IP 或端口：" + address);
+        return -1;
+    }
+#if defined(Q_OS_LINUX)
+    //预先构造 sockaddr，发送时直接引用
+    if (dest.ip.protocol() == QAbstractSocket::IPv4Protocol)
+    {
+        sockaddr_in sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(dest.port);
+        sa.sin_addr.s_addr = htonl(dest.ip.toIPv4Address());
+        dest.nativeAddr = QByteArray(reinterpret_cast<const char *>(&sa), sizeof(sa));
+    }
+    else
+    {
+        sockaddr_in6 sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sin6_family = AF_INET6;
+        sa.sin6_port = htons(dest.port);
+        const Q_IPV6ADDR ip6 = dest.ip.toIPv6Address();
+        std::memcpy(&sa.sin6_addr, &ip6, sizeof(sa.sin6_addr));
+        sa.sin6_scope_id = dest.ip.scopeId().toUInt();
+        dest.nativeAddr = QByteArray(reinterpret_cast<const char *>(&sa), sizeof(sa));
+    }
+#endif
+    QMutexLocker locker(&m_dataMutex);
+    m_destinations.append(dest);
+    m_destinationsVersion.fetch_add(1);
+    return m_destinations.size() - 1;
+}
+
+void UdpSender::setRateLimit(int destination, const RateLimit &limit)
 {
-    if (address.isEmpty() || data.isEmpty())
+    QMutexLocker locker(&m_dataMutex);
+    if (destination < 0 || destination >= m_destinations.size())
+    {
+        return;
+    }
+    m_destinations[destination].limit = limit;
+    m_destinationsVersion.fetch_add(1);
+}
+
+void UdpSender::setMulticastOptions(int ttl, bool loopback)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_multicastTtl = qBound(1, ttl, 255);
+    m_multicastLoopback = loopback;
+    //随目标地址一起由发送线程取用
+    m_destinationsVersion.fetch_add(1);
+}
+
+char *UdpSender::reserve(int maxLength, int fanout)
+{
+    if (maxLength <= 0 || maxLength > m_ring->maxPayload() || fanout <= 0 || fanout > m_ring->slotCapacity())
+    {
+        qCWarning(udpLog) << "数据包长度或目标数量超出发送队列容量：" << maxLength << fanout;
+        emit logMessage("ERROR", QString("数据包长度或目标数量超出发送队列容量：%1 字节，%2 个目标").arg(maxLength).arg(fanout));
+        return nullptr;
+    }
+    char *buffer = m_ring->reserve(maxLength, fanout);
+    if (buffer || !m_running)
+    {
+        return m_running ? buffer : nullptr;
+    }
+    //队列已满：阻塞生产者，避免无限增长
+    m_backpressureTotal.fetch_add(1, std::memory_order_relaxed);
+    while (m_running)
+    {
+        m_producerWaiting.store(true);
+        QMutexLocker locker(&m_dataMutex);
+        buffer = m_ring->reserve(maxLength, fanout);
+        if (buffer || !m_running)
+        {
+            break;
+        }
+        //限时等待作为兜底，防止唤醒丢失
+        m_spaceCondition.wait(&m_dataMutex, 5);
+    }
+    m_producerWaiting.store(false, std::memory_order_relaxed);
+    return m_running ? buffer : nullptr;
+}
+
+void UdpSender::publish(int length, const int *destinations, int fanout, qint64 dueNs, quint16 topic)
+{
+    m_ring->publish(length, destinations, fanout, dueNs, topic);
+    //仅在发送线程休眠时加锁唤醒；与 waitForData 中的标志写入构成全序，保证不丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumerWaiting.load(std::memory_order_relaxed))
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_condition.wakeOne();
+    }
+}
+
+bool UdpSender::send(int destination, const QByteArray &data, qint64 dueNs)
+{
+    if (destination < 0 || data.isEmpty())
     {
         qCWarning(udpLog) << "无效的目标地址或数据";
         emit logMessage("ERROR", "无效的目标地址或数据");
         return false;
     }
-    SendTask task{address, data, topic};
-    enqueue(task);
+    char *buffer = reserve(data.size(), 1);
+    if (!buffer)
+    {
+        return false;
+    }
+    std::memcpy(buffer, data.constData(), static_cast<size_t>(data.size()));
+    publish(data.size(), &destination, 1, dueNs, 0);
     return true;
 }
 
+void UdpSender::setScheduler(const ReplayScheduler *scheduler)
+{
+    m_scheduler.store(scheduler);
+}
+
+void UdpSender::setTelemetry(ReplayTelemetry *telemetry)
+{
+    m_telemetry.store(telemetry);
+}
+
+int UdpSender::queueDepth() const
+{
+    return m_ring->depth();
+}
+
+int UdpSender::queueHighWater() const
+{
+    return m_ring->highWater();
+}
+
+int UdpSender::queueCapacity() const
+{
+    return m_ring->slotCapacity();
+}
+
 void UdpSender::stop()
 {
     QMutexLocker locker(&m_dataMutex);
@@ -49,17 +211,34 @@ void UdpSender::stop()
         return;
     }
     qCDebug(udpLog) << "正在停止 UDP 发送器...";
-    int pending = m_queue.size();
+    int pending = m_ring->depth() + m_backlogDepth.load();
     if (pending > 0)
     {
         qCWarning(udpLog) << "丢弃未发送的数据包数量:" << pending;
-        m_queue.clear();
         emit logMessage("WARN", QString("丢弃未发送的数据包数量: %1").arg(pending));
     }
     //设置停止标志
     m_running = false;
     //唤醒可能等待的线程
     m_condition.wakeAll();
+    m_spaceCondition.wakeAll();
+    m_drainedCondition.wakeAll();
+}
+
+void UdpSender::flush()
+{
+    //槽位在整批发出后才释放，队列与积压均为空即表示数据已全部交给系统
+    m_flushWaiting.store(true);
+    {
+        QMutexLocker locker(&m_dataMutex);
+        //持锁复查：发送线程排空后持锁唤醒，不会落在复查与等待之间
+        while (m_running && (m_ring->depth() > 0 || m_backlogDepth.load() > 0))
+        {
+            //限时等待作为兜底，防止唤醒丢失
+            m_drainedCondition.wait(&m_dataMutex, 5);
+        }
+    }
+    m_flushWaiting.store(false, std::memory_order_relaxed);
 }
 
 void UdpSender::waitForStop()
@@ -91,70 +270,422 @@ void UdpSender::pause(bool paused)
 
 void UdpSender::processQueue()
 {
-    QMutexLocker locker(&m_dataMutex);
-    QElapsedTimer timer;
-    timer.start();
+#if defined(Q_OS_LINUX)
+    m_fd4 = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    m_fd6 = ::socket(AF_INET6, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_fd4 < 0)
+    {
+        qCWarning(udpLog) << "创建 UDP 套接字失败：" << std::strerror(errno);
+        emit logMessage("ERROR", QString("创建 UDP 套接字失败：%1").arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+#else
+    //套接字在发送线程中创建，保证线程归属正确
+    m_socket.reset(new QUdpSocket());
+#endif
+    QVector<Destination> destinations;
+    int destinationsVersion = -1;
+    OutPacket packets[SEND_BATCH_SIZE];
     while (m_running)
     {
-        //队列为空或暂停时等待
-        while ((m_queue.isEmpty() || m_paused) && m_running)
+        //暂停时等待恢复
+        if (m_paused)
         {
-            m_condition.wait(&m_dataMutex);
+            QMutexLocker locker(&m_dataMutex);
+            while (m_paused && m_running)
+            {
+                m_condition.wait(&m_dataMutex);
+            }
+            continue;
         }
-        if (!m_running)
+        //目标地址仅在变更后重新复制
+        if (destinationsVersion != m_destinationsVersion.load())
         {
-            break;
+            QMutexLocker locker(&m_dataMutex);
+            destinations = m_destinations;
+            destinationsVersion = m_destinationsVersion.load();
+            const int multicastTtl = m_multicastTtl;
+            const bool multicastLoopback = m_multicastLoopback;
+            locker.unlock();
+            if (multicastTtl > 0)
+            {
+                applyMulticastOptions(multicastTtl, multicastLoopback);
+            }
+            const qint64 nowNs = ReplayScheduler::nowNs();
+            m_shapers.resize(destinations.size());
+            for (int i = 0; i < destinations.size(); ++i)
+            {
+                const RateLimit &limit = destinations[i].limit;
+                m_shapers[i].bucket.configure(limit.packetsPerSecond, limit.bitsPerSecond,
+                                              limit.burstPackets, limit.burstBytes, nowNs);
+                m_shapers[i].backlogLimit = limit.backlog;
+            }
+        }
+        //先补发积压数据，再处理新数据
+        const qint64 backlogWakeNs = m_backlogDepth.load() > 0 ? drainBacklogs(destinations) : 0;
+        const int available = m_ring->available();
+        if (available == 0)
+        {
+            waitForData(backlogWakeNs);
+            continue;
         }
-        SendTask task = m_queue.dequeue();
-        locker.unlock();
-        bool success = sendInternal(task.address, task.data);
-        emit logMessage(success ? "INFO" : "ERROR",
-                        QString("发送%1 [%2] %3")
-                        .arg(success ? "成功" : "失败")
-                        .arg(task.topic)
-                        .arg(task.address));
-        locker.relock();
-        //限流处理
-        if (timer.elapsed() < 10)
+        const ReplayScheduler *scheduler = m_scheduler.load();
+        //等待队首数据包的调度时刻，暂停、停止或有积压可发时中断（数据包仍留在队列中）
+        const qint64 headDueNs = m_ring->peek(0).dueNs;
+        if (scheduler && headDueNs != ReplayScheduler::AsFastAsPossible)
         {
-            QThread::usleep(static_cast<unsigned long>(10 - timer.elapsed()));
+            const auto interrupted = [this, backlogWakeNs]()
+            {
+                return !m_running || m_paused
+                       || (backlogWakeNs > 0 && ReplayScheduler::nowNs() >= backlogWakeNs);
+            };
+            if (!scheduler->waitUntil(headDueNs, interrupted))
+            {
+                continue;
+            }
         }
-        timer.restart();
+        //收集所有已到期的数据包组成一批
+        const qint64 nowNs = ReplayScheduler::nowNs();
+        const int limit = qMin(available, static_cast<int>(SEND_BATCH_SIZE));
+        int count = 1;
+        while (count < limit)
+        {
+            const qint64 dueNs = m_ring->peek(count).dueNs;
+            if (scheduler && dueNs != ReplayScheduler::AsFastAsPossible && scheduler->toWallNs(dueNs) > nowNs)
+            {
+                break;
+            }
+            ++count;
+        }
+        //限速：令牌不足或已有积压的目标转入积压队列，保持该目标内的顺序
+        int packetCount = 0;
+        int dropped = 0;
+        int droppedDestinations[SEND_BATCH_SIZE];
+        for (int i = 0; i < count; ++i)
+        {
+            const PacketRing::Slot &slot = m_ring->peek(i);
+            const char *payload = m_ring->payload(slot);
+            if (slot.destination >= 0 && slot.destination < m_shapers.size()
+                    && m_shapers[slot.destination].bucket.isLimited())
+            {
+                Shaper &shaper = m_shapers[slot.destination];
+                if (!shaper.backlog.isEmpty() || !shaper.bucket.tryConsume(slot.length, nowNs))
+                {
+                    if (shaper.backlog.size() < shaper.backlogLimit)
+                    {
+                        shaper.backlog.enqueue(QByteArray(payload, slot.length));
+                        m_backlogDepth.fetch_add(1);
+                    }
+                    else
+                    {
+                        droppedDestinations[dropped++] = slot.destination;
+                    }
+                    continue;
+                }
+            }
+            packets[packetCount++] = OutPacket{payload, slot.length, slot.destination, slot.dueNs, false};
+        }
+        int failed = 0;
+        const int sent = packetCount > 0 ? sendBatch(packets, packetCount, destinations, failed) : 0;
+        recordTelemetry(packets, packetCount, droppedDestinations, dropped, available);
+        m_ring->release(count);
+        wakeProducer();
+        if (dropped > 0)
+        {
+            m_droppedTotal.fetch_add(dropped);
+            failed += dropped;
+        }
+        m_sentTotal.fetch_add(sent);
+        m_failedTotal.fetch_add(failed);
+        emit batchSent(sent, failed);
     }
+    m_shapers.clear();
+    m_backlogDepth.store(0);
+    m_socket.reset();
 }
 
-void UdpSender::enqueue(const SendTask &task)
+qint64 UdpSender::drainBacklogs(const QVector<Destination> &destinations)
 {
-    QMutexLocker locker(&m_dataMutex);  //自动加锁
-    m_queue.enqueue(task);
-    m_condition.wakeAll();              //唤醒所有等待线程
+    OutPacket packets[SEND_BATCH_SIZE];
+    int taken[SEND_BATCH_SIZE];
+    int shaperIndex[SEND_BATCH_SIZE];
+    while (true)
+    {
+        const qint64 nowNs = ReplayScheduler::nowNs();
+        qint64 nextNs = 0;
+        int packetCount = 0;
+        int shaperCount = 0;
+        for (int d = 0; d < m_shapers.size() && packetCount < SEND_BATCH_SIZE; ++d)
+        {
+            Shaper &shaper = m_shapers[d];
+            int n = 0;
+            while (n < shaper.backlog.size() && packetCount < SEND_BATCH_SIZE)
+            {
+                const QByteArray &data = shaper.backlog.at(n);
+                if (!shaper.bucket.tryConsume(data.size(), nowNs))
+                {
+                    break;
+                }
+                packets[packetCount++] = OutPacket{data.constData(), data.size(), d, ReplayScheduler::AsFastAsPossible, false};
+                ++n;
+            }
+            if (n < shaper.backlog.size())
+            {
+                //仍有积压：记录最早可发时刻
+                const qint64 readyNs = shaper.bucket.nextAvailableNs(nowNs);
+                nextNs = nextNs == 0 ? readyNs : qMin(nextNs, readyNs);
+            }
+            if (n > 0)
+            {
+                taken[shaperCount] = n;
+                shaperIndex[shaperCount] = d;
+                ++shaperCount;
+            }
+        }
+        if (packetCount == 0)
+        {
+            return nextNs;
+        }
+        int failed = 0;
+        const int sent = sendBatch(packets, packetCount, destinations, failed);
+        recordTelemetry(packets, packetCount, nullptr, 0, -1);
+        for (int i = 0; i < shaperCount; ++i)
+        {
+            QQueue<QByteArray> &backlog = m_shapers[shaperIndex[i]].backlog;
+            for (int n = 0; n < taken[i]; ++n)
+            {
+                backlog.dequeue();
+            }
+        }
+        m_backlogDepth.fetch_sub(packetCount);
+        wakeProducer();
+        m_sentTotal.fetch_add(sent);
+        m_failedTotal.fetch_add(failed);
+        emit batchSent(sent, failed);
+        if (packetCount < SEND_BATCH_SIZE)
+        {
+            return nextNs;
+        }
+    }
 }
 
-bool UdpSender::sendInternal(const QString &address, const QByteArray &data)
+void UdpSender::waitForData(qint64 untilNs)
 {
-    QStringList parts = address.split(':');
-    if (parts.size() != 2)
+    qint64 timeoutMs = 5;
+    if (untilNs > 0)
     {
-        qCWarning(udpLog) << "无效的目标地址格式：" << address;
-        emit logMessage("ERROR", "无效的目标地址格式：" + address);
-        return false;
+        const qint64 remainingNs = untilNs - ReplayScheduler::nowNs();
+        //积压即将可发：让出时间片后立即重试，保证高速率限速的精度
+        if (remainingNs < 1000000)
+        {
+            QThread::yieldCurrentThread();
+            return;
+        }
+        timeoutMs = qMin<qint64>(timeoutMs, remainingNs / 1000000);
     }
-    QHostAddress ip(parts[0]);
-    quint16 port = parts[1].toUShort();
-    if (ip.isNull() || port == 0)
+    m_consumerWaiting.store(true);
     {
-        qCWarning(udpLog) << "无效的 IP 或端口：" << address;
-        emit logMessage("ERROR", "无效的 IP 或端口：" + address);
-        return false;
+        QMutexLocker locker(&m_dataMutex);
+        //持锁复查：生产者的唤醒同样需要持锁，不会落在复查与等待之间
+        if (m_ring->available() == 0 && m_running && !m_paused)
+        {
+            //限时等待作为兜底
+            m_condition.wait(&m_dataMutex, static_cast<unsigned long>(timeoutMs));
+        }
     }
-    qint64 bytesSent = m_socket.writeDatagram(data, ip, port);
-    if (bytesSent == -1)
+    m_consumerWaiting.store(false, std::memory_order_relaxed);
+}
+
+void UdpSender::wakeProducer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool producerWaiting = m_producerWaiting.load(std::memory_order_relaxed);
+    //flush() 只在队列与积压均为空时唤醒
+    const bool drained = m_flushWaiting.load(std::memory_order_relaxed)
+                         && m_ring->depth() == 0 && m_backlogDepth.load() == 0;
+    if (producerWaiting || drained)
     {
-        qCWarning(udpLog) << "数据发送失败：" << m_socket.errorString();
-        emit logMessage("ERROR", "数据发送失败：" + m_socket.errorString());
-        return false;
+        QMutexLocker locker(&m_dataMutex);
+        if (producerWaiting)
+        {
+            m_spaceCondition.wakeOne();
+        }
+        if (drained)
+        {
+            m_drainedCondition.wakeAll();
+        }
     }
-    qCInfo(udpLog) << "数据已发送：" << data.toHex().toUpper();
-    emit logMessage("INFO", "数据已发送：" + QString(data.toHex().toUpper()));
-    return true;
+}
+
+void UdpSender::applyMulticastOptions(int ttl, bool loopback)
+{
+#if defined(Q_OS_LINUX)
+    const int loop = loopback ? 1 : 0;
+    if (m_fd4 >= 0)
+    {
+        ::setsockopt(m_fd4, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        ::setsockopt(m_fd4, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    if (m_fd6 >= 0)
+    {
+        ::setsockopt(m_fd6, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl));
+        ::setsockopt(m_fd6, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+#else
+    //套接字选项需在绑定后设置；未绑定时先绑定任意端口（writeDatagram 本会自动绑定）
+    if (m_socket->state() != QAbstractSocket::BoundState)
+    {
+        m_socket->bind();
+    }
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, ttl);
+    m_socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, loopback ? 1 : 0);
+#endif
+}
+
+int UdpSender::sendBatch(OutPacket *packets, int count, const QVector<Destination> &destinations, int &failed)
+{
+    int sent = 0;
+    failed = 0;
+#if defined(Q_OS_LINUX)
+    //按地址族分组，各自一次 sendmmsg 提交；packetIndex 记录消息对应的数据包
+    mmsghdr msgs4[SEND_BATCH_SIZE];
+    mmsghdr msgs6[SEND_BATCH_SIZE];
+    int packetIndex4[SEND_BATCH_SIZE];
+    int packetIndex6[SEND_BATCH_SIZE];
+    iovec iov[SEND_BATCH_SIZE];
+    int count4 = 0;
+    int count6 = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        OutPacket &packet = packets[i];
+        packet.sent = false;
+        if (packet.destination < 0 || packet.destination >= destinations.size())
+        {
+            ++failed;
+            continue;
+        }
+        const Destination &dest = destinations[packet.destination];
+        //直接引用队列字节区，不拷贝载荷
+        iov[i].iov_base = const_cast<char *>(packet.data);
+        iov[i].iov_len = static_cast<size_t>(packet.length);
+        const bool v4 = dest.ip.protocol() == QAbstractSocket::IPv4Protocol;
+        if (v4)
+        {
+            packetIndex4[count4] = i;
+        }
+        else
+        {
+            packetIndex6[count6] = i;
+        }
+        mmsghdr &msg = v4 ? msgs4[count4++] : msgs6[count6++];
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_hdr.msg_name = const_cast<char *>(dest.nativeAddr.constData());
+        msg.msg_hdr.msg_namelen = static_cast<socklen_t>(dest.nativeAddr.size());
+        msg.msg_hdr.msg_iov = &iov[i];
+        msg.msg_hdr.msg_iovlen = 1;
+    }
+    int lastErrno = 0;
+    const auto submit = [&](int fd, mmsghdr *msgs, const int *packetIndex, int count)
+    {
+        int offset = 0;
+        int retries = 0;
+        while (offset < count)
+        {
+            const int n = fd >= 0 ? ::sendmmsg(fd, msgs + offset, static_cast<unsigned int>(count - offset), 0) : -1;
+            if (n > 0)
+            {
+                for (int k = offset; k < offset + n; ++k)
+                {
+                    packets[packetIndex[k]].sent = true;
+                }
+                sent += n;
+                offset += n;
+                retries = 0;
+                continue;
+            }
+            const int err = fd >= 0 ? errno : EBADF;
+            if (err == EINTR)
+            {
+                continue;
+            }
+            //发送缓冲区暂满：让出 CPU 后有限次重试
+            if ((err == ENOBUFS || err == EAGAIN) && retries++ < 3)
+            {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+            //跳过出错的数据包，继续发送本批其余数据
+            lastErrno = err;
+            ++failed;
+            ++offset;
+            retries = 0;
+        }
+    };
+    submit(m_fd4, msgs4, packetIndex4, count4);
+    submit(m_fd6, msgs6, packetIndex6, count6);
+    if (lastErrno != 0)
+    {
+        const QString error = QString::fromLocal8Bit(std::strerror(lastErrno));
+        qCWarning(udpLog) << "批量发送失败：" << failed << "包" << error;
+        emit logMessage("ERROR", QString("批量发送失败 %1/%2 包：%3").arg(failed).arg(count).arg(error));
+    }
+#else
+    //逐包发送，目标地址使用缓存的解析结果
+    QString lastError;
+    for (int i = 0; i < count; ++i)
+    {
+        OutPacket &packet = packets[i];
+        packet.sent = false;
+        if (packet.destination < 0 || packet.destination >= destinations.size())
+        {
+            ++failed;
+            continue;
+        }
+        const Destination &dest = destinations[packet.destination];
+        if (m_socket->writeDatagram(packet.data, packet.length, dest.ip, dest.port) == -1)
+        {
+            ++failed;
+            lastError = m_socket->errorString();
+        }
+        else
+        {
+            packet.sent = true;
+            ++sent;
+        }
+    }
+    if (failed > 0)
+    {
+        qCWarning(udpLog) << "批量发送失败：" << failed << "包" << lastError;
+        emit logMessage("ERROR", QString("批量发送失败 %1/%2 包：%3").arg(failed).arg(count).arg(lastError));
+    }
+#endif
+    return sent;
+}
+
+void UdpSender::recordTelemetry(const OutPacket *packets, int count, const int *droppedDestinations, int dropped, int queueDepth)
+{
+    ReplayTelemetry *telemetry = m_telemetry.load();
+    if (!telemetry || count + dropped == 0)
+    {
+        return;
+    }
+    //调度误差以整批发出后的时刻计算，包含系统调用本身的耗时
+    const ReplayScheduler *scheduler = m_scheduler.load();
+    const qint64 nowNs = ReplayScheduler::nowNs();
+    ReplayTelemetry::Sample samples[SEND_BATCH_SIZE * 2];
+    int sampleCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        ReplayTelemetry::Sample &sample = samples[sampleCount++];
+        sample.destination = packets[i].destination;
+        sample.bytes = packets[i].length;
+        sample.sent = packets[i].sent;
+        sample.timed = scheduler && packets[i].dueNs != ReplayScheduler::AsFastAsPossible;
+        sample.errorNs = sample.timed ? nowNs - scheduler->toWallNs(packets[i].dueNs) : 0;
+    }
+    for (int i = 0; i < dropped; ++i)
+    {
+        ReplayTelemetry::Sample &sample = samples[sampleCount++];
+        sample.destination = droppedDestinations[i];
+    }
+    telemetry->recordBatch(samples, sampleCount, queueDepth, nowNs);
 }
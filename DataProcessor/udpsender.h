@@ -9,28 +9,111 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QThread>
+#include <QVector>
 #include <QQueue>
+#include <atomic>
+#include "replay/tokenbucket.h"
+
+class ReplayScheduler;
+class ReplayTelemetry;
+class PacketRing;
 
 /**
  * @brief UDP 数据发送器类
  * 负责管理 UDP 数据包的发送，支持多线程和批量发送。
+ * 目标地址在发送前一次性解析并缓存；发送线程按批次取出已到期的数据包，
+ * Linux 下通过 sendmmsg 一次系统调用提交整批，其他平台逐包发送。
+ * 生产者与发送线程之间通过无锁环形队列（PacketRing）交接数据，
+ * 队列满时生产者阻塞等待（背压），仅在一方确实休眠时才使用互斥锁唤醒。
+ * 每个目标可单独设置令牌桶限速：超速的数据包转入该目标的积压队列，
+ * 由发送线程按令牌节奏补发，不影响其他目标，也不阻塞生产者；积压满时丢弃。
  */
 class UdpSender : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief 单个目标的限速参数
+     */
+    struct RateLimit
+    {
+        double packetsPerSecond = 0.0; ///< 包速率，0 表示不限
+        double bitsPerSecond = 0.0;    ///< 比特速率，0 表示不限
+        int burstPackets = 1;          ///< 包突发容量
+        int burstBytes = 0;            ///< 字节突发容量
+        int backlog = 4096;            ///< 积压队列上限（包），超出后丢弃
+    };
+
     explicit UdpSender(QObject *parent = nullptr);
     ~UdpSender();
 
     /**
-     * @brief 发送数据到指定地址
+     * @brief 注册目标地址，解析结果缓存供后续发送使用
      * @param address 目标地址（格式：IP:Port）
+     * @return 目标索引，地址无效时返回 -1
+     */
+    int addDestination(const QString &address);
+
+    /**
+     * @brief 设置目标限速（需在发送该目标的数据前调用）
+     * @param destination 目标索引
+     * @param limit 限速参数
+     */
+    void setRateLimit(int destination, const RateLimit &limit);
+
+    /**
+     * @brief 设置组播发送参数，由发送线程在套接字上设置一次，对全部组播目标生效
+     * @param ttl 组播 TTL（1-255）
+     * @param loopback 是否回环到本机
+     */
+    void setMulticastOptions(int ttl, bool loopback);
+
+    /**
+     * @brief 预留一个数据包的载荷空间（生产者线程调用）
+     * 队列已满时阻塞等待发送线程腾出空间。调用方可直接在返回的缓冲区中写入数据，
+     * 再调用 publish() 发布；不发布则该预留在下一次 reserve() 时自动作废。
+     * @param maxLength 载荷最大长度
+     * @param fanout 目标数量
+     * @return 可写缓冲区，发送器已停止或长度超限时返回 nullptr
+     */
+    char *reserve(int maxLength, int fanout);
+
+    /**
+     * @brief 发布最近一次预留的数据包
+     * @param length 实际长度
+     * @param destinations 目标索引数组（addDestination 的返回值）
+     * @param fanout 目标数量（与 reserve 一致）
+     * @param dueNs 调度时刻（见 ReplayScheduler），-1 表示立即发送
+     * @param topic 主题号
+     */
+    void publish(int length, const int *destinations, int fanout, qint64 dueNs, quint16 topic);
+
+    /**
+     * @brief 发送数据到指定目标（拷贝数据，便捷接口）
+     * @param destination 目标索引
      * @param data 要发送的数据
-     * @param topic 数据主题（用于日志记录）
+     * @param dueNs 调度时刻，-1 表示立即发送
      * @return 是否成功加入发送队列
      */
-    bool send(const QString &address, const QByteArray &data, const QString &topic);
+    bool send(int destination, const QByteArray &data, qint64 dueNs = -1);
+
+    /**
+     * @brief 设置回放调度器，发送线程按任务的调度时刻精确发送
+     * @param scheduler 调度器（由调用方持有，生命周期需覆盖发送器）
+     */
+    void setScheduler(const ReplayScheduler *scheduler);
+
+    /**
+     * @brief 设置回放统计，发送线程每批记录一次发送结果与调度误差
+     * @param telemetry 统计对象（由调用方持有，生命周期需覆盖发送器）
+     */
+    void setTelemetry(ReplayTelemetry *telemetry);
+
+    /**
+     * @brief 阻塞等待队列中的数据全部发出（或发送器停止）
+     */
+    void flush();
 
     /**
      * @brief 停止发送并释放资源
@@ -48,6 +131,27 @@ public:
      */
     void pause(bool paused);
 
+    ///累计发送成功包数
+    qint64 sentCount() const { return m_sentTotal.load(); }
+
+    ///累计发送失败包数
+    qint64 failedCount() const { return m_failedTotal.load(); }
+
+    ///发送队列当前深度（槽位数）
+    int queueDepth() const;
+
+    ///发送队列历史最大深度
+    int queueHighWater() const;
+
+    ///发送队列容量（槽位数）
+    int queueCapacity() const;
+
+    ///因超出限速且积压已满而丢弃的包数（已计入失败数）
+    qint64 droppedCount() const { return m_droppedTotal.load(); }
+
+    ///生产者因队列满而等待的次数
+    qint64 backpressureCount() const { return m_backpressureTotal.load(); }
+
 signals:
     /**
      * @brief 日志信号
@@ -56,6 +160,13 @@ signals:
      */
     void logMessage(const QString &level, const QString &msg);
 
+    /**
+     * @brief 批次发送结果
+     * @param sent 本批成功包数
+     * @param failed 本批失败包数
+     */
+    void batchSent(int sent, int failed);
+
 private slots:
     /**
      * @brief 处理发送队列
@@ -64,36 +175,109 @@ private slots:
 
 private:
     /**
-     * @brief 发送任务结构体
+     * @brief 已解析的目标地址
      */
-    struct SendTask
+    struct Destination
     {
-        QString address; //目标地址（IP:Port）
-        QByteArray data; //要发送的数据
-        QString topic;   //数据主题
+        QString address;        //原始地址（IP:Port）
+        QHostAddress ip;        //IP 地址
+        quint16 port;           //端口
+        QByteArray nativeAddr;  //系统 sockaddr 结构（sendmmsg 使用）
+        RateLimit limit;        //限速参数
     };
 
     /**
-     * @brief 将任务加入发送队列
-     * @param task 发送任务
+     * @brief 待发送的数据包（指向队列字节区或积压数据）
      */
-    void enqueue(const SendTask &task);
+    struct OutPacket
+    {
+        const char *data;
+        int length;
+        int destination;
+        qint64 dueNs;   //调度时刻（积压补发为 -1）
+        bool sent;      //发送结果（由 sendBatch 填写）
+    };
 
     /**
-     * @brief 内部发送逻辑
-     * @param address 目标地址
-     * @param data 要发送的数据
-     * @return 是否发送成功
+     * @brief 目标限速状态（仅发送线程访问）
      */
-    bool sendInternal(const QString &address, const QByteArray &data);
+    struct Shaper
+    {
+        TokenBucket bucket;         //令牌桶
+        QQueue<QByteArray> backlog; //超速积压的数据包
+        int backlogLimit = 0;       //积压上限
+    };
+
+    /**
+     * @brief 发送一批数据包
+     * @param packets 数据包数组，各包的 sent 字段填写发送结果
+     * @param count 数据包数量
+     * @param destinations 目标地址快照
+     * @param failed 输出参数，失败包数
+     * @return 成功包数
+     */
+    int sendBatch(OutPacket *packets, int count, const QVector<Destination> &destinations, int &failed);
+
+    /**
+     * @brief 将一批发送结果计入回放统计（未设置统计时直接返回）
+     * @param packets 已发送的数据包
+     * @param count 数据包数量
+     * @param droppedDestinations 因限速丢弃的数据包所属目标
+     * @param dropped 丢弃数量
+     * @param queueDepth 本批发送前的队列深度，-1 表示不采样
+     */
+    void recordTelemetry(const OutPacket *packets, int count, const int *droppedDestinations, int dropped, int queueDepth);
+
+    /**
+     * @brief 按令牌补发各目标的积压数据包
+     * @param destinations 目标地址快照
+     * @return 下一次有积压可发的时刻，无积压时返回 0
+     */
+    qint64 drainBacklogs(const QVector<Destination> &destinations);
+
+    /**
+     * @brief 发送线程：队列为空时休眠等待
+     * @param untilNs 积压数据包可发的时刻，0 表示无积压
+     */
+    void waitForData(qint64 untilNs);
+
+    ///唤醒等待空位的生产者，队列与积压均已排空时一并唤醒 flush()
+    void wakeProducer();
+
+    ///在发送套接字上设置组播参数（发送线程调用）
+    void applyMulticastOptions(int ttl, bool loopback);
 
-    QUdpSocket m_socket;          //UDP 套接字
-    QMutex m_dataMutex;           //数据互斥锁
-    QQueue<SendTask> m_queue;     //发送队列
-    QWaitCondition m_condition;   //条件变量，用于线程同步
-    bool m_running = true;        //是否运行中
+    QScopedPointer<QUdpSocket> m_socket; //UDP 套接字（在发送线程中创建）
+    QScopedPointer<PacketRing> m_ring;   //无锁发送队列
+    QMutex m_dataMutex;           //休眠/唤醒与目标地址互斥锁
+    QVector<Destination> m_destinations; //目标地址缓存
+    std::atomic<int> m_destinationsVersion{0}; //目标地址变更计数
+    QWaitCondition m_condition;   //条件变量，用于唤醒发送线程
+    QWaitCondition m_spaceCondition; //队列空位条件变量，用于生产者背压
+    QWaitCondition m_drainedCondition; //队列与积压排空条件变量，用于 flush()
+    std::atomic<bool> m_running{true}; //是否运行中
     QThread m_workerThread;       //工作线程
-    bool m_paused = false;        //暂停状态标志
+    std::atomic<bool> m_paused{false}; //暂停状态标志
+    std::atomic<bool> m_consumerWaiting{false}; //发送线程是否在休眠
+    std::atomic<bool> m_producerWaiting{false}; //生产者是否在等待空位
+    std::atomic<bool> m_flushWaiting{false}; //是否有线程在 flush() 中等待排空
+    std::atomic<const ReplayScheduler *> m_scheduler{nullptr}; //回放调度器
+    std::atomic<ReplayTelemetry *> m_telemetry{nullptr}; //回放统计
+    std::atomic<qint64> m_sentTotal{0};   //累计发送成功
+    std::atomic<qint64> m_failedTotal{0}; //累计发送失败
+    std::atomic<qint64> m_backpressureTotal{0}; //背压等待次数
+    std::atomic<qint64> m_droppedTotal{0}; //限速丢弃
+    std::atomic<int> m_backlogDepth{0};    //积压队列总深度
+    QVector<Shaper> m_shapers;             //目标限速状态（仅发送线程访问）
+    int m_multicastTtl = -1;               //组播 TTL，-1 表示使用系统默认（受 m_dataMutex 保护）
+    bool m_multicastLoopback = true;       //组播本机回环（受 m_dataMutex 保护）
+#if defined(Q_OS_LINUX)
+    int m_fd4 = -1;               //IPv4 原生套接字
+    int m_fd6 = -1;               //IPv6 原生套接字
+#endif
+    static const int RING_SLOTS = 16384;             //发送队列槽位数
+    static const int RING_ARENA_BYTES = 16 * 1024 * 1024; //发送队列载荷字节区
+    static const int SEND_BATCH_SIZE = 64;           //单批最大包数
 };
 
 #endif //UDPSENDER_H
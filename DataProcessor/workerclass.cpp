@@ -1,24 +1,39 @@
 #include "workerclass.h"
+#include "replay/hexdecoder.h"
+#include "replay/dpcapfile.h"
+#include "replay/dpcapconverter.h"
 #include <QFile>
-#include <QTextStream>
 #include <QFileInfo>
 #include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <cstring>
 
 //定义日志分类
 Q_LOGGING_CATEGORY(workerLog, "[app.WorkerClass]")
 
+namespace
+{
+    ///生产者相对发送时刻的最大预读时间，既吸收解析抖动又保证暂停/停止及时
+    const qint64 SCHEDULE_LOOKAHEAD_NS = 20000000;
+    ///断点写入间隔
+    const qint64 CHECKPOINT_INTERVAL_MS = 1000;
+}
+
 WorkerClass::WorkerClass(QObject *parent)
     : QObject(parent)
 {
     qCDebug(workerLog) << "工作线程对象已创建";
-    emit logMessage("DEBUG", "工作线程对象已创建");
+    m_log.add("DEBUG", "工作线程对象已创建");
 }
 
 WorkerClass::~WorkerClass()
 {
     stopProcessing();
     qCDebug(workerLog) << "工作线程对象已销毁";
-    emit logMessage("DEBUG", "工作线程对象已销毁");
+    m_log.add("DEBUG", "工作线程对象已销毁");
 }
 
 void WorkerClass::configure(const QVariantMap &config)
@@ -26,13 +41,13 @@ void WorkerClass::configure(const QVariantMap &config)
     QMutexLocker locker(&m_mutex);
     m_config = config;
     //验证必要配置参数
-    if(!config.contains("dataDir") || m_addrlist.isEmpty())
+    if(!config.contains("dataDir") || (m_task != Task::Convert && m_addrlist.isEmpty()))
     {
         qCCritical(workerLog) << "缺失必要配置参数";
-        emit logMessage("ERROR", "配置缺失必要参数");
+        m_log.add("ERROR", "配置缺失必要参数");
     }
     qCInfo(workerLog) << "工作线程配置完成，数据目录: " << config["dataDir"].toString();
-    emit logMessage("DEBUG", "工作线程配置完成，数据目录: " + config["dataDir"].toString());
+    m_log.add("DEBUG", "工作线程配置完成，数据目录: " + config["dataDir"].toString());
 }
 
 void WorkerClass::startProcessing()
@@ -41,32 +56,42 @@ void WorkerClass::startProcessing()
     if(m_running)
     {
         qCWarning(workerLog) << "尝试启动已运行的工作线程";
-        emit logMessage("WARN", "工作线程已在运行状态");
+        m_log.add("WARN", "工作线程已在运行状态");
         return;
     }
     //初始化运行状态
     m_running = true;
     m_paused = false;
+    m_seekPending = false;
     m_successCount = 0;
     m_failedCount = 0;
     m_files.clear();
-    m_sentTopics.clear();
+    //转换与录制任务不需要发送器
+    if(m_task != Task::Replay)
+    {
+        m_log.add("DEBUG", m_task == Task::Convert ? "工作线程启动成功（转换模式）" : "工作线程启动成功（录制模式）");
+        QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
+        return;
+    }
     //初始化 UDP 发送器
     try
     {
         m_udpSender.reset(new UdpSender());
-        connect(m_udpSender.data(), &UdpSender::logMessage,
-                this, &WorkerClass::logMessage);
+        m_udpSender->setScheduler(&m_scheduler);
+        m_udpSender->setTelemetry(&m_telemetry);
+        //发送器日志在其线程中直接写入缓冲
+        connect(m_udpSender.data(), &UdpSender::logMessage, this,
+                [this](const QString &level, const QString &msg) { m_log.add(level, msg); }, Qt::DirectConnection);
     }
     catch(const std::bad_alloc&)
     {
         qCCritical(workerLog) << "UDP 发送器初始化失败（内存不足）";
-        emit logMessage("ERROR", "系统资源不足，无法启动");
+        m_log.add("ERROR", "系统资源不足，无法启动");
         m_running = false;
         return;
     }
     qCInfo(workerLog) << "工作线程启动成功";
-    emit logMessage("DEBUG", "工作线程启动成功");
+    m_log.add("DEBUG", "工作线程启动成功");
     QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
 }
 
@@ -78,6 +103,15 @@ void WorkerClass::pauseProcessing(bool paused)
         return;
     }
     m_paused = paused;
+    //暂停时长计入调度偏移，恢复后发送节奏整体顺延
+    if(paused)
+    {
+        m_scheduler.pause();
+    }
+    else
+    {
+        m_scheduler.resume();
+    }
     if(m_udpSender)
     {
         m_udpSender->pause(paused);
@@ -86,7 +120,7 @@ void WorkerClass::pauseProcessing(bool paused)
     {
         m_pauseCondition.wakeAll();
     }
-    emit logMessage("DEBUG", paused ? "处理已暂停" : "处理已恢复");
+    m_log.add("DEBUG", paused ? "处理已暂停" : "处理已恢复");
 }
 
 void WorkerClass::stopProcessing()
@@ -103,18 +137,41 @@ void WorkerClass::stopProcessing()
     m_paused = false;
     //唤醒可能暂停的线程
     m_pauseCondition.wakeAll();
-    //释放锁，避免死锁
-    locker.unlock();
-    //安全停止UdpSender
+    //唤醒等待解析结果的线程
+    if(m_pipeline)
+    {
+        m_pipeline->stop();
+    }
+    //停止UdpSender：唤醒阻塞在 reserve()/flush() 中的工作线程；
+    //发送线程由工作线程在 process() 结束时等待退出并释放，此处不持锁等待线程
     if(m_udpSender)
     {
-        qCDebug(workerLog) << "正在停止UdpSender...";
         m_udpSender->stop();
-        m_udpSender->waitForStop();  //确保等待发送线程结束
-        m_udpSender.reset();
-        qCDebug(workerLog) << "UdpSender已停止并释放";
     }
-    qCDebug(workerLog) << "工作线程已完全停止";
+    qCDebug(workerLog) << "已请求工作线程停止";
+}
+
+bool WorkerClass::seekTo(const QString &target)
+{
+    qint64 us = 0;
+    bool hasDate = false;
+    bool relative = false;
+    if(!SeekIndex::parseTarget(target, us, hasDate, relative))
+    {
+        m_log.add("WARN", "无法识别的跳转位置: " + target);
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    if(!m_running || m_task != Task::Replay)
+    {
+        return false;
+    }
+    //由工作线程在当前包之后处理，暂停中的等待同样被唤醒
+    m_seekTarget = target.trimmed();
+    m_seekPending = true;
+    m_pauseCondition.wakeAll();
+    m_log.add("DEBUG", "跳转请求: " + m_seekTarget);
+    return true;
 }
 
 bool WorkerClass::isPaused()
@@ -134,266 +191,1166 @@ void WorkerClass::setAddrList(const QStringList addrlist)
     m_addrlist = addrlist;
 }
 
-QStringList WorkerClass::collectFilesRecursive(const QString &path, bool isDesc)
+void WorkerClass::setTask(Task task)
 {
-    QStringList files;
-    QDir currentDir(path);
-    //处理当前目录文件（始终正序）
-    QStringList currentFiles = currentDir.entryList({"*.txt"}, QDir::Files);
-    currentFiles.sort();
-    for(const QString &file : currentFiles)
+    QMutexLocker locker(&m_mutex);
+    m_task = task;
+}
+
+int WorkerClass::discoverFiles(int count)
+{
+    const bool wasAtEnd = m_walker->atEnd();
+    QString filePath;
+    while(m_files.size() < count && m_walker->next(filePath))
     {
-        files.append(currentDir.absoluteFilePath(file));
+        m_files.append(filePath);
+        if(m_pipeline)
+        {
+            m_pipeline->addFile(filePath);
+        }
     }
-    //处理子目录（根据 order 参数控制顺序）
-    QStringList subDirs = currentDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    subDirs.sort();
-    if(isDesc)
+    //遍历刚结束：通知解析线程不再有新文件
+    if(!wasAtEnd && m_walker->atEnd())
     {
-        std::reverse(subDirs.begin(), subDirs.end());
+        qCInfo(workerLog) << "目录遍历完成 文件数:" << m_files.size() << "目录数:" << m_walker->directoriesVisited();
+        m_log.add("DEBUG", QString("目录遍历完成 文件数:[%1] 目录数:[%2]")
+                        .arg(m_files.size()).arg(m_walker->directoriesVisited()));
+        if(m_pipeline)
+        {
+            m_pipeline->finishInput();
+        }
     }
-    //递归处理子目录
-    for(const QString &dir : subDirs)
+    return m_files.size();
+}
+
+int WorkerClass::progressPercent(int done) const
+{
+    int total = qMax(m_walker->estimatedTotal(), m_files.size());
+    if(!m_walker->atEnd())
     {
-        files += collectFilesRecursive(currentDir.filePath(dir), isDesc);
+        total = qMax(total, done + 1);
     }
-    return files;
+    return total > 0 ? static_cast<int>(static_cast<qint64>(done) * 100 / total) : 100;
 }
 
 void WorkerClass::process()
 {
     QMutexLocker locker(&m_mutex);
     qCInfo(workerLog) << "进入主处理流程";
+    const bool converting = m_task == Task::Convert;
     //检查配置有效性
-    if(!m_config.contains("dataDir") || m_addrlist.isEmpty())
+    if(!m_config.contains("dataDir") || (!converting && m_addrlist.isEmpty()))
+    {
+        m_log.add("ERROR", "配置参数不完整");
+        locker.unlock();
+        releaseSender();
+        emit finished();
+        return;
+    }
+    if(m_task == Task::Record)
     {
-        emit logMessage("ERROR", "配置参数不完整");
+        locker.unlock();
+        recordCapture();
         emit finished();
         return;
     }
     QDir dataDir(m_config["dataDir"].toString());
-    //递归收集文件
+    //增量遍历目录（回放时同时收集 .dpcap），gzip 压缩的文本抓包边解压边读取，边遍历边处理
     bool isDesc = m_config["order"].toString().compare("倒序", Qt::CaseInsensitive) == 0;
-    m_files = collectFilesRecursive(dataDir.absolutePath(), isDesc);
-    if(m_files.isEmpty())
+    const QStringList nameFilters = converting ? QStringList{"*.txt", "*.txt.gz"} : QStringList{"*.txt", "*.txt.gz", "*.dpcap"};
+    m_files.clear();
+    m_walker.reset(new FileWalker(dataDir.absolutePath(), isDesc, nameFilters));
+    qCInfo(workerLog) << "开始遍历目录:" << dataDir.absolutePath() << "处理顺序:" << (isDesc ? "倒序" : "正序");
+    m_log.add("DEBUG", "开始遍历目录:" + dataDir.absolutePath() + " 处理顺序:" + (isDesc ? "倒序" : "正序"));
+    if(converting)
+    {
+        locker.unlock();
+        convertFiles();
+        emit finished();
+        return;
+    }
+    //编译主题过滤位图
+    const QStringList invalidTopics = m_topicFilter.compile(m_config["includeTopics"].toStringList(),
+                                                            m_config["excludeTopics"].toStringList(),
+                                                            m_config["uniqueMode"].toBool());
+    if(!invalidTopics.isEmpty())
+    {
+        m_log.add("WARN", "无法识别的主题号: " + invalidTopics.join(','));
+    }
+    //注册目标地址（一次性解析并缓存），并按配置设置各目标限速
+    m_destinations.clear();
+    m_destinationNames.clear();
+    const QVariantMap rateLimits = m_config.value("rateLimits").toMap();
+    for(const QString &addr : m_addrlist)
+    {
+        const int index = m_udpSender->addDestination(addr);
+        if(index >= 0)
+        {
+            m_destinations.append(index);
+            m_destinationNames.append(addr);
+            //未单独配置的地址使用 "*" 项
+            const QVariant entry = rateLimits.contains(addr) ? rateLimits.value(addr) : rateLimits.value("*");
+            if(entry.isValid())
+            {
+                const QVariantMap map = entry.toMap();
+                UdpSender::RateLimit limit;
+                limit.packetsPerSecond = map.value("pps", 0.0).toDouble();
+                limit.bitsPerSecond = map.value("bps", 0.0).toDouble();
+                limit.burstPackets = map.value("burst", 1).toInt();
+                limit.burstBytes = map.value("burstBytes", 0).toInt();
+                limit.backlog = map.value("backlog", limit.backlog).toInt();
+                m_udpSender->setRateLimit(index, limit);
+                if(limit.packetsPerSecond > 0 || limit.bitsPerSecond > 0)
+                {
+                    m_log.add("DEBUG", QString("目标限速 %1: %2 包/秒 %3 bit/秒 突发 %4 包")
+                                    .arg(addr).arg(limit.packetsPerSecond).arg(limit.bitsPerSecond)
+                                    .arg(limit.burstPackets));
+                }
+            }
+        }
+    }
+    if(m_destinations.isEmpty())
     {
-        emit logMessage("WARN", "未找到文本文件: " + dataDir.path());
+        m_log.add("ERROR", "没有有效的目标地址");
+        locker.unlock();
+        releaseSender();
         emit finished();
         return;
     }
-    qCInfo(workerLog) << "已收集文件数:[" << QString::number(m_files.size()) << "] 处理顺序:" << (isDesc ? "倒序" : "正序");
-    emit logMessage("DEBUG", "已收集文件数:[" + QString::number(m_files.size()) + "] 处理顺序:" + (isDesc ? "倒序" : "正序"));
+    //配置回放节奏
+    const bool timestampMode = m_config.value("pacingMode").toString() == "timestamp";
+    const double speed = m_config.value("speedFactor", 1.0).toDouble();
+    m_scheduler.configure(timestampMode ? ReplayScheduler::Mode::Timestamp : ReplayScheduler::Mode::Interval,
+                          speed, m_config.value("sendInterval", 100).toInt());
+    m_log.add("DEBUG", timestampMode
+                    ? (speed > 0 ? QString("回放节奏: 按时间戳 x%1").arg(speed) : QString("回放节奏: 按时间戳 最快"))
+                    : QString("回放节奏: 固定间隔 %1ms").arg(m_config.value("sendInterval", 100).toInt()));
+    //多线程解析：解析线程按文件顺序提前解析，本线程按序发送
+    int parseThreads = m_config.value("parseThreads", 0).toInt();
+    if(parseThreads <= 0)
+    {
+        //发送线程与本线程各占一个核心
+        parseThreads = qBound(1, QThread::idealThreadCount() - 2, 8);
+    }
+    if(parseThreads > 1)
+    {
+        const qint64 budget = qMax(16, m_config.value("parseBufferMB", 256).toInt()) * 1024LL * 1024LL;
+        //文件在遍历过程中逐个加入流水线
+        m_pipeline.reset(new ParsePipeline(parseThreads, budget));
+        m_log.add("DEBUG", QString("解析线程数: %1").arg(parseThreads));
+    }
+    m_telemetry.start(m_destinationNames);
+    //循环回放：第一轮边发送边收集到预载区，之后的轮次直接从内存发送
+    const int loops = m_config.value("loopCount", 1).toInt();
+    m_arena.reset(loops != 1 ? qMax(0, m_config.value("preloadMB", 1024).toInt()) * 1024LL * 1024LL : 0);
     locker.unlock();
+    //起始位置：未完成的断点优先，其次为配置的起始时间（定位时会继续遍历目录，不持有锁）
+    m_seekIndexes.clear();
+    m_start = StartPoint();
+    m_position = StartPoint();
+    m_currentFile = -1;
+    m_checkpointFailed = false;
+    m_checkpointTimer.start();
+    const QString startTime = m_config.value("startTime").toString().trimmed();
+    if(!(m_config.value("resumeCheckpoint", false).toBool() && resolveCheckpoint(m_start)) && !startTime.isEmpty())
+    {
+        resolveSeek(startTime, m_start);
+    }
+    m_scheduler.start();
+    m_pass = 1;
     processFiles();
+    replayLoops(loops);
+    collectResults();
+    //停止时保留断点，完整结束后下次从头开始
+    locker.relock();
+    const bool completed = m_running;
+    locker.unlock();
+    saveCheckpoint(completed);
+    m_scheduler.finish();
+    m_telemetry.finish();
+    //按配置导出本次回放的统计
+    const QString telemetryFile = m_config.value("telemetryFile").toString();
+    if(!telemetryFile.isEmpty())
+    {
+        QString error;
+        if(m_telemetry.writeJson(telemetryFile, error))
+        {
+            m_log.add("INFO", "回放统计已导出: " + telemetryFile);
+        }
+        else
+        {
+            qCWarning(workerLog) << "回放统计导出失败:" << telemetryFile << error;
+            m_log.add("ERROR", QString("回放统计导出失败: %1 (%2)").arg(telemetryFile).arg(error));
+        }
+    }
+    if(m_pipeline)
+    {
+        m_log.add("DEBUG", QString("解析缓存峰值: %1 MB").arg(m_pipeline->peakBufferedBytes() / (1024 * 1024)));
+    }
+    releaseSender();
     emit finished();
 }
 
 void WorkerClass::processFiles()
 {
-    const int totalFiles = m_files.size();
-    QElapsedTimer timer;
-    timer.start();
-    for(int i = 0; i < totalFiles; ++i)
+    //解析流水线需要提前知道后续文件，遍历保持领先于其解析窗口
+    const int lookahead = m_pipeline ? m_pipeline->threadCount() * 2 + 1 : 1;
+    //从中途开始时跳过之前的文件；预载区按完整的文件顺序收集，位置改变后不再使用
+    const auto restartAt = [this](int firstParsedFile)
+    {
+        rebuildPipeline(firstParsedFile);
+        if(m_arena.isActive())
+        {
+            m_arena.release();
+            m_log.add("DEBUG", "回放位置已改变，循环回放改为逐文件读取");
+        }
+    };
+    int i = 0;
+    if(m_start.file >= 0)
+    {
+        i = m_start.file;
+        restartAt(i + 1);
+    }
+    QString seekTarget;
+    while(i < discoverFiles(i + lookahead))
     {
         {
             QMutexLocker locker(&m_mutex);
+            //处理暂停状态（暂停期间的跳转立即定位，恢复后从新位置发送）
+            while(m_paused && m_running && !m_seekPending)
+            {
+                m_pauseCondition.wait(&m_mutex);
+            }
             if(!m_running)
             {
                 return;
             }
-            //处理暂停状态
-            while(m_paused && m_running)
+        } //释放锁，处理文件时不持有锁
+        if(takeSeekRequest(seekTarget))
+        {
+            StartPoint start;
+            if(resolveSeek(seekTarget, start))
             {
-                m_pauseCondition.wait(&m_mutex);
+                m_start = start;
             }
-            if(!m_running)
+            else if(m_position.file == i)
             {
-                break;
+                //目标无效：从当前文件已发送的位置继续
+                m_start = m_position;
             }
-        } //释放锁，处理文件时不持有锁
-        emit logMessage("DEBUG", QString("正在处理第%1个文件：%2").arg(i + 1).arg(m_files[i]));
-        processFile(m_files[i]);
+            if(m_start.file >= 0)
+            {
+                i = m_start.file;
+            }
+            m_scheduler.rebase();
+            restartAt(m_start.file == i ? i + 1 : i);
+            continue;
+        }
+        const QString filePath = m_files[i];
+        m_currentFile = i;
+        //旁路索引表明不含任何待发主题的文本抓包直接跳过（.dpcap 在读取时用自带索引判断）
+        if(!m_topicFilter.allowsAll() && m_start.file != i && !Dpcap::isDpcapFile(filePath)
+                && SeekIndex::isUpToDate(filePath) && !seekIndex(i).containsAllowed(m_topicFilter))
+        {
+            m_log.add("DEBUG", QString("%1 - 不含待发送主题，已跳过").arg(QFileInfo(filePath).fileName()));
+            emit progressUpdated(progressPercent(++i));
+            continue;
+        }
+        m_log.add("DEBUG", QString("正在处理第%1个文件：%2").arg(i + 1).arg(filePath));
+        m_arena.beginFile();
+        m_fileStats = ReplayTelemetry::FileStats();
+        m_fileStats.path = filePath;
+        QElapsedTimer fileTimer;
+        fileTimer.start();
+        //起点所在文件需要定位，不经过解析流水线
+        if(m_pipeline && m_start.file != i)
+        {
+            processParsedFile(i, filePath);
+        }
+        else
+        {
+            processFile(filePath);
+        }
+        m_fileStats.elapsedNs = fileTimer.nsecsElapsed();
+        //逐文件统计只记录第一轮，长时间循环时不随轮数增长
+        if(m_pass <= 1)
+        {
+            m_telemetry.recordFile(m_fileStats);
+        }
+        if(m_start.file == i)
+        {
+            m_start = StartPoint();
+        }
+        //被跳转打断时留在本文件，由循环开头处理跳转
+        if(seekPending())
+        {
+            continue;
+        }
+        emit progressUpdated(progressPercent(++i));
+    }
+    if(m_files.isEmpty() && m_walker->atEnd())
+    {
+        m_log.add("WARN", "未找到文本文件: " + m_config["dataDir"].toString());
+    }
+}
+
+void WorkerClass::rebuildPipeline(int firstFile)
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_pipeline || !m_running)
+    {
+        return;
+    }
+    const int threads = m_pipeline->threadCount();
+    const qint64 budget = qMax(16, m_config.value("parseBufferMB", 256).toInt()) * 1024LL * 1024LL;
+    m_pipeline.reset(new ParsePipeline(threads, budget));
+    //先跳过，解析线程不会领取之前的文件
+    m_pipeline->skipTo(firstFile);
+    for(const QString &filePath : m_files)
+    {
+        m_pipeline->addFile(filePath);
+    }
+    //遍历尚未结束时由 discoverFiles() 在结束时通知
+    if(m_walker->atEnd())
+    {
+        m_pipeline->finishInput();
+    }
+}
+
+const SeekIndex &WorkerClass::seekIndex(int file)
+{
+    const QString &filePath = m_files[file];
+    auto it = m_seekIndexes.find(filePath);
+    if(it != m_seekIndexes.end())
+    {
+        return *it;
+    }
+    SeekIndex index;
+    if(!index.load(filePath) && !Dpcap::isDpcapFile(filePath))
+    {
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        //大文件扫描可能较长，停止时中断扫描
+        const auto cancelled = [this]()
         {
             QMutexLocker locker(&m_mutex);
-            const int progress = (i + 1) * 100 / totalFiles;
-            emit progressUpdated(progress);
-            //限流控制
-            if(timer.elapsed() < 10)
+            return !m_running;
+        };
+        if(index.build(filePath, error, cancelled))
+        {
+            m_log.add("DEBUG", QString("已生成定位索引 %1（%2 ms）")
+                            .arg(QFileInfo(filePath).fileName()).arg(timer.elapsed()));
+        }
+        //停止而中断的扫描不视为失败（本次回放随之结束，索引缓存在下次开始时清空）
+        if(!error.isEmpty() && !cancelled())
+        {
+            m_log.add("WARN", QString("定位索引生成失败 %1: %2").arg(filePath).arg(error));
+        }
+    }
+    return *m_seekIndexes.insert(filePath, index);
+}
+
+bool WorkerClass::resolveSeek(const QString &target, StartPoint &start)
+{
+    qint64 us = 0;
+    bool hasDate = false;
+    bool relative = false;
+    if(!SeekIndex::parseTarget(target, us, hasDate, relative))
+    {
+        m_log.add("WARN", "无法识别的跳转位置: " + target);
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    //相对偏移以回放顺序中第一个文件的首包时间为基准
+    if(relative)
+    {
+        if(discoverFiles(1) == 0 || !seekIndex(0).hasTimestamps())
+        {
+            m_log.add("WARN", "首个文件没有有效时间戳，无法按偏移跳转: " + target);
+            return false;
+        }
+        us += seekIndex(0).firstUs();
+        hasDate = seekIndex(0).hasDate();
+    }
+    //第一个最大时间不早于目标的文件，文件内按时间索引定位
+    for(int file = 0; file < discoverFiles(file + 1); ++file)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            if(!m_running)
+            {
+                return false;
+            }
+        }
+        const SeekIndex &index = seekIndex(file);
+        if(!index.hasTimestamps())
+        {
+            continue;
+        }
+        const qint64 targetUs = index.alignTarget(us, hasDate);
+        if(targetUs > index.lastUs())
+        {
+            continue;
+        }
+        start = StartPoint();
+        start.file = file;
+        start.skipByTime = true;
+        start.targetUs = targetUs;
+        index.locate(targetUs, start.offset, start.index);
+        m_log.add("INFO", QString("跳转到 %1：第%2个文件 %3，读取起点 %4（定位耗时 %5 ms）")
+                        .arg(target).arg(file + 1).arg(QFileInfo(m_files[file]).fileName())
+                        .arg(qMax<qint64>(0, start.offset)).arg(timer.elapsed()));
+        return true;
+    }
+    m_log.add("WARN", "跳转位置晚于全部抓包: " + target);
+    return false;
+}
+
+bool WorkerClass::resolveCheckpoint(StartPoint &start)
+{
+    QFile file(checkpointPath());
+    if(!file.exists())
+    {
+        m_log.add("DEBUG", "没有断点记录，从头开始");
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonObject root = file.open(QIODevice::ReadOnly)
+                             ? QJsonDocument::fromJson(file.readAll(), &parseError).object() : QJsonObject();
+    if(root.isEmpty())
+    {
+        m_log.add("WARN", "断点文件无法读取: " + file.fileName());
+        return false;
+    }
+    if(root.value("finished").toBool())
+    {
+        m_log.add("INFO", "上次回放已完整结束，从头开始");
+        return false;
+    }
+    if(root.value("dataDir").toString() != QDir(m_config["dataDir"].toString()).absolutePath())
+    {
+        m_log.add("WARN", "断点属于其他数据目录，从头开始: " + root.value("dataDir").toString());
+        return false;
+    }
+    const QString filePath = root.value("file").toString();
+    for(int i = 0; !filePath.isEmpty() && i < discoverFiles(i + 1); ++i)
+    {
+        if(m_files[i] == filePath)
+        {
+            start = StartPoint();
+            start.file = i;
+            start.offset = root.value("offset").toVariant().toLongLong();
+            start.index = root.value("index").toVariant().toLongLong();
+            m_log.add("INFO", QString("从断点继续：%1 偏移 %2").arg(filePath).arg(start.offset));
+            return true;
+        }
+    }
+    m_log.add("WARN", "断点所在文件已不存在，从头开始: " + filePath);
+    return false;
+}
+
+bool WorkerClass::takeSeekRequest(QString &target)
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_seekPending)
+    {
+        return false;
+    }
+    target = m_seekTarget;
+    m_seekPending = false;
+    return true;
+}
+
+bool WorkerClass::seekPending()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_seekPending;
+}
+
+QString WorkerClass::checkpointPath() const
+{
+    const QString path = m_config.value("checkpointFile").toString().trimmed();
+    return path.isEmpty() ? QDir(m_config["dataDir"].toString()).filePath(".dataprocessor_checkpoint.json") : path;
+}
+
+void WorkerClass::notePosition(qint64 offset, qint64 index)
+{
+    m_position.file = m_currentFile;
+    m_position.offset = offset;
+    m_position.index = index;
+    if(m_checkpointTimer.hasExpired(CHECKPOINT_INTERVAL_MS))
+    {
+        saveCheckpoint(false);
+        m_checkpointTimer.restart();
+    }
+}
+
+void WorkerClass::saveCheckpoint(bool finished)
+{
+    //断点为已交给发送队列的位置，停止时队列中尚未发出的少量数据包会在续播时跳过
+    if(m_position.file < 0 && !finished)
+    {
+        return;
+    }
+    QJsonObject root;
+    root["dataDir"] = QDir(m_config["dataDir"].toString()).absolutePath();
+    root["file"] = m_position.file >= 0 ? m_files[m_position.file] : QString();
+    root["offset"] = m_position.offset;
+    root["index"] = m_position.index;
+    root["pass"] = m_pass;
+    root["finished"] = finished;
+    root["savedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    QSaveFile file(checkpointPath());
+    if(!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit())
+    {
+        if(!m_checkpointFailed)
+        {
+            qCWarning(workerLog) << "断点写入失败:" << file.fileName() << file.errorString();
+            m_log.add("WARN", QString("断点写入失败: %1 (%2)").arg(file.fileName()).arg(file.errorString()));
+            m_checkpointFailed = true;
+        }
+    }
+}
+
+void WorkerClass::replayLoops(int loops)
+{
+    if(m_arena.isActive())
+    {
+        m_log.add("INFO", QString("已预载 %1 个文件 %2 包（%3 MB），之后的轮次从内存发送")
+                        .arg(m_arena.fileCount()).arg(m_arena.packetCount())
+                        .arg(m_arena.usedBytes() / (1024 * 1024)));
+    }
+    for(m_pass = 2; loops <= 0 || m_pass <= loops; ++m_pass)
+    {
+        if(!checkRunning() && !seekPending())
+        {
+            break;
+        }
+        //没有可发送的数据时不空转
+        if(m_files.isEmpty() || (m_arena.isActive() && m_arena.packetCount() == 0))
+        {
+            m_log.add("WARN", "没有可循环发送的数据包");
+            break;
+        }
+        m_topicFilter.resetUnique();
+        m_log.add("INFO", QString("开始第 %1 轮回放").arg(m_pass));
+        if(m_arena.isActive())
+        {
+            replayArena();
+            if(!seekPending())
             {
-                QThread::usleep(static_cast<unsigned long>(10 - timer.elapsed()));
+                continue;
             }
-            timer.restart();
+            //预载区不记录文件位置：跳转后本轮及之后的轮次逐文件读取
+            m_arena.release();
+            m_log.add("DEBUG", "回放位置已改变，循环回放改为逐文件读取");
+        }
+        //超出预载预算：重新逐文件读取，解析流水线按完整文件列表重建
+        rebuildPipeline(0);
+        processFiles();
+    }
+    m_arena.release();
+}
+
+void WorkerClass::replayArena()
+{
+    const int fileCount = m_arena.fileCount();
+    for(int file = 0; file < fileCount; ++file)
+    {
+        for(int i = m_arena.fileBegin(file); i < m_arena.fileEnd(file); ++i)
+        {
+            if(!checkRunning())
+            {
+                return;
+            }
+            const PacketArena::Packet &packet = m_arena.packet(i);
+            //唯一模式每轮重新判断，其余过滤已在收集时完成
+            if(!m_topicFilter.accept(packet.topic))
+            {
+                if(m_log.acceptDetail())
+                {
+                    m_log.addTopicSkipped(packet.topic, packet.length);
+                }
+                continue;
+            }
+            const qint64 dueNs = m_scheduler.scheduleCapture((packet.flags & Dpcap::TimestampValid) != 0, packet.timestampUs,
+                                                             (packet.flags & Dpcap::TimestampHasDate) != 0);
+            if(!publishPacket(m_arena.data(packet), packet.length, packet.topic, dueNs))
+            {
+                return;
+            }
+        }
+        emit progressUpdated((file + 1) * 100 / fileCount);
+    }
+}
+
+void WorkerClass::collectForLoop(const char *data, int length, quint16 topic, quint16 flags, qint64 timestampUs)
+{
+    if(!m_arena.append(timestampUs, flags, topic, data, length))
+    {
+        m_log.add("WARN", QString("数据量超出预载内存预算（%1 MB），之后的轮次改为逐文件读取")
+                        .arg(m_config.value("preloadMB", 1024).toInt()));
+    }
+}
+
+void WorkerClass::collectResults()
+{
+    //正常结束时等待发送队列排空，成功/失败以实际发送结果为准
+    bool stopped = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        stopped = !m_running;
+    }
+    if(!stopped && m_udpSender)
+    {
+        m_udpSender->flush();
+        m_successCount = static_cast<int>(m_udpSender->sentCount());
+        m_failedCount += static_cast<int>(m_udpSender->failedCount());
+        m_log.add("DEBUG", QString("发送队列峰值: %1/%2 背压等待: %3 次")
+                        .arg(m_udpSender->queueHighWater()).arg(m_udpSender->queueCapacity())
+                        .arg(m_udpSender->backpressureCount()));
+        if(m_udpSender->droppedCount() > 0)
+        {
+            m_log.add("WARN", QString("超出目标限速丢弃: %1 包").arg(m_udpSender->droppedCount()));
         }
     }
     emit statsUpdated(m_successCount, m_failedCount);
     qCInfo(workerLog) << "文件处理完成 成功:" << m_successCount
                       << "失败:" << m_failedCount;
-    emit logMessage("DEBUG", QString("处理完成 成功: %1 失败: %2")
+    m_log.add("DEBUG", QString("处理完成 成功: %1 失败: %2")
                     .arg(m_successCount).arg(m_failedCount));
 }
 
+void WorkerClass::releaseSender()
+{
+    //锁内取出，其他线程不再看到它们；锁外等待发送线程与解析线程退出
+    QMutexLocker locker(&m_mutex);
+    QScopedPointer<UdpSender> sender(m_udpSender.take());
+    QScopedPointer<ParsePipeline> pipeline(m_pipeline.take());
+    locker.unlock();
+}
+
 void WorkerClass::processFile(const QString &filePath)
 {
-    QFile file(filePath);
-    //打开文件
-    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if(Dpcap::isDpcapFile(filePath))
+    {
+        processDpcapFile(filePath);
+    }
+    else
+    {
+        processTextFile(filePath);
+    }
+}
+
+void WorkerClass::processTextFile(const QString &filePath)
+{
+    CaptureReader reader;
+    //打开并映射文件
+    if(!reader.open(filePath))
     {
         const QString error = QString("文件打开失败: %1 (%2)")
-                              .arg(filePath).arg(file.errorString());
+                              .arg(filePath).arg(reader.errorString());
         qCWarning(workerLog) << error;
-        emit logMessage("ERROR", error);
+        m_log.add("ERROR", error);
         m_failedCount++;
         return;
     }
-    QTextStream stream(&file);
-    int lineNum = 0;
-    while(!stream.atEnd())
+    const QString fileName = QFileInfo(filePath).fileName();
+    //起点所在文件：按索引定位后逐行跳过早于目标时间的数据包
+    const bool seeking = m_start.file == m_currentFile;
+    if(seeking && m_start.offset >= 0 && !reader.seek(m_start.offset, static_cast<int>(m_start.index)))
+    {
+        m_log.add("WARN", QString("%1 - 定位失败，从文件开头回放").arg(fileName));
+    }
+    bool skipping = seeking && m_start.skipByTime;
+    //完整读取时顺带生成旁路定位索引
+    const bool indexing = !seeking && !SeekIndex::isUpToDate(filePath);
+    SeekIndexBuilder indexBuilder;
+    CaptureRecord record;
+    //解析耗时只计读行与解码，不含等待发送队列与调度
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    while(checkRunning())
     {
-        //检查运行状态
+        //解析数据行（支持 [时间戳]\t数据 和 数据\t时间戳 两种格式）
+        const qint64 lineOffset = reader.position();
+        const int lineIndex = reader.lineNumber();
+        const qint64 readStartNs = parseTimer.nsecsElapsed();
+        const CaptureReader::LineResult result = reader.next(record);
+        m_fileStats.parseNs += parseTimer.nsecsElapsed() - readStartNs;
+        if(result == CaptureReader::LineResult::End)
         {
-            QMutexLocker locker(&m_mutex);
-            if(!m_running)
+            //压缩抓包损坏或不完整时只发送已解压的部分
+            if(!reader.errorString().isEmpty())
             {
+                const QString warn = QString("%1 - 文件未能读完: %2").arg(fileName).arg(reader.errorString());
+                qCWarning(workerLog) << warn;
+                m_log.add("WARN", warn);
                 break;
             }
-            if(m_paused)
+            QString error;
+            if(indexing && !indexBuilder.save(filePath, error))
             {
-                m_pauseCondition.wait(&m_mutex);
+                m_log.add("DEBUG", QString("%1 - 定位索引写入失败: %2").arg(fileName).arg(error));
             }
+            break;
         }
-        lineNum++;
-        const QString line = stream.readLine().trimmed();
-        if(line.isEmpty())
-        {
-            continue;
-        }
-        //解析数据行
-        const QStringList parts = line.split('\t', QString::SkipEmptyParts);
-        if(parts.size() < 2)
+        const int lineNum = record.lineNumber;
+        if(result == CaptureReader::LineResult::FormatError)
         {
             const QString warn = QString("%1 第%2行 - 数据格式错误")
-                                 .arg(QFileInfo(file).fileName()).arg(lineNum);
-            emit logMessage("WARN", warn);
+                                 .arg(fileName).arg(lineNum);
+            m_log.add("WARN", warn);
             continue;
         }
-        //识别数据格式（支持 [时间戳]\t数据 和 数据\t时间戳 两种格式）
-        QString hexDataStr;
-        if (parts[0].trimmed().startsWith('['))
+        //数据清洗：直接解码到发送队列预留区，免去中间缓冲区
+        const int capacity = HexDecoder::maxDecodedSize(record.hexData.size());
+        char *buffer = capacity > 0 ? m_udpSender->reserve(capacity, m_destinations.size()) : nullptr;
+        if(!buffer && capacity > 0)
         {
-            hexDataStr = parts[1];
-        }
-        else
-        {
-            hexDataStr = parts[0];
+            QMutexLocker locker(&m_mutex);
+            if(!m_running)
+            {
+                break;
+            }
+            m_failedCount++;
+            continue;
         }
-
-        //数据清洗
-        const QByteArray cleanData = cleanHexData(hexDataStr);
-        if(cleanData.isEmpty())
+        const qint64 decodeStartNs = parseTimer.nsecsElapsed();
+        const int size = cleanHexData(record.hexData, buffer, capacity);
+        m_fileStats.parseNs += parseTimer.nsecsElapsed() - decodeStartNs;
+        if(size <= 0)
         {
             const QString warn = QString("%1 第%2行 - 无效 HEX 数据")
-                                 .arg(QFileInfo(file).fileName()).arg(lineNum);
-            emit logMessage("WARN", warn);
+                                 .arg(fileName).arg(lineNum);
+            m_log.add("WARN", warn);
             continue;
         }
+        //仅包装，不拷贝
+        const QByteArray cleanData = QByteArray::fromRawData(buffer, size);
         //提取主题（第 3-4 字节）
         if(cleanData.size() < 4)
         {
             const QString warn = QString("%1 第%2行 - 数据长度不足")
-                                 .arg(QFileInfo(file).fileName()).arg(lineNum);
-            emit logMessage("WARN", warn);
+                                 .arg(fileName).arg(lineNum);
+            m_log.add("WARN", warn);
             m_failedCount++;
             continue;
         }
-        //构造主题号（注意字节序）
-        const QString topic = QString("%1%2")
-                              .arg(QString::fromLatin1(cleanData.mid(4, 1).toHex().toUpper()))
-                              .arg(QString::fromLatin1(cleanData.mid(3, 1).toHex().toUpper()));
-        //主题过滤
-        if(!filterTopic(topic))
+        //主题过滤：一次位测试，主题文本仅在输出日志时格式化
+        const quint16 topic = Dpcap::topicOf(buffer, size);
+        //定位索引、跳转与预载需要抓包时间，仅在需要时解析
+        qint64 captureUs = 0;
+        bool hasDate = false;
+        bool timestampValid = false;
+        if(indexing || skipping || m_arena.isActive())
+        {
+            timestampValid = ReplayScheduler::parseTimestamp(record.timestamp, captureUs, &hasDate);
+        }
+        if(indexing)
         {
-            emit logMessage("INFO", "跳过主题:" + topic);
-            qCDebug(workerLog) << "跳过主题:" << topic;
+            indexBuilder.add(lineOffset, lineIndex, timestampValid, captureUs, hasDate, topic);
+        }
+        if(skipping)
+        {
+            if(!timestampValid || captureUs < m_start.targetUs)
+            {
+                continue;
+            }
+            skipping = false;
+        }
+        //首轮同时收集到预载区，唯一模式在每一轮发送时重新判断
+        if(m_arena.isActive() && m_topicFilter.allowed(topic))
+        {
+            const quint16 flags = timestampValid ? static_cast<quint16>(Dpcap::TimestampValid | (hasDate ? Dpcap::TimestampHasDate : 0)) : 0;
+            collectForLoop(buffer, size, topic, flags, captureUs);
+        }
+        if(!m_topicFilter.accept(topic))
+        {
+            if(m_log.acceptDetail())
+            {
+                m_log.addTopicSkipped(topic, size);
+            }
             continue;
         }
-        //发送到所有目标地址
-        const QStringList addresses = m_addrlist;
-        for(const QString &addr : addresses)
+        //计算调度时刻，过早时先等待，发送线程负责精确定时
+        const qint64 dueNs = m_scheduler.schedule(record.timestamp);
+        if(!waitForSchedule(dueNs))
         {
-            if(!m_udpSender->send(addr, cleanData, topic))
+            break;
+        }
+        //一次发布到所有目标地址，载荷共用
+        m_udpSender->publish(size, m_destinations.constData(), m_destinations.size(), dueNs, topic);
+        m_fileStats.packets++;
+        logPacketSent(buffer, size, topic);
+        notePosition(reader.position(), reader.lineNumber());
+    }
+}
+
+void WorkerClass::processDpcapFile(const QString &filePath)
+{
+    DpcapReader reader;
+    if(!reader.open(filePath))
+    {
+        const QString error = QString("文件打开失败: %1 (%2)")
+                              .arg(filePath).arg(reader.errorString());
+        qCWarning(workerLog) << error;
+        m_log.add("ERROR", error);
+        m_failedCount++;
+        return;
+    }
+    const QString fileName = QFileInfo(filePath).fileName();
+    //借助主题索引跳过不含任何待发主题的文件
+    if(reader.hasIndex())
+    {
+        bool anyAllowed = false;
+        for(const Dpcap::TopicEntry &entry : reader.topicIndex())
+        {
+            if(m_topicFilter.allowed(entry.topic))
             {
-                const QString error = QString("发送失败 [%1] [长度：%2] [%3] [%4]").arg(topic).arg(cleanData.size()).arg(addr).arg(QString::fromLatin1(cleanData.toHex().toUpper()));
-                emit logMessage("ERROR", error);
-                m_failedCount++;
+                anyAllowed = true;
+                break;
+            }
+        }
+        if(!anyAllowed)
+        {
+            m_log.add("DEBUG", QString("%1 - 不含待发送主题，已跳过").arg(fileName));
+            return;
+        }
+    }
+    //起点所在文件：按索引定位后跳过早于目标时间的数据包
+    const bool seeking = m_start.file == m_currentFile;
+    if(seeking && m_start.offset >= 0 && !reader.seek(m_start.offset, m_start.index))
+    {
+        m_log.add("WARN", QString("%1 - 定位失败，从文件开头回放").arg(fileName));
+    }
+    bool skipping = seeking && m_start.skipByTime;
+    Dpcap::Record record;
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    while(checkRunning())
+    {
+        const qint64 readStartNs = parseTimer.nsecsElapsed();
+        const bool hasRecord = reader.next(record);
+        m_fileStats.parseNs += parseTimer.nsecsElapsed() - readStartNs;
+        if(!hasRecord)
+        {
+            if(!reader.errorString().isEmpty())
+            {
+                const QString warn = QString("%1 - 文件损坏: %2").arg(fileName).arg(reader.errorString());
+                qCWarning(workerLog) << warn;
+                m_log.add("WARN", warn);
             }
-            else
+            break;
+        }
+        if(skipping)
+        {
+            if(!(record.flags & Dpcap::TimestampValid) || record.timestampUs < m_start.targetUs)
             {
-                const QString info = QString("发送成功 [%1] [长度：%2] [%3] [%4]").arg(topic).arg(cleanData.size()).arg(addr).arg(QString::fromLatin1(cleanData.toHex().toUpper()));
-                emit logMessage("INFO", info);
-                m_successCount++;
+                continue;
+            }
+            skipping = false;
+        }
+        if(m_arena.isActive() && m_topicFilter.allowed(record.topic))
+        {
+            collectForLoop(record.data, record.length, record.topic, record.flags, record.timestampUs);
+        }
+        //主题过滤
+        if(!m_topicFilter.accept(record.topic))
+        {
+            if(m_log.acceptDetail())
+            {
+                m_log.addTopicSkipped(record.topic, record.length);
             }
+            continue;
         }
-        //发送间隔控制
-        const int interval = m_config.value("sendInterval", 100).toInt();
-        if(interval > 0)
+        //时间戳已在转换时解析
+        const qint64 dueNs = m_scheduler.scheduleCapture((record.flags & Dpcap::TimestampValid) != 0, record.timestampUs,
+                                                         (record.flags & Dpcap::TimestampHasDate) != 0);
+        if(!publishPacket(record.data, record.length, record.topic, dueNs))
         {
-            QThread::msleep(static_cast<unsigned long>(interval));
+            break;
         }
+        notePosition(reader.position(), record.index + 1);
     }
-    file.close();
 }
 
-bool WorkerClass::filterTopic(const QString &topic)
+void WorkerClass::processParsedFile(int fileIndex, const QString &filePath)
 {
-    QMutexLocker locker(&m_mutex);
-    //包含列表检查
-    const QStringList include = m_config["includeTopics"].toStringList();
-    if(!include.isEmpty() && !include.contains(topic, Qt::CaseInsensitive))
+    const QString fileName = QFileInfo(filePath).fileName();
+    ParsePipeline::Chunk chunk;
+    while(checkRunning() && m_pipeline->take(fileIndex, chunk))
     {
-        return false;
+        if(chunk.kind == ParsePipeline::ChunkKind::Passthrough)
+        {
+            processDpcapFile(filePath);
+            return;
+        }
+        if(chunk.kind == ParsePipeline::ChunkKind::Error)
+        {
+            const QString error = QString("文件打开失败: %1 (%2)").arg(filePath).arg(chunk.error);
+            qCWarning(workerLog) << error;
+            m_log.add("ERROR", error);
+            m_failedCount++;
+            return;
+        }
+        //解析线程只在最后一块填写整文件的解析耗时
+        m_fileStats.parseNs += chunk.parseNs;
+        const char *payload = chunk.payload.constData();
+        for(const ParsePipeline::Packet &packet : chunk.packets)
+        {
+            if(!checkRunning())
+            {
+                return;
+            }
+            switch(packet.status)
+            {
+            case ParsePipeline::LineStatus::FormatError:
+                m_log.add("WARN", QString("%1 第%2行 - 数据格式错误").arg(fileName).arg(packet.lineNumber));
+                continue;
+            case ParsePipeline::LineStatus::InvalidHex:
+                m_log.add("WARN", QString("%1 第%2行 - 无效 HEX 数据").arg(fileName).arg(packet.lineNumber));
+                continue;
+            case ParsePipeline::LineStatus::TooShort:
+                m_log.add("WARN", QString("%1 第%2行 - 数据长度不足").arg(fileName).arg(packet.lineNumber));
+                m_failedCount++;
+                continue;
+            case ParsePipeline::LineStatus::Ok:
+                break;
+            }
+            const char *data = payload + packet.offset;
+            if(m_arena.isActive() && m_topicFilter.allowed(packet.topic))
+            {
+                collectForLoop(data, packet.length, packet.topic, packet.flags, packet.timestampUs);
+            }
+            if(!m_topicFilter.accept(packet.topic))
+            {
+                if(m_log.acceptDetail())
+                {
+                    m_log.addTopicSkipped(packet.topic, packet.length);
+                }
+                continue;
+            }
+            const qint64 dueNs = m_scheduler.scheduleCapture((packet.flags & Dpcap::TimestampValid) != 0, packet.timestampUs,
+                                                             (packet.flags & Dpcap::TimestampHasDate) != 0);
+            if(!publishPacket(data, packet.length, packet.topic, dueNs))
+            {
+                return;
+            }
+            notePosition(packet.endOffset, packet.lineNumber);
+        }
+        if(chunk.last)
+        {
+            if(!chunk.error.isEmpty())
+            {
+                const QString warn = QString("%1 - 文件未能读完: %2").arg(fileName).arg(chunk.error);
+                qCWarning(workerLog) << warn;
+                m_log.add("WARN", warn);
+            }
+            return;
+        }
     }
-    //排除列表检查
-    const QStringList exclude = m_config["excludeTopics"].toStringList();
-    if(exclude.contains(topic, Qt::CaseInsensitive))
+}
+
+bool WorkerClass::publishPacket(const char *data, int length, quint16 topic, qint64 dueNs)
+{
+    if(!waitForSchedule(dueNs))
     {
         return false;
     }
-    //唯一模式检查
-    if(m_config["uniqueMode"].toBool())
+    char *buffer = m_udpSender->reserve(length, m_destinations.size());
+    if(!buffer)
     {
-        if(m_sentTopics.contains(topic))
+        QMutexLocker locker(&m_mutex);
+        if(!m_running)
         {
             return false;
         }
-        m_sentTopics.insert(topic);
+        m_failedCount++;
+        return true;
     }
+    std::memcpy(buffer, data, static_cast<size_t>(length));
+    //一次发布到所有目标地址，载荷共用
+    m_udpSender->publish(length, m_destinations.constData(), m_destinations.size(), dueNs, topic);
+    m_fileStats.packets++;
+    logPacketSent(data, length, topic);
     return true;
 }
 
-QByteArray WorkerClass::cleanHexData(const QString &data)
+void WorkerClass::logPacketSent(const char *data, int length, quint16 topic)
 {
-    //移除所有非十六进制字符
-    static QRegularExpression nonHexChar("[^0-9A-Fa-f]");
-    QString cleanStr = data;
-    cleanStr.remove(nonHexChar);
-    //长度校验
-    if(cleanStr.isEmpty() || (cleanStr.length() % 2 != 0))
+    //只保存一份数据包副本供各目标的日志共用，十六进制文本在显示时才生成
+    QByteArray payload;
+    for(int i = 0; i < m_destinationNames.size(); ++i)
     {
-        qCDebug(workerLog) << "无效 HEX 数据:" << data;
-        emit logMessage("WARN", "无效 HEX 数据:" + data);
-        return QByteArray();
+        if(!m_log.acceptDetail())
+        {
+            continue;
+        }
+        if(payload.isNull())
+        {
+            payload = QByteArray(data, length);
+        }
+        m_log.addPacketSent(topic, m_destinationNames[i], payload);
     }
-    //转换字节数组
-    QByteArray result;
-    try
+}
+
+void WorkerClass::convertFiles()
+{
+    int converted = 0;
+    int upToDate = 0;
+    qint64 totalPackets = 0;
+    const auto cancelled = [this]()
+    {
+        QMutexLocker locker(&m_mutex);
+        return !m_running;
+    };
+    for(int i = 0; checkRunning() && i < discoverFiles(i + 1); ++i)
+    {
+        const QString textPath = m_files[i];
+        const QString outputPath = DpcapConverter::outputPath(textPath);
+        if(DpcapConverter::isUpToDate(textPath))
+        {
+            m_log.add("DEBUG", QString("已是最新，跳过: %1").arg(outputPath));
+            ++upToDate;
+        }
+        else
+        {
+            QElapsedTimer timer;
+            timer.start();
+            DpcapConverter::Result result;
+            QString error;
+            if(DpcapConverter::convert(textPath, outputPath, result, error, cancelled))
+            {
+                ++converted;
+                m_successCount++;
+                totalPackets += result.packets;
+                m_log.add("INFO", QString("转换完成 %1：%2 包，跳过 %3 行，耗时 %4 ms")
+                                .arg(QFileInfo(outputPath).fileName()).arg(result.packets)
+                                .arg(result.skipped).arg(timer.elapsed()));
+            }
+            else if(!cancelled())
+            {
+                m_failedCount++;
+                const QString message = QString("转换失败 %1: %2").arg(textPath).arg(error);
+                qCWarning(workerLog) << message;
+                m_log.add("ERROR", message);
+            }
+        }
+        emit progressUpdated(progressPercent(i + 1));
+        emit statsUpdated(m_successCount, m_failedCount);
+    }
+    if(m_files.isEmpty() && m_walker->atEnd())
+    {
+        m_log.add("WARN", "未找到文本文件: " + m_config["dataDir"].toString());
+    }
+    qCInfo(workerLog) << "转换完成 文件:" << converted << "最新:" << upToDate << "失败:" << m_failedCount;
+    m_log.add("DEBUG", QString("转换完成 新转换: %1 个文件（%2 包） 已是最新: %3 失败: %4")
+                    .arg(converted).arg(totalPackets).arg(upToDate).arg(m_failedCount));
+}
+
+void WorkerClass::recordCapture()
+{
+    CaptureRecorder::Options options;
+    options.addresses = m_addrlist;
+    options.format = CaptureRecorder::formatFromString(m_config.value("recordFormat").toString());
+    options.interfaceAddress = m_config.value("recordInterface").toString().trimmed();
+    QString recordDir = m_config.value("recordDir").toString();
+    if(recordDir.isEmpty())
     {
-        result = QByteArray::fromHex(cleanStr.toLatin1());
+        recordDir = m_config["dataDir"].toString();
     }
-    catch(...)
+    QDir dir(recordDir);
+    if(!dir.exists() && !dir.mkpath("."))
     {
-        qCWarning(workerLog) << "HEX 数据转换异常:" << cleanStr;
-        emit logMessage("WARN", "HEX 数据转换异常:" + cleanStr);
-        return QByteArray();
+        m_log.add("ERROR", "无法创建录制目录: " + recordDir);
+        return;
+    }
+    options.outputPath = dir.filePath(CaptureRecorder::defaultFileName(options.format));
+    m_recorder.setLog(&m_log);
+    QString error;
+    if(!m_recorder.start(options, error))
+    {
+        qCWarning(workerLog) << "录制启动失败:" << error;
+        m_log.add("ERROR", "录制启动失败: " + error);
+        return;
+    }
+    //录制没有终点：每 0.5 秒刷新一次计数，直到停止
+    qint64 lastDropped = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        while(m_running)
+        {
+            m_pauseCondition.wait(&m_mutex, 500);
+            const CaptureRecorder::Stats stats = m_recorder.stats();
+            emit statsUpdated(static_cast<int>(stats.written), static_cast<int>(stats.dropped));
+            if(stats.dropped > lastDropped)
+            {
+                m_log.add("WARN", QString("写盘跟不上接收，已丢弃 %1 包（待写盘缓冲块 %2）")
+                                .arg(stats.dropped).arg(stats.pendingBlocks));
+                lastDropped = stats.dropped;
+            }
+        }
+    }
+    if(!m_recorder.stop(error))
+    {
+        qCWarning(workerLog) << "录制文件写入失败:" << error;
+        return;
+    }
+    const CaptureRecorder::Stats stats = m_recorder.stats();
+    emit statsUpdated(static_cast<int>(stats.written), static_cast<int>(stats.dropped));
+    qCInfo(workerLog) << "录制完成" << options.outputPath << "包数:" << stats.written << "丢弃:" << stats.dropped;
+}
+
+bool WorkerClass::checkRunning()
+{
+    QMutexLocker locker(&m_mutex);
+    while(m_paused && m_running && !m_seekPending)
+    {
+        m_pauseCondition.wait(&m_mutex);
+    }
+    return m_running && !m_seekPending;
+}
+
+bool WorkerClass::waitForSchedule(qint64 dueNs)
+{
+    if(dueNs == ReplayScheduler::AsFastAsPossible)
+    {
+        return true;
+    }
+    const auto interrupted = [this]()
+    {
+        QMutexLocker locker(&m_mutex);
+        return !m_running || m_paused || m_seekPending;
+    };
+    while(!m_scheduler.waitUntil(dueNs - SCHEDULE_LOOKAHEAD_NS, interrupted, false))
+    {
+        QMutexLocker locker(&m_mutex);
+        while(m_paused && m_running && !m_seekPending)
+        {
+            m_pauseCondition.wait(&m_mutex);
+        }
+        if(!m_running || m_seekPending)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int WorkerClass::cleanHexData(QLatin1String data, char *buffer, int capacity)
+{
+    //单趟解码：跳过非十六进制字符并直接写入结果缓冲区
+    const int size = buffer ? HexDecoder::decode(data.data(), data.size(), buffer, capacity) : -1;
+    //长度校验（空数据或奇数个十六进制字符）
+    if(size <= 0)
+    {
+        qCDebug(workerLog) << "无效 HEX 数据:" << data;
+        m_log.add("WARN", "无效 HEX 数据:" + QString(data));
+        return -1;
     }
-    return result;
+    return size;
 }
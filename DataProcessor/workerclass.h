@@ -11,8 +11,19 @@
 #include <QRegularExpression>
 #include <QLoggingCategory>
 #include "udpsender.h"
+#include "replay/capturereader.h"
+#include "replay/replayscheduler.h"
+#include "replay/topicfilter.h"
+#include "replay/parsepipeline.h"
+#include "replay/filewalker.h"
+#include "replay/replaytelemetry.h"
+#include "replay/capturerecorder.h"
+#include "replay/packetarena.h"
+#include "replay/seekindex.h"
+#include "log/logbatcher.h"
 #include <QMutexLocker>
 #include <QElapsedTimer>
+#include <QHash>
 
 /**
  * @brief 工作线程类
@@ -23,6 +34,14 @@ class WorkerClass : public QObject
     Q_OBJECT
 
 public:
+    ///任务类型
+    enum class Task
+    {
+        Replay,  ///< 回放抓包（.txt / .dpcap）
+        Convert, ///< 将 .txt 抓包转换为 .dpcap
+        Record   ///< 从目标地址接收数据包录制为抓包文件
+    };
+
     explicit WorkerClass(QObject *parent = nullptr);
     ~WorkerClass();
 
@@ -32,9 +51,22 @@ public:
      *   - dataDir: 数据目录路径
      *   - addresses: 目标地址列表 (IP:Port)
      *   - sendInterval: 发送间隔(ms)
+     *   - pacingMode: 回放节奏 (interval-固定间隔 / timestamp-按时间戳)
+     *   - speedFactor: 时间戳回放倍速，0 表示尽可能快
      *   - order: 文件处理顺序 (顺序/倒序)
      *   - include/excludeTopics: 主题过滤列表
      *   - uniqueMode: 是否过滤重复主题
+     *   - parseThreads: 解析线程数（0-自动，1-在工作线程内解析）
+     *   - parseBufferMB: 解析流水线缓存预算(MB)
+     *   - telemetryFile: 回放结束后导出统计 JSON 的路径（为空不导出）
+     *   - loopCount: 回放轮数（1-单次，0-循环直到停止）
+     *   - preloadMB: 循环回放的预载内存预算(MB)，0 表示每轮都逐文件读取
+     *   - recordDir: 录制文件保存目录（为空时使用数据目录）
+     *   - recordFormat: 录制格式 (text / dpcap)
+     *   - recordInterface: 加入组播使用的本机网卡地址（为空由系统选择）
+     *   - startTime: 起始位置（抓包时间或 "+偏移"，为空从头开始）
+     *   - checkpointFile: 断点文件路径（为空时为数据目录下的 .dataprocessor_checkpoint.json）
+     *   - resumeCheckpoint: 是否从上次未完成的断点继续（优先于 startTime）
      */
     void configure(const QVariantMap &config);
 
@@ -48,6 +80,14 @@ public:
     ///停止处理任务
     void stopProcessing();
 
+    /**
+     * @brief 运行中跳转（可在任意线程调用）
+     * 当前包发送后生效，从目标时间所在位置继续；暂停期间跳转立即定位，恢复后从新位置发送。
+     * @param target 抓包时间或 "+偏移"，格式见 SeekIndex::parseTarget
+     * @return 目标无法解析或未在回放时返回 false
+     */
+    bool seekTo(const QString &target);
+
     ///获取暂停状态
     bool isPaused();
 
@@ -57,9 +97,16 @@ public:
     ///设置组播地址
     void setAddrList(const QStringList addrlist);
 
+    ///设置任务类型（需在 startProcessing 之前调用）
+    void setTask(Task task);
+
+    ///日志缓冲（界面线程定时取出，包含发送器日志）
+    LogBatcher *logBatcher() { return &m_log; }
+
+    ///回放统计（界面线程定时取快照，运行结束后可导出）
+    ReplayTelemetry *telemetry() { return &m_telemetry; }
+
 signals:
-    ///日志信号
-    void logMessage(const QString &level, const QString &msg);
 
     ///进度更新 (0-100%)
     void progressUpdated(int percent);
@@ -77,35 +124,147 @@ private slots:
     void process();
 
 private:
-    ///递归收集文件
-    QStringList collectFilesRecursive(const QString &path, bool isDesc);
+    ///回放起点
+    struct StartPoint
+    {
+        int file = -1;           ///< 文件序号（-1 表示从头开始）
+        qint64 offset = -1;      ///< 读取起点的字节偏移（-1 表示文件开头）
+        qint64 index = 0;        ///< 起点之前的行数（文本）或包序号（.dpcap）
+        bool skipByTime = false; ///< 是否跳过早于 targetUs 的数据包
+        qint64 targetUs = 0;     ///< 目标抓包时间（已换算到该文件的时间表示）
+    };
+
+    ///按需继续遍历目录，直到已发现的文件数达到 count 或遍历结束
+    ///新发现的文件同时交给解析流水线
+    ///@return 已发现的文件数
+    int discoverFiles(int count);
+
+    ///按已处理文件数与估算总数计算进度百分比（遍历结束前不超过 99）
+    int progressPercent(int done) const;
 
     ///遍历处理文件列表
     void processFiles();
 
-    ///处理单个文件
+    ///按完整文件列表重建解析流水线，并跳过 firstFile 之前的文件
+    void rebuildPipeline(int firstFile);
+
+    ///取得文件的定位索引（首次使用时加载，文本抓包缺少旁路索引时扫描生成）
+    const SeekIndex &seekIndex(int file);
+
+    /**
+     * @brief 将跳转目标解析为回放起点（按需继续遍历目录）
+     * @return 目标无效或晚于全部抓包时返回 false
+     */
+    bool resolveSeek(const QString &target, StartPoint &start);
+
+    ///读取断点文件，未完成时解析为回放起点
+    bool resolveCheckpoint(StartPoint &start);
+
+    ///取出待处理的跳转请求
+    bool takeSeekRequest(QString &target);
+
+    ///是否有待处理的跳转请求
+    bool seekPending();
+
+    ///断点文件路径
+    QString checkpointPath() const;
+
+    ///记录最后交给发送队列的数据包之后的位置，每秒写一次断点
+    void notePosition(qint64 offset, qint64 index);
+
+    ///写断点文件
+    ///@param finished 回放是否已完整结束
+    void saveCheckpoint(bool finished);
+
+    ///第一轮之后的循环回放：预载完整时从内存发送，否则重新逐文件读取
+    ///@param loops 总轮数（0 表示直到停止）
+    void replayLoops(int loops);
+
+    ///从预载区发送一轮
+    void replayArena();
+
+    ///等待发送队列排空并汇总成功/失败计数
+    void collectResults();
+
+    ///在工作线程中释放发送器与解析流水线（锁内取出，锁外等待线程退出）
+    void releaseSender();
+
+    ///第一轮回放时将通过包含/排除列表的数据包收集到预载区
+    void collectForLoop(const char *data, int length, quint16 topic, quint16 flags, qint64 timestampUs);
+
+    ///处理单个文件（按扩展名分派）
     ///@param filePath 文件完整路径
     void processFile(const QString &filePath);
 
-    ///主题过滤
-    ///@return true-需要发送，false-跳过
-    bool filterTopic(const QString &topic);
+    ///回放文本抓包
+    void processTextFile(const QString &filePath);
+
+    ///回放 .dpcap 抓包（无需解析，直接发送载荷）
+    void processDpcapFile(const QString &filePath);
+
+    ///回放解析流水线中已解析的文件
+    ///@param fileIndex 流水线中的文件序号
+    void processParsedFile(int fileIndex, const QString &filePath);
+
+    ///等待调度时刻后将载荷拷入发送队列并发布到所有目标
+    ///@return false-处理已停止
+    bool publishPacket(const char *data, int length, quint16 topic, qint64 dueNs);
+
+    ///记录发送成功明细（每个目标一条，超出阈值的不记录）
+    void logPacketSent(const char *data, int length, quint16 topic);
+
+    ///将文件列表中的 .txt 转换为 .dpcap
+    void convertFiles();
+
+    ///录制目标地址上的数据包，直到停止
+    void recordCapture();
+
+    ///检查运行状态，暂停时阻塞等待
+    ///@return false-处理已停止或有待处理的跳转
+    bool checkRunning();
+
+    ///等待至距调度时刻一个预读窗口内，避免解析过度超前
+    ///@return false-处理已停止或有待处理的跳转
+    bool waitForSchedule(qint64 dueNs);
 
     ///清理十六进制数据
-    ///@return 有效数据返回字节数组，无效返回空
-    QByteArray cleanHexData(const QString &data);
+    ///@param data 指向文件映射区的十六进制文本视图
+    ///@param buffer 解码输出缓冲区（发送队列预留区）
+    ///@param capacity 缓冲区容量
+    ///@return 有效数据返回字节数，无效返回 -1
+    int cleanHexData(QLatin1String data, char *buffer, int capacity);
 
     QVariantMap m_config;             ///< 配置参数
     QStringList m_addrlist;           ///需要发送的组播地址
-    QScopedPointer<UdpSender> m_udpSender; ///< UDP 发送器实例
-    QStringList m_files;               ///< 待处理文件列表
-    QSet<QString> m_sentTopics;        ///< 已发送主题记录（唯一模式使用）
+    QVector<int> m_destinations;      ///< 已注册到发送器的目标索引
+    QStringList m_destinationNames;   ///< 与目标索引对应的地址文本
+    QScopedPointer<UdpSender> m_udpSender; ///< UDP 发送器实例（在工作线程中创建与释放）
+    QStringList m_files;               ///< 已发现的待处理文件
+    QScopedPointer<FileWalker> m_walker; ///< 增量目录遍历器
+    TopicFilter m_topicFilter;         ///< 主题过滤位图（含唯一模式记录）
+    QScopedPointer<ParsePipeline> m_pipeline; ///< 多线程解析流水线（单线程解析时为空）
+    ReplayScheduler m_scheduler;       ///< 回放调度器
+    Task m_task = Task::Replay;        ///< 任务类型
+    LogBatcher m_log;                  ///< 日志缓冲（逐包明细超出阈值时折叠）
+    ReplayTelemetry m_telemetry;       ///< 回放统计（发送器同样写入）
+    ReplayTelemetry::FileStats m_fileStats; ///< 当前文件的统计
+    CaptureRecorder m_recorder;        ///< 抓包录制器（录制任务）
+    PacketArena m_arena;               ///< 循环回放的预载区
+    int m_pass = 0;                    ///< 当前回放轮次（从 1 开始）
+    int m_currentFile = -1;            ///< 正在回放的文件序号
+    StartPoint m_start;                ///< 回放起点（仅作用于 m_start.file 这一个文件）
+    StartPoint m_position;             ///< 最后交给发送队列的数据包之后的位置
+    QHash<QString, SeekIndex> m_seekIndexes; ///< 已加载的定位索引
+    QElapsedTimer m_checkpointTimer;   ///< 断点写入计时
+    bool m_checkpointFailed = false;   ///< 断点写入是否已失败（只提示一次）
 
     mutable QMutex m_mutex;            ///< 线程互斥锁
     QWaitCondition m_pauseCondition;   ///< 暂停条件变量
 
     bool m_running = false;            ///< 运行状态标志
     bool m_paused = false;             ///< 暂停状态标志
+    bool m_seekPending = false;        ///< 是否有待处理的跳转
+    QString m_seekTarget;              ///< 待处理的跳转目标
     int m_successCount = 0;            ///< 成功发送计数
     int m_failedCount = 0;             ///< 发送失败计数
 };
@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     DataProcessor \
+    DataProcessor/replay_cli \
     FileTransferTool \
     FilesManager \
     FilesRename \